@@ -40,6 +40,7 @@ option(CINOLIB_USES_BOOST               "Use Boost"                  OFF)
 option(CINOLIB_USES_VTK                 "Use VTK"                    OFF)
 option(CINOLIB_USES_SPECTRA             "Use Spectra"                OFF)
 option(CINOLIB_USES_CGAL                "Use CGAL"                   OFF)
+option(CINOLIB_USES_ZLIB                "Use zlib"                   OFF)
 
 #::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 #::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -178,3 +179,16 @@ if(CINOLIB_USES_CGAL)
     endif()
 endif()
 
+#::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+if(CINOLIB_USES_ZLIB)
+    message("CINOLIB OPTIONAL MODULE: zlib")
+    find_package(ZLIB)
+    if(ZLIB_FOUND)
+        target_link_libraries(cinolib INTERFACE ZLIB::ZLIB)
+        target_compile_definitions(cinolib INTERFACE CINOLIB_USES_ZLIB)
+    else()
+        message("Could not find zlib!")
+        set(CINOLIB_USES_ZLIB OFF)
+    endif()
+endif()
@@ -18,24 +18,24 @@ int main(int argc, char **argv)
     gui.push(&menu);
 
     // associates to the mouse single click event a function that
-    // unprojects the 2D click point and looks for the mesh vertex
-    // closest to it.
-    // NOTE: the complexity here is linear w.r.t. the number of verts.
-    // In my personal experience this has never been a bottleneck, not
-    // even on big meshes. Should this be the case, accelleration data
-    // structures (e.g. octrees) could be used
+    // shoots a ray from the camera through the clicked pixel and
+    // selects the vertex closest to the first (visible) point hit.
+    // NOTE: queries are answered by a spatial index (BVH) which is
+    // built at the first pick, so the first click is slower than
+    // the following ones. The index is dropped automatically when
+    // the mesh geometry changes (e.g. update_bbox/update_normals)
     Profiler profiler;
     gui.callback_mouse_left_click = [&](int modifiers) -> bool
     {
         if(modifiers & GLFW_MOD_SHIFT)
         {
-            vec3d p;
+            uint vid;
             vec2d click = gui.cursor_pos();
-            if(gui.unproject(click, p)) // transform click in a 3d point
+            profiler.push("Vertex pick");
+            bool hit = m.pick_vert(gui.eye_ray(click), vid);
+            profiler.pop();
+            if(hit)
             {
-                profiler.push("Vertex pick");
-                uint vid = m.pick_vert(p);
-                profiler.pop();
                 std::cout << "ID " << vid << std::endl;
                 m.vert_data(vid).color = Color::RED();
                 m.updateGL();
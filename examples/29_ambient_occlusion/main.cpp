@@ -22,6 +22,11 @@ int main(int argc, char **argv)
         {
             m.updateGL();
         }
+        if(ImGui::Button("Ray traced AO (CPU)"))
+        {
+            ambient_occlusion_srf_meshes_CPU(m);
+            m.updateGL();
+        }
     };
 
     return gui.launch();
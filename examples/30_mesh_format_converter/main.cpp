@@ -1,18 +1,134 @@
 #include <cinolib/io/read_write.h>
 #include <cinolib/string_utilities.h>
 #include <cinolib/stl_container_utilities.h>
+#include <cinolib/io/mesh_stream_reader.h>
 #include <cinolib/meshes/trimesh.h>
 
-int main(int argc, char **argv)
+using namespace cinolib;
+
+// Out of core conversion for meshes that do not fit in memory. Input is streamed
+// in chunks (OBJ, OFF, STL, MESH, CINO) and written straight to the output
+// (OBJ, OFF, MESH), without ever building the whole mesh
+//
+bool stream_convert(const char * in, const char * out, const size_t budget)
 {
-    using namespace cinolib;
+    std::string ext = get_file_extension(in);
+    if(ext.compare("OBJ") !=0 && ext.compare("obj") !=0 &&
+       ext.compare("OFF") !=0 && ext.compare("off") !=0 &&
+       ext.compare("STL") !=0 && ext.compare("stl") !=0 &&
+       ext.compare("MESH")!=0 && ext.compare("mesh")!=0 &&
+       ext.compare("CINO")!=0 && ext.compare("cino")!=0) return false;
+
+    bool to_obj  = (get_file_extension(out).compare("OBJ") ==0 || get_file_extension(out).compare("obj") ==0);
+    bool to_off  = (get_file_extension(out).compare("OFF") ==0 || get_file_extension(out).compare("off") ==0);
+    bool to_mesh = (get_file_extension(out).compare("MESH")==0 || get_file_extension(out).compare("mesh")==0);
+    if(!to_obj && !to_off && !to_mesh) return false;
+
+    MeshStreamReader s(in, budget);
+    if(!s.is_open()) return false;
+
+    std::vector<vec3d>             verts;
+    std::vector<std::vector<uint>> polys;
+
+    // OFF and MESH headers need element counts: make a first pass. In MESH
+    // files volumes are stored as Tetrahedra/Hexahedra, surfaces as Triangles/
+    // Quadrilaterals (other polygons are split into triangle fans)
+    bool volume = s.is_volume();
+    uint nv = 0, np = 0, n4 = 0, n8 = 0, n3 = 0;
+    if(to_off || to_mesh)
+    {
+        while(s.next_verts(verts)) {}
+        while(s.next_polys(polys)) for(const auto & p : polys)
+        {
+                 if(p.size()==4)           ++n4;
+            else if(p.size()==8 && volume) ++n8;
+            else if(p.size()>=3 && !volume) n3 += uint(p.size())-2;
+        }
+        nv = s.verts_read();
+        np = s.polys_read();
+        s.rewind();
+    }
+
+    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+    FILE *fp = fopen(out, "w");
+    if(!fp)
+    {
+        std::cout << "ERROR: couldn't write output file " << out << std::endl;
+        return true;
+    }
+
+    if(to_off)  fprintf(fp, "OFF\n%d %d 0\n", nv, np);
+    if(to_mesh) fprintf(fp, "MeshVersionFormatted 1\nDimension 3\nVertices\n%d\n", nv);
+    while(s.next_verts(verts))
+    {
+        for(const vec3d & v : verts)
+        {
+            if(to_obj)  fprintf(fp, "v %.17g %.17g %.17g\n", v.x(), v.y(), v.z());
+            if(to_off)  fprintf(fp, "%.17g %.17g %.17g\n",   v.x(), v.y(), v.z());
+            if(to_mesh) fprintf(fp, "%.17g %.17g %.17g 0\n", v.x(), v.y(), v.z());
+        }
+    }
 
-    if(argc!=3)
+    if(to_mesh)
+    {
+        // each element type goes in its own section, hence one pass each
+        for(uint arity : {3,4,8})
+        {
+            uint n = (arity==3) ? n3 : ((arity==4) ? n4 : n8);
+            if(n==0) continue;
+                 if(arity==3) fprintf(fp, "Triangles\n%d\n", n);
+            else if(arity==8) fprintf(fp, "Hexahedra\n%d\n", n);
+            else              fprintf(fp, volume ? "Tetrahedra\n%d\n" : "Quadrilaterals\n%d\n", n);
+            s.rewind();
+            while(s.next_polys(polys))
+            {
+                for(const auto & p : polys)
+                {
+                    if(arity==3 && p.size()!=4 && p.size()>=3)
+                    {
+                        for(uint i=2; i<p.size(); ++i) fprintf(fp, "%d %d %d 0\n", p[0]+1, p[i-1]+1, p[i]+1);
+                        continue;
+                    }
+                    if(p.size()!=arity) continue;
+                    for(uint vid : p) fprintf(fp, "%d ", vid+1);
+                    fprintf(fp, "0\n");
+                }
+            }
+        }
+        fprintf(fp, "End\n\n");
+    }
+    else
     {
-        std::cout << "\n\nusage:\n\tfile_converter input output\n\n" << std::endl;
+        while(s.next_polys(polys))
+        {
+            for(const auto & p : polys)
+            {
+                if(to_obj) fprintf(fp, "f ");
+                if(to_off) fprintf(fp, "%d ", int(p.size()));
+                for(uint vid : p) fprintf(fp, "%d ", to_obj ? vid+1 : vid);
+                fprintf(fp, "\n");
+            }
+        }
+    }
+    fclose(fp);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    if(argc!=3 && argc!=4)
+    {
+        std::cout << "\n\nusage:\n\tfile_converter input output [memory budget in MB, for out of core conversion]\n\n" << std::endl;
         return -1;
     }
 
+    if(argc==4 && stream_convert(argv[1], argv[2], size_t(atoi(argv[3]))*1024*1024))
+    {
+        return 0;
+    }
+
     std::vector<vec3d>             verts;
     std::vector<std::vector<uint>> faces;
     std::vector<std::vector<uint>> polys;
@@ -0,0 +1,129 @@
+#include <cinolib/io/read_write.h>
+#include <cinolib/io/write_NODE_ELE.h>
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/grid_mesh.h>
+#include <cinolib/profiler.h>
+#include <cinolib/string_utilities.h>
+#include <functional>
+#include <random>
+#include <sys/stat.h>
+
+using namespace cinolib;
+
+// Compares the throughput (MB/s) of the text writers for OBJ, OFF and NODE/ELE
+// against plain fprintf based writers, which were used in CinoLib before the
+// switch to the buffered emitter (see cinolib/io/buffered_text_writer.h).
+// Coordinates are randomly perturbed, so that they have full mantissas
+// and formatting costs are representative of real data.
+//
+// Usage: ./text_writers_benchmark [quads_per_side] [output_folder]
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void fprintf_OBJ(const char * filename, const std::vector<double> & xyz, const std::vector<std::vector<uint>> & poly)
+{
+    FILE *fp = fopen(filename, "w");
+    for(uint i=0; i<xyz.size(); i+=3) fprintf(fp, "v %.17g %.17g %.17g\n", xyz[i], xyz[i+1], xyz[i+2]);
+    for(auto p : poly)
+    {
+        fprintf(fp, "f ");
+        for(uint vid : p) fprintf(fp, "%d ", vid+1);
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void fprintf_OFF(const char * filename, const std::vector<double> & xyz, const std::vector<std::vector<uint>> & poly)
+{
+    FILE *fp = fopen(filename, "w");
+    fprintf (fp, "OFF\n%zu %d 0\n", xyz.size()/3, uint(poly.size()));
+    for(uint i=0; i<xyz.size(); i+=3) fprintf(fp, "%.17g %.17g %.17g\n", xyz[i], xyz[i+1], xyz[i+2]);
+    for(auto p : poly)
+    {
+        fprintf(fp, "%d ", static_cast<int>(p.size()));
+        for(uint vid : p) fprintf(fp, "%d ", vid);
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void fprintf_NODE_ELE(const char * basename, const std::vector<vec3d> & verts, const std::vector<std::vector<uint>> & poly)
+{
+    FILE *f_node = fopen((std::string(basename) + ".node").c_str(), "w");
+    FILE *f_ele  = fopen((std::string(basename) + ".ele").c_str(),  "w");
+    fprintf(f_node, "%d 0\n", (int)verts.size());
+    for(auto p : verts) fprintf(f_node, "%.17g %.17g %.17g\n", p.x(), p.y(), p.z());
+    fprintf(f_ele, "%d\n", (int)poly.size());
+    for(const std::vector<uint> & p : poly)
+    {
+        fprintf(f_ele, "%d ", (int)p.size());
+        for(uint vid : p) fprintf(f_ele, "%d ", vid+1);
+        fprintf(f_ele, "\n");
+    }
+    fclose(f_node);
+    fclose(f_ele);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+double file_MB(const std::string & filename)
+{
+    struct stat st;
+    return (stat(filename.c_str(), &st)==0) ? double(st.st_size)/(1024.0*1024.0) : 0.0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char *argv[])
+{
+    uint        n   = (argc>=2) ? atoi(argv[1]) : 1000;
+    std::string dir = (argc>=3) ? std::string(argv[2]) : std::string(".");
+
+    Quadmesh<> m;
+    grid_mesh(n, n, m);
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> noise(-0.25,0.25);
+    for(uint vid=0; vid<m.num_verts(); ++vid) m.vert(vid) += vec3d(noise(rng), noise(rng), noise(rng));
+
+    std::vector<double>            xyz   = serialized_xyz_from_vec3d(m.vector_verts());
+    const std::vector<vec3d>     & verts = m.vector_verts();
+    const std::vector<std::vector<uint>> & polys = m.vector_polys();
+    std::cout << m.num_verts() << " verts, " << m.num_polys() << " polys" << std::endl << std::endl;
+
+    Profiler p;
+    auto bench = [&](const std::string & name, const std::string & file, const std::string & file2,
+                     const std::function<void()> & before, const std::function<void()> & after)
+    {
+        p.push(name); before(); double t0 = p.pop(false);
+        double mb0 = file_MB(file) + file_MB(file2);
+        p.push(name); after();  double t1 = p.pop(false);
+        double mb1 = file_MB(file) + file_MB(file2);
+        std::cout << name << "\tfprintf: " << mb0/t0 << " MB/s (" << mb0 << " MB)"
+                          << "\tbuffered: " << mb1/t1 << " MB/s (" << mb1 << " MB)"
+                          << "\tspeedup: " << (mb1/t1)/(mb0/t0) << "x" << std::endl;
+    };
+
+    std::string obj  = dir + "/bench.obj";
+    std::string off  = dir + "/bench.off";
+    std::string base = dir + "/bench";
+    bench("OBJ",      obj, "",              [&]{ fprintf_OBJ(obj.c_str(), xyz, polys); },
+                                            [&]{ write_OBJ  (obj.c_str(), xyz, polys); });
+    bench("OFF",      off, "",              [&]{ fprintf_OFF(off.c_str(), xyz, polys); },
+                                            [&]{ write_OFF  (off.c_str(), xyz, polys); });
+    bench("NODE/ELE", base+".node", base+".ele", [&]{ fprintf_NODE_ELE(base.c_str(), verts, polys); },
+                                                 [&]{ write_NODE_ELE  (base.c_str(), verts, polys); });
+
+    // coordinates must survive the round trip bit by bit
+    std::vector<vec3d> tmp_verts;
+    std::vector<std::vector<uint>> tmp_polys;
+    read_OBJ(obj.c_str(), tmp_verts, tmp_polys);
+    bool ok = (tmp_polys==polys && tmp_verts.size()==verts.size());
+    for(uint vid=0; ok && vid<verts.size(); ++vid) ok = (tmp_verts[vid]==verts[vid]);
+    std::cout << std::endl << "round trip " << (ok ? "OK" : "FAILED") << std::endl;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/io/async_mesh_loader.h>
+#include <cinolib/gl/glcanvas.h>
+
+int main(int argc, char **argv)
+{
+    using namespace cinolib;
+
+    std::string s = (argc==2) ? std::string(argv[1]) : std::string(DATA_PATH) + "/bunny.obj";
+
+    // the mesh must not be accessed until the loader is ready
+    DrawableTrimesh<> m;
+    AsyncMeshLoader<DrawableTrimesh<>> loader(m, s.c_str());
+    bool pushed = false;
+
+    GLcanvas gui;
+    gui.callback_app_controls = [&]()
+    {
+        if(!loader.is_ready())
+        {
+            ImGui::Text("Loading %s", get_file_name(s).c_str());
+            ImGui::ProgressBar(loader.progress());
+            if(ImGui::SmallButton("Cancel")) loader.cancel();
+        }
+        else if(!loader.wait())
+        {
+            ImGui::Text(loader.is_canceled() ? "Loading canceled" : "Loading failed");
+        }
+        else if(!pushed)
+        {
+            // rendering data must be generated on the GL thread
+            m.updateGL();
+            gui.push(&m);
+            pushed = true;
+        }
+        else ImGui::Text("%d verts, %d polys", m.num_verts(), m.num_polys());
+    };
+
+    return gui.launch();
+}
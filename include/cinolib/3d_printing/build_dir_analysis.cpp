@@ -0,0 +1,196 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/3d_printing/build_dir_analysis.h>
+#include <cinolib/Moller_Trumbore_intersection.h>
+#include <cinolib/vector_serialization.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/deg_rad.h>
+#include <cmath>
+
+namespace cinolib
+{
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+BuildDirAnalysis::BuildDirAnalysis(const Trimesh<M,V,E,P> & m)
+{
+    c     = m.centroid();
+    verts = m.vector_verts();
+    tris  = serialized_vids_from_polys(m.vector_polys());
+
+    uint nv = m.num_verts();
+    uint np = m.num_polys();
+    vx.resize(nv); vy.resize(nv); vz.resize(nv);
+    nx.resize(np); ny.resize(np); nz.resize(np);
+    cx.resize(np); cy.resize(np); cz.resize(np);
+    area.resize(np);
+
+    PARALLEL_FOR(0, nv, 10000, [&](const uint vid)
+    {
+        vec3d p = m.vert(vid) - c;
+        vx[vid] = p.x();
+        vy[vid] = p.y();
+        vz[vid] = p.z();
+    });
+
+    std::vector<AABB> boxes(np);
+    PARALLEL_FOR(0, np, 10000, [&](const uint pid)
+    {
+        vec3d n = m.poly_data(pid).normal;
+        vec3d p = m.poly_centroid(pid) - c;
+        n.normalize();
+        nx[pid]   = n.x();
+        ny[pid]   = n.y();
+        nz[pid]   = n.z();
+        cx[pid]   = p.x();
+        cy[pid]   = p.y();
+        cz[pid]   = p.z();
+        area[pid] = m.poly_area(pid);
+        boxes[pid] = AABB(m.poly_verts(pid));
+    });
+    bvh.build(boxes);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// returns the first triangle hit by a ray shot from the centroid of pid
+// along dir, or pid itself if there is no such triangle
+CINO_INLINE
+uint BuildDirAnalysis::hit_below(const uint pid, const vec3d & dir) const
+{
+    vec3d orig = c + vec3d(cx[pid], cy[pid], cz[pid]);
+    auto hit = [&](const uint tid, const double t_max, double & t) -> bool
+    {
+        if(tid==pid) return false;
+        bool   backside, coplanar;
+        vec3d  bary;
+        return Moller_Trumbore_intersection(orig, dir,
+                                            verts[tris[3*tid  ]],
+                                            verts[tris[3*tid+1]],
+                                            verts[tris[3*tid+2]],
+                                            backside, coplanar, t, bary) && t>=0 && t<t_max;
+    };
+    uint   id;
+    double t;
+    return bvh.first_hit(orig, dir, hit, id, t) ? id : pid;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BuildDirAnalysis::eval(const vec3d          & build_dir,
+                            const float            thresh,
+                                  BuildDirScores & scores) const
+{
+    vec3d  d = build_dir;
+    d.normalize();
+    double dx = d.x();
+    double dy = d.y();
+    double dz = d.z();
+
+    // height and floor (same as height_along_build_dir)
+    double h_min =  inf_double;
+    double h_max = -inf_double;
+    for(uint vid=0; vid<vx.size(); ++vid)
+    {
+        double h = vx[vid]*dx + vy[vid]*dy + vz[vid]*dz;
+        h_min = std::min(h_min, h);
+        h_max = std::max(h_max, h);
+    }
+    scores.floor  = float(h_min);
+    scores.height = float(h_max - h_min);
+
+    // overhangs: the angle between normal and build direction exceeds 90+thresh
+    // degrees, or equivalently, their dot product is below cos(90+thresh)
+    double cos_max = -std::sin(to_rad(double(thresh)));
+    scores.overhangs.clear();
+    for(uint pid=0; pid<area.size(); ++pid)
+    {
+        if(nx[pid]*dx + ny[pid]*dy + nz[pid]*dz < cos_max)
+        {
+            scores.overhangs.push_back(std::make_pair(pid,pid));
+        }
+    }
+
+    // supports (same as supports_contact_area and supports_volume)
+    scores.contact_area = 0;
+    scores.supp_volume  = 0;
+    for(auto & o : scores.overhangs)
+    {
+        o.second = hit_below(o.first, -d);
+
+        float a     = float(area[o.first]);
+        float z_beg = float(cx[o.first]*dx + cy[o.first]*dy + cz[o.first]*dz);
+        float z_end = (o.first==o.second) ? scores.floor : float(cx[o.second]*dx + cy[o.second]*dy + cz[o.second]*dz);
+        scores.contact_area += a;
+        if(o.second!=o.first) scores.contact_area += a;
+        scores.supp_volume  += a * (z_beg - z_end);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BuildDirAnalysis::eval(const std::vector<vec3d>          & build_dirs,
+                            const float                         thresh,
+                                  std::vector<BuildDirScores> & scores) const
+{
+    scores.resize(build_dirs.size());
+    PARALLEL_FOR(0, uint(build_dirs.size()), 2, [&](const uint i)
+    {
+        eval(build_dirs[i], thresh, scores[i]);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BuildDirAnalysis::support_beams(const vec3d              & build_dir,
+                                     const BuildDirScores     & scores,
+                                           std::vector<vec3d> & beams) const
+{
+    for(const auto & ov : scores.overhangs)
+    {
+        vec3d p0(cx[ov.first ], cy[ov.first ], cz[ov.first ]);
+        vec3d p1(cx[ov.second], cy[ov.second], cz[ov.second]);
+        float length = (ov.first!=ov.second) ? float(p0.dot(build_dir) - p1.dot(build_dir))
+                                             : float(p0.dot(build_dir)) - scores.floor;
+        beams.push_back(c + p0);
+        beams.push_back(c + p0 - build_dir*length);
+    }
+}
+
+}
@@ -0,0 +1,118 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_BUILD_DIR_ANALYSIS_H
+#define CINO_BUILD_DIR_ANALYSIS_H
+
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/bvh.h>
+
+namespace cinolib
+{
+
+/* Batched evaluation of the main 3D printing metrics (overhangs, support contact area,
+ * support volume, height along the build direction) for many candidate build directions.
+ *
+ * Calling overhangs, supports_contact_area, supports_volume and height_along_build_dir
+ * once per direction recomputes the same per triangle quantities (normals, areas and
+ * centroids) over and over, and sets up a new spatial index for the ray casting. Here
+ * all per element data is computed once, stored in flat arrays, and shared among all
+ * directions, which can be processed in parallel. Results are the same one would obtain
+ * with the functions above (see their documentation for details), except that overhangs
+ * are listed in ascending order of triangle ID.
+*/
+
+struct BuildDirScores
+{
+    std::vector<std::pair<uint,uint>> overhangs;        // hanging triangles, and the triangle below them (see overhangs.h)
+    float                             height       = 0; // see height_along_build_dir.h
+    float                             floor        = 0; // lowest point along the build direction (w.r.t. the mesh centroid)
+    float                             contact_area = 0; // see supports_contact_area.h
+    float                             supp_volume  = 0; // see supports_volume.h
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class BuildDirAnalysis
+{
+    public:
+
+        template<class M, class V, class E, class P>
+        explicit BuildDirAnalysis(const Trimesh<M,V,E,P> & m);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void eval(const vec3d          & build_dir,
+                  const float            thresh,     // overhang threshold (degrees)
+                        BuildDirScores & scores) const;
+
+        void eval(const std::vector<vec3d>          & build_dirs,
+                  const float                         thresh,     // overhang threshold (degrees)
+                        std::vector<BuildDirScores> & scores) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // same as support_beams (see support_beams.h)
+        void support_beams(const vec3d              & build_dir,
+                           const BuildDirScores     & scores,
+                                 std::vector<vec3d> & beams) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint num_polys() const { return uint(area.size()); }
+
+    protected:
+
+        uint hit_below(const uint pid, const vec3d & dir) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        vec3d               c;          // mesh centroid
+        std::vector<vec3d>  verts;      // mesh vertices (for ray casting)
+        std::vector<uint>   tris;       // mesh triangles (for ray casting)
+        std::vector<double> vx, vy, vz; // vertex coordinates, w.r.t. the centroid
+        std::vector<double> nx, ny, nz; // triangle normals (unit length)
+        std::vector<double> cx, cy, cz; // triangle centroids, w.r.t. the mesh centroid
+        std::vector<double> area;       // triangle areas
+        BVH                 bvh;        // spatial index of the triangles
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "build_dir_analysis.cpp"
+#endif
+
+#endif // CINO_BUILD_DIR_ANALYSIS_H
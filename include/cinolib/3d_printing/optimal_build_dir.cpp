@@ -34,95 +34,84 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/3d_printing/optimal_build_dir.h>
-#include <cinolib/3d_printing/overhangs.h>
-#include <cinolib/3d_printing/height_along_build_dir.h>
-#include <cinolib/3d_printing/supports_contact_area.h>
-#include <cinolib/3d_printing/supports_volume.h>
+#include <cinolib/3d_printing/build_dir_analysis.h>
 #include <cinolib/3d_printing/shadow_on_build_platform.h>
 #include <cinolib/sphere_coverage.h>
+#include <cinolib/parallel_for.h>
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+#include <cinolib/gl/offline_gl_context.h>
+#endif
 
 namespace cinolib
 {
 
+CINO_INLINE
+bool optimal_build_dir_is_forbidden(const OptimalBuildDirOptions & opt, const vec3d & dir)
+{
+    for(const vec3d & fd : opt.forb_dirs)
+    {
+        if(fd.angle_deg(dir)<opt.forb_cone_angle) return true;
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// evaluates height, support contact area and support volume for a candidate build
+// direction (the shadow area depends on the rasterization backend, and is computed
+// by the caller)
 template<class M, class V, class E, class P>
 CINO_INLINE
-vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
-                        const OptimalBuildDirOptions   & opt,
-                              float                    & best_height,
-                              float                    & best_shadow_area,
-                              float                    & best_contact_area,
-                              float                    & best_supp_volume)
+void optimal_build_dir_scores(const Trimesh<M,V,E,P>       & m,
+                              const OptimalBuildDirOptions & opt,
+                              const vec3d                  & dir,
+                              const BuildDirAnalysis       & analysis,
+                                    float                  & h,
+                                    float                  & c,
+                                    float                  & v)
 {
-    // evenly sample the unit sphere to produce
-    // a set of candidate build directions
-    std::vector<vec3d> dirs;
-    sphere_coverage(opt.n_dirs, dirs);
+    // NOTE: this call is 90% of the computational cost
+    BuildDirScores s;
+    analysis.eval(dir, opt.overhang_threshold, s);
 
-    // cache everything that can be cached to speed up computation
-    GLFWwindow *GL_context = create_offline_GL_context(opt.buffer_size, opt.buffer_size);
-    u_int8_t   *data       = new u_int8_t[opt.buffer_size*opt.buffer_size];
-    Octree octree;
-    octree.build_from_mesh_polys(m);
+    h = (opt.w_height         >0) ? s.height       : 0.f;
+    c = (opt.w_support_contact>0) ? s.contact_area : 0.f;
+    v = (opt.w_support_volume >0) ? s.supp_volume  : 0.f;
 
-    // compute scores for all candidate directions. scores are stored separately because this will
-    // allow to normalize them in the same range and combine them in a meaningful way...
-    //
-    std::vector<float> h(opt.n_dirs, inf_float); // height (along the build direction)
-    std::vector<float> a(opt.n_dirs, inf_float); // area of the projection on the building platform
-    std::vector<float> c(opt.n_dirs, inf_float); // area of the contacts between model and supports
-    std::vector<float> v(opt.n_dirs, inf_float); // volume of the supports
-    //
-    for(uint i=0; i<opt.n_dirs; ++i)
+    // add penalty for critical surfaces
+    if(opt.w_support_contact>0 &&
+       opt.crit_srf.size()  >0)
     {
-        bool skip = false;
-        for(const vec3d & fd : opt.forb_dirs)
+        for(auto & ov : s.overhangs)
         {
-            if(fd.angle_deg(dirs[i])<opt.forb_cone_angle)
+            // scale overhang area
+            if(CONTAINS(opt.crit_srf,ov.first))
             {
-                skip = true;
-                break;
+                c += m.poly_area(ov.first) * opt.crit_srf_boost;
             }
-        }
-        if(skip) continue;
-
-        // NOTE: this call is 90% of the computational cost
-        std::vector<std::pair<uint,uint>> polys_hanging;
-        overhangs(m, opt.overhang_threshold, dirs[i], polys_hanging, octree);
-
-        // projection of the "lowest" mesh vertex along the build direction
-        // this is used further down to estimate the volume of support structures
-        // which are supposed to expand from the overhang down to the floor
-        float floor;
-
-        h[i] = (opt.w_height         >0) ? height_along_build_dir(m, dirs[i], floor) : 0.f;
-        a[i] = (opt.w_shadow_area    >0) ? shadow_on_build_platform(m, dirs[i], opt.buffer_size, data, GL_context) : 0.f;
-        c[i] = (opt.w_support_contact>0) ? supports_contact_area(m, polys_hanging) : 0.f;
-        v[i] = (opt.w_support_volume >0) ? supports_volume(m, dirs[i], floor, polys_hanging) : 0.f;
-
-        // add penalty for critical surfaces
-        if(opt.w_support_contact>0 &&
-           opt.crit_srf.size()  >0)
-        {
-            for(auto & ov : polys_hanging)
+            // scale area of poly vertically below overhang
+            if(ov.second!=ov.first && CONTAINS(opt.crit_srf,ov.second))
             {
-                // scale overhang area
-                if(CONTAINS(opt.crit_srf,ov.first))
-                {
-                    c[i] += m.poly_area(ov.first) * opt.crit_srf_boost;
-                }
-                // scale area of poly vertically below overhang
-                if(ov.second!=ov.first && CONTAINS(opt.crit_srf,ov.second))
-                {
-                    c[i] += m.poly_area(ov.second) * opt.crit_srf_boost;
-                }
+                c += m.poly_area(ov.second) * opt.crit_srf_boost;
             }
         }
     }
+}
 
-    // release memory
-    destroy_offline_GL_context(GL_context);
-    delete[] data;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// combines the scores of all candidate directions and returns the index of the best one
+CINO_INLINE
+uint optimal_build_dir_select(const OptimalBuildDirOptions & opt,
+                                    std::vector<float>     & h,
+                                    std::vector<float>     & a,
+                                    std::vector<float>     & c,
+                                    std::vector<float>     & v,
+                                    float                  & best_height,
+                                    float                  & best_shadow_area,
+                                    float                  & best_contact_area,
+                                    float                  & best_supp_volume)
+{
     // normalize all scores in [0,1]
     auto h_minmax = std::minmax_element(h.begin(), h.end());
     auto a_minmax = std::minmax_element(a.begin(), a.end());
@@ -162,7 +151,116 @@ vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
     best_contact_area = c.at(std::distance(scores.begin(),it));
     best_supp_volume  = v.at(std::distance(scores.begin(),it));
 
-    return dirs.at(std::distance(scores.begin(),it));
+    return uint(std::distance(scores.begin(),it));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+vec3d optimal_build_dir(const Trimesh<M,V,E,P>       & m,
+                        const OptimalBuildDirOptions & opt,
+                              float                  & best_height,
+                              float                  & best_shadow_area,
+                              float                  & best_contact_area,
+                              float                  & best_supp_volume)
+{
+    // evenly sample the unit sphere to produce
+    // a set of candidate build directions
+    std::vector<vec3d> dirs;
+    sphere_coverage(opt.n_dirs, dirs);
+
+    // cache everything that can be cached to speed up computation
+    BuildDirAnalysis analysis(m);
+
+    // compute scores for all candidate directions. scores are stored separately because this will
+    // allow to normalize them in the same range and combine them in a meaningful way...
+    //
+    std::vector<float> h(opt.n_dirs, inf_float); // height (along the build direction)
+    std::vector<float> a(opt.n_dirs, inf_float); // area of the projection on the building platform
+    std::vector<float> c(opt.n_dirs, inf_float); // area of the contacts between model and supports
+    std::vector<float> v(opt.n_dirs, inf_float); // volume of the supports
+    //
+    // directions are independent from each other, and are therefore evaluated in parallel
+    // (each one with its own rasterization buffer)
+    PARALLEL_FOR(0, opt.n_dirs, 2, [&](const uint i)
+    {
+        if(optimal_build_dir_is_forbidden(opt, dirs[i])) return;
+
+        optimal_build_dir_scores(m, opt, dirs[i], analysis, h[i], c[i], v[i]);
+
+        if(opt.w_shadow_area>0)
+        {
+            std::vector<u_int8_t> data(opt.buffer_size*opt.buffer_size);
+            a[i] = shadow_on_build_platform_CPU(m, dirs[i], opt.buffer_size, data.data(), false);
+        }
+        else a[i] = 0.f;
+    });
+
+    uint best = optimal_build_dir_select(opt, h, a, c, v, best_height, best_shadow_area, best_contact_area, best_supp_volume);
+    return dirs.at(best);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+vec3d optimal_build_dir(const Trimesh<M,V,E,P>       & m,
+                        const OptimalBuildDirOptions & opt)
+{
+    float best_height;
+    float best_shadow_area;
+    float best_contact_area;
+    float best_supp_volume;
+    return optimal_build_dir(m, opt, best_height, best_shadow_area, best_contact_area, best_supp_volume);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
+                        const OptimalBuildDirOptions   & opt,
+                              float                    & best_height,
+                              float                    & best_shadow_area,
+                              float                    & best_contact_area,
+                              float                    & best_supp_volume)
+{
+    const Trimesh<M,V,E,P> & tm = m;
+    if(!opt.use_GL) return optimal_build_dir(tm, opt, best_height, best_shadow_area, best_contact_area, best_supp_volume);
+
+    // evenly sample the unit sphere to produce
+    // a set of candidate build directions
+    std::vector<vec3d> dirs;
+    sphere_coverage(opt.n_dirs, dirs);
+
+    // cache everything that can be cached to speed up computation
+    GLFWwindow *GL_context = create_offline_GL_context(opt.buffer_size, opt.buffer_size);
+    u_int8_t   *data       = new u_int8_t[opt.buffer_size*opt.buffer_size];
+    BuildDirAnalysis analysis(tm);
+
+    std::vector<float> h(opt.n_dirs, inf_float); // height (along the build direction)
+    std::vector<float> a(opt.n_dirs, inf_float); // area of the projection on the building platform
+    std::vector<float> c(opt.n_dirs, inf_float); // area of the contacts between model and supports
+    std::vector<float> v(opt.n_dirs, inf_float); // volume of the supports
+    //
+    // the GL context cannot be shared among threads: directions are evaluated sequentially
+    for(uint i=0; i<opt.n_dirs; ++i)
+    {
+        if(optimal_build_dir_is_forbidden(opt, dirs[i])) continue;
+
+        optimal_build_dir_scores(tm, opt, dirs[i], analysis, h[i], c[i], v[i]);
+        a[i] = (opt.w_shadow_area>0) ? shadow_on_build_platform(m, dirs[i], opt.buffer_size, data, GL_context) : 0.f;
+    }
+
+    // release memory
+    destroy_offline_GL_context(GL_context);
+    delete[] data;
+
+    uint best = optimal_build_dir_select(opt, h, a, c, v, best_height, best_shadow_area, best_contact_area, best_supp_volume);
+    return dirs.at(best);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -179,4 +277,6 @@ vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
     return optimal_build_dir(m, opt, best_height, best_shadow_area, best_contact_area, best_supp_volume);
 }
 
+#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
+
 }
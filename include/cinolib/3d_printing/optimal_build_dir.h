@@ -36,7 +36,9 @@
 #ifndef CINO_OPTIMAL_BUILD_DIR_H
 #define CINO_OPTIMAL_BUILD_DIR_H
 
+#include <cinolib/meshes/trimesh.h>
 #include <cinolib/meshes/drawable_trimesh.h>
+#include <unordered_set>
 
 namespace cinolib
 {
@@ -76,6 +78,11 @@ namespace cinolib
  * the support contact area, the area of critical surfaces touched by a support structure
  * will be multiplied by a boost factor, in order to count more than the other regular
  * surface elements.
+ *
+ * Candidate directions are evaluated in parallel. Shadow areas are computed with the
+ * CPU rasterizer (see cinolib/rasterizer.h), hence no GL context is needed. Drawable
+ * meshes can still rasterize shadows with OpenGL by setting use_GL in the options
+ * (in this case directions are evaluated sequentially).
 */
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -93,10 +100,31 @@ struct OptimalBuildDirOptions
     float forb_cone_angle    = 3.0;     // amplitude of each cone hosting a forbidden build direction
     std::vector<vec3d>       forb_dirs; // set of forbidden build directions
     std::unordered_set<uint> crit_srf;  // list of triangles that are critical
+    bool  use_GL             = false;   // rasterize shadows with an offline GL context (drawable meshes only)
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+vec3d optimal_build_dir(const Trimesh<M,V,E,P>       & m,
+                        const OptimalBuildDirOptions & opt,
+                              float                  & best_height,
+                              float                  & best_shadow_area,
+                              float                  & best_contact_area,
+                              float                  & best_supp_volume);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+vec3d optimal_build_dir(const Trimesh<M,V,E,P>       & m,
+                        const OptimalBuildDirOptions & opt);
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
@@ -113,6 +141,7 @@ CINO_INLINE
 vec3d optimal_build_dir(const DrawableTrimesh<M,V,E,P> & m,
                         const OptimalBuildDirOptions   & opt);
 
+#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
 }
 
 #ifndef  CINO_STATIC_LIB
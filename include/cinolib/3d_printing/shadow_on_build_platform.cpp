@@ -35,11 +35,34 @@
 *********************************************************************************/
 #include <cinolib/3d_printing/shadow_on_build_platform.h>
 #include <cinolib/cast_shadow.h>
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
 #include <cinolib/gl/offline_gl_context.h>
+#endif
 
 namespace cinolib
 {
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+float shadow_on_build_platform_CPU(const Trimesh<M,V,E,P> & m,         //
+                                   const vec3d            & build_dir, //
+                                   const uint               img_size,  // frame buffer will be img_size x img_size
+                                         u_int8_t         * data,      //
+                                   const bool               parallel)  // rasterize on multiple threads
+{
+    cast_shadow_CPU(m, build_dir, img_size, img_size, data, parallel);
+    uint shadow_pixels = 0;
+    for(uint i=0; i<img_size*img_size; ++i)
+    {
+        if(data[i]==0xFF) ++shadow_pixels;
+    }
+    return (float)shadow_pixels/(img_size*img_size);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 float shadow_on_build_platform(const DrawableTrimesh<M,V,E,P> & m,         //
@@ -77,4 +100,6 @@ float shadow_on_build_platform(const DrawableTrimesh<M,V,E,P> & m,          //
     return (float)shadow_pixels/(img_size*img_size);
 }
 
+#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
+
 }
@@ -36,8 +36,11 @@
 #ifndef CINO_SHADOW_ON_BUILD_PLATFORM_H
 #define CINO_SHADOW_ON_BUILD_PLATFORM_H
 
+#include <cinolib/meshes/trimesh.h>
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
 #include <cinolib/meshes/drawable_trimesh.h>
 #include <cinolib/gl/gl_glfw.h>
+#endif
 
 namespace cinolib
 {
@@ -52,8 +55,24 @@ namespace cinolib
  *
  * In case the method is called multiple times it is conveniente to pass
  * a GL context so as to amortize the cost of initialization.
+ *
+ * The CPU version rasterizes the mesh with cinolib::cast_shadow_CPU, hence it
+ * does not need any GL context and can be called from multiple threads (with
+ * parallel set to false, e.g. to evaluate many build directions at once)
 */
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+float shadow_on_build_platform_CPU(const Trimesh<M,V,E,P> & m,                //
+                                   const vec3d            & build_dir,        //
+                                   const uint               img_size,         // frame buffer will be img_size x img_size
+                                         u_int8_t         * data,             //
+                                   const bool               parallel = true); // rasterize on multiple threads
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 float shadow_on_build_platform(const DrawableTrimesh<M,V,E,P> & m,         //
@@ -71,7 +90,7 @@ float shadow_on_build_platform(const DrawableTrimesh<M,V,E,P> & m,           //
                                      u_int8_t                 * data,        //
                                      GLFWwindow               * GL_context); // cached for amortized computation
 
-
+#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -0,0 +1,275 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/3d_printing/slice_mesh.h>
+#include <cinolib/parallel_for.h>
+#include <climits>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+namespace cinolib
+{
+
+namespace
+{
+
+// a mesh edge, used as a key to identify intersection points
+CINO_INLINE
+uint64_t slice_edge_key(const uint v0, const uint v1)
+{
+    return (v0<v1) ? (uint64_t(v0)<<32 | v1) : (uint64_t(v1)<<32 | v0);
+}
+
+struct SliceSegment
+{
+    uint64_t beg = 0;  // key of the edge containing the first endpoint
+    uint64_t end = 0;  // key of the edge containing the second endpoint
+    vec3d    p;        // first endpoint (the second is the first of the next segment)
+};
+
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void slice_mesh(const Trimesh<M,V,E,P>                             & m,
+                const std::vector<double>                          & z_levels,
+                      std::vector<std::vector<std::vector<vec3d>>> & internal_polylines,
+                      std::vector<std::vector<std::vector<vec3d>>> & external_polylines)
+{
+    assert(std::is_sorted(z_levels.begin(), z_levels.end()));
+
+    uint nl = uint(z_levels.size());
+    uint nt = m.num_polys();
+    internal_polylines.assign(nl, std::vector<std::vector<vec3d>>());
+    external_polylines.assign(nl, std::vector<std::vector<vec3d>>());
+    if(nl==0 || nt==0) return;
+
+    // sort triangles by their lowest z
+    std::vector<std::pair<double,uint>> z_min(nt);
+    PARALLEL_FOR(0, nt, 10000, [&](const uint pid)
+    {
+        double z0 = m.poly_vert(pid,0).z();
+        double z1 = m.poly_vert(pid,1).z();
+        double z2 = m.poly_vert(pid,2).z();
+        z_min[pid] = std::make_pair(std::min(z0,std::min(z1,z2)), pid);
+    });
+    std::sort(z_min.begin(), z_min.end());
+
+    // make a compact copy of the mesh, with triangles sorted along z and vertices
+    // renumbered by first use. Triangles that are active at the same time are then
+    // close in memory, and so are their vertices
+    std::vector<uint>   v_map(m.num_verts(), UINT_MAX);
+    std::vector<vec3d>  verts;
+    std::vector<uint>   tris(3*nt);
+    std::vector<double> z_max(nt);
+    verts.reserve(m.num_verts());
+    for(uint i=0; i<nt; ++i)
+    {
+        uint pid = z_min[i].second;
+        double z = z_min[i].first;
+        for(uint j=0; j<3; ++j)
+        {
+            uint vid = m.poly_vert_id(pid,j);
+            if(v_map[vid]==UINT_MAX)
+            {
+                v_map[vid] = uint(verts.size());
+                verts.push_back(m.vert(vid));
+            }
+            tris[3*i+j] = v_map[vid];
+            z = std::max(z, verts[v_map[vid]].z());
+        }
+        z_max[i] = z;
+    }
+
+    // slices a triangle spanning z, returning the oriented segment (if any). Vertices with
+    // z coordinate equal to the plane are considered above it. Looking from the top, the
+    // segment goes from the edge crossed downwards to the edge crossed upwards, so that
+    // outer boundaries are counter-clockwise and holes clockwise
+    auto slice_tri = [&](const uint tid, const double z, SliceSegment & seg) -> bool
+    {
+        const uint * v = &tris[3*tid];
+        bool below[3];
+        for(uint i=0; i<3; ++i) below[i] = (verts[v[i]].z() < z);
+        if(below[0]==below[1] && below[1]==below[2]) return false;
+
+        for(uint i=0; i<3; ++i)
+        {
+            uint a = v[i];
+            uint b = v[(i+1)%3];
+            if(below[i] && !below[(i+1)%3]) seg.end = slice_edge_key(a,b); else
+            if(!below[i] && below[(i+1)%3])
+            {
+                // always interpolate from the vertex below, so that the same point
+                // is computed from both the triangles incident to the edge
+                const vec3d & pa = verts[b];
+                const vec3d & pb = verts[a];
+                double t = (z - pa.z())/(pb.z() - pa.z());
+                seg.beg  = slice_edge_key(a,b);
+                seg.p    = (pb.z()==z) ? pb : pa + (pb-pa)*t;
+                seg.p.z()= z;
+            }
+        }
+        return true;
+    };
+
+    // chains the segments of a slice into closed loops, and classifies them as
+    // outer boundaries or holes depending on their orientation. Segments are matched
+    // with an open addressing hash table, indexed by the edge key of their first point
+    std::atomic<uint> n_open(0);
+    auto chain = [&](const uint lid, const std::vector<SliceSegment> & segs, std::vector<uint> & table)
+    {
+        uint size = 1;
+        while(size < 2*segs.size()) size <<= 1;
+        table.assign(size, UINT_MAX);
+        auto slot = [&](const uint64_t key) -> uint
+        {
+            return uint((key*0x9E3779B97F4A7C15ull) >> 32) & (size-1);
+        };
+        for(uint i=0; i<segs.size(); ++i)
+        {
+            uint h = slot(segs[i].beg);
+            while(table[h]!=UINT_MAX) h = (h+1) & (size-1);
+            table[h] = i;
+        }
+        auto next = [&](const uint64_t key) -> uint
+        {
+            uint h = slot(key);
+            while(table[h]!=UINT_MAX)
+            {
+                if(segs[table[h]].beg==key) return table[h];
+                h = (h+1) & (size-1);
+            }
+            return UINT_MAX;
+        };
+
+        std::vector<bool> visited(segs.size(), false);
+        for(uint i=0; i<segs.size(); ++i)
+        {
+            if(visited[i]) continue;
+
+            std::vector<vec3d> loop;
+            bool closed = false;
+            uint curr   = i;
+            while(!visited[curr])
+            {
+                visited[curr] = true;
+                // skip zero length segments (generated by vertices lying on the plane)
+                if(loop.empty() || !(loop.back()==segs[curr].p)) loop.push_back(segs[curr].p);
+                curr = next(segs[curr].end);
+                if(curr==UINT_MAX) break;
+                closed = (curr==i);
+            }
+            if(!closed) { ++n_open; continue; }
+            if(loop.size()>1 && loop.back()==loop.front()) loop.pop_back();
+            if(loop.size()<3) continue;
+
+            double area = 0;
+            for(uint j=0; j<loop.size(); ++j)
+            {
+                const vec3d & p0 = loop[j];
+                const vec3d & p1 = loop[(j+1)%loop.size()];
+                area += p0.x()*p1.y() - p1.x()*p0.y();
+            }
+            if(area>0) external_polylines[lid].push_back(std::move(loop)); else
+            if(area<0) internal_polylines[lid].push_back(std::move(loop));
+        }
+    };
+
+    // split the stack of planes into bands, and sweep each band independently
+    uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+    uint n_bands   = std::min(nl, 4*n_threads);
+    uint band_size = (nl + n_bands - 1)/n_bands;
+    n_bands        = (nl + band_size - 1)/band_size;
+    PARALLEL_FOR(0, n_bands, 2, [&](const uint bid)
+    {
+        uint l_beg = bid*band_size;
+        uint l_end = std::min(nl, l_beg+band_size);
+
+        std::vector<uint>                 active;
+        std::vector<SliceSegment>         segs;
+        std::vector<uint>                 table;
+
+        // initialize the sweep: activate all triangles that start below the first plane
+        // and do not end below it (the others are filtered out in the loop below)
+        uint cursor = 0;
+        while(cursor<nt && z_min[cursor].first<z_levels[l_beg])
+        {
+            if(z_max[cursor]>=z_levels[l_beg]) active.push_back(cursor);
+            ++cursor;
+        }
+
+        for(uint lid=l_beg; lid<l_end; ++lid)
+        {
+            double z = z_levels[lid];
+            while(cursor<nt && z_min[cursor].first<z) active.push_back(cursor++);
+            active.erase(std::remove_if(active.begin(), active.end(), [&](const uint tid){ return z_max[tid]<z; }), active.end());
+
+            segs.clear();
+            SliceSegment seg;
+            for(uint tid : active) if(slice_tri(tid, z, seg)) segs.push_back(seg);
+            chain(lid, segs, table);
+        }
+    });
+
+    if(n_open>0)
+    {
+        std::cerr << "WARNING: " << n_open << " open polylines discarded while slicing (is the mesh watertight?)" << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void slice_mesh(const Trimesh<M,V,E,P>                             & m,
+                const double                                         layer_thickness,
+                      std::vector<std::vector<std::vector<vec3d>>> & internal_polylines,
+                      std::vector<std::vector<std::vector<vec3d>>> & external_polylines)
+{
+    assert(layer_thickness>0);
+    double z_min = m.bbox().min.z();
+    double z_max = m.bbox().max.z();
+    uint   n     = uint(std::ceil((z_max-z_min)/layer_thickness));
+
+    std::vector<double> z_levels(n);
+    for(uint i=0; i<n; ++i) z_levels[i] = z_min + (i+0.5)*layer_thickness;
+
+    slice_mesh(m, z_levels, internal_polylines, external_polylines);
+}
+
+}
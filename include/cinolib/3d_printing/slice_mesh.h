@@ -0,0 +1,89 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SLICE_MESH_H
+#define CINO_SLICE_MESH_H
+
+#include <cinolib/meshes/trimesh.h>
+
+namespace cinolib
+{
+
+/* Slices a triangle mesh with a stack of horizontal planes (z = const), producing for each
+ * plane the closed polylines bounding the cross section of the object. The output follows
+ * the same conventions of read_CLI, and can therefore be directly fed to a SlicedObj:
+ *
+ *   SlicedObj<> obj(internal_polylines, external_polylines, {}, {});
+ *
+ * Polylines are not closed (the last point does not repeat the first one). Outer boundaries
+ * and holes are distinguished by the orientation of each loop, which is inherited from the
+ * orientation of the triangles. Hence, the input mesh is assumed to be watertight and
+ * consistently oriented, with normals pointing outwards. Loops that cannot be closed (e.g.
+ * because the mesh has boundaries) are discarded.
+ *
+ * Slicing is done with a plane sweep: triangles are sorted by their minimum z, and the
+ * planes are visited bottom to top maintaining the list of triangles that span the current
+ * height. The stack of planes is split in bands that are sliced in parallel, each with its
+ * own sweep. Intersection points are keyed by the mesh edge they lie on, hence segments are
+ * chained into loops by exact (hashed) endpoint matching, without geometric tolerances.
+ * Mesh vertices lying exactly on a slicing plane are considered above it.
+*/
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void slice_mesh(const Trimesh<M,V,E,P>                             & m,
+                const std::vector<double>                          & z_levels,           // sorted in ascending order
+                      std::vector<std::vector<std::vector<vec3d>>> & internal_polylines, // inner holes
+                      std::vector<std::vector<std::vector<vec3d>>> & external_polylines);// outer slice boundary
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// uniform layers of the given thickness, covering the whole height of the object.
+// Each layer is sliced at its mid height. For variable layer thickness, just
+// use the version above, passing the desired sequence of z levels
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void slice_mesh(const Trimesh<M,V,E,P>                             & m,
+                const double                                         layer_thickness,
+                      std::vector<std::vector<std::vector<vec3d>>> & internal_polylines, // inner holes
+                      std::vector<std::vector<std::vector<vec3d>>> & external_polylines);// outer slice boundary
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "slice_mesh.cpp"
+#endif
+
+#endif // CINO_SLICE_MESH_H
@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/3d_printing/sliced_object.h>
+#include <cinolib/3d_printing/slice_mesh.h>
 #include <cinolib/io/read_CLI.h>
 #include <cinolib/triangle_wrap.h>
 #include <cinolib/vector_serialization.h>
@@ -73,6 +74,23 @@ SlicedObj<M,V,E,P>::SlicedObj(const std::vector<std::vector<std::vector<vec3d>>>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+SlicedObj<M,V,E,P>::SlicedObj(const Trimesh<M,V,E,P>    & m,
+                              const std::vector<double> & z_levels,
+                              const double                thick_radius)
+    : Trimesh<M,V,E,P>()
+    , thick_radius(thick_radius)
+{
+    std::vector<std::vector<std::vector<vec3d>>> slice_polys;
+    std::vector<std::vector<std::vector<vec3d>>> slice_holes;
+    std::vector<std::vector<std::vector<vec3d>>> supports(z_levels.size());
+    slice_mesh(m, z_levels, slice_polys, slice_holes);
+    init(slice_polys, slice_holes, supports);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 BoostMultiPolygon SlicedObj<M,V,E,P>::slice_as_boost_poly(const uint sid) const
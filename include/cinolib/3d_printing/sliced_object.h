@@ -70,6 +70,13 @@ class SlicedObj : public Trimesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        // slices a (watertight) triangle mesh at the given heights (see slice_mesh.h)
+        explicit SlicedObj(const Trimesh<M,V,E,P>    & m,
+                           const std::vector<double> & z_levels,
+                           const double                thick_radius = 0.01);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         uint num_slices() const { return slices.size(); }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
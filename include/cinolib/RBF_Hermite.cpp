@@ -34,6 +34,10 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/RBF_Hermite.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 
 namespace cinolib
 {
@@ -41,17 +45,19 @@ namespace cinolib
 template<class RBF>
 CINO_INLINE
 Hermite_RBF<RBF>::Hermite_RBF(const std::vector<vec3d> & points,
-                              const std::vector<vec3d> & normals)
+                              const std::vector<vec3d> & normals,
+                              const double               support_radius)
 {
     assert(points.size()==normals.size());
+    assert(support_radius>=0);
 
     uint np = uint(points.size());
     alpha.resize(np);
     beta.resize(3, np);
     center.resize(3, np);
+    support = support_radius;
 
     uint size = 4*np;
-    Eigen::MatrixXd A(size, size);
     Eigen::VectorXd f(size);
     Eigen::VectorXd x(size);
 
@@ -59,42 +65,130 @@ Hermite_RBF<RBF>::Hermite_RBF(const std::vector<vec3d> & points,
     for(uint i=0; i<np; ++i)
     {
         center.col(i) = Eigen::Vector3d(points.at(i).x(), points.at(i).y(), points.at(i).z());
-    }
-
-    for(uint i=0; i<np; ++i)
-    {
-        Eigen::Vector3d p = Eigen::Vector3d(points.at(i).x(),  points.at(i).y(),  points.at(i).z());
-        Eigen::Vector3d n = Eigen::Vector3d(normals.at(i).x(), normals.at(i).y(), normals.at(i).z());
 
         uint ii = 4*i;
         f(ii) = 0;
-        f.template segment<3>(ii+1) = n;
+        f.template segment<3>(ii+1) = Eigen::Vector3d(normals.at(i).x(), normals.at(i).y(), normals.at(i).z());
+    }
 
-        for(uint j=0; j<np; ++j)
+    if(support==0)
+    {
+        // global kernel: dense system, assembled in parallel (one block row per thread)
+        Eigen::MatrixXd A(size, size);
+        PARALLEL_FOR(0, np, 64, [&](uint i)
         {
-            uint jj = 4*j;
-            Eigen::Vector3d diff = p-center.col(j);
-            double len=diff.norm();
-            if(len==0)
+            Eigen::Matrix4d B;
+            for(uint j=0; j<np; ++j)
             {
-                A.template block<4,4>(ii,jj).setZero();
+                kernel_block(center.col(i)-center.col(j), B);
+                A.template block<4,4>(4*i,4*j) = B;
             }
-            else
+        });
+        x = A.lu().solve(f);
+    }
+    else
+    {
+        // compactly supported kernel: the system is sparse. Neighbors are stored once
+        // (CSR), and kernel blocks are recomputed at each product with the (never
+        // assembled) system matrix, so that memory stays linear in the number of points.
+        // The system is solved with the centers sorted by grid cell, so that centers
+        // which are close in space are also close in memory
+        grid_build();
+        std::vector<uint> rank(np);
+        Eigen::Matrix3Xd  pts(3, np);
+        Eigen::VectorXd   fs(size);
+        for(uint k=0; k<np; ++k)
+        {
+            rank[grid_ids[k]] = k;
+            pts.col(k) = center.col(grid_ids[k]);
+            fs.template segment<4>(4*k) = f.template segment<4>(4*grid_ids[k]);
+        }
+        f = fs;
+
+        std::vector<std::vector<uint>> tmp(np);
+        std::vector<uint> nbr_off(np+1,0);
+        PARALLEL_FOR(0, np, 1000, [&](uint i)
+        {
+            grid_nbrs(pts.col(i), tmp[i]);
+            for(uint & j : tmp[i]) j = rank[j];
+            nbr_off[i] = uint(tmp[i].size());
+        });
+        uint nnz = PARALLEL_PREFIX_SUM(nbr_off, 1000);
+        nbr_off[np] = nnz;
+        std::vector<uint> nbr(nnz);
+        PARALLEL_FOR(0, np, 1000, [&](uint i)
+        {
+            std::copy(tmp[i].begin(), tmp[i].end(), nbr.begin()+nbr_off[i]);
+            std::vector<uint>().swap(tmp[i]);
+        });
+
+        const double inv_support = 1.0/support;
+        auto mat_vec = [&](const Eigen::VectorXd & in, Eigen::VectorXd & out)
+        {
+            PARALLEL_FOR(0, np, 1000, [&](uint i)
             {
-                double w    = RBF::eval_f(len);
-                double dw_l = RBF::eval_df(len)/len;
-                double ddw  = RBF::eval_ddf(len);
-                Eigen::Vector3d g = diff*dw_l;
-                A(ii,jj) = w;
-                A.row(ii).template segment<3>(jj+1) = g.transpose();
-                A.col(jj).template segment<3>(ii+1) = g;
-                A.template block<3,3>(ii+1,jj+1)  = (ddw - dw_l)/(len*len) * (diff*diff.transpose());
-                A.template block<3,3>(ii+1,jj+1).diagonal().array() += dw_l;
-            }
+                double * sum = out.data() + 4*i;
+                sum[0] = sum[1] = sum[2] = sum[3] = 0;
+                for(uint k=nbr_off[i]; k<nbr_off[i+1]; ++k)
+                {
+                    uint j = nbr[k];
+                    kernel_block_mul(pts.data()+3*i, pts.data()+3*j, inv_support, in.data()+4*j, sum);
+                }
+            });
+        };
+
+        // Jacobi preconditioner. Diagonal blocks are all equal (kernel_block at zero distance)
+        Eigen::Matrix4d D;
+        kernel_block(Eigen::Vector3d::Zero(), D);
+        Eigen::Vector4d inv_diag;
+        for(uint k=0; k<4; ++k) inv_diag[k] = (D(k,k)!=0) ? 1.0/D(k,k) : 1.0;
+        auto precond = [&](const Eigen::VectorXd & in, Eigen::VectorXd & out)
+        {
+            PARALLEL_FOR(0, np, 10000, [&](uint i)
+            {
+                out.template segment<4>(4*i) = in.template segment<4>(4*i).cwiseProduct(inv_diag);
+            });
+        };
+
+        // preconditioned BiCGSTAB (the Hermite system is not symmetric)
+        const double tol      = 1e-6;
+        const uint   max_iter = 1000;
+        x.setZero();
+        Eigen::VectorXd r = f, r0 = f, p = Eigen::VectorXd::Zero(size), v = p, y(size), z(size), s(size), t(size);
+        double rho = 1, a = 1, w = 1;
+        double f_norm = f.norm();
+        uint   iter = 0;
+        while(f_norm>0 && r.norm()>tol*f_norm && iter<max_iter)
+        {
+            double rho_new = r0.dot(r);
+            if(rho_new==0) break;
+            double b = (rho_new/rho)*(a/w);
+            rho = rho_new;
+            p = r + b*(p - w*v);
+            precond(p, y);
+            mat_vec(y, v);
+            a = rho/r0.dot(v);
+            s = r - a*v;
+            precond(s, z);
+            mat_vec(z, t);
+            double tt = t.squaredNorm();
+            w = (tt>0) ? t.dot(s)/tt : 0;
+            x += a*y + w*z;
+            r = s - w*t;
+            ++iter;
+            if(w==0) break;
+        }
+        if(f_norm>0 && r.norm()>tol*f_norm)
+        {
+            std::cout << "WARNING : " << __FILE__ << ", line " << __LINE__ << " : Hermite_RBF() : BiCGSTAB stopped after " << iter
+                      << " iterations, with relative residual " << r.norm()/f_norm << std::endl;
         }
+
+        // back to the input order
+        for(uint k=0; k<np; ++k) fs.template segment<4>(4*grid_ids[k]) = x.template segment<4>(4*k);
+        x = fs;
     }
 
-    x = A.lu().solve(f);
     Eigen::Map<Eigen::Matrix4Xd> mx(x.data(), 4, np);
 
     alpha = mx.row(0);
@@ -108,7 +202,10 @@ CINO_INLINE
 ScalarField Hermite_RBF<RBF>::eval(const std::vector<vec3d> & plist) const
 {
     ScalarField f(uint(plist.size()));
-    for(uint i=0; i<plist.size(); ++i) f[i] = eval(plist.at(i));
+    PARALLEL_FOR(0, uint(plist.size()), 100, [&](uint i)
+    {
+        f[i] = eval(plist.at(i));
+    });
     return f;
 }
 
@@ -119,17 +216,15 @@ CINO_INLINE
 double Hermite_RBF<RBF>::eval(const vec3d & p) const
 {
     Eigen::Vector3d pp(p.x(), p.y(), p.z());
+    double s   = (support>0) ? 1.0/support : 1.0;
     double val = 0;
-    for(uint i=0; i<center.cols(); ++i)
+    if(support>0)
     {
-        Eigen::Vector3d diff = pp-center.col(i);
-        double l = diff.norm();
-        if(l>0)
-        {
-            val += alpha(i) * RBF::eval_f(l);
-            val += beta.col(i).dot(diff)*RBF::eval_df(l)/l;
-        }
+        std::vector<uint> ids;
+        grid_nbrs(pp, ids);
+        for(uint i : ids) val += eval_center(pp, i, s);
     }
+    else for(uint i=0; i<center.cols(); ++i) val += eval_center(pp, i, s);
     return val;
 }
 
@@ -141,31 +236,184 @@ vec3d Hermite_RBF<RBF>::eval_grad(const vec3d &p) const
 {
     Eigen::Vector3d pp(p.x(), p.y(), p.z());
     Eigen::Vector3d grad = Eigen::Vector3d::Zero();
+    double s = (support>0) ? 1.0/support : 1.0;
+    if(support>0)
+    {
+        std::vector<uint> ids;
+        grid_nbrs(pp, ids);
+        for(uint i : ids) add_grad(pp, i, s, grad);
+    }
+    else for(uint i=0; i<center.cols(); ++i) add_grad(pp, i, s, grad);
+    return vec3d(grad[0], grad[1], grad[2]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    for(uint i=0; i<center.cols(); i++)
+// 4x4 block of the interpolation matrix that relates the constraints at point p_i
+// to the coefficients (alpha_j,beta_j) of center c_j, with diff = p_i - c_j.
+// At zero distance the (finite) limit of the block is used, which is zero for
+// kernels like CubicRBF, and diag(phi(0),phi''(0),phi''(0),phi''(0)) in general
+template<class RBF>
+CINO_INLINE
+void Hermite_RBF<RBF>::kernel_block(const Eigen::Vector3d & diff, Eigen::Matrix4d & B) const
+{
+    double s   = (support>0) ? 1.0/support : 1.0;
+    double len = diff.norm();
+    B.setZero();
+    if(len==0)
+    {
+        B(0,0) = RBF::eval_f(0);
+        B.template bottomRightCorner<3,3>().diagonal().array() = RBF::eval_ddf(0)*s*s;
+    }
+    else
     {
-        Eigen::Vector3d node = center.col(i);
-        Eigen::Vector3d beta = this->beta.col(i);
-        Eigen::Vector3d diff = pp - node;
+        double w    = RBF::eval_f(len*s);
+        double dw_l = RBF::eval_df(len*s)*s/len;
+        double ddw  = RBF::eval_ddf(len*s)*s*s;
+        Eigen::Vector3d g = diff*dw_l;
+        B(0,0) = w;
+        B.row(0).template segment<3>(1) = g.transpose();
+        B.col(0).template segment<3>(1) = g;
+        B.template block<3,3>(1,1)  = (ddw - dw_l)/(len*len) * (diff*diff.transpose());
+        B.template block<3,3>(1,1).diagonal().array() += dw_l;
+    }
+}
 
-        float len=diff.norm();
-        if(len>0.00001f)
-        {
-            Eigen::Vector3d diffNormalized = diff;
-            diffNormalized.normalize();
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// y += B*x, with B the block computed by kernel_block for point p and center c,
+// without assembling it (its lower right 3x3 block is a rank one update of a scaled identity)
+template<class RBF>
+CINO_INLINE
+void Hermite_RBF<RBF>::kernel_block_mul(const double * p, const double * c, const double s, const double * x, double * y) const
+{
+    double d[3] = { p[0]-c[0], p[1]-c[1], p[2]-c[2] };
+    double len  = std::sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+    if(len==0)
+    {
+        double ddw = RBF::eval_ddf(0)*s*s;
+        y[0] += RBF::eval_f(0)*x[0];
+        y[1] += ddw*x[1];
+        y[2] += ddw*x[2];
+        y[3] += ddw*x[3];
+    }
+    else
+    {
+        double w    = RBF::eval_f(len*s);
+        double dw_l = RBF::eval_df(len*s)*s/len;
+        double ddw  = RBF::eval_ddf(len*s)*s*s;
+        double dx   = d[0]*x[1] + d[1]*x[2] + d[2]*x[3];
+        double c    = dw_l*x[0] + (ddw - dw_l)/(len*len)*dx;
+        y[0] += w*x[0] + dw_l*dx;
+        y[1] += c*d[0] + dw_l*x[1];
+        y[2] += c*d[1] + dw_l*x[2];
+        y[3] += c*d[2] + dw_l*x[3];
+    }
+}
 
-            float dphi       = RBF::eval_df(len);
-            float ddphi      = RBF::eval_ddf(len);
-            float alpha_dphi = alpha(i) * dphi;
-            float bDotd_l    = beta.dot(diff)/len;
-            float squared_l  = diff.squaredNorm();
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-            grad += alpha_dphi * diffNormalized;
-            grad += bDotd_l * (ddphi*diffNormalized - diff*dphi/squared_l) + beta*dphi/len ;
-        }
+template<class RBF>
+CINO_INLINE
+double Hermite_RBF<RBF>::eval_center(const Eigen::Vector3d & p, const uint i, const double s) const
+{
+    const double * c = center.data() + 3*i;
+    const double * b = beta.data()   + 3*i;
+    double dx = p[0]-c[0];
+    double dy = p[1]-c[1];
+    double dz = p[2]-c[2];
+    double l  = std::sqrt(dx*dx + dy*dy + dz*dz);
+    if(l>0)
+    {
+        return alpha[i] * RBF::eval_f(l*s) +
+               (b[0]*dx + b[1]*dy + b[2]*dz) * RBF::eval_df(l*s)*s/l;
     }
+    return alpha[i] * RBF::eval_f(0);
+}
 
-    return vec3d(grad[0], grad[1], grad[2]);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+void Hermite_RBF<RBF>::add_grad(const Eigen::Vector3d & p, const uint i, const double s, Eigen::Vector3d & grad) const
+{
+    Eigen::Vector3d b    = beta.col(i);
+    Eigen::Vector3d diff = p - center.col(i);
+    double len = diff.norm();
+    if(len*s>1e-8)
+    {
+        double dphi  = RBF::eval_df (len*s)*s;
+        double ddphi = RBF::eval_ddf(len*s)*s*s;
+        grad += alpha(i)*dphi/len * diff;
+        grad += b.dot(diff)*(ddphi - dphi/len)/(len*len) * diff + b*dphi/len;
+    }
+    else grad += b*RBF::eval_ddf(0)*s*s;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// cells have the size of the support radius and are identified by their (21 bits per axis)
+// integer coordinates, packed into a 64 bits key with Z as the least significant part,
+// so that the cells of a Z column are contiguous in the sorted list of keys
+template<class RBF>
+CINO_INLINE
+void Hermite_RBF<RBF>::grid_build()
+{
+    uint np = uint(center.cols());
+    grid_origin = (np>0) ? Eigen::Vector3d(center.rowwise().minCoeff()) : Eigen::Vector3d::Zero();
+
+    std::vector<std::pair<uint64_t,uint>> cells(np);
+    PARALLEL_FOR(0, np, 10000, [&](uint i)
+    {
+        Eigen::Vector3d c = (center.col(i)-grid_origin)/support;
+        uint64_t key = (uint64_t(c[0])<<42) | (uint64_t(c[1])<<21) | uint64_t(c[2]);
+        cells[i] = std::make_pair(key,i);
+    });
+    std::sort(cells.begin(), cells.end());
+
+    grid_keys.resize(np);
+    grid_ids.resize(np);
+    for(uint i=0; i<np; ++i)
+    {
+        grid_keys[i] = cells[i].first;
+        grid_ids[i]  = cells[i].second;
+    }
+    if(np>0) assert(((center.rowwise().maxCoeff()-grid_origin)/support).maxCoeff() < double(1<<21));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// centers strictly closer than the support radius to point p
+template<class RBF>
+CINO_INLINE
+void Hermite_RBF<RBF>::grid_nbrs(const Eigen::Vector3d & p, std::vector<uint> & ids) const
+{
+    ids.clear();
+    Eigen::Vector3d c = (p-grid_origin)/support;
+    const int64_t max_c = (int64_t(1)<<21) - 1;
+    int64_t ijk[3];
+    for(int d=0; d<3; ++d)
+    {
+        if(!(c[d] > -2 && c[d] < double(max_c+2))) return; // far from all centers (or NaN)
+        ijk[d] = int64_t(std::floor(c[d]));
+    }
+    double sq_r = support*support;
+    int64_t k0  = std::max(int64_t(0), ijk[2]-1);
+    int64_t k1  = std::min(max_c,      ijk[2]+1);
+    if(k0>k1) return;
+    for(int64_t i=ijk[0]-1; i<=ijk[0]+1; ++i)
+    for(int64_t j=ijk[1]-1; j<=ijk[1]+1; ++j)
+    {
+        if(i<0 || j<0 || i>max_c || j>max_c) continue;
+        uint64_t col = (uint64_t(i)<<42) | (uint64_t(j)<<21);
+        auto beg = std::lower_bound(grid_keys.begin(), grid_keys.end(), col | uint64_t(k0));
+        auto end = std::upper_bound(beg,               grid_keys.end(), col | uint64_t(k1));
+        for(auto it=beg; it!=end; ++it)
+        {
+            uint id = grid_ids[it-grid_keys.begin()];
+            if((p-center.col(id)).squaredNorm() < sq_r) ids.push_back(id);
+        }
+    }
 }
 
 }
@@ -39,6 +39,7 @@
 #include <cinolib/geometry/vec_mat.h>
 #include <cinolib/scalar_field.h>
 #include <Eigen/Dense>
+#include <cstdint>
 
 namespace cinolib
 {
@@ -60,6 +61,15 @@ namespace cinolib
  *     A Closed-Form Formulation of HRBF-Based Surface Reconstruction
  *     S. Liu, C.C.L. Wang, G. Brunnett, J. Wang
  *     Computer-Aided Design (2016)
+ *
+ * With global kernels (e.g. CubicRBF) the interpolation system is dense, and fitting is
+ * limited to a few thousand points. For large point sets use a compactly supported kernel
+ * (e.g. WendlandRBF) and a positive support radius: each center only interacts with the
+ * centers closer than the radius, fetched through a uniform grid. The sparse system is
+ * solved with a matrix-free (and parallel) BiCGSTAB, and evaluation costs only depend on
+ * the number of centers around the query point. The radius should be large enough for
+ * each point to have at least a few tens of neighbors, otherwise the interpolant will
+ * only be defined in a thin shell around the input points.
 */
 
 template<class RBF>
@@ -69,11 +79,12 @@ class Hermite_RBF
 
         Hermite_RBF(){}
         Hermite_RBF(const std::vector<vec3d> & points,
-                    const std::vector<vec3d> & normals);
+                    const std::vector<vec3d> & normals,
+                    const double               support_radius = 0); // 0 => global kernel
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        ScalarField eval     (const std::vector<vec3d> & plist) const; // evaluate RBF at points plist
+        ScalarField eval     (const std::vector<vec3d> & plist) const; // evaluate RBF at points plist (in parallel)
         double      eval     (const vec3d & p) const;                  // evaluate RBF at point p
         vec3d       eval_grad(const vec3d & p) const;                  // evaluate nabla RBF at point p
 
@@ -82,6 +93,22 @@ class Hermite_RBF
         Eigen::VectorXd  alpha;  // vector of scalar values alpha
         Eigen::Matrix3Xd beta;   // each column represents beta_i: VectorX bi = beta.col(i);
         Eigen::Matrix3Xd center; // each column represents p_i:    VectorX pi = centers.col(i);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        double                support = 0;  // support radius of the kernel (0 for global kernels)
+        Eigen::Vector3d       grid_origin;  // uniform grid with cell size equal to the support radius
+        std::vector<uint64_t> grid_keys;    // sorted cell keys, one per center
+        std::vector<uint>     grid_ids;     // centers, sorted by cell key
+
+    protected:
+
+        void    kernel_block    (const Eigen::Vector3d & diff, Eigen::Matrix4d & B) const;
+        void    kernel_block_mul(const double * p, const double * c, const double s, const double * x, double * y) const;
+        void    grid_build      ();
+        void    grid_nbrs       (const Eigen::Vector3d & p, std::vector<uint> & ids) const;
+        double  eval_center     (const Eigen::Vector3d & p, const uint i, const double s) const;
+        void    add_grad        (const Eigen::Vector3d & p, const uint i, const double s, Eigen::Vector3d & grad) const;
 };
 
 }
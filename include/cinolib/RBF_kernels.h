@@ -47,6 +47,19 @@ class CubicRBF
     static inline double eval_ddf(const double x) { return 6*x;   } // second derivative
 };
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Wendland's C2 kernel (1-x)^4 (4x+1), compactly supported in [0,1].
+// It is meant to be used with a support radius (see Hermite_RBF),
+// which rescales distances and makes the interpolation system sparse
+class WendlandRBF
+{
+    public:
+    static inline double eval_f  (const double x) { if(x>=1) return 0; double t = 1-x; return t*t*t*t*(4*x+1); }
+    static inline double eval_df (const double x) { if(x>=1) return 0; double t = 1-x; return -20*x*t*t*t;     } // first  derivative
+    static inline double eval_ddf(const double x) { if(x>=1) return 0; double t = 1-x; return 20*t*t*(4*x-1);  } // second derivative
+};
+
 }
 
 #endif // CINO_RBF_KERNELS_H
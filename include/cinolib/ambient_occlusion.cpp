@@ -34,17 +34,200 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/ambient_occlusion.h>
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/bvh.h>
+#include <cinolib/Moller_Trumbore_intersection.h>
+#include <cinolib/pi.h>
+#include <algorithm>
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
 #include <cinolib/gl/gl_glfw.h>
 #include <cinolib/gl/glproject.h>
 #include <cinolib/gl/glunproject.h>
 #include <cinolib/sphere_coverage.h>
-#include <cinolib/meshes/meshes.h>
-#include <cinolib/parallel_for.h>
 #include <cinolib/gl/offline_gl_context.h>
+#endif
 
 namespace cinolib
 {
 
+// deterministic per element sampler: the first rays_per_elem points of the
+// Hammersley sequence, randomly shifted (Cranley-Patterson rotation) with
+// a hash of the element id, and mapped to the cosine weighted hemisphere
+// around n
+CINO_INLINE
+void AO_hemisphere_samples(const vec3d              & n,
+                           const uint                 elem,
+                           const uint                 rays,
+                                 std::vector<vec3d> & dirs)
+{
+    auto hash = [](uint x) -> double
+    {
+        x ^= x >> 16; x *= 0x7feb352dU;
+        x ^= x >> 15; x *= 0x846ca68bU;
+        x ^= x >> 16;
+        return x/4294967296.0;
+    };
+    auto radical_inverse = [](uint x) -> double
+    {
+        x = (x << 16) | (x >> 16);
+        x = ((x & 0x55555555U) << 1) | ((x & 0xAAAAAAAAU) >> 1);
+        x = ((x & 0x33333333U) << 2) | ((x & 0xCCCCCCCCU) >> 2);
+        x = ((x & 0x0F0F0F0FU) << 4) | ((x & 0xF0F0F0F0U) >> 4);
+        x = ((x & 0x00FF00FFU) << 8) | ((x & 0xFF00FF00U) >> 8);
+        return x/4294967296.0;
+    };
+
+    // orthonormal frame around n
+    vec3d u = (std::fabs(n.x())>0.9) ? vec3d(0,1,0) : vec3d(1,0,0);
+    u = n.cross(u); u.normalize();
+    vec3d v = n.cross(u);
+
+    double s0 = hash(2*elem);
+    double s1 = hash(2*elem+1);
+    dirs.resize(rays);
+    for(uint i=0; i<rays; ++i)
+    {
+        double r0 = (i+0.5)/rays + s0;        r0 -= std::floor(r0);
+        double r1 = radical_inverse(i) + s1;  r1 -= std::floor(r1);
+        double r  = std::sqrt(r0);
+        double a  = 2.0*M_PI*r1;
+        dirs[i]   = u*(r*std::cos(a)) + v*(r*std::sin(a)) + n*std::sqrt(std::max(0.0,1.0-r0));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// traces rays from the center of each active element towards the hemisphere around
+// its normal, and stores in ao the fraction of rays that do not hit any occluder
+// (i.e. the cosine weighted visibility). Occluders are serialized triangles, each
+// labeled with the element it belongs to, so as to avoid self intersections
+CINO_INLINE
+void AO_raytrace(const std::vector<vec3d> & verts,
+                 const std::vector<uint>  & tris,
+                 const std::vector<uint>  & tri_elem,
+                 const std::vector<vec3d> & centers,
+                 const std::vector<vec3d> & normals,
+                 const std::vector<bool>  & active,
+                 const uint                 rays,
+                 const double               max_dist,
+                       std::vector<float> & ao)
+{
+    uint n_tris = uint(tris.size()/3);
+    std::vector<AABB> boxes(n_tris);
+    PARALLEL_FOR(0, n_tris, 1000, [&](const uint tid)
+    {
+        boxes[tid] = AABB(verts[tris[3*tid]], verts[tris[3*tid+1]]);
+        boxes[tid].push(verts[tris[3*tid+2]]);
+    });
+    BVH bvh;
+    bvh.build(boxes);
+
+    // move ray origins slightly off the surface to avoid hitting adjacent elements
+    double eps = 1e-6 * bvh.bbox().diag();
+
+    ao.assign(centers.size(), 0.f);
+    PARALLEL_FOR(0, uint(centers.size()), 64, [&](const uint id)
+    {
+        if(!active[id] || rays==0) return;
+
+        std::vector<vec3d> dirs;
+        std::vector<bool>  occluded;
+        AO_hemisphere_samples(normals[id], id, rays, dirs);
+        vec3d orig = centers[id] + normals[id]*eps;
+        auto hit = [&](const uint tid, const uint i, const double t_max, double & t) -> bool
+        {
+            if(tri_elem[tid]==id) return false;
+            bool   backside, coplanar;
+            vec3d  bary;
+            return Moller_Trumbore_intersection(orig, dirs[i],
+                                                verts[tris[3*tid  ]],
+                                                verts[tris[3*tid+1]],
+                                                verts[tris[3*tid+2]],
+                                                backside, coplanar, t, bary) && t>=0 && t<t_max;
+        };
+        bvh.any_hit(orig, dirs, hit, occluded, max_dist);
+        ao[id] = float(std::count(occluded.begin(), occluded.end(), false))/rays;
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void ambient_occlusion_srf_meshes_CPU(      Mesh   & m,
+                                      const uint     rays_per_elem,
+                                      const double   max_dist)
+{
+    // hidden polygons neither receive AO nor occlude
+    std::vector<uint>  tris, tri_elem;
+    std::vector<vec3d> centers(m.num_polys()), normals(m.num_polys());
+    std::vector<bool>  active(m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        active[pid] = !m.poly_data(pid).flags[HIDDEN];
+        if(!active[pid]) continue;
+        centers[pid] = m.poly_centroid(pid);
+        normals[pid] = m.poly_data(pid).normal;
+        for(uint vid : m.poly_tessellation(pid))
+        {
+            tris.push_back(vid);
+            if(tris.size()%3==0) tri_elem.push_back(pid);
+        }
+    }
+
+    std::vector<float> ao;
+    AO_raytrace(m.vector_verts(), tris, tri_elem, centers, normals, active, rays_per_elem, max_dist, ao);
+
+    // apply AO. The visibility fraction is already in [0,1] and is used as is
+    // (no renormalization: a convex object must not be darkened). With no rays
+    // there is nothing to estimate: no shading
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        m.poly_data(pid).AO = (active.at(pid) && rays_per_elem>0) ? ao[pid] : 1.f;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void ambient_occlusion_vol_meshes_CPU(      Mesh   & m,
+                                      const uint     rays_per_elem,
+                                      const double   max_dist)
+{
+    // only faces on the visible surface (see face_is_visible) receive AO and occlude
+    std::vector<uint>  tris, tri_elem;
+    std::vector<vec3d> centers(m.num_faces()), normals(m.num_faces());
+    std::vector<bool>  active(m.num_faces());
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        uint pid_beneath = 0;
+        active[fid] = m.face_is_visible(fid, pid_beneath);
+        if(!active[fid]) continue;
+        centers[fid] = m.face_centroid(fid);
+        normals[fid] = m.poly_face_normal(pid_beneath, fid);
+        for(uint vid : m.face_tessellation(fid))
+        {
+            tris.push_back(vid);
+            if(tris.size()%3==0) tri_elem.push_back(fid);
+        }
+    }
+
+    std::vector<float> ao;
+    AO_raytrace(m.vector_verts(), tris, tri_elem, centers, normals, active, rays_per_elem, max_dist, ao);
+
+    // apply AO (raw visibility fraction, as in ambient_occlusion_srf_meshes_CPU)
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        m.face_data(fid).AO = (active.at(fid) && rays_per_elem>0) ? ao[fid] : 1.f;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
 template<class Mesh>
 CINO_INLINE
 void ambient_occlusion_srf_meshes(      Mesh & m,
@@ -216,4 +399,6 @@ void ambient_occlusion_vol_meshes(      Mesh & m,
     }
 }
 
+#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
+
 }
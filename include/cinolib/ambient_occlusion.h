@@ -36,14 +36,42 @@
 #ifndef CINO_AMBIENT_OCCLUSION_H
 #define CINO_AMBIENT_OCCLUSION_H
 
-#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
-
 #include <cinolib/cino_inline.h>
+#include <cinolib/min_max_inf.h>
 #include <sys/types.h>
 
 namespace cinolib
 {
 
+/* updates the ambient occlusion for the (visible portion of) an input mesh.
+ * All surface and volumetric meshes are supported. AO values are computed on
+ * the CPU by tracing rays_per_elem rays from the centroid of each visible
+ * element, sampling the hemisphere around its normal with a cosine weighted
+ * distribution. Rays are traced in packets against a BVH built on the visible
+ * triangles, and each element gets the fraction of its rays that escape (i.e.
+ * 1 means unoccluded). Occluders farther than max_dist are ignored. The sampler is
+ * deterministic, hence results do not depend on the number of threads.
+ * Does not require an OpenGL context.
+*/
+
+template<class Mesh>
+CINO_INLINE
+void ambient_occlusion_srf_meshes_CPU(      Mesh   & m,
+                                      const uint     rays_per_elem = 64,
+                                      const double   max_dist      = inf_double);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void ambient_occlusion_vol_meshes_CPU(      Mesh   & m,
+                                      const uint     rays_per_elem = 64,
+                                      const double   max_dist      = inf_double);
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 /* updates the ambient occlusion for the (visible portion of) an input mesh.
  * All surface and volumetric meshes are supported. AO values are approximated
  * with a dirty trick: the mesh is rendered from a given number of viepoints,
@@ -63,11 +91,12 @@ CINO_INLINE
 void ambient_occlusion_vol_meshes(      Mesh & m,
                                   const int    buffer_size = 350,
                                   const uint   sample_dirs = 256);
+
+#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
 }
 
 #ifndef  CINO_STATIC_LIB
 #include "ambient_occlusion.cpp"
 #endif
 
-#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
 #endif // CINO_AMBIENT_OCCLUSION_H
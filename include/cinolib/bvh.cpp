@@ -0,0 +1,378 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/bvh.h>
+#include <algorithm>
+#include <cmath>
+
+namespace cinolib
+{
+
+CINO_INLINE
+BVH::BVH(const uint items_per_leaf) : items_per_leaf(std::max(1u,items_per_leaf))
+{}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::clear()
+{
+    nodes.clear();
+    ids.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::build(const std::vector<AABB> & boxes)
+{
+    clear();
+    if(boxes.empty()) return;
+
+    uint n = uint(boxes.size());
+    std::vector<std::pair<vec3d,uint>> items(n); // (center,id)
+    for(uint i=0; i<n; ++i) items[i] = std::make_pair(boxes[i].center(), i);
+
+    // top down construction: each node splits its items in two halves at the
+    // median of the longest axis of the box spanned by their centers. The tree
+    // is balanced, hence there are less than 2*n/items_per_leaf nodes. Children
+    // are always stored after their parent
+    nodes.reserve(2*(n/items_per_leaf+1));
+    nodes.push_back(Node());
+    struct Range { uint node, beg, end; };
+    std::vector<Range> stack(1, {0, 0, n});
+    while(!stack.empty())
+    {
+        Range r = stack.back();
+        stack.pop_back();
+
+        if(r.end-r.beg <= items_per_leaf)
+        {
+            nodes[r.node].first = r.beg;
+            nodes[r.node].count = r.end-r.beg;
+            continue;
+        }
+
+        vec3d c_min = items[r.beg].first;
+        vec3d c_max = items[r.beg].first;
+        for(uint i=r.beg+1; i<r.end; ++i)
+        {
+            c_min = c_min.min(items[i].first);
+            c_max = c_max.max(items[i].first);
+        }
+        vec3d delta = c_max - c_min;
+        uint  axis  = (delta[0]>=delta[1] && delta[0]>=delta[2]) ? 0 : ((delta[1]>=delta[2]) ? 1 : 2);
+        uint  mid   = (r.beg + r.end)/2;
+        std::nth_element(items.begin()+r.beg, items.begin()+mid, items.begin()+r.end,
+                         [axis](const std::pair<vec3d,uint> & a, const std::pair<vec3d,uint> & b)
+        {
+            return a.first[axis] < b.first[axis];
+        });
+
+        uint child = uint(nodes.size());
+        nodes[r.node].first = child;
+        nodes[r.node].count = 0;
+        nodes.push_back(Node());
+        nodes.push_back(Node());
+        stack.push_back({child,   r.beg, mid  });
+        stack.push_back({child+1, mid,   r.end});
+    }
+
+    ids.resize(n);
+    for(uint i=0; i<n; ++i) ids[i] = items[i].second;
+
+    // fit the boxes bottom up (children come after their parent)
+    for(uint i=uint(nodes.size()); i-->0;)
+    {
+        Node & node = nodes[i];
+        node.bbox.reset();
+        if(node.count>0)
+        {
+            for(uint j=node.first; j<node.first+node.count; ++j) node.bbox.push(boxes[ids[j]]);
+        }
+        else
+        {
+            node.bbox.push(nodes[node.first  ].bbox);
+            node.bbox.push(nodes[node.first+1].bbox);
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool BVH::ray_hits_box(const AABB   & box,
+                       const vec3d  & orig,
+                       const vec3d  & inv_dir,
+                       const double   t_max,
+                             double & t_near)
+{
+    double t0 = 0.0;
+    double t1 = t_max;
+    for(int i=0; i<3; ++i)
+    {
+        if(inv_dir[i]==inf_double)
+        {
+            // ray is parallel to current axis. No hit if origin not within slab
+            if(orig[i]<box.min[i] || orig[i]>box.max[i]) return false;
+            continue;
+        }
+        double t_in  = (box.min[i] - orig[i]) * inv_dir[i];
+        double t_out = (box.max[i] - orig[i]) * inv_dir[i];
+        if(t_in>t_out) std::swap(t_in,t_out);
+        t0 = std::max(t0, t_in);
+        t1 = std::min(t1, t_out);
+        if(t0>t1) return false;
+    }
+    t_near = t0;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Dist>
+CINO_INLINE
+bool BVH::closest(const vec3d & p, const Dist & dist, uint & id, double & d) const
+{
+    d = inf_double;
+    if(nodes.empty()) return false;
+
+    bool found = false;
+    std::vector<uint> stack(1,0);
+    while(!stack.empty())
+    {
+        const Node & node = nodes[stack.back()];
+        stack.pop_back();
+        if(node.bbox.dist(p) > d) continue;
+
+        if(node.count>0)
+        {
+            for(uint i=node.first; i<node.first+node.count; ++i)
+            {
+                double tmp = dist(ids[i]);
+                if(tmp==inf_double) continue;
+                if(tmp<d || (tmp==d && ids[i]<id))
+                {
+                    d     = tmp;
+                    id    = ids[i];
+                    found = true;
+                }
+            }
+        }
+        else // visit the closest child first
+        {
+            double d0 = nodes[node.first  ].bbox.dist(p);
+            double d1 = nodes[node.first+1].bbox.dist(p);
+            if(d0<=d1)
+            {
+                stack.push_back(node.first+1);
+                stack.push_back(node.first);
+            }
+            else
+            {
+                stack.push_back(node.first);
+                stack.push_back(node.first+1);
+            }
+        }
+    }
+    return found;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Hit>
+CINO_INLINE
+bool BVH::first_hit(const vec3d  & orig,
+                    const vec3d  & dir,
+                    const Hit    & hit,
+                          uint   & id,
+                          double & t,
+                    const double   t_max) const
+{
+    t = t_max;
+    if(nodes.empty()) return false;
+
+    vec3d inv_dir;
+    for(int i=0; i<3; ++i) inv_dir[i] = (std::fabs(dir[i])<1e-15) ? inf_double : 1.0/dir[i];
+
+    bool found = false;
+    double t_near;
+    std::vector<std::pair<double,uint>> stack;
+    if(ray_hits_box(nodes.front().bbox, orig, inv_dir, t, t_near)) stack.push_back(std::make_pair(t_near,0u));
+    while(!stack.empty())
+    {
+        std::pair<double,uint> top = stack.back();
+        stack.pop_back();
+        if(top.first>t) continue; // a closer hit was found in the meantime
+
+        const Node & node = nodes[top.second];
+        if(node.count>0)
+        {
+            for(uint i=node.first; i<node.first+node.count; ++i)
+            {
+                double tmp;
+                if(hit(ids[i], t, tmp) && tmp<t)
+                {
+                    t     = tmp;
+                    id    = ids[i];
+                    found = true;
+                }
+            }
+        }
+        else // visit the closest child first
+        {
+            double t0, t1;
+            bool   h0 = ray_hits_box(nodes[node.first  ].bbox, orig, inv_dir, t, t0);
+            bool   h1 = ray_hits_box(nodes[node.first+1].bbox, orig, inv_dir, t, t1);
+            if(h0 && h1)
+            {
+                if(t0<=t1)
+                {
+                    stack.push_back(std::make_pair(t1,node.first+1));
+                    stack.push_back(std::make_pair(t0,node.first));
+                }
+                else
+                {
+                    stack.push_back(std::make_pair(t0,node.first));
+                    stack.push_back(std::make_pair(t1,node.first+1));
+                }
+            }
+            else if(h0) stack.push_back(std::make_pair(t0,node.first));
+            else if(h1) stack.push_back(std::make_pair(t1,node.first+1));
+        }
+    }
+    return found;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Hit>
+CINO_INLINE
+bool BVH::any_hit(const vec3d  & orig,
+                  const vec3d  & dir,
+                  const Hit    & hit,
+                  const double   t_max) const
+{
+    if(nodes.empty()) return false;
+
+    vec3d inv_dir;
+    for(int i=0; i<3; ++i) inv_dir[i] = (std::fabs(dir[i])<1e-15) ? inf_double : 1.0/dir[i];
+
+    double t_near;
+    std::vector<uint> stack(1,0);
+    while(!stack.empty())
+    {
+        const Node & node = nodes[stack.back()];
+        stack.pop_back();
+        if(!ray_hits_box(node.bbox, orig, inv_dir, t_max, t_near)) continue;
+
+        if(node.count>0)
+        {
+            for(uint i=node.first; i<node.first+node.count; ++i)
+            {
+                double t;
+                if(hit(ids[i], t_max, t) && t<t_max) return true;
+            }
+        }
+        else
+        {
+            stack.push_back(node.first+1);
+            stack.push_back(node.first);
+        }
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Hit>
+CINO_INLINE
+void BVH::any_hit(const vec3d              & orig,
+                  const std::vector<vec3d> & dirs,
+                  const Hit                & hit,
+                        std::vector<bool>  & occluded,
+                  const double               t_max) const
+{
+    uint n = uint(dirs.size());
+    occluded.assign(n,false);
+    if(nodes.empty() || n==0) return;
+
+    std::vector<vec3d> inv_dirs(n);
+    for(uint i=0; i<n; ++i)
+    for(int  j=0; j<3; ++j) inv_dirs[i][j] = (std::fabs(dirs[i][j])<1e-15) ? inf_double : 1.0/dirs[i][j];
+
+    // active rays of each pending node are stored as ranges of a shared buffer.
+    // Traversal is depth first, so the range of the node on top of the stack is
+    // always at the tail of the buffer, and whatever lies beyond can be dropped
+    struct Task { uint node, beg, end; };
+    std::vector<uint> active(n);
+    for(uint i=0; i<n; ++i) active[i] = i;
+    std::vector<Task> stack(1, {0, 0, n});
+    while(!stack.empty())
+    {
+        Task task = stack.back();
+        stack.pop_back();
+        active.resize(task.end);
+
+        const Node & node = nodes[task.node];
+        uint beg = uint(active.size());
+        for(uint k=task.beg; k<task.end; ++k)
+        {
+            uint   i = active[k];
+            double t_near;
+            if(!occluded[i] && ray_hits_box(node.bbox, orig, inv_dirs[i], t_max, t_near)) active.push_back(i);
+        }
+        uint end = uint(active.size());
+        if(beg==end) continue;
+
+        if(node.count>0)
+        {
+            for(uint j=node.first; j<node.first+node.count; ++j)
+            for(uint k=beg; k<end; ++k)
+            {
+                uint i = active[k];
+                double t;
+                if(!occluded[i] && hit(ids[j], i, t_max, t) && t<t_max) occluded[i] = true;
+            }
+        }
+        else
+        {
+            stack.push_back({node.first+1, beg, end});
+            stack.push_back({node.first,   beg, end});
+        }
+    }
+}
+
+}
@@ -0,0 +1,146 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_BVH_H
+#define CINO_BVH_H
+
+#include <cinolib/geometry/aabb.h>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Bounding Volume Hierarchy built on top of a list of axis aligned
+ * boxes, one per item. The tree is stored in a flat array and knows
+ * nothing about the geometry of the items, which is accessed through
+ * the callbacks passed to the queries. Typical usage:
+ *
+ *  i)   build the tree from the AABBs of the items (e.g. mesh elements)
+ *  ii)  query it, providing a function that computes the exact distance
+ *       (or ray intersection) between the query and a given item
+ *
+ * Items are identified by their position in the list used for building.
+*/
+
+class BVH
+{
+    public:
+
+        explicit BVH(const uint items_per_leaf = 4);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void build(const std::vector<AABB> & boxes);
+        void clear();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool empty()     const { return nodes.empty(); }
+        uint num_items() const { return uint(ids.size()); }
+        uint num_nodes() const { return uint(nodes.size()); }
+        AABB bbox()      const { return nodes.empty() ? AABB() : nodes.front().bbox; }
+
+        // QUERIES :::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // returns the item that minimizes dist(id), breaking ties in favour of the
+        // smallest id. For the pruning to be correct the distance of an item from p
+        // must be no smaller than the distance between p and the box of the item.
+        // Items for which dist returns inf_double are skipped
+        //
+        template<class Dist>
+        bool closest(const vec3d & p, const Dist & dist, uint & id, double & d) const;
+
+        // returns the first item hit by the ray R(t) := orig + t * dir, with t in [0,t_max).
+        // hit(id,t_max,t) must return true if item id is hit at some t < t_max, storing the
+        // hit parameter in t. Items that should not be hit (e.g. hidden elements) are simply
+        // reported as not intersecting by the callback
+        //
+        template<class Hit>
+        bool first_hit(const vec3d  & orig,
+                       const vec3d  & dir,
+                       const Hit    & hit,
+                             uint   & id,
+                             double & t,
+                       const double   t_max = inf_double) const;
+
+        // returns true as soon as an item hit by R(t) := orig + t * dir for some t in [0,t_max)
+        // is found. Cheaper than first_hit, as the traversal stops at the first hit (occlusion queries)
+        //
+        template<class Hit>
+        bool any_hit(const vec3d  & orig,
+                     const vec3d  & dir,
+                     const Hit    & hit,
+                     const double   t_max = inf_double) const;
+
+        // packet version of any_hit, for bundles of rays sharing the same origin (e.g.
+        // hemisphere sampling). The tree is traversed once, visiting each node with the
+        // subset of rays that hit its box and are not occluded yet. hit(id,i,t_max,t)
+        // tests item id against the i-th ray. On return occluded[i] is true if the i-th
+        // ray hits some item for t in [0,t_max)
+        //
+        template<class Hit>
+        void any_hit(const vec3d              & orig,
+                     const std::vector<vec3d> & dirs,
+                     const Hit                & hit,
+                           std::vector<bool>  & occluded,
+                     const double               t_max = inf_double) const;
+
+    protected:
+
+        struct Node
+        {
+            AABB bbox;
+            uint first; // inner nodes: index of the first child (the second is first+1). Leaves: offset in ids
+            uint count; // number of items in the leaf (zero for inner nodes)
+        };
+
+        static bool ray_hits_box(const AABB   & box,
+                                 const vec3d  & orig,
+                                 const vec3d  & inv_dir,
+                                 const double   t_max,
+                                       double & t_near);
+
+        uint              items_per_leaf;
+        std::vector<Node> nodes;
+        std::vector<uint> ids;   // item ids, sorted so that each leaf references a contiguous range
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "bvh.cpp"
+#endif
+
+#endif // CINO_BVH_H
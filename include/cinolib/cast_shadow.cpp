@@ -34,11 +34,62 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/cast_shadow.h>
+#include <cinolib/rasterizer.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/meshes/mesh_attributes.h>
+#include <cstring>
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
 #include <cinolib/gl/offline_gl_context.h>
+#endif
 
 namespace cinolib
 {
 
+template<class Mesh>
+CINO_INLINE
+void cast_shadow_CPU(const Mesh    & m,        // mesh to be rendered
+                     const vec3d   & dir,      // light direction
+                     const uint      w,        // width
+                     const uint      h,        // height
+                           uint8_t * data,     // w x h buffer, 8 bits per pixel
+                     const bool      parallel) // rasterize on multiple threads
+{
+    // same model-view-projection-viewport used by the GL version: center the mesh
+    // at the origin, scale it by 2/diag, rotate dir onto the Z axis and project
+    // orthogonally onto the XY plane
+    vec3d  Z(0,0,1);
+    vec3d  a = dir.cross(Z);
+    mat3d  R = (a.norm()>0) ? mat3d::ROT_3D(a/a.norm(), Z.angle_rad(dir))
+                            : mat3d::DIAG(vec3d(1, dir.z()<0 ? -1 : 1, dir.z()<0 ? -1 : 1));
+    vec3d  c = m.centroid();
+    double s = 2.0/m.bbox().diag();
+
+    std::vector<vec3d> verts(m.num_verts());
+    auto to_window = [&](const uint vid)
+    {
+        vec3d p = R*((m.vert(vid)-c)*s);
+        verts[vid] = vec3d((p.x()+1.0)*0.5*w, (p.y()+1.0)*0.5*h, (p.z()+1.0)*0.5);
+    };
+    if(parallel) PARALLEL_FOR(0, m.num_verts(), 1000, to_window);
+    else for(uint vid=0; vid<m.num_verts(); ++vid) to_window(vid);
+
+    std::vector<uint> tris;
+    tris.reserve(3*m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(m.poly_data(pid).flags[HIDDEN]) continue;
+        const std::vector<uint> & tess = m.poly_tessellation(pid);
+        tris.insert(tris.end(), tess.begin(), tess.end());
+    }
+
+    std::memset(data, 0x00, w*h);
+    rasterize_triangles(verts, tris, w, h, data, nullptr, parallel);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
 template<class Mesh>
 CINO_INLINE
 void cast_shadow(const Mesh    & m,    // mesh to be rendered
@@ -99,5 +150,7 @@ void cast_shadow(const Mesh       & m,           // mesh to be rendered
     glReadPixels(0, 0, w, h, GL_STENCIL_INDEX, GL_UNSIGNED_BYTE, data);
 }
 
+#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
+
 }
 
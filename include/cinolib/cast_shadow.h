@@ -37,11 +37,31 @@
 #define CINO_CAST_SHADOW_H
 
 #include <cinolib/geometry/vec_mat.h>
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
 #include <cinolib/gl/gl_glfw.h>
+#endif
 
 namespace cinolib
 {
 
+// CPU version of cast_shadow (see cinolib/rasterizer.h). It does not need an OpenGL
+// context, and produces the same image of its GL counterpart up to the pixels touched
+// by silhouette edges. Supports surface meshes. Hidden polygons cast no shadow.
+// Set parallel to false when calling it from multiple threads
+//
+template<class Mesh>
+CINO_INLINE
+void cast_shadow_CPU(const Mesh    & m,                // mesh to be rendered
+                     const vec3d   & dir,              // light direction
+                     const uint      w,                // width
+                     const uint      h,                // height
+                           uint8_t * data,             // w x h buffer, 8 bits per pixel
+                     const bool      parallel = true); // rasterize on multiple threads
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class Mesh>
 CINO_INLINE
 void cast_shadow(const Mesh    & m,     // mesh to be rendered
@@ -60,6 +80,8 @@ void cast_shadow(const Mesh       & m,           // mesh to be rendered
                  const uint         h,           // height (must be an EVEN number)
                        uint8_t    * data,        // w x h buffer, 8 bits per pixel
                        GLFWwindow * GL_context); // cached GL context (for amortized calls)
+
+#endif // CINOLIB_USES_OPENGL_GLFW_IMGUI
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -34,25 +34,137 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/gl/draw_lines_tris.h>
+#include <algorithm>
 
 namespace cinolib
 {
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// makes sure the GPU buffers mirror the content of data. Returns false if
+// data should be rendered from client side arrays (VBOs off or unsupported)
 CINO_INLINE
-void render_tris(const RenderData & data)
+bool vbo_sync(const RenderData & data)
 {
+    if(!data.use_vbo || !vbo_api().supported)
+    {
+        // nothing to track: GPU buffers (if any) will be refreshed from scratch
+        data.vbo.full_upload = true;
+        data.vbo.dirty_tris.clear();
+        data.vbo.dirty_segs.clear();
+        return false;
+    }
+
+    VBOApi & gl  = vbo_api();
+    VBO    & vbo = data.vbo;
+
+    if(vbo.tris==0)
+    {
+        GLuint ids[8];
+        gl.gen_buffers(8, ids);
+        vbo.tris         = ids[0];
+        vbo.tri_coords   = ids[1];
+        vbo.tri_v_norms  = ids[2];
+        vbo.tri_v_colors = ids[3];
+        vbo.tri_text     = ids[4];
+        vbo.segs         = ids[5];
+        vbo.seg_coords   = ids[6];
+        vbo.seg_colors   = ids[7];
+        vbo.full_upload  = true;
+    }
+
+    struct Buffer
+    {
+        GLenum       target;
+        GLuint       id;
+        const void * ptr;
+        size_t       size;     // bytes
+        size_t       stride;   // bytes per triangle/segment (zero for index buffers, which never change in place)
+        bool         per_tri;
+    };
+    const Buffer buffers[] =
+    {
+        { GL_ELEMENT_ARRAY_BUFFER, vbo.tris,         data.tris.data(),         data.tris.size()        *sizeof(uint),  0,                                   true  },
+        { GL_ARRAY_BUFFER,         vbo.tri_coords,   data.tri_coords.data(),   data.tri_coords.size()  *sizeof(float), 9                    *sizeof(float), true  },
+        { GL_ARRAY_BUFFER,         vbo.tri_v_norms,  data.tri_v_norms.data(),  data.tri_v_norms.size() *sizeof(float), data.norms_per_tri() *sizeof(float), true  },
+        { GL_ARRAY_BUFFER,         vbo.tri_v_colors, data.tri_v_colors.data(), data.tri_v_colors.size()*sizeof(float), data.colors_per_tri()*sizeof(float), true  },
+        { GL_ARRAY_BUFFER,         vbo.tri_text,     data.tri_text.data(),     data.tri_text.size()    *sizeof(float), data.text_per_tri()  *sizeof(float), true  },
+        { GL_ELEMENT_ARRAY_BUFFER, vbo.segs,         data.segs.data(),         data.segs.size()        *sizeof(uint),  0,                                   false },
+        { GL_ARRAY_BUFFER,         vbo.seg_coords,   data.seg_coords.data(),   data.seg_coords.size()  *sizeof(float), 6                    *sizeof(float), false },
+        { GL_ARRAY_BUFFER,         vbo.seg_colors,   data.seg_colors.data(),   data.seg_colors.size()  *sizeof(float), 8                    *sizeof(float), false },
+    };
+
+    if(vbo.uploaded_size.size()!=8) vbo.uploaded_size.assign(8, 0);
+    vbo_merge_ranges(vbo.dirty_tris);
+    vbo_merge_ranges(vbo.dirty_segs);
+
+    for(uint i=0; i<8; ++i)
+    {
+        const Buffer & b = buffers[i];
+        gl.bind_buffer(b.target, b.id);
+        if(vbo.full_upload || vbo.uploaded_size.at(i)!=b.size)
+        {
+            gl.buffer_data(b.target, (std::ptrdiff_t)b.size, b.ptr, GL_STATIC_DRAW);
+            vbo.uploaded_size.at(i) = b.size;
+        }
+        else if(b.stride>0)
+        {
+            for(const auto & r : (b.per_tri ? vbo.dirty_tris : vbo.dirty_segs))
+            {
+                size_t beg = std::min(b.size, r.first *b.stride);
+                size_t end = std::min(b.size, r.second*b.stride);
+                if(end>beg) gl.buffer_sub_data(b.target, (std::ptrdiff_t)beg, (std::ptrdiff_t)(end-beg), (const char*)b.ptr + beg);
+            }
+        }
+        gl.bind_buffer(b.target, 0);
+    }
+
+    vbo.full_upload = false;
+    vbo.dirty_tris.clear();
+    vbo.dirty_segs.clear();
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// returns the pointer to be passed to gl*Pointer: an offset within the
+// given buffer object if VBOs are in use, the client side array otherwise
+CINO_INLINE
+const GLvoid * array_ptr(const bool use_vbo, const GLenum target, const GLuint buffer, const void * client_data)
+{
+    if(!use_vbo) return client_data;
+    vbo_api().bind_buffer(target, buffer);
+    return nullptr;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void unbind_buffers(const bool use_vbo)
+{
+    if(!use_vbo) return;
+    vbo_api().bind_buffer(GL_ARRAY_BUFFER, 0);
+    vbo_api().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void render_tris(const RenderData & data, const bool use_vbo)
+{
+    const VBO & vbo = data.vbo;
+
     if(data.draw_mode & DRAW_TRI_POINTS)
     {
         glEnableClientState(GL_COLOR_ARRAY);
-        glColorPointer(4, GL_FLOAT, 0, data.tri_v_colors.data());
+        glColorPointer(4, GL_FLOAT, 0, array_ptr(use_vbo, GL_ARRAY_BUFFER, vbo.tri_v_colors, data.tri_v_colors.data()));
         glEnableClientState(GL_VERTEX_ARRAY);
-        glVertexPointer(3, GL_FLOAT, 0, data.tri_coords.data());
+        glVertexPointer(3, GL_FLOAT, 0, array_ptr(use_vbo, GL_ARRAY_BUFFER, vbo.tri_coords, data.tri_coords.data()));
         glPointSize(data.seg_width);
         glDrawArrays(GL_POINTS, 0, (GLsizei)(data.tri_coords.size()/3));
         glDisableClientState(GL_VERTEX_ARRAY);
         glDisableClientState(GL_COLOR_ARRAY);
+        unbind_buffers(use_vbo);
     }
     else
     {
@@ -60,7 +172,7 @@ void render_tris(const RenderData & data)
         {
             glBindTexture(GL_TEXTURE_1D, data.texture.id);
             glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-            glTexCoordPointer(1, GL_FLOAT, 0, data.tri_text.data());
+            glTexCoordPointer(1, GL_FLOAT, 0, array_ptr(use_vbo, GL_ARRAY_BUFFER, vbo.tri_text, data.tri_text.data()));
             glColor3f(1,1,1);
             glEnable(GL_COLOR_MATERIAL);
             glEnable(GL_TEXTURE_1D);
@@ -69,7 +181,7 @@ void render_tris(const RenderData & data)
         {
             glBindTexture(GL_TEXTURE_2D, data.texture.id);
             glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-            glTexCoordPointer(2, GL_FLOAT, 0, data.tri_text.data());
+            glTexCoordPointer(2, GL_FLOAT, 0, array_ptr(use_vbo, GL_ARRAY_BUFFER, vbo.tri_text, data.tri_text.data()));
             glColor3f(1,1,1);
             glEnable(GL_COLOR_MATERIAL);
             glEnable(GL_TEXTURE_2D);
@@ -78,15 +190,16 @@ void render_tris(const RenderData & data)
         {
             glEnable(GL_COLOR_MATERIAL);
             glEnableClientState(GL_COLOR_ARRAY);
-            glColorPointer(4, GL_FLOAT, 0, data.tri_v_colors.data());
+            glColorPointer(4, GL_FLOAT, 0, array_ptr(use_vbo, GL_ARRAY_BUFFER, vbo.tri_v_colors, data.tri_v_colors.data()));
         }
         glEnableClientState(GL_VERTEX_ARRAY);
-        glVertexPointer(3, GL_FLOAT, 0, data.tri_coords.data());
+        glVertexPointer(3, GL_FLOAT, 0, array_ptr(use_vbo, GL_ARRAY_BUFFER, vbo.tri_coords, data.tri_coords.data()));
         glEnableClientState(GL_NORMAL_ARRAY);
-        glNormalPointer(GL_FLOAT, 0, data.tri_v_norms.data());
-        glDrawElements(GL_TRIANGLES, (GLsizei)data.tris.size(), GL_UNSIGNED_INT, data.tris.data());
+        glNormalPointer(GL_FLOAT, 0, array_ptr(use_vbo, GL_ARRAY_BUFFER, vbo.tri_v_norms, data.tri_v_norms.data()));
+        glDrawElements(GL_TRIANGLES, (GLsizei)data.tris.size(), GL_UNSIGNED_INT, array_ptr(use_vbo, GL_ELEMENT_ARRAY_BUFFER, vbo.tris, data.tris.data()));
         glDisableClientState(GL_VERTEX_ARRAY);
         glDisableClientState(GL_NORMAL_ARRAY);
+        unbind_buffers(use_vbo);
         if(data.draw_mode & DRAW_TRI_TEXTURE1D)
         {
             glDisableClientState(GL_TEXTURE_COORD_ARRAY);
@@ -110,21 +223,24 @@ void render_tris(const RenderData & data)
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void render_segs(const RenderData & data)
+void render_segs(const RenderData & data, const bool use_vbo)
 {
+    const VBO & vbo = data.vbo;
+
     if(data.draw_mode & DRAW_SEGS)
     {
         glEnable(GL_LINE_SMOOTH);
         glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);        
         glDisable(GL_LIGHTING);
         glEnableClientState(GL_VERTEX_ARRAY);
-        glVertexPointer(3, GL_FLOAT, 0, data.seg_coords.data());
+        glVertexPointer(3, GL_FLOAT, 0, array_ptr(use_vbo, GL_ARRAY_BUFFER, vbo.seg_coords, data.seg_coords.data()));
         glLineWidth(data.seg_width);
         glEnableClientState(GL_COLOR_ARRAY);
-        glColorPointer(4, GL_FLOAT, 0, data.seg_colors.data());
-        glDrawElements(GL_LINES, (GLsizei)data.segs.size(), GL_UNSIGNED_INT, data.segs.data());
+        glColorPointer(4, GL_FLOAT, 0, array_ptr(use_vbo, GL_ARRAY_BUFFER, vbo.seg_colors, data.seg_colors.data()));
+        glDrawElements(GL_LINES, (GLsizei)data.segs.size(), GL_UNSIGNED_INT, array_ptr(use_vbo, GL_ELEMENT_ARRAY_BUFFER, vbo.segs, data.segs.data()));
         glDisableClientState(GL_COLOR_ARRAY);
         glDisableClientState(GL_VERTEX_ARRAY);
+        unbind_buffers(use_vbo);
         glEnable(GL_LIGHTING);
         glDisable(GL_LINE_SMOOTH);
     }
@@ -137,6 +253,8 @@ void render(const RenderData & data)
 {
     data.material.apply();
 
+    bool use_vbo = vbo_sync(data);
+
     glLightModeli(GL_LIGHT_MODEL_TWO_SIDE, GL_TRUE);
     glEnable(GL_DEPTH_TEST);
     glDisable(GL_CULL_FACE);
@@ -149,19 +267,19 @@ void render(const RenderData & data)
         if(data.draw_mode & DRAW_TRI_POINTS)
         {
             glDisable(GL_LIGHTING);
-            render_tris(data);
+            render_tris(data, use_vbo);
         }
         else if(data.draw_mode & DRAW_TRI_SMOOTH)
         {
             glEnable(GL_LIGHTING);
             glShadeModel(GL_SMOOTH);
-            render_tris(data);
+            render_tris(data, use_vbo);
         }
         else // default: FLAT shading
         {
             glEnable(GL_LIGHTING);
             glShadeModel(GL_SMOOTH); // flatness is given by input normals
-            render_tris(data);
+            render_tris(data, use_vbo);
         }
 
         if(data.draw_mode & DRAW_SEGS)
@@ -169,7 +287,7 @@ void render(const RenderData & data)
             glDisable(GL_POLYGON_OFFSET_FILL);
             glPushAttrib(GL_POLYGON_BIT);
             glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-            render_segs(data);
+            render_segs(data, use_vbo);
             glPopAttrib();
             glEnable(GL_POLYGON_OFFSET_FILL);
         }
@@ -46,6 +46,7 @@
 #include <cinolib/color.h>
 #include <cinolib/gl/gl_glfw.h>
 #include <cinolib/gl/load_texture.h>
+#include <cinolib/gl/vbo.h>
 
 namespace cinolib
 {
@@ -106,6 +107,36 @@ struct RenderData
     std::vector<float> seg_colors; // rgba
     GLfloat            seg_width = 1;
     //
+    bool               use_vbo = false; // render from GPU buffers (if supported) rather than client side arrays
+    mutable VBO        vbo;
+    //
+
+    // amount of floats per triangle in tri_v_norms, tri_text and tri_v_colors for the current draw mode
+    uint norms_per_tri()  const { return (draw_mode & (DRAW_TRI_SMOOTH | DRAW_TRI_FLAT)) ? 9 : 0; }
+    uint text_per_tri()   const { return (draw_mode & DRAW_TRI_TEXTURE1D) ? 3 : ((draw_mode & DRAW_TRI_TEXTURE2D) ? 6 : 0); }
+    uint colors_per_tri() const { return (draw_mode & (DRAW_TRI_FACECOLOR | DRAW_TRI_VERTCOLOR | DRAW_TRI_QUALITY)) ? 12 : 0; }
+
+    // size all buffers to host n_tris triangles and n_segs segments (to be filled in parallel)
+    void resize(const uint n_tris, const uint n_segs)
+    {
+        tris.resize(3*n_tris);
+        tri_coords.resize(9*n_tris);
+        tri_v_norms.resize(norms_per_tri()*n_tris);
+        tri_text.resize(text_per_tri()*n_tris);
+        tri_v_colors.resize(colors_per_tri()*n_tris);
+        segs.resize(2*n_segs);
+        seg_coords.resize(6*n_segs);
+        seg_colors.resize(8*n_segs);
+        tag_all_dirty();
+        for(uint i=0; i<tris.size(); ++i) tris[i] = i;
+        for(uint i=0; i<segs.size(); ++i) segs[i] = i;
+    }
+
+    // tell the renderer which parts of the buffers changed since the last
+    // frame, so that only those will be sent to the GPU (if use_vbo is on)
+    void tag_all_dirty()                               { vbo.full_upload = true; }
+    void tag_tris_dirty(const uint beg, const uint end) { vbo.dirty_tris.push_back(std::make_pair(beg,end)); }
+    void tag_segs_dirty(const uint beg, const uint end) { vbo.dirty_segs.push_back(std::make_pair(beg,end)); }
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -536,6 +536,20 @@ bool GLcanvas::unproject(const vec2d & p2d, const GLdouble & depth, vec3d & p3d)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+Ray GLcanvas::eye_ray(const vec2d & p2d) const
+{
+    // unproject two points along the line of sight: one (almost) on the near plane
+    // and one halfway through the frustum. Works for both perspective and orthographic
+    // cameras (gl_unproject rejects depths that are exactly 0 or 1)
+    vec3d p_near, p_mid;
+    unproject(p2d, 1e-7, p_near);
+    unproject(p2d, 0.5,  p_mid);
+    return Ray(p_near, p_mid - p_near);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void GLcanvas::project(const vec3d & p3d, vec2d & p2d, GLdouble & depth) const
 {
@@ -40,6 +40,7 @@
 #include <cinolib/drawable_object.h>
 #include <cinolib/gl/side_bar_item.h>
 #include <cinolib/gl/camera.h>
+#include <cinolib/geometry/ray.h>
 #include <cinolib/min_max_inf.h>
 #include <cinolib/color.h>
 
@@ -184,6 +185,10 @@ class GLcanvas
         bool unproject(const vec2d & p2d, vec3d & p3d)                        const;
         bool unproject(const vec2d & p2d, const GLdouble & depth, vec3d & p3d) const;
 
+        // ray from the camera through pixel p2d. Unlike unproject, it does not
+        // read the Z buffer (see AbstractMesh::pick_vert/edge/poly for ray picking)
+        Ray eye_ray(const vec2d & p2d) const;
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         // internal event handlers
@@ -0,0 +1,124 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/gl/vbo.h>
+#include <algorithm>
+
+namespace cinolib
+{
+
+CINO_INLINE
+VBOApi & vbo_api()
+{
+    static VBOApi api;
+    if(!api.loaded)
+    {
+        // fetch core entry points first, and resort to the ARB extension if missing
+        auto load = [](const char *core, const char *arb) -> GLFWglproc
+        {
+            GLFWglproc f = glfwGetProcAddress(core);
+            return (f!=nullptr) ? f : glfwGetProcAddress(arb);
+        };
+        api.gen_buffers     = (VBOApi::GenBuffers)    load("glGenBuffers",    "glGenBuffersARB");
+        api.delete_buffers  = (VBOApi::DeleteBuffers) load("glDeleteBuffers", "glDeleteBuffersARB");
+        api.bind_buffer     = (VBOApi::BindBuffer)    load("glBindBuffer",    "glBindBufferARB");
+        api.buffer_data     = (VBOApi::BufferData)    load("glBufferData",    "glBufferDataARB");
+        api.buffer_sub_data = (VBOApi::BufferSubData) load("glBufferSubData", "glBufferSubDataARB");
+        api.supported       = api.gen_buffers    != nullptr &&
+                              api.delete_buffers != nullptr &&
+                              api.bind_buffer    != nullptr &&
+                              api.buffer_data    != nullptr &&
+                              api.buffer_sub_data!= nullptr;
+        api.loaded = true;
+    }
+    return api;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void vbo_release(VBO & vbo)
+{
+    if(vbo.tris>0 && vbo_api().supported && glfwGetCurrentContext()!=nullptr)
+    {
+        GLuint ids[] =
+        {
+            vbo.tris, vbo.tri_coords, vbo.tri_v_norms, vbo.tri_v_colors, vbo.tri_text,
+            vbo.segs, vbo.seg_coords, vbo.seg_colors
+        };
+        vbo_api().delete_buffers(8, ids);
+    }
+    vbo.tris         = 0;
+    vbo.tri_coords   = 0;
+    vbo.tri_v_norms  = 0;
+    vbo.tri_v_colors = 0;
+    vbo.tri_text     = 0;
+    vbo.segs         = 0;
+    vbo.seg_coords   = 0;
+    vbo.seg_colors   = 0;
+    vbo.uploaded_size.clear();
+    vbo.full_upload = true;
+    vbo.dirty_tris.clear();
+    vbo.dirty_segs.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+VBO::~VBO()
+{
+    vbo_release(*this);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void vbo_merge_ranges(std::vector<std::pair<uint,uint>> & ranges)
+{
+    if(ranges.empty()) return;
+    std::sort(ranges.begin(), ranges.end());
+    uint last = 0;
+    for(uint i=1; i<ranges.size(); ++i)
+    {
+        if(ranges.at(i).first <= ranges.at(last).second)
+        {
+            ranges.at(last).second = std::max(ranges.at(last).second, ranges.at(i).second);
+        }
+        else ranges.at(++last) = ranges.at(i);
+    }
+    ranges.resize(last+1);
+}
+
+}
@@ -0,0 +1,151 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_VBO_H
+#define CINO_VBO_H
+
+#ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
+#include <vector>
+#include <cstddef>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/gl/gl_glfw.h>
+
+/* Minimal support for OpenGL Vertex Buffer Objects (core since OpenGL 1.5).
+ * Their entry points are not exported by all GL libraries (e.g. opengl32.dll
+ * only exposes OpenGL 1.1), hence they are fetched at runtime through GLFW the
+ * first time they are needed, with a GL context current. If they are missing,
+ * rendering falls back to client side vertex arrays (see draw_lines_tris.cpp)
+*/
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER         0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW          0x88E4
+#endif
+
+#ifdef _WIN32
+#define CINO_GL_APIENTRY __stdcall
+#else
+#define CINO_GL_APIENTRY
+#endif
+
+namespace cinolib
+{
+
+struct VBOApi
+{
+    typedef void (CINO_GL_APIENTRY *GenBuffers)   (GLsizei n, GLuint *buffers);
+    typedef void (CINO_GL_APIENTRY *DeleteBuffers)(GLsizei n, const GLuint *buffers);
+    typedef void (CINO_GL_APIENTRY *BindBuffer)   (GLenum target, GLuint buffer);
+    typedef void (CINO_GL_APIENTRY *BufferData)   (GLenum target, std::ptrdiff_t size, const void *data, GLenum usage);
+    typedef void (CINO_GL_APIENTRY *BufferSubData)(GLenum target, std::ptrdiff_t offset, std::ptrdiff_t size, const void *data);
+
+    GenBuffers    gen_buffers     = nullptr;
+    DeleteBuffers delete_buffers  = nullptr;
+    BindBuffer    bind_buffer     = nullptr;
+    BufferData    buffer_data     = nullptr;
+    BufferSubData buffer_sub_data = nullptr;
+    bool          loaded          = false;
+    bool          supported       = false;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// entry points of the buffer object API (loaded on first call)
+CINO_INLINE
+VBOApi & vbo_api();
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* GPU side copy of the buffers of a RenderData. Buffers are created and fully
+ * uploaded on first use (or whenever their size changes), and then refreshed
+ * only within the ranges of triangles/segments tagged as dirty.
+ *
+ * NOTE: buffer objects are released on destruction (see vbo_release), provided
+ * that a GL context is still current at that point. Copies of a VBO do not share
+ * GPU buffers, they allocate their own
+*/
+struct VBO
+{
+    GLuint tris         = 0;
+    GLuint tri_coords   = 0;
+    GLuint tri_v_norms  = 0;
+    GLuint tri_v_colors = 0;
+    GLuint tri_text     = 0;
+    GLuint segs         = 0;
+    GLuint seg_coords   = 0;
+    GLuint seg_colors   = 0;
+
+    // sizes (in bytes) of the data currently stored on the GPU
+    std::vector<size_t> uploaded_size;
+
+    // what needs to be uploaded at the next render
+    bool                              full_upload = true;
+    std::vector<std::pair<uint,uint>> dirty_tris;
+    std::vector<std::pair<uint,uint>> dirty_segs;
+
+    VBO() {}
+    VBO(const VBO &) {}
+    VBO & operator=(const VBO &) { full_upload = true; return *this; }
+   ~VBO();
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// deletes the GPU buffers and resets vbo, so that the next render will create
+// and fully upload them again. If no GL context is current the buffers cannot
+// be deleted (they die with their context), and vbo is just reset
+CINO_INLINE
+void vbo_release(VBO & vbo);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// sort and merge overlapping/adjacent ranges
+CINO_INLINE
+void vbo_merge_ranges(std::vector<std::pair<uint,uint>> & ranges);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "vbo.cpp"
+#endif
+
+#endif // #ifdef CINOLIB_USES_OPENGL_GLFW_IMGUI
+
+#endif // CINO_VBO_H
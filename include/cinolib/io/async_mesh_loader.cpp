@@ -0,0 +1,229 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/async_mesh_loader.h>
+#include <cinolib/string_utilities.h>
+#include <cinolib/meshes/abstract_mesh.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace cinolib
+{
+
+template<class Mesh>
+CINO_INLINE
+AsyncMeshLoader<Mesh>::AsyncMeshLoader(Mesh                   & m,
+                                       const char             * filename,
+                                       const ProgressCallback & callback,
+                                       const bool               pipelined,
+                                       const size_t             memory_budget)
+    : m(m)
+    , filename(filename)
+    , callback(callback)
+    , canceled(false)
+    , current_progress(0.f)
+{
+    std::string ext = get_file_extension(this->filename);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    bool is_surface = (m.mesh_type()==TRIMESH || m.mesh_type()==QUADMESH || m.mesh_type()==POLYGONMESH);
+    bool streamable = is_surface ? (ext=="obj" || ext=="off") : (ext=="mesh");
+
+    if(pipelined && streamable)
+    {
+        result = std::async(std::launch::async, [this,memory_budget]() { return load_pipelined(memory_budget); }).share();
+    }
+    else
+    {
+        result = std::async(std::launch::async, [this]() { return load_blocking(); }).share();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+AsyncMeshLoader<Mesh>::~AsyncMeshLoader()
+{
+    cancel();
+    result.wait();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AsyncMeshLoader<Mesh>::set_progress(const float p)
+{
+    current_progress = p;
+    if(callback) callback(p);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool AsyncMeshLoader<Mesh>::load_blocking()
+{
+    set_progress(0.f);
+    if(canceled) return false;
+    m.load(filename.c_str());
+    if(canceled || m.num_verts()==0)
+    {
+        m.clear();
+        return false;
+    }
+    set_progress(1.f);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool AsyncMeshLoader<Mesh>::load_pipelined(const size_t memory_budget)
+{
+    set_progress(0.f);
+    m.clear();
+
+    MeshStreamReader s(filename.c_str(), memory_budget);
+    if(!s.is_open()) return false;
+
+    // chunks are handed over from the reader to the builder through a short
+    // queue, so that at most a few chunks are in memory at any time
+    struct Chunk
+    {
+        std::vector<vec3d>             verts;
+        std::vector<std::vector<uint>> polys;
+        float                          progress = 0.f;
+    };
+    std::deque<Chunk>       queue;
+    std::mutex              mutex;
+    std::condition_variable cv;
+    bool                    eof       = false; // the reader is done
+    bool                    stop      = false; // the builder is done
+    const size_t            max_queue = 2;
+
+    std::thread reader([&]()
+    {
+        auto push = [&](Chunk & c)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&]() { return queue.size()<max_queue || stop; });
+            if(stop) return false;
+            queue.push_back(std::move(c));
+            cv.notify_all();
+            return true;
+        };
+
+        // vertices first (elements refer to them), then elements
+        Chunk c;
+        bool go_on = true;
+        while(go_on && s.next_verts(c.verts))
+        {
+            c.progress = 0.5f*float(s.verts_progress());
+            go_on = push(c);
+            c = Chunk();
+        }
+        while(go_on && s.next_polys(c.polys))
+        {
+            c.progress = 0.5f + 0.5f*float(s.polys_progress());
+            go_on = push(c);
+            c = Chunk();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        eof = true;
+        cv.notify_all();
+    });
+
+    // builder: connectivity is updated chunk by chunk, while the reader goes on
+    bool ok = true;
+    try
+    {
+        while(ok && !canceled)
+        {
+            Chunk c;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return !queue.empty() || eof; });
+                if(queue.empty()) break;
+                c = std::move(queue.front());
+                queue.pop_front();
+                cv.notify_all();
+            }
+
+            for(const vec3d & v : c.verts) m.vert_add(v);
+            for(const auto  & p : c.polys)
+            {
+                if(canceled) break;
+                for(uint vid : p) if(vid>=m.num_verts()) ok = false;
+                if(!ok) break;
+                m.poly_add(p);
+            }
+            set_progress(std::min(c.progress, 0.99f));
+        }
+    }
+    catch(...) // e.g. elements not supported by the mesh type
+    {
+        ok = false;
+    }
+
+    // wake up the reader, in case it is waiting for room in the queue
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        cv.notify_all();
+    }
+    reader.join();
+
+    if(!ok || canceled || m.num_verts()==0)
+    {
+        if(!ok) std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_pipelined() : invalid elements in " << filename << std::endl;
+        m.clear();
+        return false;
+    }
+
+    m.mesh_data().filename = filename;
+    m.finalize_init();
+    set_progress(1.f);
+    return true;
+}
+
+}
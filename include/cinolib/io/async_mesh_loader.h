@@ -0,0 +1,122 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_ASYNC_MESH_LOADER_H
+#define CINO_ASYNC_MESH_LOADER_H
+
+#include <sys/types.h>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <string>
+#include <cinolib/cino_inline.h>
+#include <cinolib/io/mesh_stream_reader.h>
+
+namespace cinolib
+{
+
+/* Loads a mesh in background, without blocking the calling thread (e.g.
+ * the GUI), or to prefetch the next mesh of a batch job while the current
+ * one is processed. For OBJ and OFF surface meshes and MESH volume meshes
+ * parsing and mesh construction are pipelined: a reader thread parses the
+ * file in chunks (see MeshStreamReader), while a builder thread adds the
+ * vertices and elements of each chunk to the mesh, hence the deduplication
+ * of edges (and faces) starts as soon as the first chunk is available. The
+ * pipelined path loads positions and connectivity only (textures, normals,
+ * colors and labels are ignored). With pipelined=false, or for any other
+ * format, the builder thread just calls Mesh::load.
+ *
+ * Progress (in [0,1]) is reported through the optional callback, which is
+ * invoked from the builder thread, and can be polled with progress(). If
+ * loading is canceled, or fails, the mesh is left empty. The mesh must not be
+ * accessed until is_ready() returns true. Drawable meshes should call
+ * updateGL() from the rendering thread once the mesh is ready. Usage:
+ *
+ *     DrawableTrimesh<> m;
+ *     AsyncMeshLoader<DrawableTrimesh<>> loader(m, filename);
+ *     ...
+ *     if(loader.is_ready() && loader.wait()) m.updateGL();
+*/
+
+template<class Mesh>
+class AsyncMeshLoader
+{
+    public:
+
+        typedef std::function<void(const float)> ProgressCallback;
+
+        explicit AsyncMeshLoader(Mesh                   & m,
+                                 const char             * filename,
+                                 const ProgressCallback & callback      = nullptr,
+                                 const bool               pipelined     = true,
+                                 const size_t             memory_budget = CINO_STREAM_DEFAULT_BUDGET);
+
+        ~AsyncMeshLoader(); // cancels loading and waits for the worker threads
+
+        AsyncMeshLoader(const AsyncMeshLoader &) = delete;
+        AsyncMeshLoader & operator=(const AsyncMeshLoader &) = delete;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void  cancel()            { canceled = true; }
+        bool  is_canceled() const { return canceled; }
+        bool  is_ready()    const { return result.wait_for(std::chrono::seconds(0))==std::future_status::ready; }
+        bool  wait()        const { return result.get(); } // blocks until loading is over. True if the mesh was loaded
+        float progress()    const { return current_progress; }
+
+        // handle to the outcome of loading (true if the mesh was loaded)
+        std::shared_future<bool> future() const { return result; }
+
+    protected:
+
+        bool load_pipelined(const size_t memory_budget);
+        bool load_blocking();
+        void set_progress(const float p);
+
+        Mesh                   & m;
+        std::string              filename;
+        ProgressCallback         callback;
+        std::atomic<bool>        canceled;
+        std::atomic<float>       current_progress;
+        std::shared_future<bool> result;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "async_mesh_loader.cpp"
+#endif
+
+#endif // CINO_ASYNC_MESH_LOADER_H
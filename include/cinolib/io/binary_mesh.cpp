@@ -0,0 +1,315 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/binary_mesh.h>
+#include <cinolib/parallel_for.h>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+namespace cinolib
+{
+
+template<typename T>
+CINO_INLINE
+void BinaryMeshWriter::add(const uint id, const std::vector<T> & data)
+{
+    typedef typename BinaryRepr<T>::type R;
+    if(!std::is_same<T,R>::value)
+    {
+        add<T>(id, data, [](const T & x) { return x; });
+        return;
+    }
+    static_assert(std::is_standard_layout<R>::value, "BinaryMeshWriter: type must have standard layout");
+    Chunk c;
+    c.id        = id;
+    c.elem_size = sizeof(R);
+    c.count     = data.size();
+    c.ptr       = reinterpret_cast<const char*>(data.data());
+    c.bytes     = data.size()*sizeof(R);
+    chunks.push_back(std::move(c));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T, typename C, typename Func>
+CINO_INLINE
+void BinaryMeshWriter::add(const uint id, const std::vector<C> & items, const Func & get)
+{
+    typedef typename BinaryRepr<T>::type R;
+    static_assert(std::is_standard_layout<R>::value, "BinaryMeshWriter: type must have standard layout");
+    Chunk c;
+    c.id        = id;
+    c.elem_size = sizeof(R);
+    c.count     = items.size();
+    c.bytes     = items.size()*sizeof(R);
+    c.owned.resize(c.bytes);
+    R *dst = reinterpret_cast<R*>(c.owned.data());
+    for(size_t i=0; i<items.size(); ++i) dst[i] = BinaryRepr<T>::to(get(items[i]));
+    c.ptr = c.owned.data();
+    chunks.push_back(std::move(c));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BinaryMeshWriter::add(const uint id, const std::vector<std::vector<uint>> & data)
+{
+    uint64_t n_ids = 0;
+    for(const auto & row : data) n_ids += row.size();
+
+    Chunk c;
+    c.id        = id;
+    c.elem_size = 0;
+    c.count     = data.size();
+    c.bytes     = (data.size()+1)*sizeof(uint64_t) + n_ids*sizeof(uint32_t);
+    c.owned.resize(c.bytes);
+    uint64_t *off = reinterpret_cast<uint64_t*>(c.owned.data());
+    uint32_t *ids = reinterpret_cast<uint32_t*>(off + data.size()+1);
+    off[0] = 0;
+    for(size_t i=0; i<data.size(); ++i)
+    {
+        std::copy(data[i].begin(), data[i].end(), ids+off[i]);
+        off[i+1] = off[i] + data[i].size();
+    }
+    c.ptr = c.owned.data();
+    chunks.push_back(std::move(c));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BinaryMeshWriter::add(const uint id, const std::vector<std::vector<bool>> & data)
+{
+    std::vector<std::vector<uint>> tmp(data.size());
+    for(size_t i=0; i<data.size(); ++i) tmp[i].assign(data[i].begin(), data[i].end());
+    add(id, tmp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool BinaryMeshWriter::write(const char * filename) const
+{
+    FILE *f = fopen(filename, "wb");
+    if(!f)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write() : couldn't open output file " << filename << std::endl;
+        return false;
+    }
+
+    auto align = [](const uint64_t x) { return (x + CINO_BIN_ALIGNMENT-1) / CINO_BIN_ALIGNMENT * CINO_BIN_ALIGNMENT; };
+
+    BinaryMeshHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "CINOMESH", 8);
+    h.version    = CINO_BIN_VERSION;
+    h.endianness = 0x01020304;
+    h.mesh_type  = uint32_t(mesh_type);
+    h.n_sections = uint32_t(chunks.size());
+
+    std::vector<BinaryMeshSection> table(chunks.size());
+    uint64_t offset = align(sizeof(h) + table.size()*sizeof(BinaryMeshSection));
+    for(size_t i=0; i<chunks.size(); ++i)
+    {
+        table[i].id        = chunks[i].id;
+        table[i].elem_size = chunks[i].elem_size;
+        table[i].count     = chunks[i].count;
+        table[i].bytes     = chunks[i].bytes;
+        table[i].offset    = offset;
+        offset = align(offset + chunks[i].bytes);
+    }
+
+    static const char zeros[CINO_BIN_ALIGNMENT] = {0};
+    bool ok = true;
+    uint64_t pos = 0;
+    auto put = [&](const void * data, const uint64_t bytes)
+    {
+        if(bytes>0 && fwrite(data, 1, bytes, f)!=bytes) ok = false;
+        pos += bytes;
+    };
+    put(&h, sizeof(h));
+    put(table.data(), table.size()*sizeof(BinaryMeshSection));
+    for(size_t i=0; i<chunks.size(); ++i)
+    {
+        put(zeros, table[i].offset - pos);
+        put(chunks[i].ptr, chunks[i].bytes);
+    }
+    fclose(f);
+
+    if(!ok) std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write() : failed writing " << filename << std::endl;
+    return ok;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool BinaryMeshReader::open(const char * filename)
+{
+    sections.clear();
+    type = -1;
+
+    if(!f.open(filename))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : open() : couldn't open input file " << filename << std::endl;
+        return false;
+    }
+
+    BinaryMeshHeader h;
+    if(f.size()<sizeof(h))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : open() : truncated file " << filename << std::endl;
+        return false;
+    }
+    memcpy(&h, f.data(), sizeof(h));
+    if(memcmp(h.magic, "CINOMESH", 8)!=0 || h.endianness!=0x01020304)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : open() : not a CinoLib binary mesh (or wrong endianness) " << filename << std::endl;
+        return false;
+    }
+    if(h.version>CINO_BIN_VERSION)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : open() : unsupported file version " << h.version << std::endl;
+        return false;
+    }
+
+    uint64_t table_end = sizeof(h) + uint64_t(h.n_sections)*sizeof(BinaryMeshSection);
+    if(f.size()<table_end) return false;
+    sections.resize(h.n_sections);
+    memcpy(sections.data(), f.data()+sizeof(h), h.n_sections*sizeof(BinaryMeshSection));
+    for(const auto & s : sections)
+    {
+        if(s.offset+s.bytes>f.size())
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : open() : truncated file " << filename << std::endl;
+            sections.clear();
+            return false;
+        }
+    }
+    type = int(h.mesh_type);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const BinaryMeshSection * BinaryMeshReader::find(const uint id) const
+{
+    for(const auto & s : sections) if(s.id==id) return &s;
+    return nullptr;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+bool BinaryMeshReader::get(const uint id, std::vector<T> & data) const
+{
+    typedef typename BinaryRepr<T>::type R;
+    static_assert(std::is_standard_layout<R>::value, "BinaryMeshReader: type must have standard layout");
+    const BinaryMeshSection *s = find(id);
+    if(s==nullptr || s->elem_size!=sizeof(R)) return false;
+    data.resize(s->count);
+    if(s->count==0) return true;
+    if(std::is_same<T,R>::value)
+    {
+        memcpy((void*)data.data(), f.data()+s->offset, s->count*sizeof(R));
+    }
+    else
+    {
+        const char *src = f.data()+s->offset;
+        PARALLEL_FOR(0, uint(s->count), 100000, [&](uint i)
+        {
+            R val;
+            memcpy(&val, src+i*sizeof(R), sizeof(R));
+            data[i] = BinaryRepr<T>::from(val);
+        });
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T, typename C, typename Func>
+CINO_INLINE
+bool BinaryMeshReader::get(const uint id, std::vector<C> & items, const Func & set) const
+{
+    typedef typename BinaryRepr<T>::type R;
+    const BinaryMeshSection *s = find(id);
+    if(s==nullptr || s->elem_size!=sizeof(R) || s->count!=items.size()) return false;
+    const char *src = f.data()+s->offset;
+    PARALLEL_FOR(0, uint(items.size()), 100000, [&](uint i)
+    {
+        R val;
+        memcpy(&val, src+i*sizeof(R), sizeof(R));
+        set(items[i], BinaryRepr<T>::from(val));
+    });
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool BinaryMeshReader::get(const uint id, std::vector<std::vector<uint>> & data) const
+{
+    const BinaryMeshSection *s = find(id);
+    if(s==nullptr || s->elem_size!=0) return false;
+    const uint64_t *off = reinterpret_cast<const uint64_t*>(f.data()+s->offset);
+    const uint32_t *ids = reinterpret_cast<const uint32_t*>(off + s->count+1);
+    data.resize(s->count);
+    // rows are independent, and allocating them is the bottleneck
+    PARALLEL_FOR(0, uint(s->count), 100000, [&](uint i)
+    {
+        data[i].assign(ids+off[i], ids+off[i+1]);
+    });
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool BinaryMeshReader::get(const uint id, std::vector<std::vector<bool>> & data) const
+{
+    std::vector<std::vector<uint>> tmp;
+    if(!get(id, tmp)) return false;
+    data.resize(tmp.size());
+    for(size_t i=0; i<tmp.size(); ++i) data[i].assign(tmp[i].begin(), tmp[i].end());
+    return true;
+}
+
+}
@@ -0,0 +1,249 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_BINARY_MESH_H
+#define CINO_BINARY_MESH_H
+
+#include <sys/types.h>
+#include <cstdint>
+#include <vector>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+#include <cinolib/io/memory_mapped_file.h>
+
+namespace cinolib
+{
+
+/* Native binary container for CinoLib meshes (extension ".cino").
+ * The file stores all the arrays that define a mesh (vertices, elements,
+ * adjacency and standard attributes) as a list of typed sections, so that
+ * reloading a mesh does not require any parsing or topology reconstruction.
+ *
+ * Layout (little endian, all sections aligned to CINO_BIN_ALIGNMENT bytes):
+ *
+ *     header        : magic "CINOMESH", version, endianness tag, mesh type, #sections
+ *     section table : for each section its id, element size, #elements, offset and size in bytes
+ *     sections      : raw data. Plain arrays are stored as is. Jagged arrays
+ *                     (i.e. std::vector<std::vector<uint>>) are stored as n+1
+ *                     uint64 offsets followed by the serialized uint indices
+ *
+ * Files are read through a memory mapping, and sections are copied straight
+ * into the mesh containers with bulk copies.
+*/
+
+static const uint32_t CINO_BIN_VERSION   = 1;
+static const uint32_t CINO_BIN_ALIGNMENT = 64;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+enum
+{
+    // elements
+    BIN_VERTS = 0,
+    BIN_EDGES,
+    BIN_FACES,
+    BIN_POLYS,
+    BIN_POLY_WINDING,
+    // adjacency
+    BIN_V2V,
+    BIN_V2E,
+    BIN_V2F,
+    BIN_V2P,
+    BIN_E2F,
+    BIN_E2P,
+    BIN_F2E,
+    BIN_F2F,
+    BIN_F2P,
+    BIN_P2V,
+    BIN_P2E,
+    BIN_P2P,
+    BIN_POLY_TRIANGLES,
+    BIN_FACE_TRIANGLES,
+    // vertex attributes
+    BIN_V_NORMAL = 100,
+    BIN_V_COLOR,
+    BIN_V_UVW,
+    BIN_V_LABEL,
+    BIN_V_QUALITY,
+    BIN_V_FLAGS,
+    // edge attributes
+    BIN_E_COLOR = 200,
+    BIN_E_LABEL,
+    BIN_E_FLAGS,
+    // face attributes (volume meshes only)
+    BIN_F_NORMAL = 300,
+    BIN_F_COLOR,
+    BIN_F_LABEL,
+    BIN_F_QUALITY,
+    BIN_F_AO,
+    BIN_F_FLAGS,
+    // polygon/polyhedron attributes
+    BIN_P_NORMAL = 400,
+    BIN_P_COLOR,
+    BIN_P_LABEL,
+    BIN_P_QUALITY,
+    BIN_P_AO,
+    BIN_P_FLAGS,
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// on disk representation of a type. Types with a plain memory layout are
+// stored as they are, vectors are stored as arrays of doubles (vec3d has
+// a virtual destructor, hence its memory layout contains a vtable pointer)
+//
+template<typename T> struct BinaryRepr
+{
+    typedef T type;
+    static type to  (const T    & x) { return x; }
+    static T    from(const type & x) { return x; }
+};
+//
+template<> struct BinaryRepr<vec3d>
+{
+    struct type { double xyz[3]; };
+    static type  to  (const vec3d & x) { type t = {{x.x(), x.y(), x.z()}}; return t; }
+    static vec3d from(const type  & x) { return vec3d(x.xyz[0], x.xyz[1], x.xyz[2]); }
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct BinaryMeshHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t endianness; // 0x01020304 as written by the host
+    uint32_t mesh_type;
+    uint32_t n_sections;
+    char     reserved[CINO_BIN_ALIGNMENT-24];
+};
+
+static_assert(sizeof(BinaryMeshHeader)==CINO_BIN_ALIGNMENT, "unexpected padding");
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct BinaryMeshSection
+{
+    uint32_t id;
+    uint32_t elem_size; // 0 for jagged arrays
+    uint64_t count;     // number of elements (rows, for jagged arrays)
+    uint64_t offset;    // from the beginning of the file
+    uint64_t bytes;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class BinaryMeshWriter
+{
+    public:
+
+        explicit BinaryMeshWriter(const int mesh_type) : mesh_type(mesh_type) {}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // plain arrays are not copied (unless their on disk representation
+        // differs from the memory one). The input must remain valid until write()
+        template<typename T>
+        void add(const uint id, const std::vector<T> & data);
+
+        // attribute channels, extracted from a vector of attribute structs
+        template<typename T, typename C, typename Func>
+        void add(const uint id, const std::vector<C> & items, const Func & get);
+
+        void add(const uint id, const std::vector<std::vector<uint>> & data);
+        void add(const uint id, const std::vector<std::vector<bool>> & data);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool write(const char * filename) const;
+
+    protected:
+
+        struct Chunk
+        {
+            uint32_t          id;
+            uint32_t          elem_size;
+            uint64_t          count;
+            const char      * ptr;   // either points to external data...
+            std::vector<char> owned; // ...or to this buffer
+            uint64_t          bytes;
+        };
+
+        int                mesh_type;
+        std::vector<Chunk> chunks;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class BinaryMeshReader
+{
+    public:
+
+        explicit BinaryMeshReader() {}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool open(const char * filename);
+        int  mesh_type() const { return type; }
+        bool has(const uint id) const { return find(id)!=nullptr; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<typename T>
+        bool get(const uint id, std::vector<T> & data) const;
+
+        // attribute channels, scattered into a vector of attribute structs
+        template<typename T, typename C, typename Func>
+        bool get(const uint id, std::vector<C> & items, const Func & set) const;
+
+        bool get(const uint id, std::vector<std::vector<uint>> & data) const;
+        bool get(const uint id, std::vector<std::vector<bool>> & data) const;
+
+    protected:
+
+        const BinaryMeshSection * find(const uint id) const;
+
+        MemoryMappedFile               f;
+        int                            type = -1;
+        std::vector<BinaryMeshSection> sections;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "binary_mesh.cpp"
+#endif
+
+#endif // CINO_BINARY_MESH_H
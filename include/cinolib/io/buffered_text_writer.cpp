@@ -0,0 +1,73 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/buffered_text_writer.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <thread>
+
+namespace cinolib
+{
+
+template<typename Func>
+CINO_INLINE
+bool write_parallel(FILE       * fp,
+                    const uint   n,
+                    const Func & emit,
+                    const uint   batch_size)
+{
+    uint n_threads = (n<batch_size) ? 1 : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<TextBuffer> bufs(n_threads);
+
+    bool ok = true;
+    for(uint beg=0; beg<n; beg+=std::min(n-beg, n_threads*batch_size))
+    {
+        uint end   = beg + std::min(n-beg, n_threads*batch_size);
+        uint slice = (end-beg+n_threads-1)/n_threads;
+        auto format_range = [&](uint t)
+        {
+            uint i0 = std::min(end, beg + t*slice);
+            uint i1 = std::min(end, i0 + slice);
+            for(uint i=i0; i<i1; ++i) emit(i, bufs[t]);
+        };
+        if(n_threads==1) format_range(0);
+        else PARALLEL_FOR(0, n_threads, 2, format_range);
+
+        for(TextBuffer & b : bufs) ok &= b.flush(fp);
+    }
+    return ok;
+}
+
+}
@@ -0,0 +1,124 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_BUFFERED_TEXT_WRITER_H
+#define CINO_BUFFERED_TEXT_WRITER_H
+
+#include <sys/types.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <cinolib/cino_inline.h>
+#include <cinolib/io/fast_number_formatting.h>
+
+namespace cinolib
+{
+
+/* Growable character buffer, used by text writers to format numbers in
+ * memory (see fast_number_formatting.h) and flush them with a single fwrite,
+ * as opposed to calling fprintf for each and every number. Doubles are written
+ * with the shortest representation that parses back to the same value (see
+ * format_double), hence text files round trip exactly.
+*/
+
+class TextBuffer
+{
+    public:
+
+        explicit TextBuffer(const size_t capacity = 65536) { buf.resize(capacity); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void         clear()       { len = 0; }
+        size_t       size()  const { return len; }
+        const char * data()  const { return buf.data(); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void put(const char     c) { reserve(1); buf[len++] = c; }
+        void put(const char   * s) { size_t n = strlen(s); reserve(n); memcpy(buf.data()+len, s, n); len += n; }
+        void put(const double   d) { reserve(CINO_MAX_DOUBLE_CHARS); len = size_t(format_double(d, buf.data()+len) - buf.data()); }
+        void put(const int      i) { reserve(24); len = size_t(format_int (i, buf.data()+len) - buf.data()); }
+        void put(const uint     i) { reserve(24); len = size_t(format_uint(i, buf.data()+len) - buf.data()); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool flush(FILE * fp)
+        {
+            bool ok = (fwrite(buf.data(), 1, len, fp)==len);
+            len = 0;
+            return ok;
+        }
+
+    protected:
+
+        void reserve(const size_t n)
+        {
+            if(len+n>buf.size()) buf.resize(std::max(2*buf.size(), len+n));
+        }
+
+        std::vector<char> buf;
+        size_t            len = 0;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Writes n items to fp, formatting them in parallel. Items are processed
+ * in batches: within each batch every thread formats a contiguous range of
+ * items in its own buffer, then buffers are written in order, with one fwrite
+ * each. Memory usage is bounded by the batch size (items per thread).
+ *
+ * emit is a function (typically a lambda) with signature
+ *
+ *     void emit(const uint i, TextBuffer & buf)
+ *
+ * that appends the text of the i-th item to buf.
+*/
+
+template<typename Func>
+CINO_INLINE
+bool write_parallel(FILE       * fp,
+                    const uint   n,
+                    const Func & emit,
+                    const uint   batch_size = 65536);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "buffered_text_writer.cpp"
+#endif
+
+#endif // CINO_BUFFERED_TEXT_WRITER_H
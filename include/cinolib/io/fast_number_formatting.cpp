@@ -0,0 +1,395 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/fast_number_formatting.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace cinolib
+{
+
+namespace schubfach
+{
+    static const int      P       = 53;                        // precision of doubles
+    static const int      Q_MIN   = -1074;                     // min binary exponent
+    static const uint64_t C_MIN   = uint64_t(1) << (P-1);      // min normal significand
+    static const uint64_t C_TINY  = 3;                         // significands below this lose one digit
+    static const int      K_MIN   = -324;                      // range of decimal exponents
+    static const int      K_MAX   = 292;
+    static const uint64_t MASK_63 = (uint64_t(1) << 63) - 1;
+
+    // floor(e*log10(2)), floor(e*log10(3/4 2)), floor(e*log2(10)), for the exponents of interest
+    inline int flog10pow2             (const int e) { return int((int64_t(e) * 661971961083LL) >> 41); }
+    inline int flog10threeQuartersPow2(const int e) { return int((int64_t(e) * 661971961083LL - 274743187321LL) >> 41); }
+    inline int flog2pow10             (const int e) { return int((int64_t(e) * 913124641741LL) >> 38); }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    inline uint64_t mul_high(const uint64_t a, const uint64_t b)
+    {
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 uint128;
+        return uint64_t((uint128(a) * b) >> 64);
+#else
+        uint64_t a0 = a & 0xffffffff, a1 = a >> 32;
+        uint64_t b0 = b & 0xffffffff, b1 = b >> 32;
+        uint64_t p00 = a0*b0, p01 = a0*b1, p10 = a1*b0, p11 = a1*b1;
+        uint64_t mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+        return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // minimal fixed size big integer, only used to build the table of powers of ten
+    struct BigInt
+    {
+        static const int N = 40; // 1280 bits, enough for 10^324 and 2^(125+971)
+        uint32_t w[N];
+
+        explicit BigInt(const uint32_t x = 0) { memset(w, 0, sizeof(w)); w[0] = x; }
+
+        void mul10()
+        {
+            uint64_t carry = 0;
+            for(int i=0; i<N; ++i)
+            {
+                uint64_t v = uint64_t(w[i])*10 + carry;
+                w[i]  = uint32_t(v);
+                carry = v >> 32;
+            }
+        }
+
+        void shl1()
+        {
+            uint32_t carry = 0;
+            for(int i=0; i<N; ++i)
+            {
+                uint32_t next = w[i] >> 31;
+                w[i]  = (w[i] << 1) | carry;
+                carry = next;
+            }
+        }
+
+        bool geq(const BigInt & b) const
+        {
+            for(int i=N-1; i>=0; --i) if(w[i]!=b.w[i]) return w[i]>b.w[i];
+            return true;
+        }
+
+        void sub(const BigInt & b)
+        {
+            int64_t borrow = 0;
+            for(int i=0; i<N; ++i)
+            {
+                int64_t v = int64_t(w[i]) - int64_t(b.w[i]) - borrow;
+                borrow = (v<0) ? 1 : 0;
+                w[i]   = uint32_t(v + (borrow << 32));
+            }
+        }
+
+        bool bit    (const int i) const { return i>=0 && i<32*N && ((w[i>>5] >> (i&31)) & 1); }
+        void set_bit(const int i)       { w[i>>5] |= uint32_t(1) << (i&31); }
+
+        int bit_length() const
+        {
+            for(int i=32*N-1; i>=0; --i) if(bit(i)) return i+1;
+            return 0;
+        }
+    };
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // For each k in [K_MIN,K_MAX] let 10^-k = beta 2^r, with 2^125 <= beta < 2^126.
+    // g = floor(beta)+1 is stored as its higher 63 bits (g1) and lower 63 bits (g0).
+    // The table is computed once, with exact integer arithmetic
+    //
+    struct PowTable
+    {
+        uint64_t g[2*(K_MAX-K_MIN+1)];
+
+        PowTable()
+        {
+            for(int k=K_MIN; k<=K_MAX; ++k)
+            {
+                int e = -k;
+                int r = flog2pow10(e) - 125;
+                uint64_t hi = 0, lo = 0; // floor(beta), 126 bits
+                if(e>=0)
+                {
+                    BigInt pow10(1);
+                    for(int i=0; i<e; ++i) pow10.mul10();
+                    for(int i=0; i<126; ++i)
+                    {
+                        if(!pow10.bit(i+r)) continue;
+                        if(i<64) lo |= uint64_t(1) << i;
+                        else     hi |= uint64_t(1) << (i-64);
+                    }
+                }
+                else
+                {
+                    // long division 2^(-r) / 10^k
+                    BigInt pow10(1);
+                    for(int i=0; i<k; ++i) pow10.mul10();
+                    int m = -r;
+                    int j = pow10.bit_length()-1; // 2^j < 10^k (it is not a power of two)
+                    BigInt rem;
+                    rem.set_bit(j);
+                    for(int b=m-j-1; b>=0; --b)
+                    {
+                        rem.shl1();
+                        if(rem.geq(pow10))
+                        {
+                            rem.sub(pow10);
+                            if(b<64) lo |= uint64_t(1) << b;
+                            else     hi |= uint64_t(1) << (b-64);
+                        }
+                    }
+                }
+                if(++lo==0) ++hi;
+                g[2*(k-K_MIN)  ] = (hi << 1) | (lo >> 63);
+                g[2*(k-K_MIN)+1] = lo & MASK_63;
+            }
+        }
+    };
+
+    inline const PowTable & pow_table()
+    {
+        static const PowTable table;
+        return table;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    inline uint64_t rop(const uint64_t g1, const uint64_t g0, const uint64_t cp)
+    {
+        uint64_t x1  = mul_high(g0, cp);
+        uint64_t y0  = g1 * cp;
+        uint64_t y1  = mul_high(g1, cp);
+        uint64_t z   = (y0 >> 1) + x1;
+        uint64_t vbp = y1 + (z >> 63);
+        return vbp | (((z & MASK_63) + MASK_63) >> 63);
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // computes the shortest decimal f 10^e that rounds to c 2^q
+    //
+    inline void to_decimal(const int q, const uint64_t c, const int dk, uint64_t & f, int & e)
+    {
+        uint64_t out = c & 1;
+        uint64_t cb  = c << 2;
+        uint64_t cbr = cb + 2;
+        uint64_t cbl;
+        int k;
+        if(c!=C_MIN || q==Q_MIN)
+        {
+            cbl = cb - 2;
+            k   = flog10pow2(q);
+        }
+        else
+        {
+            cbl = cb - 1;
+            k   = flog10threeQuartersPow2(q);
+        }
+        int h = q + flog2pow10(-k) + 2;
+        const uint64_t *g = pow_table().g + 2*(k-K_MIN);
+        uint64_t vb  = rop(g[0], g[1], cb  << h);
+        uint64_t vbl = rop(g[0], g[1], cbl << h);
+        uint64_t vbr = rop(g[0], g[1], cbr << h);
+        uint64_t s   = vb >> 2;
+        if(s>=100)
+        {
+            uint64_t sp10 = 10 * mul_high(s, uint64_t(115292150460684698ULL) << 4); // 10 floor(s/10)
+            uint64_t tp10 = sp10 + 10;
+            bool upin = vbl + out <= (sp10 << 2);
+            bool wpin = (tp10 << 2) + out <= vbr;
+            if(upin!=wpin)
+            {
+                f = upin ? sp10 : tp10;
+                e = k;
+                return;
+            }
+        }
+        uint64_t t = s + 1;
+        bool uin = vbl + out <= (s << 2);
+        bool win = (t << 2) + out <= vbr;
+        if(uin!=win)
+        {
+            f = uin ? s : t;
+            e = k + dk;
+            return;
+        }
+        int64_t cmp = int64_t(vb) - int64_t((s + t) << 1);
+        f = (cmp<0 || (cmp==0 && (s & 1)==0)) ? s : t;
+        e = k + dk;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // writes f 10^e, mimicking the layout of "%g"
+    //
+    inline char * to_chars(uint64_t f, int e, char * buf)
+    {
+        while(f>0 && f%10==0) { f /= 10; ++e; }
+        char digits[20];
+        int  n = 0;
+        do { digits[n++] = char('0' + f%10); f /= 10; } while(f>0);
+        int exp10 = e + n - 1; // exponent of the first digit
+
+        if(exp10>=-5 && exp10<17)
+        {
+            if(exp10<0)
+            {
+                *buf++ = '0';
+                *buf++ = '.';
+                for(int i=0; i<-exp10-1; ++i) *buf++ = '0';
+                for(int i=n-1; i>=0; --i) *buf++ = digits[i];
+            }
+            else
+            {
+                for(int i=0; i<n || i<=exp10; ++i)
+                {
+                    if(i==exp10+1) *buf++ = '.';
+                    *buf++ = (i<n) ? digits[n-1-i] : '0';
+                }
+            }
+            return buf;
+        }
+
+        *buf++ = digits[n-1];
+        if(n>1)
+        {
+            *buf++ = '.';
+            for(int i=n-2; i>=0; --i) *buf++ = digits[i];
+        }
+        *buf++ = 'e';
+        *buf++ = (exp10<0) ? '-' : '+';
+        int ae = (exp10<0) ? -exp10 : exp10;
+        if(ae>=100) *buf++ = char('0' + ae/100);
+        *buf++ = char('0' + (ae/10)%10);
+        *buf++ = char('0' + ae%10);
+        return buf;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+char * format_double(const double d, char * buf)
+{
+    using namespace schubfach;
+
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(double));
+    uint64_t t  = bits & (C_MIN-1);
+    int      bq = int(bits >> (P-1)) & 0x7ff;
+
+    if(bq==0x7ff)
+    {
+        if(t!=0) { memcpy(buf, "nan", 3); return buf+3; }
+        if(bits>>63) *buf++ = '-';
+        memcpy(buf, "inf", 3);
+        return buf+3;
+    }
+    if(bits>>63) *buf++ = '-';
+
+    uint64_t f;
+    int      e;
+    if(bq!=0)
+    {
+        int      mq = -Q_MIN + 1 - bq;
+        uint64_t c  = C_MIN | t;
+        if(mq>0 && mq<P && ((c >> mq) << mq)==c) // fast path for integers
+        {
+            return to_chars(c >> mq, 0, buf);
+        }
+        to_decimal(-mq, c, 0, f, e);
+    }
+    else if(t!=0) // subnormals
+    {
+        if(t<C_TINY) to_decimal(Q_MIN, 10*t, -1, f, e);
+        else         to_decimal(Q_MIN,    t,  0, f, e);
+
+        // the smallest subnormals come out with two digits, even
+        // when one would do (e.g. 4.9e-324 for 5e-324). Try harder
+        if(f>=10 && f<100)
+        {
+            uint64_t cand[2] = { (f+5)/10, (f%10<5) ? f/10+1 : f/10 };
+            for(uint64_t c : cand)
+            {
+                if(c==0) continue;
+                char tmp[CINO_MAX_DOUBLE_CHARS];
+                *to_chars(c, e+1, tmp) = '\0'; // to_chars strips trailing zeros (e.g. 10 -> 1e+1)
+                double x = strtod(tmp, nullptr);
+                if(x==std::fabs(d)) return to_chars(c, e+1, buf);
+            }
+        }
+    }
+    else
+    {
+        *buf++ = '0';
+        return buf;
+    }
+    return to_chars(f, e, buf);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+char * format_uint(uint64_t i, char * buf)
+{
+    char digits[20];
+    int  n = 0;
+    do { digits[n++] = char('0' + i%10); i /= 10; } while(i>0);
+    while(n>0) *buf++ = digits[--n];
+    return buf;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+char * format_int(const int64_t i, char * buf)
+{
+    if(i<0)
+    {
+        *buf++ = '-';
+        return format_uint(uint64_t(0)-uint64_t(i), buf);
+    }
+    return format_uint(uint64_t(i), buf);
+}
+
+}
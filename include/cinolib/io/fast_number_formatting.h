@@ -0,0 +1,81 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_FAST_NUMBER_FORMATTING_H
+#define CINO_FAST_NUMBER_FORMATTING_H
+
+#include <sys/types.h>
+#include <cstdint>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Number formatting into raw character buffers, meant to be used by text
+ * writers. All functions write at the position pointed by buf (without a
+ * null terminator) and return the position right after the last character.
+ *
+ * Doubles are written with the shortest sequence of decimal digits that
+ * parses back to the very same bits (Schubfach algorithm, R. Giulietti, "The
+ * Schubfach way to render doubles", 2020). Among the shortest sequences the
+ * one closest to the exact value is chosen. The layout mimics "%g": fixed
+ * notation for decimal exponents in [-5,17), scientific notation otherwise.
+ * Infinities and NaNs are written as "inf" and "nan".
+*/
+
+static const int CINO_MAX_DOUBLE_CHARS = 32; // upper bound to the length of a formatted double
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+char * format_double(const double d, char * buf);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+char * format_int(const int64_t i, char * buf);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+char * format_uint(uint64_t i, char * buf);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "fast_number_formatting.cpp"
+#endif
+
+#endif // CINO_FAST_NUMBER_FORMATTING_H
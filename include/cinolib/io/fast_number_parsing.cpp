@@ -0,0 +1,194 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/fast_number_parsing.h>
+#include <cfloat>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+
+namespace cinolib
+{
+
+// slow path: copy the token in a NULL terminated buffer and use strtod
+//
+CINO_INLINE
+bool fast_parse_double_slow(const char *& s, const char * end, double & d)
+{
+    char buf[128];
+    size_t n = 0;
+    while(s+n<end && n<sizeof(buf)-1 && !is_blank(s[n]) && s[n]!='\n') { buf[n] = s[n]; ++n; }
+    buf[n] = '\0';
+    char *last;
+    double val = strtod(buf, &last);
+    if(last==buf) return false;
+    d  = val;
+    s += (last-buf);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool fast_parse_double(const char *& s, const char * end, double & d)
+{
+    static const double pow10[] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *p = s;
+    bool neg = false;
+    if(p<end && (*p=='-' || *p=='+'))
+    {
+        neg = (*p=='-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int      n_digits = 0; // significant digits accumulated in the mantissa
+    int      exp10    = 0;
+    bool     any      = false;
+    bool     fast     = true;
+
+    // integer part
+    for(; p<end && *p>='0' && *p<='9'; ++p)
+    {
+        any = true;
+        if(mantissa==0 && *p=='0') continue; // leading zeros are not significant
+        if(++n_digits>19) { fast = false; continue; }
+        mantissa = mantissa*10 + uint64_t(*p-'0');
+    }
+    // fractional part
+    if(p<end && *p=='.')
+    {
+        ++p;
+        for(; p<end && *p>='0' && *p<='9'; ++p)
+        {
+            any = true;
+            --exp10;
+            if(mantissa==0 && *p=='0') continue;
+            if(++n_digits>19) { fast = false; continue; }
+            mantissa = mantissa*10 + uint64_t(*p-'0');
+        }
+    }
+    if(!any) return fast_parse_double_slow(s, end, d); // inf, nan, hex floats...
+
+    // exponent
+    if(p<end && (*p=='e' || *p=='E'))
+    {
+        ++p;
+        bool exp_neg = false;
+        if(p<end && (*p=='-' || *p=='+'))
+        {
+            exp_neg = (*p=='-');
+            ++p;
+        }
+        if(p==end || *p<'0' || *p>'9') return false;
+        int e = 0;
+        for(; p<end && *p>='0' && *p<='9'; ++p)
+        {
+            if(e<100000) e = e*10 + (*p-'0');
+        }
+        exp10 += exp_neg ? -e : e;
+    }
+
+    // Clinger: if both the mantissa and the power of ten are exactly representable
+    // as doubles, a single IEEE operation produces the correctly rounded result.
+    // Extended precision intermediates (x87) could double round: skip the fast path
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD==0
+    if(fast && (mantissa==0 || (mantissa<=(uint64_t(1)<<53) && exp10>=-22 && exp10<=22)))
+    {
+        double val = double(mantissa);
+        if(exp10<0) val /= pow10[-exp10];
+        else        val *= pow10[ exp10];
+        d = neg ? -val : val;
+        s = p;
+        return true;
+    }
+#endif
+    return fast_parse_double_slow(s, end, d);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool fast_parse_int(const char *& s, const char * end, int & i)
+{
+    const char *p = s;
+    bool neg = false;
+    if(p<end && (*p=='-' || *p=='+'))
+    {
+        neg = (*p=='-');
+        ++p;
+    }
+    if(p==end || *p<'0' || *p>'9') return false;
+
+    int64_t val = 0;
+    for(; p<end && *p>='0' && *p<='9'; ++p)
+    {
+        val = val*10 + (*p-'0');
+        if(val>int64_t(INT_MAX)+1) return false;
+    }
+    if(neg) val = -val;
+    if(val>INT_MAX || val<INT_MIN) return false;
+
+    i = int(val);
+    s = p;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool fast_parse_uint(const char *& s, const char * end, uint & i)
+{
+    const char *p = s;
+    if(p==end || *p<'0' || *p>'9') return false;
+
+    uint64_t val = 0;
+    for(; p<end && *p>='0' && *p<='9'; ++p)
+    {
+        val = val*10 + uint64_t(*p-'0');
+        if(val>UINT_MAX) return false;
+    }
+
+    i = uint(val);
+    s = p;
+    return true;
+}
+
+}
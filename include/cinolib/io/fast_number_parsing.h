@@ -0,0 +1,89 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_FAST_NUMBER_PARSING_H
+#define CINO_FAST_NUMBER_PARSING_H
+
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Number parsing on (non null terminated) character ranges, meant to be
+ * used by text parsers operating on memory mapped files.
+ *
+ * All functions move the pointer s past the parsed token and return true on
+ * success, or return false and leave s untouched on failure. Doubles are
+ * parsed with the Clinger fast path, which is exact (i.e. produces the very
+ * same bits of strtod/sscanf) for decimals with up to 15 significant digits
+ * and small exponents. All the other inputs (e.g. the 17 digits written with
+ * "%.17g", huge exponents, hex floats, inf/nan) are handed to strtod.
+*/
+
+CINO_INLINE
+bool fast_parse_double(const char *& s, const char * end, double & d);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool fast_parse_int(const char *& s, const char * end, int & i);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool fast_parse_uint(const char *& s, const char * end, uint & i);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+inline bool is_blank(const char c)
+{
+    return c==' ' || c=='\t' || c=='\r' || c=='\v' || c=='\f';
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+inline void skip_blanks(const char *& s, const char * end)
+{
+    while(s<end && is_blank(*s)) ++s;
+}
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "fast_number_parsing.cpp"
+#endif
+
+#endif // CINO_FAST_NUMBER_PARSING_H
@@ -0,0 +1,209 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/io_data.h>
+#include <cinolib/parallel_for.h>
+#include <assert.h>
+#include <atomic>
+#include <map>
+#include <tuple>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void IOData::clear()
+{
+    verts.clear();
+    poly_offsets.assign(1,0);
+    poly_vids.clear();
+    uvw.clear();
+    normals.clear();
+    poly_uvw.clear();
+    poly_nor.clear();
+    vert_colors.clear();
+    poly_colors.clear();
+    vert_labels.clear();
+    poly_labels.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void IOData::reserve(const uint nv, const uint np, const uint n_corners)
+{
+    verts.reserve(nv);
+    poly_offsets.reserve(np+1);
+    poly_vids.reserve(n_corners);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void IOData::poly_add(const std::vector<uint> & vids)
+{
+    poly_add(vids.data(), uint(vids.size()));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void IOData::poly_add(const uint * vids, const uint n)
+{
+    if(poly_offsets.empty()) poly_offsets.push_back(0);
+    poly_vids.insert(poly_vids.end(), vids, vids+n);
+    poly_offsets.push_back(uint(poly_vids.size()));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void IOData::polys_add_serialized(const std::vector<uint> & vids, const uint n_corners)
+{
+    assert(vids.size()%n_corners==0);
+    if(poly_offsets.empty()) poly_offsets.push_back(0);
+    uint base = uint(poly_vids.size());
+    uint np   = uint(vids.size()/n_corners);
+    poly_vids.insert(poly_vids.end(), vids.begin(), vids.end());
+    poly_offsets.reserve(poly_offsets.size()+np);
+    for(uint i=1; i<=np; ++i) poly_offsets.push_back(base + i*n_corners);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void IOData::set_polys(const std::vector<std::vector<uint>> & polys)
+{
+    uint np = uint(polys.size());
+    poly_offsets.resize(np+1);
+    poly_offsets[0] = 0;
+    for(uint pid=0; pid<np; ++pid) poly_offsets[pid+1] = poly_offsets[pid] + uint(polys[pid].size());
+    poly_vids.resize(poly_offsets.back());
+    PARALLEL_FOR(0, np, 10000, [&](const uint pid)
+    {
+        std::copy(polys[pid].begin(), polys[pid].end(), poly_vids.begin() + poly_offsets[pid]);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<std::vector<uint>> IOData::polys() const
+{
+    std::vector<std::vector<uint>> res(num_polys());
+    PARALLEL_FOR(0, num_polys(), 10000, [&](const uint pid)
+    {
+        res[pid].assign(poly_begin(pid), poly_end(pid));
+    });
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool IOData::polys_refer_to_existing_verts() const
+{
+    std::atomic<bool> ok(true);
+    uint nv = num_verts();
+    PARALLEL_FOR(0, uint(poly_vids.size()), 100000, [&](const uint i)
+    {
+        if(poly_vids[i]>=nv) ok = false;
+    });
+    return ok;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// if the model is textured or has multiple normals per vertex (or both),
+// cut it along seams to create unique openGL-like vertices having xyz,
+// uvw and normals all condensed in a single entity. Vertices are numbered
+// in order of first appearance, as in to_openGL_unified_verts
+//
+CINO_INLINE
+void IOData::unify_verts()
+{
+    bool has_uvw = !poly_uvw.empty() && poly_uvw.size()==poly_vids.size();
+    bool has_nor = !poly_nor.empty() && poly_nor.size()==poly_vids.size();
+    if(!has_uvw) poly_uvw.clear();
+    if(!has_nor) poly_nor.clear();
+    if(!has_uvw && !has_nor) return;
+
+    typedef std::tuple<uint,uint,uint> v_vt_vn;
+    std::map<v_vt_vn,uint> v_map;
+
+    std::vector<vec3d> tmp_xyz, tmp_uvw, tmp_nor;
+    std::vector<uint>  orig_vid; // to carry per vertex colors and labels along
+    for(size_t i=0; i<poly_vids.size(); ++i)
+    {
+        uint v  = poly_vids[i];
+        uint vt = has_uvw ? poly_uvw[i] : 0;
+        uint vn = has_nor ? poly_nor[i] : 0;
+        v_vt_vn key = std::make_tuple(v,vt,vn);
+
+        auto query = v_map.find(key);
+        if(query == v_map.end())
+        {
+            uint fresh_id = uint(tmp_xyz.size());
+            v_map[key] = fresh_id;
+            tmp_xyz.push_back(verts.at(v));
+            if(has_uvw) tmp_uvw.push_back(uvw.at(vt));
+            if(has_nor) tmp_nor.push_back(normals.at(vn));
+            orig_vid.push_back(v);
+            poly_vids[i] = fresh_id;
+        }
+        else poly_vids[i] = query->second;
+    }
+
+    if(vert_colors.size()==verts.size())
+    {
+        std::vector<Color> tmp(orig_vid.size());
+        for(uint vid=0; vid<orig_vid.size(); ++vid) tmp[vid] = vert_colors[orig_vid[vid]];
+        vert_colors.swap(tmp);
+    }
+    if(vert_labels.size()==verts.size())
+    {
+        std::vector<int> tmp(orig_vid.size());
+        for(uint vid=0; vid<orig_vid.size(); ++vid) tmp[vid] = vert_labels[orig_vid[vid]];
+        vert_labels.swap(tmp);
+    }
+
+    verts.swap(tmp_xyz);
+    if(has_uvw) uvw.swap(tmp_uvw);
+    if(has_nor) normals.swap(tmp_nor);
+    poly_uvw.clear();
+    poly_nor.clear();
+}
+
+}
@@ -0,0 +1,107 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_IO_DATA_H
+#define CINO_IO_DATA_H
+
+#include <sys/types.h>
+#include <vector>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+#include <cinolib/color.h>
+
+namespace cinolib
+{
+
+/* Flat container for the content of a mesh file. Readers fill it, and
+ * meshes consume it by move (see the init(IOData &&) method of surface
+ * and volume meshes), so that no intermediate copy is made on the load path.
+ *
+ * Vertex coordinates are stored in a contiguous array (i.e. serialized
+ * xyz triplets), and can therefore be moved directly inside a mesh.
+ * Elements (polygons or polyhedra, depending on the file) are serialized
+ * in a single array of vertex ids, and indexed by offsets: the i-th element
+ * spans poly_vids[poly_offsets[i] ... poly_offsets[i+1]).
+ *
+ * All other channels are optional, and are left empty if the file does not
+ * contain them. Texture coordinates and normals can be either defined per
+ * vertex or, as in OBJ files, indexed per corner by poly_uvw and poly_nor,
+ * which share the offsets of poly_vids. In the latter case unify_verts()
+ * cuts the mesh along seams, making all channels per vertex.
+*/
+
+struct IOData
+{
+    std::vector<vec3d> verts;
+    std::vector<uint>  poly_offsets = std::vector<uint>(1,0);
+    std::vector<uint>  poly_vids;
+
+    std::vector<vec3d> uvw;          // texture coordinates
+    std::vector<vec3d> normals;
+    std::vector<uint>  poly_uvw;     // per corner references to uvw     (optional)
+    std::vector<uint>  poly_nor;     // per corner references to normals (optional)
+    std::vector<Color> vert_colors;
+    std::vector<Color> poly_colors;
+    std::vector<int>   vert_labels;
+    std::vector<int>   poly_labels;
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    uint         num_verts()               const { return uint(verts.size()); }
+    uint         num_polys()               const { return poly_offsets.empty() ? 0 : uint(poly_offsets.size()-1); }
+    uint         poly_size (const uint pid) const { return poly_offsets[pid+1] - poly_offsets[pid]; }
+    const uint * poly_begin(const uint pid) const { return poly_vids.data() + poly_offsets[pid];   }
+    const uint * poly_end  (const uint pid) const { return poly_vids.data() + poly_offsets[pid+1]; }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    void clear();
+    void reserve(const uint nv, const uint np, const uint n_corners);
+    void poly_add(const std::vector<uint> & vids);
+    void poly_add(const uint * vids, const uint n);
+    void polys_add_serialized(const std::vector<uint> & vids, const uint n_corners); // fixed size elements (e.g. tets)
+    void set_polys(const std::vector<std::vector<uint>> & polys);
+    std::vector<std::vector<uint>> polys() const;
+    bool polys_refer_to_existing_verts() const;
+    void unify_verts();
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "io_data.cpp"
+#endif
+
+#endif // CINO_IO_DATA_H
@@ -0,0 +1,126 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/memory_mapped_file.h>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CINO_HAS_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace cinolib
+{
+
+CINO_INLINE
+bool MemoryMappedFile::open(const char * filename)
+{
+    close();
+
+#ifdef CINO_HAS_MMAP
+    int fd = ::open(filename, O_RDONLY);
+    if(fd<0) return false;
+
+    struct stat st;
+    if(fstat(fd, &st)<0)
+    {
+        ::close(fd);
+        return false;
+    }
+    n_bytes = size_t(st.st_size);
+    opened  = true;
+
+    if(n_bytes>0)
+    {
+        void *addr = mmap(nullptr, n_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(addr!=MAP_FAILED)
+        {
+            // the file will be mostly traversed front to back
+            madvise(addr, n_bytes, MADV_SEQUENTIAL);
+            ptr       = static_cast<const char*>(addr);
+            is_mapped = true;
+            ::close(fd); // the mapping remains valid after closing the descriptor
+            return true;
+        }
+    }
+    ::close(fd);
+    if(n_bytes==0) return true;
+#endif
+
+    // fallback: read the whole file in memory
+    FILE *f = fopen(filename, "rb");
+    if(!f) return false;
+    fseek(f, 0, SEEK_END);
+    long sz = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if(sz<0)
+    {
+        fclose(f);
+        return false;
+    }
+    n_bytes = size_t(sz);
+    opened  = true;
+    buffer.resize(n_bytes);
+    if(n_bytes>0 && fread(buffer.data(), 1, n_bytes, f)!=n_bytes)
+    {
+        fclose(f);
+        close();
+        return false;
+    }
+    fclose(f);
+    ptr = buffer.data();
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MemoryMappedFile::close()
+{
+#ifdef CINO_HAS_MMAP
+    if(is_mapped) munmap(const_cast<char*>(ptr), n_bytes);
+#endif
+    buffer.clear();
+    buffer.shrink_to_fit();
+    ptr       = nullptr;
+    n_bytes   = 0;
+    is_mapped = false;
+    opened    = false;
+}
+
+}
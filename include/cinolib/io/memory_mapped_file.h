@@ -0,0 +1,91 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MEMORY_MAPPED_FILE_H
+#define CINO_MEMORY_MAPPED_FILE_H
+
+#include <sys/types.h>
+#include <vector>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Read-only view of the content of a file. On POSIX systems the file is
+ * memory mapped, so that pages are loaded lazily by the OS and multiple
+ * threads can parse disjoint portions of it without any extra copy.
+ * On other systems the file is read in memory with a single fread.
+*/
+
+class MemoryMappedFile
+{
+    public:
+
+        explicit MemoryMappedFile() {}
+        explicit MemoryMappedFile(const char * filename) { open(filename); }
+                ~MemoryMappedFile() { close(); }
+
+        MemoryMappedFile(const MemoryMappedFile &) = delete;
+        MemoryMappedFile & operator=(const MemoryMappedFile &) = delete;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool open (const char * filename);
+        void close();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool         is_open() const { return opened;  }
+        const char * data()    const { return ptr;     }
+        size_t       size()    const { return n_bytes; }
+        const char * begin()   const { return ptr;     }
+        const char * end()     const { return ptr + n_bytes; }
+
+    protected:
+
+        const char      * ptr       = nullptr;
+        size_t            n_bytes   = 0;
+        bool              is_mapped = false;
+        bool              opened    = false;
+        std::vector<char> buffer; // used only when mmap is not available
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "memory_mapped_file.cpp"
+#endif
+
+#endif // CINO_MEMORY_MAPPED_FILE_H
@@ -0,0 +1,811 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/mesh_stream_reader.h>
+#include <cinolib/io/binary_mesh.h>
+#include <cinolib/io/fast_number_parsing.h>
+#include <cinolib/string_utilities.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace cinolib
+{
+
+namespace
+{
+    // approximate heap footprint of a polygon with n vertices
+    inline size_t poly_bytes(const size_t n)
+    {
+        return sizeof(std::vector<uint>) + n*sizeof(uint) + 16;
+    }
+
+    inline bool token_is(const char * b, const char * e, const char * word)
+    {
+        size_t n = strlen(word);
+        return size_t(e-b)==n && strncmp(b, word, n)==0;
+    }
+
+    inline int seek64(FILE *fp, const uint64_t offset)
+    {
+#ifdef _WIN32
+        return _fseeki64(fp, int64_t(offset), SEEK_SET);
+#else
+        return fseeko(fp, off_t(offset), SEEK_SET);
+#endif
+    }
+
+    inline uint64_t tell64(FILE *fp)
+    {
+#ifdef _WIN32
+        return uint64_t(_ftelli64(fp));
+#else
+        return uint64_t(ftello(fp));
+#endif
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+MeshStreamReader::MeshStreamReader(const size_t memory_budget)
+    : budget(memory_budget)
+{}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+MeshStreamReader::MeshStreamReader(const char * filename, const size_t memory_budget)
+    : budget(memory_budget)
+{
+    open(filename);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+MeshStreamReader::~MeshStreamReader()
+{
+    close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t MeshStreamReader::io_buffer_size() const
+{
+    return std::min<size_t>(1024*1024, std::max<size_t>(4096, budget/8));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// each cursor gets an I/O buffer, the rest is split evenly among chunks
+//
+CINO_INLINE
+size_t MeshStreamReader::chunk_budget() const
+{
+    size_t io = 2*io_buffer_size();
+    return (budget>io) ? std::max<size_t>(1024, (budget-io)/2) : 1024;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::open(const char * filename)
+{
+    close();
+    this->filename = std::string(filename);
+
+    std::string ext = get_file_extension(this->filename);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    int fmt = NONE;
+         if(ext=="obj")  fmt = OBJ;
+    else if(ext=="off")  fmt = OFF;
+    else if(ext=="stl")  fmt = STL_ASCII;
+    else if(ext=="mesh") fmt = MESH;
+    else if(ext=="cino") fmt = CINO;
+    else
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : open() : file format not supported " << filename << std::endl;
+        return false;
+    }
+
+    if(!cursor_open(vc) || !cursor_open(pc))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : open() : couldn't open input file " << filename << std::endl;
+        close();
+        return false;
+    }
+
+    n_bytes = (fseek(vc.fp, 0, SEEK_END)==0) ? tell64(vc.fp) : 0;
+    seek64(vc.fp, 0);
+
+    if(fmt==STL_ASCII)
+    {
+        // binary STLs have an 80 bytes header, followed by the number of
+        // triangles and 50 bytes per triangle. Some binary files start with
+        // "solid" (as ASCII files do), hence the file size is a better probe
+        uint32_t nt = 0;
+        if(seek64(vc.fp, 80)==0 && fread(&nt, 4, 1, vc.fp)==1 && n_bytes==84+50*uint64_t(nt))
+        {
+            fmt    = STL_BINARY;
+            nv_tot = 3*uint64_t(nt);
+            np_tot = nt;
+            v_base = 84;
+            p_base = 84;
+        }
+    }
+    else if(fmt==CINO)
+    {
+        BinaryMeshHeader h;
+        std::vector<BinaryMeshSection> table;
+        bool ok = (fread(&h, sizeof(h), 1, vc.fp)==1) &&
+                  memcmp(h.magic, "CINOMESH", 8)==0    &&
+                  h.endianness==0x01020304             &&
+                  h.version<=CINO_BIN_VERSION;
+        if(ok)
+        {
+            table.resize(h.n_sections);
+            ok = (fread(table.data(), sizeof(BinaryMeshSection), table.size(), vc.fp)==table.size());
+        }
+        const BinaryMeshSection *sv = nullptr;
+        const BinaryMeshSection *sp = nullptr;
+        for(const auto & s : table)
+        {
+            if(s.id==BIN_VERTS)                                          sv = &s;
+            if(s.id==BIN_P2V || (s.id==BIN_POLYS && sp==nullptr)) sp = &s; // volume meshes: elements as lists of verts
+        }
+        if(!ok || sv==nullptr || sp==nullptr || sv->elem_size!=3*sizeof(double) || sp->elem_size!=0)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : open() : not a valid CinoLib binary mesh " << filename << std::endl;
+            close();
+            return false;
+        }
+        nv_tot = sv->count;
+        np_tot = sp->count;
+        v_base = sv->offset;
+        p_base = sp->offset;
+        volume = (sp->id==BIN_P2V);
+    }
+    if(fmt==MESH) volume = true;
+
+    format = fmt;
+    rewind();
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MeshStreamReader::close()
+{
+    cursor_close(vc);
+    cursor_close(pc);
+    format = NONE;
+    volume = false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MeshStreamReader::rewind()
+{
+    for(Cursor *c : { &vc, &pc })
+    {
+        if(c->fp) seek64(c->fp, 0);
+        c->beg     = 0;
+        c->end     = 0;
+        c->eof     = false;
+        c->lb      = nullptr;
+        c->le      = nullptr;
+        c->started = false;
+        c->n_read  = 0;
+        c->n_left  = 0;
+        c->arity   = 0;
+        c->keep    = false;
+        c->nv_seen = 0;
+        c->offset  = 0;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_verts(std::vector<vec3d> & verts)
+{
+    verts.clear();
+    size_t max = std::max<size_t>(1, chunk_budget()/sizeof(vec3d));
+    bool ok = false;
+    switch(format)
+    {
+        case OBJ        : ok = next_verts_OBJ (verts, max); break;
+        case OFF        : ok = next_verts_OFF (verts, max); break;
+        case STL_ASCII  :
+        case STL_BINARY : ok = next_verts_STL (verts, max); break;
+        case MESH       : ok = next_verts_MESH(verts, max); break;
+        case CINO       : ok = next_verts_CINO(verts, max); break;
+        default         : return false;
+    }
+    vc.n_read += verts.size();
+    return ok && !verts.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_polys(std::vector<std::vector<uint>> & polys)
+{
+    polys.clear();
+    size_t max_bytes = chunk_budget();
+    bool ok = false;
+    switch(format)
+    {
+        case OBJ        : ok = next_polys_OBJ (polys, max_bytes); break;
+        case OFF        : ok = next_polys_OFF (polys, max_bytes); break;
+        case STL_ASCII  :
+        case STL_BINARY : ok = next_polys_STL (polys, max_bytes); break;
+        case MESH       : ok = next_polys_MESH(polys, max_bytes); break;
+        case CINO       : ok = next_polys_CINO(polys, max_bytes); break;
+        default         : return false;
+    }
+    pc.n_read += polys.size();
+    return ok && !polys.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::cursor_open(Cursor & c)
+{
+    c.fp = fopen(filename.c_str(), "rb");
+    c.buf.resize(io_buffer_size());
+    return c.fp!=nullptr;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MeshStreamReader::cursor_close(Cursor & c)
+{
+    if(c.fp) fclose(c.fp);
+    c.fp = nullptr;
+    std::vector<char>().swap(c.buf);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// returns the next line (without the end of line character). The I/O
+// buffer is refilled as needed, and grows only if a line does not fit in it
+//
+CINO_INLINE
+bool MeshStreamReader::cursor_line(Cursor & c, const char *& b, const char *& e)
+{
+    while(true)
+    {
+        char *p = c.buf.data();
+        const char *nl = static_cast<const char*>(memchr(p+c.beg, '\n', c.end-c.beg));
+        if(nl!=nullptr)
+        {
+            b     = p+c.beg;
+            e     = nl;
+            c.beg = size_t(nl-p)+1;
+            if(e>b && *(e-1)=='\r') --e;
+            return true;
+        }
+        if(c.eof)
+        {
+            if(c.beg==c.end) return false;
+            b     = p+c.beg;
+            e     = p+c.end;
+            c.beg = c.end;
+            return true;
+        }
+        if(c.beg>0)
+        {
+            memmove(p, p+c.beg, c.end-c.beg);
+            c.end -= c.beg;
+            c.beg  = 0;
+        }
+        if(c.end==c.buf.size()) c.buf.resize(2*c.buf.size());
+        size_t n = fread(c.buf.data()+c.end, 1, c.buf.size()-c.end, c.fp);
+        if(n==0) c.eof = true;
+        c.end += n;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// returns the next blank separated token, skipping comments (#)
+//
+CINO_INLINE
+bool MeshStreamReader::cursor_token(Cursor & c, const char *& b, const char *& e)
+{
+    while(true)
+    {
+        skip_blanks(c.lb, c.le);
+        if(c.lb<c.le && *c.lb!='#')
+        {
+            b = c.lb;
+            while(c.lb<c.le && !is_blank(*c.lb)) ++c.lb;
+            e = c.lb;
+            return true;
+        }
+        if(!cursor_line(c, c.lb, c.le)) return false;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::cursor_double(Cursor & c, double & d)
+{
+    const char *b, *e;
+    return cursor_token(c, b, e) && fast_parse_double(b, e, d);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::cursor_uint(Cursor & c, uint & i)
+{
+    const char *b, *e;
+    return cursor_token(c, b, e) && fast_parse_uint(b, e, i);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::cursor_read(Cursor & c, void * dst, const size_t bytes, const uint64_t offset)
+{
+    return seek64(c.fp, offset)==0 && fread(dst, 1, bytes, c.fp)==bytes;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// bytes read from the file, minus the ones still buffered
+//
+CINO_INLINE
+double MeshStreamReader::cursor_progress(const Cursor & c) const
+{
+    if(c.fp==nullptr || n_bytes==0) return 0;
+    uint64_t pos = tell64(c.fp) - (c.end-c.beg);
+    return std::min(1.0, double(pos)/double(n_bytes));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_verts_OBJ(std::vector<vec3d> & verts, const size_t max)
+{
+    const char *b, *e;
+    while(verts.size()<max && cursor_line(vc, b, e))
+    {
+        skip_blanks(b, e);
+        if(e-b<2 || b[0]!='v' || !is_blank(b[1])) continue;
+        b += 2;
+        double xyz[3] = { 0, 0, 0 };
+        for(int i=0; i<3; ++i)
+        {
+            skip_blanks(b, e);
+            if(!fast_parse_double(b, e, xyz[i]))
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : next_verts() : failed parsing vertex " << vc.n_read+verts.size() << std::endl;
+                return false;
+            }
+        }
+        verts.push_back(vec3d(xyz[0], xyz[1], xyz[2]));
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_polys_OBJ(std::vector<std::vector<uint>> & polys, const size_t max_bytes)
+{
+    size_t bytes = 0;
+    const char *b, *e;
+    while(bytes<max_bytes && cursor_line(pc, b, e))
+    {
+        skip_blanks(b, e);
+        if(e-b<2 || !is_blank(b[1])) continue;
+        if(b[0]=='v') { ++pc.nv_seen; continue; }
+        if(b[0]!='f') continue;
+        b += 2;
+        std::vector<uint> p;
+        while(true)
+        {
+            skip_blanks(b, e);
+            if(b==e) break;
+            int vid;
+            if(!fast_parse_int(b, e, vid))
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : next_polys() : failed parsing polygon " << pc.n_read+polys.size() << std::endl;
+                return false;
+            }
+            // negative indices are relative to the last vertex read
+            p.push_back((vid<0) ? uint(int(pc.nv_seen)+vid) : uint(vid-1));
+            while(b<e && !is_blank(*b)) ++b; // skip texture and normal references
+        }
+        bytes += poly_bytes(p.size());
+        polys.push_back(p);
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::parse_OFF_header(Cursor & c, size_t & nv, size_t & np)
+{
+    const char *b, *e;
+    uint v, p, ed;
+    if(!cursor_token(c, b, e) || e-b<3 || strncmp(e-3, "OFF", 3)!=0 ||
+       !cursor_uint(c, v) || !cursor_uint(c, p) || !cursor_uint(c, ed))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : parse_OFF_header() : invalid OFF header " << filename << std::endl;
+        return false;
+    }
+    c.lb = c.le; // switch to line based parsing
+    nv = v;
+    np = p;
+    c.started = true;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_verts_OFF(std::vector<vec3d> & verts, const size_t max)
+{
+    if(!vc.started)
+    {
+        size_t np;
+        if(!parse_OFF_header(vc, vc.n_left, np)) return false;
+    }
+    const char *b, *e;
+    while(verts.size()<max && vc.n_left>0 && cursor_line(vc, b, e))
+    {
+        skip_blanks(b, e);
+        if(b==e || *b=='#') continue;
+        double xyz[3] = { 0, 0, 0 };
+        for(int i=0; i<3; ++i)
+        {
+            skip_blanks(b, e);
+            if(!fast_parse_double(b, e, xyz[i]))
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : next_verts() : failed parsing vertex " << vc.n_read+verts.size() << std::endl;
+                return false;
+            }
+        }
+        verts.push_back(vec3d(xyz[0], xyz[1], xyz[2]));
+        --vc.n_left;
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_polys_OFF(std::vector<std::vector<uint>> & polys, const size_t max_bytes)
+{
+    const char *b, *e;
+    if(!pc.started)
+    {
+        size_t nv;
+        if(!parse_OFF_header(pc, nv, pc.n_left)) return false;
+        while(nv>0 && cursor_line(pc, b, e)) // skip vertices
+        {
+            skip_blanks(b, e);
+            if(b!=e && *b!='#') --nv;
+        }
+    }
+    size_t bytes = 0;
+    while(bytes<max_bytes && pc.n_left>0 && cursor_line(pc, b, e))
+    {
+        skip_blanks(b, e);
+        if(b==e || *b=='#') continue;
+        uint n;
+        bool ok = fast_parse_uint(b, e, n);
+        std::vector<uint> p(ok ? n : 0);
+        for(uint i=0; ok && i<n; ++i)
+        {
+            skip_blanks(b, e);
+            ok = fast_parse_uint(b, e, p[i]);
+        }
+        if(!ok)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : next_polys() : failed parsing polygon " << pc.n_read+polys.size() << std::endl;
+            return false;
+        }
+        bytes += poly_bytes(p.size());
+        polys.push_back(p);
+        --pc.n_left;
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_verts_STL(std::vector<vec3d> & verts, const size_t max)
+{
+    if(format==STL_BINARY)
+    {
+        // triangle records: normal (3 floats), 3 verts (9 floats), attribute (uint16)
+        size_t nt = std::min<size_t>(nv_tot/3-vc.offset, std::max<size_t>(1, max/3));
+        if(nt==0) return true;
+        std::vector<char> tmp(50*nt);
+        if(!cursor_read(vc, tmp.data(), tmp.size(), v_base+50*vc.offset))
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : next_verts() : unexpected end of file " << filename << std::endl;
+            return false;
+        }
+        verts.reserve(3*nt);
+        for(size_t t=0; t<nt; ++t)
+        {
+            float xyz[9];
+            memcpy(xyz, tmp.data()+50*t+12, sizeof(xyz));
+            for(int i=0; i<9; i+=3) verts.push_back(vec3d(xyz[i], xyz[i+1], xyz[i+2]));
+        }
+        vc.offset += nt;
+        return true;
+    }
+
+    const char *b, *e;
+    while(verts.size()+3<=std::max<size_t>(3,max) && cursor_token(vc, b, e))
+    {
+        if(!token_is(b, e, "vertex")) continue;
+        double xyz[3];
+        if(!cursor_double(vc, xyz[0]) || !cursor_double(vc, xyz[1]) || !cursor_double(vc, xyz[2]))
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : next_verts() : failed parsing vertex " << vc.n_read+verts.size() << std::endl;
+            return false;
+        }
+        verts.push_back(vec3d(xyz[0], xyz[1], xyz[2]));
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_polys_STL(std::vector<std::vector<uint>> & polys, const size_t max_bytes)
+{
+    size_t bytes = 0;
+    const char *b, *e;
+    while(bytes<max_bytes)
+    {
+        if(format==STL_BINARY)
+        {
+            if(pc.n_read+polys.size()>=np_tot) break;
+        }
+        else
+        {
+            bool found = false;
+            while(!found && cursor_token(pc, b, e)) found = token_is(b, e, "facet");
+            if(!found) break;
+        }
+        uint t = uint(pc.n_read+polys.size());
+        polys.push_back({ 3*t, 3*t+1, 3*t+2 });
+        bytes += poly_bytes(3);
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// moves the cursor to the first item of the next section of interest:
+// the vertex list if polys is false, the next element list otherwise
+//
+CINO_INLINE
+bool MeshStreamReader::seek_MESH_section(Cursor & c, bool polys)
+{
+    const char *b, *e;
+    if(!c.started)
+    {
+        bool found = false;
+        while(!found && cursor_token(c, b, e)) found = token_is(b, e, "Vertices");
+        uint nv;
+        if(!found || !cursor_uint(c, nv))
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : seek_MESH_section() : could not find keyword Vertices " << filename << std::endl;
+            return false;
+        }
+        c.started = true;
+        c.n_left  = nv;
+        c.arity   = 3;
+        c.keep    = !polys;
+        if(!polys) return true;
+        for(size_t i=0; i<4*size_t(nv); ++i) if(!cursor_token(c, b, e)) return false; // skip vertices
+        c.n_left = 0;
+    }
+    if(!polys) return false;
+
+    while(cursor_token(c, b, e))
+    {
+        if(token_is(b, e, "End")) return false;
+
+        int  arity = -1;
+        bool label = true;
+        bool keep  = false;
+             if(token_is(b, e, "Tetrahedra"      )) { arity = 4; keep = true; }
+        else if(token_is(b, e, "Hexahedra"       )) { arity = 8; keep = true; }
+        else if(token_is(b, e, "Triangles"       )) arity = 3;
+        else if(token_is(b, e, "Quadrilaterals"  )) arity = 4;
+        else if(token_is(b, e, "Edges"           )) arity = 2;
+        else if(token_is(b, e, "Corners"         )) { arity = 1; label = false; }
+        else if(token_is(b, e, "RequiredVertices")) { arity = 1; label = false; }
+        else if(token_is(b, e, "Ridges"          )) { arity = 1; label = false; }
+        if(arity<0)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : seek_MESH_section() : unsupported section " << std::string(b,e) << std::endl;
+            return false;
+        }
+
+        uint n;
+        if(!cursor_uint(c, n)) return false;
+        c.arity  = arity;
+        c.n_left = n;
+        c.keep   = keep;
+        if(c.keep) return true;
+
+        // discard these elements
+        size_t n_tokens = size_t(n)*(arity + (label ? 1 : 0));
+        for(size_t i=0; i<n_tokens; ++i) if(!cursor_token(c, b, e)) return false;
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_verts_MESH(std::vector<vec3d> & verts, const size_t max)
+{
+    if(!vc.started && !seek_MESH_section(vc, false)) return false;
+    const char *b, *e;
+    while(verts.size()<max && vc.n_left>0)
+    {
+        double xyz[3];
+        if(!cursor_double(vc, xyz[0]) || !cursor_double(vc, xyz[1]) || !cursor_double(vc, xyz[2]) || !cursor_token(vc, b, e))
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : next_verts() : failed parsing vertex " << vc.n_read+verts.size() << std::endl;
+            return false;
+        }
+        verts.push_back(vec3d(xyz[0], xyz[1], xyz[2]));
+        --vc.n_left;
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_polys_MESH(std::vector<std::vector<uint>> & polys, const size_t max_bytes)
+{
+    size_t bytes = 0;
+    const char *b, *e;
+    while(bytes<max_bytes)
+    {
+        if(pc.n_left==0 && !seek_MESH_section(pc, true)) break;
+        if(pc.n_left==0) continue;
+        std::vector<uint> p(pc.arity);
+        for(uint & vid : p)
+        {
+            if(!cursor_uint(pc, vid) || vid==0)
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : next_polys() : failed parsing element " << pc.n_read+polys.size() << std::endl;
+                return false;
+            }
+            vid -= 1;
+        }
+        if(!cursor_token(pc, b, e)) return false; // label
+        bytes += poly_bytes(p.size());
+        polys.push_back(p);
+        --pc.n_left;
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_verts_CINO(std::vector<vec3d> & verts, const size_t max)
+{
+    size_t n = std::min<size_t>(nv_tot-vc.offset, max);
+    if(n==0) return true;
+    std::vector<double> tmp(3*n);
+    if(!cursor_read(vc, tmp.data(), tmp.size()*sizeof(double), v_base+3*sizeof(double)*vc.offset))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : next_verts() : unexpected end of file " << filename << std::endl;
+        return false;
+    }
+    verts.reserve(n);
+    for(size_t i=0; i<n; ++i) verts.push_back(vec3d(tmp[3*i], tmp[3*i+1], tmp[3*i+2]));
+    vc.offset += n;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshStreamReader::next_polys_CINO(std::vector<std::vector<uint>> & polys, const size_t max_bytes)
+{
+    // jagged arrays are stored as n+1 uint64 offsets followed by the indices
+    size_t n = std::min<size_t>(np_tot-pc.offset, std::max<size_t>(1, max_bytes/poly_bytes(1)));
+    if(n==0) return true;
+    std::vector<uint64_t> off(n+1);
+    bool ok = cursor_read(pc, off.data(), off.size()*sizeof(uint64_t), p_base+sizeof(uint64_t)*pc.offset);
+
+    // shrink the chunk to fit the budget
+    size_t bytes = 0, k = 0;
+    while(ok && k<n && (k==0 || bytes+poly_bytes(off[k+1]-off[k])<=max_bytes))
+    {
+        bytes += poly_bytes(off[k+1]-off[k]);
+        ++k;
+    }
+
+    std::vector<uint32_t> ids(ok ? off[k]-off[0] : 0);
+    uint64_t ids_base = p_base + sizeof(uint64_t)*(np_tot+1);
+    ok = ok && cursor_read(pc, ids.data(), ids.size()*sizeof(uint32_t), ids_base+sizeof(uint32_t)*off[0]);
+    if(!ok)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : next_polys() : unexpected end of file " << filename << std::endl;
+        return false;
+    }
+    polys.resize(k);
+    for(size_t i=0; i<k; ++i)
+    {
+        polys[i].assign(ids.begin()+(off[i]-off[0]), ids.begin()+(off[i+1]-off[0]));
+    }
+    pc.offset += k;
+    return true;
+}
+
+}
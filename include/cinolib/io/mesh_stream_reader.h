@@ -0,0 +1,183 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MESH_STREAM_READER_H
+#define CINO_MESH_STREAM_READER_H
+
+#include <sys/types.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+
+namespace cinolib
+{
+
+/* Out of core reader for large meshes. Vertices and elements are yielded in
+ * chunks of bounded size, and the overall memory footprint (I/O buffers and
+ * chunks) stays within a user defined budget, regardless of the mesh size.
+ * Supported formats are OBJ, OFF, STL, MESH and the native binary format (.cino).
+ *
+ * Vertices and elements are read through two independent cursors, hence the
+ * two streams can be consumed in any order, and interleaved. Element indices
+ * are global (i.e. they refer to the whole vertex stream). Notes:
+ *
+ *   - STL files are yielded as triangle soups (each triangle refers to its own
+ *     three vertices), because merging duplicated vertices requires a global map
+ *   - MESH files yield Tetrahedra and Hexahedra, consistently with read_MESH
+ *   - .cino volume meshes yield the polyhedra as lists of vertices (p2v)
+ *
+ * Typical usage:
+ *
+ *     MeshStreamReader s(filename, 256*1024*1024);
+ *     std::vector<vec3d> verts;
+ *     while(s.next_verts(verts)) { ... }
+ *     std::vector<std::vector<uint>> polys;
+ *     while(s.next_polys(polys)) { ... }
+*/
+
+static const size_t CINO_STREAM_DEFAULT_BUDGET = 64*1024*1024; // bytes
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class MeshStreamReader
+{
+    public:
+
+        explicit MeshStreamReader(const size_t memory_budget = CINO_STREAM_DEFAULT_BUDGET);
+        explicit MeshStreamReader(const char * filename, const size_t memory_budget = CINO_STREAM_DEFAULT_BUDGET);
+                ~MeshStreamReader();
+
+        MeshStreamReader(const MeshStreamReader &) = delete;
+        MeshStreamReader & operator=(const MeshStreamReader &) = delete;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool open(const char * filename);
+        void close();
+        void rewind();
+        bool is_open() const { return format!=NONE; }
+
+        // true if elements are polyhedra (MESH files and .cino volume meshes)
+        bool is_volume() const { return volume; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // fill the input vector with the next chunk. Return false at the end of the stream
+        bool next_verts(std::vector<vec3d>             & verts);
+        bool next_polys(std::vector<std::vector<uint>> & polys);
+
+        // number of items yielded so far, i.e. the global id of the first item of the next chunk
+        uint verts_read() const { return uint(vc.n_read); }
+        uint polys_read() const { return uint(pc.n_read); }
+
+        // fraction of the file consumed by the vertex and element cursors (e.g. to report progress)
+        double verts_progress() const { return cursor_progress(vc); }
+        double polys_progress() const { return cursor_progress(pc); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        size_t memory_budget() const { return budget; }
+        size_t io_buffer_size() const;
+        size_t chunk_budget() const;
+
+    protected:
+
+        enum { NONE, OBJ, OFF, STL_ASCII, STL_BINARY, MESH, CINO };
+
+        // a buffered view of the input file. Only a window of the file
+        // (of size io_buffer_size) is kept in memory at any time
+        struct Cursor
+        {
+            FILE              * fp       = nullptr;
+            std::vector<char>   buf;
+            size_t              beg      = 0;       // valid data is in buf[beg,end)
+            size_t              end      = 0;
+            bool                eof      = false;
+            const char        * lb       = nullptr; // current line (token level access)
+            const char        * le       = nullptr;
+            bool                started  = false;   // header parsed
+            size_t              n_read   = 0;       // items yielded so far
+            size_t              n_left   = 0;       // items left in the current section/block
+            int                 arity    = 0;       // MESH only: #vids per element of the current section
+            bool                keep     = false;   // MESH only: whether the current section is yielded
+            size_t              nv_seen  = 0;       // OBJ only: #verts before the current line
+            uint64_t            offset   = 0;       // binary only: index of the next item
+        };
+
+        bool cursor_open    (Cursor & c);
+        void cursor_close   (Cursor & c);
+        bool cursor_line    (Cursor & c, const char *& b, const char *& e);
+        bool cursor_token   (Cursor & c, const char *& b, const char *& e);
+        bool cursor_double  (Cursor & c, double & d);
+        bool cursor_uint    (Cursor & c, uint & i);
+        bool cursor_read    (Cursor & c, void * dst, const size_t bytes, const uint64_t offset);
+        double cursor_progress(const Cursor & c) const;
+
+        bool parse_OFF_header (Cursor & c, size_t & nv, size_t & np);
+        bool seek_MESH_section(Cursor & c, bool polys);
+
+        bool next_verts_OBJ (std::vector<vec3d>             & verts, const size_t max);
+        bool next_polys_OBJ (std::vector<std::vector<uint>> & polys, const size_t max_bytes);
+        bool next_verts_OFF (std::vector<vec3d>             & verts, const size_t max);
+        bool next_polys_OFF (std::vector<std::vector<uint>> & polys, const size_t max_bytes);
+        bool next_verts_STL (std::vector<vec3d>             & verts, const size_t max);
+        bool next_polys_STL (std::vector<std::vector<uint>> & polys, const size_t max_bytes);
+        bool next_verts_MESH(std::vector<vec3d>             & verts, const size_t max);
+        bool next_polys_MESH(std::vector<std::vector<uint>> & polys, const size_t max_bytes);
+        bool next_verts_CINO(std::vector<vec3d>             & verts, const size_t max);
+        bool next_polys_CINO(std::vector<std::vector<uint>> & polys, const size_t max_bytes);
+
+        std::string filename;
+        size_t      budget;
+        int         format = NONE;
+        bool        volume = false;
+        Cursor      vc;       // vertex cursor
+        Cursor      pc;       // element cursor
+        uint64_t    nv_tot;   // binary only: #verts (or #triangles, for STL)
+        uint64_t    np_tot;   // binary only: #elements
+        uint64_t    v_base;   // binary only: file offset of the first vertex
+        uint64_t    p_base;   // binary only: file offset of the first element
+        uint64_t    n_bytes = 0; // file size
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "mesh_stream_reader.cpp"
+#endif
+
+#endif // CINO_MESH_STREAM_READER_H
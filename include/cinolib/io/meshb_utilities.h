@@ -0,0 +1,126 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MESHB_UTILITIES_H
+#define CINO_MESHB_UTILITIES_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+namespace meshb
+{
+    // keyword codes of the binary Medit format (see libMeshb, GmfKwdCod)
+    enum
+    {
+        DIMENSION      = 3,
+        VERTICES       = 4,
+        EDGES          = 5,
+        TRIANGLES      = 6,
+        QUADRILATERALS = 7,
+        TETRAHEDRA     = 8,
+        HEXAHEDRA      = 10,
+        END            = 54
+    };
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    /* Width of the binary words, which depends on the file version:
+     *
+     *   version 1: float reals, 32 bit integers, 32 bit file positions
+     *   version 2: double reals, 32 bit integers, 32 bit file positions (files < 2GB)
+     *   version 3: double reals, 32 bit integers, 64 bit file positions
+     *   version 4: double reals, 64 bit integers, 64 bit file positions
+     *
+     * Every file starts with the 32 bit integer 1 (used to detect endianness)
+     * and the version number. Then a list of keywords follows. Each keyword is
+     * made of its code, the position of the next keyword, the number of lines
+     * and a binary block of lines of fixed size (see libMeshb for details).
+    */
+
+    struct Format
+    {
+        explicit Format(const int version = 2, const bool swap = false) : version(version), swap(swap)
+        {
+            real_w = (version==1) ? 4 : 8;
+            int_w  = (version==4) ? 8 : 4;
+            pos_w  = (version>=3) ? 8 : 4;
+        }
+
+        int  version;
+        bool swap;   // file endianness differs from the host
+        int  real_w; // bytes per real
+        int  int_w;  // bytes per integer (indices, refs and number of lines)
+        int  pos_w;  // bytes per file position
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<typename T>
+        T get(const char * p) const
+        {
+            T val;
+            memcpy(&val, p, sizeof(T));
+            if(swap) std::reverse((char*)&val, (char*)&val + sizeof(T));
+            return val;
+        }
+
+        int64_t get_int (const char * p) const { return (int_w==4)  ? get<int32_t>(p) : get<int64_t>(p); }
+        int64_t get_pos (const char * p) const { return (pos_w==4)  ? get<int32_t>(p) : get<int64_t>(p); }
+        double  get_real(const char * p) const { return (real_w==4) ? get<float>(p)   : get<double>(p);  }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // files are always written with the endianness of the host
+        template<typename T>
+        char * put(char * p, const T val) const
+        {
+            memcpy(p, &val, sizeof(T));
+            return p + sizeof(T);
+        }
+
+        char * put_int (char * p, const int64_t i) const { return (int_w==4)  ? put(p, int32_t(i)) : put(p, i); }
+        char * put_pos (char * p, const int64_t i) const { return (pos_w==4)  ? put(p, int32_t(i)) : put(p, i); }
+        char * put_real(char * p, const double  d) const { return (real_w==4) ? put(p, float(d))   : put(p, d); }
+    };
+}
+
+}
+
+#endif // CINO_MESHB_UTILITIES_H
@@ -43,16 +43,13 @@ namespace cinolib
 {
 
 CINO_INLINE
-void read_MESH(const char                     * filename,
-               std::vector<vec3d>             & verts,
-               std::vector<std::vector<uint>> & polys,
-               std::vector<int>               & vert_labels,
-               std::vector<int>               & poly_labels)
+void read_MESH(const char * filename,
+               IOData     & data)
 {
-    verts.clear();
-    polys.clear();
-    vert_labels.clear();
-    poly_labels.clear();
+    data.clear();
+    std::vector<vec3d> & verts       = data.verts;
+    std::vector<int>   & vert_labels = data.vert_labels;
+    std::vector<int>   & poly_labels = data.poly_labels;
 
     setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
 
@@ -112,7 +109,7 @@ void read_MESH(const char                     * filename,
             for(int i=0; i<nc; ++i)
             {
                 int l;
-                std::vector<uint> tet(4);
+                uint tet[4];
                 if(!eat_uint(f, tet[0]) ||
                    !eat_uint(f, tet[1]) ||
                    !eat_uint(f, tet[2]) ||
@@ -120,7 +117,7 @@ void read_MESH(const char                     * filename,
                    !eat_int(f, l)) assert(false && "failed reading tet");
 
                 for(uint & vid : tet) vid -= 1;
-                polys.push_back(tet);
+                data.poly_add(tet, 4);
                 poly_labels.push_back(l);
                 p_unique_labels.insert(l);
             }
@@ -131,7 +128,7 @@ void read_MESH(const char                     * filename,
             for(int i=0; i<nc; ++i)
             {
                 int l;
-                std::vector<uint> hex(8);                
+                uint hex[8];
                 if(!eat_uint(f, hex[0]) ||
                    !eat_uint(f, hex[1]) ||
                    !eat_uint(f, hex[2]) ||
@@ -143,7 +140,7 @@ void read_MESH(const char                     * filename,
                    !eat_int(f, l)) assert(false && "failed reading hexa");
 
                 for(uint & vid : hex) vid -= 1;
-                polys.push_back(hex);
+                data.poly_add(hex, 8);
                 poly_labels.push_back(l);
                 p_unique_labels.insert(l);
             }
@@ -205,6 +202,23 @@ void read_MESH(const char                     * filename,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+void read_MESH(const char                     * filename,
+               std::vector<vec3d>             & verts,
+               std::vector<std::vector<uint>> & polys,
+               std::vector<int>               & vert_labels,
+               std::vector<int>               & poly_labels)
+{
+    IOData data;
+    read_MESH(filename, data);
+    polys       = data.polys();
+    verts       = std::move(data.verts);
+    vert_labels = std::move(data.vert_labels);
+    poly_labels = std::move(data.poly_labels);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void read_MESH(const char                     * filename,
                std::vector<vec3d>             & verts,
@@ -40,11 +40,18 @@
 #include <vector>
 #include <cinolib/cino_inline.h>
 #include <cinolib/geometry/vec_mat.h>
+#include <cinolib/io/io_data.h>
 
 
 namespace cinolib
 {
 
+CINO_INLINE
+void read_MESH(const char * filename,
+               IOData     & data);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void read_MESH(const char                     * filename,
                std::vector<vec3d>             & verts,
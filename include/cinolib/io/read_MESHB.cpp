@@ -0,0 +1,275 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/read_MESHB.h>
+#include <cinolib/io/meshb_utilities.h>
+#include <cinolib/io/memory_mapped_file.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+
+namespace cinolib
+{
+
+namespace meshb
+{
+    // appends n elements with npe vertices each (plus their refs), reading them from a keyword block
+    inline void read_elements(const Format                   & fmt,
+                              const char                     * data,
+                              const size_t                     n,
+                              const uint                       npe,
+                              std::vector<std::vector<uint>> & elems,
+                              std::vector<int>               & labels)
+    {
+        size_t off = elems.size();
+        size_t row = (npe+1)*fmt.int_w;
+        elems.resize(off+n);
+        labels.resize(off+n);
+        PARALLEL_FOR(0, uint(n), 10000, [&](const uint i)
+        {
+            const char * p = data + i*row;
+            std::vector<uint> & e = elems[off+i];
+            e.resize(npe);
+            for(uint j=0; j<npe; ++j) e[j] = uint(fmt.get_int(p + j*fmt.int_w) - 1);
+            labels[off+i] = int(fmt.get_int(p + npe*fmt.int_w));
+        });
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    inline bool refer_to_existing_verts(const std::vector<std::vector<uint>> & elems, const size_t nv)
+    {
+        std::atomic<bool> ok(true);
+        PARALLEL_FOR(0, uint(elems.size()), 10000, [&](const uint i)
+        {
+            for(uint vid : elems[i]) if(vid>=nv) ok = false;
+        });
+        return ok;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    inline void discard_if_constant(std::vector<int> & labels)
+    {
+        if(std::adjacent_find(labels.begin(), labels.end(), std::not_equal_to<int>())==labels.end()) labels.clear();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_MESHB(const char                     * filename,
+                std::vector<vec3d>             & verts,
+                std::vector<int>               & vert_labels,
+                std::vector<std::vector<uint>> & edges,
+                std::vector<int>               & edge_labels,
+                std::vector<std::vector<uint>> & faces,
+                std::vector<int>               & face_labels,
+                std::vector<std::vector<uint>> & polys,
+                std::vector<int>               & poly_labels)
+{
+    verts.clear();
+    vert_labels.clear();
+    edges.clear();
+    edge_labels.clear();
+    faces.clear();
+    face_labels.clear();
+    polys.clear();
+    poly_labels.clear();
+
+    MemoryMappedFile f(filename);
+    if(!f.is_open())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_MESHB() : couldn't open input file " << filename << std::endl;
+        exit(-1);
+    }
+
+    const char * beg  = f.begin();
+    size_t       size = f.size();
+
+    // header: the integer 1 (to detect endianness) and the file version
+    //
+    meshb::Format fmt;
+    if(size>=8)
+    {
+        meshb::Format native(2,false), swapped(2,true);
+        if     (native.get <int32_t>(beg)==1) fmt = meshb::Format(native.get <int32_t>(beg+4), false);
+        else if(swapped.get<int32_t>(beg)==1) fmt = meshb::Format(swapped.get<int32_t>(beg+4), true);
+        else fmt.version = 0;
+    }
+    if(size<8 || fmt.version<1 || fmt.version>4)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_MESHB() : not a valid .meshb file " << filename << std::endl;
+        return;
+    }
+
+    // keywords
+    //
+    bool   ok  = true;
+    int    dim = 3;
+    size_t p   = 8;
+    while(ok && p+4+fmt.pos_w<=size)
+    {
+        int     kwd  = fmt.get<int32_t>(beg+p);
+        int64_t next = fmt.get_pos(beg+p+4);
+        p += 4+fmt.pos_w;
+
+        if(kwd==meshb::END) break;
+        if(next<0 || size_t(next)>size) { ok = false; break; }
+
+        // size of each line and number of vertices per element
+        size_t row = 0;
+        uint   npe = 0;
+        switch(kwd)
+        {
+            case meshb::DIMENSION      : if(p+4<=size) dim = fmt.get<int32_t>(beg+p);
+                                         ok = (dim==2 || dim==3);
+                                         break;
+            case meshb::VERTICES       : row = dim*fmt.real_w + fmt.int_w; break;
+            case meshb::EDGES          : npe = 2; break;
+            case meshb::TRIANGLES      : npe = 3; break;
+            case meshb::QUADRILATERALS : npe = 4; break;
+            case meshb::TETRAHEDRA     : npe = 4; break;
+            case meshb::HEXAHEDRA      : npe = 8; break;
+            default                    : break;
+        }
+        if(npe>0) row = (npe+1)*fmt.int_w;
+
+        if(row>0)
+        {
+            if(p+fmt.int_w>size) { ok = false; break; }
+            int64_t n = fmt.get_int(beg+p);
+            p += fmt.int_w;
+            if(n<0 || size_t(n)>(size-p)/row) { ok = false; break; }
+            const char * data = beg+p;
+            p += n*row;
+
+            switch(kwd)
+            {
+                case meshb::VERTICES :
+                {
+                    size_t off = verts.size();
+                    verts.resize(off+n);
+                    vert_labels.resize(off+n);
+                    PARALLEL_FOR(0, uint(n), 10000, [&](const uint vid)
+                    {
+                        const char * v = data + vid*row;
+                        for(int i=0; i<dim; ++i) verts[off+vid][i] = fmt.get_real(v + i*fmt.real_w);
+                        if(dim==2) verts[off+vid][2] = 0;
+                        vert_labels[off+vid] = int(fmt.get_int(v + dim*fmt.real_w));
+                    });
+                    break;
+                }
+                case meshb::EDGES          : meshb::read_elements(fmt, data, n, npe, edges, edge_labels); break;
+                case meshb::TRIANGLES      :
+                case meshb::QUADRILATERALS : meshb::read_elements(fmt, data, n, npe, faces, face_labels); break;
+                case meshb::TETRAHEDRA     :
+                case meshb::HEXAHEDRA      : meshb::read_elements(fmt, data, n, npe, polys, poly_labels); break;
+            }
+        }
+
+        if(next==0) break; // last keyword
+        p = size_t(next);
+    }
+
+    if(ok)
+    {
+        ok = meshb::refer_to_existing_verts(edges, verts.size()) &&
+             meshb::refer_to_existing_verts(faces, verts.size()) &&
+             meshb::refer_to_existing_verts(polys, verts.size());
+    }
+    if(!ok)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_MESHB() : corrupted file " << filename << std::endl;
+        verts.clear();
+        vert_labels.clear();
+        edges.clear();
+        edge_labels.clear();
+        faces.clear();
+        face_labels.clear();
+        polys.clear();
+        poly_labels.clear();
+        return;
+    }
+
+    meshb::discard_if_constant(vert_labels);
+    meshb::discard_if_constant(edge_labels);
+    meshb::discard_if_constant(face_labels);
+    meshb::discard_if_constant(poly_labels);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_MESHB(const char                     * filename,
+                std::vector<vec3d>             & verts,
+                std::vector<std::vector<uint>> & polys,
+                std::vector<int>               & vert_labels,
+                std::vector<int>               & poly_labels)
+{
+    std::vector<std::vector<uint>> edges, faces;
+    std::vector<int>               edge_labels, face_labels;
+    read_MESHB(filename, verts, vert_labels, edges, edge_labels, faces, face_labels, polys, poly_labels);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_MESHB(const char                     * filename,
+                std::vector<vec3d>             & verts,
+                std::vector<std::vector<uint>> & polys)
+{
+    std::vector<int> vert_labels, poly_labels;
+    read_MESHB(filename, verts, polys, vert_labels, poly_labels);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_MESHB(const char * filename,
+                IOData     & data,
+                const int    dim)
+{
+    data.clear();
+    std::vector<std::vector<uint>> edges, faces, polys;
+    std::vector<int>               edge_labels, face_labels, poly_labels;
+    read_MESHB(filename, data.verts, data.vert_labels, edges, edge_labels, faces, face_labels, polys, poly_labels);
+    data.set_polys((dim==2) ? faces : polys);
+    data.poly_labels = std::move((dim==2) ? face_labels : poly_labels);
+}
+
+}
@@ -0,0 +1,100 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_READ_MESHB_H
+#define CINO_READ_MESHB_H
+
+#include <sys/types.h>
+#include <vector>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+#include <cinolib/io/io_data.h>
+
+namespace cinolib
+{
+
+/* Reader for the binary Medit format (.meshb, versions 1 to 4, as written
+ * by libMeshb based tools such as MMG). Each keyword block is parsed directly
+ * from the memory mapped file, and keywords other than vertices, edges,
+ * triangles, quadrilaterals, tetrahedra and hexahedra are skipped using the
+ * position of the next keyword stored in the file. As in read_MESH, refs
+ * are returned as labels, and labels that are all equal are discarded.
+ * Faces contain both triangles and quads, polys both tets and hexa.
+*/
+
+CINO_INLINE
+void read_MESHB(const char                     * filename,
+                std::vector<vec3d>             & verts,
+                std::vector<int>               & vert_labels,
+                std::vector<std::vector<uint>> & edges,
+                std::vector<int>               & edge_labels,
+                std::vector<std::vector<uint>> & faces,
+                std::vector<int>               & face_labels,
+                std::vector<std::vector<uint>> & polys,
+                std::vector<int>               & poly_labels);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_MESHB(const char                     * filename,
+                std::vector<vec3d>             & verts,
+                std::vector<std::vector<uint>> & polys,
+                std::vector<int>               & vert_labels,
+                std::vector<int>               & poly_labels);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_MESHB(const char                     * filename,
+                std::vector<vec3d>             & verts,
+                std::vector<std::vector<uint>> & polys);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// elements of dimension dim (2 for triangles and quads, 3 for tets and hexa)
+// are stored in data as polys. Elements of other dimensions are discarded
+//
+CINO_INLINE
+void read_MESHB(const char * filename,
+                IOData     & data,
+                const int    dim = 3);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "read_MESHB.cpp"
+#endif
+
+#endif // CINO_READ_MESHB_H
@@ -0,0 +1,388 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/read_MSH.h>
+#include <cinolib/io/memory_mapped_file.h>
+#include <cinolib/io/fast_number_parsing.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+
+namespace cinolib
+{
+
+namespace msh
+{
+    // Gmsh element types (see https://gmsh.info/doc/texinfo/gmsh.html#MSH-file-format)
+    enum { TET = 4, HEX = 5 };
+
+    // number of nodes of each element type, needed to skip the unused ones
+    inline int nodes_per_element(const int type)
+    {
+        static const int n_nodes[] =
+        {
+            -1, 2, 3, 4, 4, 8, 6, 5,  // 1st order (line, tri, quad, tet, hex, prism, pyramid)
+            3, 6, 9, 10, 27, 18, 14,  // 2nd order (complete)
+            1,                        // point
+            8, 20, 15, 13             // 2nd order (incomplete)
+        };
+        return (type>0 && type<20) ? n_nodes[type] : -1;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // reads the content of a memory mapped MSH file, either as text or as binary data
+    struct Cursor
+    {
+        const char * p;
+        const char * end;
+        bool         binary = false;
+
+        void skip_spaces() { while(p<end && isspace(*p)) ++p; }
+
+        bool get(double & d)
+        {
+            if(binary) return get_binary(d);
+            skip_spaces();
+            return fast_parse_double(p, end, d);
+        }
+
+        bool get(int & i)
+        {
+            if(binary) return get_binary(i);
+            skip_spaces();
+            return fast_parse_int(p, end, i);
+        }
+
+        bool get(size_t & i)
+        {
+            if(binary) return get_binary(i);
+            skip_spaces();
+            if(p==end || *p<'0' || *p>'9') return false;
+            for(i=0; p<end && *p>='0' && *p<='9'; ++p) i = i*10 + size_t(*p-'0');
+            return true;
+        }
+
+        template<typename T>
+        bool get_binary(T & val)
+        {
+            if(p+sizeof(T)>end) return false;
+            memcpy(&val, p, sizeof(T));
+            p += sizeof(T);
+            return true;
+        }
+
+        // reads n consecutive values into a flat buffer (a single copy for binary data)
+        template<typename T>
+        bool get(T * dst, const size_t n)
+        {
+            if(binary)
+            {
+                if(p+n*sizeof(T)>end) return false;
+                memcpy(dst, p, n*sizeof(T));
+                p += n*sizeof(T);
+                return true;
+            }
+            for(size_t i=0; i<n; ++i) if(!get(dst[i])) return false;
+            return true;
+        }
+
+        // moves to the next section header (e.g. "$Nodes") and returns its name
+        bool next_section(std::string & name)
+        {
+            skip_spaces();
+            if(p==end) return false;
+            if(*p!='$')
+            {
+                const char * s = "\n$";
+                p = std::search(p, end, s, s+2);
+                if(p==end) return false;
+                ++p;
+            }
+            const char * beg = ++p;
+            while(p<end && !isspace(*p)) ++p;
+            name.assign(beg, p);
+            while(p<end && *p!='\n') ++p; // binary data starts right after the newline
+            if(p<end) ++p;
+            return true;
+        }
+
+        // moves past the end of the current section
+        bool end_section(const std::string & name)
+        {
+            std::string tag = "$End" + name;
+            p = std::search(p, end, tag.begin(), tag.end());
+            if(p==end) return false;
+            p += tag.size();
+            return true;
+        }
+    };
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_MSH(const char * filename,
+              IOData     & data)
+{
+    data.clear();
+
+    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+
+    MemoryMappedFile f(filename);
+    if(!f.is_open())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_MSH() : couldn't open input file " << filename << std::endl;
+        exit(-1);
+    }
+
+    auto error = [&](const std::string & msg)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_MSH() : " << msg << " (" << filename << ")" << std::endl;
+        data.clear();
+    };
+
+    msh::Cursor c;
+    c.p   = f.begin();
+    c.end = f.end();
+
+    std::unordered_map<int,int> volume_label;  // physical tag of each volume entity
+    std::vector<size_t>         node_tags;
+    std::vector<double>         xyz;
+    std::vector<size_t>         elem_tags;     // volume elements only
+    std::vector<size_t>         elem_nodes;    // node tags, 8 per element (tets use the first 4)
+    std::vector<uint8_t>        elem_size;
+    std::vector<int>            elem_entity;
+
+    std::string section;
+    while(c.next_section(section))
+    {
+        if(section=="MeshFormat")
+        {
+            double version;
+            int    file_type, data_size;
+            if(!c.get(version) || !c.get(file_type) || !c.get(data_size)) { error("bad header"); return; }
+            if(version<4.1 || version>=5.0) { error("only MSH 4.1 is supported"); return; }
+            if(data_size!=sizeof(size_t))   { error("unsupported data size"); return; }
+            if(file_type==1)
+            {
+                while(c.p<c.end && *c.p!='\n') ++c.p;
+                ++c.p;
+                c.binary = true;
+                int one;
+                if(!c.get(one) || one!=1) { error("unsupported endianness"); return; }
+            }
+        }
+        else if(section=="Entities")
+        {
+            size_t n[4];
+            if(!c.get(n,4)) { error("bad entities"); return; }
+            for(int dim=0; dim<4; ++dim)
+            {
+                for(size_t i=0; i<n[dim]; ++i)
+                {
+                    int    tag;
+                    double bbox[6];
+                    size_t n_phys;
+                    if(!c.get(tag) || !c.get(bbox, (dim==0) ? 3 : 6) || !c.get(n_phys)) { error("bad entities"); return; }
+                    std::vector<int> phys(n_phys);
+                    if(!c.get(phys.data(), n_phys)) { error("bad entities"); return; }
+                    if(dim>0)
+                    {
+                        size_t n_bound;
+                        if(!c.get(n_bound)) { error("bad entities"); return; }
+                        std::vector<int> bound(n_bound);
+                        if(!c.get(bound.data(), n_bound)) { error("bad entities"); return; }
+                    }
+                    if(dim==3 && !phys.empty()) volume_label[tag] = phys.front()-1;
+                }
+            }
+        }
+        else if(section=="Nodes")
+        {
+            size_t n_blocks, n_nodes, min_tag, max_tag;
+            if(!c.get(n_blocks) || !c.get(n_nodes) || !c.get(min_tag) || !c.get(max_tag)) { error("bad nodes"); return; }
+            node_tags.resize(n_nodes);
+            xyz.resize(3*n_nodes);
+            size_t off = 0;
+            for(size_t b=0; b<n_blocks; ++b)
+            {
+                int    dim, tag, parametric;
+                size_t n;
+                if(!c.get(dim) || !c.get(tag) || !c.get(parametric) || !c.get(n) || off+n>n_nodes) { error("bad nodes"); return; }
+                if(parametric!=0) { error("parametric nodes are not supported"); return; }
+                if(!c.get(node_tags.data()+off, n) || !c.get(xyz.data()+3*off, 3*n)) { error("bad nodes"); return; }
+                off += n;
+            }
+        }
+        else if(section=="Elements")
+        {
+            size_t n_blocks, n_elems, min_tag, max_tag;
+            if(!c.get(n_blocks) || !c.get(n_elems) || !c.get(min_tag) || !c.get(max_tag)) { error("bad elements"); return; }
+            std::vector<size_t> buf;
+            for(size_t b=0; b<n_blocks; ++b)
+            {
+                int    dim, tag, type;
+                size_t n;
+                if(!c.get(dim) || !c.get(tag) || !c.get(type) || !c.get(n)) { error("bad elements"); return; }
+                int npe = msh::nodes_per_element(type);
+                if(npe<0) { error("unsupported element type " + std::to_string(type)); return; }
+
+                // [tag, node tags...] for each element, in one go
+                buf.resize(n*(1+npe));
+                if(!c.get(buf.data(), buf.size())) { error("bad elements"); return; }
+                if(type!=msh::TET && type!=msh::HEX) continue;
+
+                size_t base = elem_tags.size();
+                elem_tags.resize(base+n);
+                elem_nodes.resize(8*(base+n));
+                elem_size.resize(base+n, uint8_t(npe));
+                elem_entity.resize(base+n, tag);
+                PARALLEL_FOR(0, uint(n), 100000, [&](const uint i)
+                {
+                    const size_t * e = buf.data() + i*(1+npe);
+                    elem_tags[base+i] = e[0];
+                    std::copy(e+1, e+1+npe, elem_nodes.begin() + 8*(base+i));
+                });
+            }
+        }
+        if(!c.end_section(section)) { error("missing $End" + section); return; }
+    }
+
+    // vertices are sorted by node tag. Tags are mapped to vertex ids
+    // with a lookup table if they are dense enough, with a hash map otherwise
+    //
+    size_t nv = node_tags.size();
+    std::vector<uint> order(nv);
+    std::iota(order.begin(), order.end(), 0);
+    if(!std::is_sorted(node_tags.begin(), node_tags.end()))
+    {
+        std::sort(order.begin(), order.end(), [&](const uint a, const uint b) { return node_tags[a] < node_tags[b]; });
+    }
+    data.verts.resize(nv);
+    PARALLEL_FOR(0, uint(nv), 100000, [&](const uint vid)
+    {
+        const double * p = xyz.data() + 3*order[vid];
+        data.verts[vid] = vec3d(p[0], p[1], p[2]);
+    });
+
+    size_t max_tag = nv>0 ? *std::max_element(node_tags.begin(), node_tags.end()) : 0;
+    std::vector<uint> tag_to_vid;
+    std::unordered_map<size_t,uint> tag_to_vid_map;
+    bool dense = (max_tag <= 4*nv + 1024);
+    if(dense)
+    {
+        tag_to_vid.resize(max_tag+1, uint(-1));
+        for(uint vid=0; vid<nv; ++vid) tag_to_vid[node_tags[order[vid]]] = vid;
+    }
+    else
+    {
+        for(uint vid=0; vid<nv; ++vid) tag_to_vid_map[node_tags[order[vid]]] = vid;
+    }
+    auto vid_of = [&](const size_t tag) -> uint
+    {
+        if(dense) return (tag<tag_to_vid.size()) ? tag_to_vid[tag] : uint(-1);
+        auto it = tag_to_vid_map.find(tag);
+        return (it!=tag_to_vid_map.end()) ? it->second : uint(-1);
+    };
+
+    // polyhedra are sorted by element tag
+    //
+    size_t np = elem_tags.size();
+    order.resize(np);
+    std::iota(order.begin(), order.end(), 0);
+    if(!std::is_sorted(elem_tags.begin(), elem_tags.end()))
+    {
+        std::sort(order.begin(), order.end(), [&](const uint a, const uint b) { return elem_tags[a] < elem_tags[b]; });
+    }
+    data.poly_offsets.resize(np+1);
+    for(uint pid=0; pid<np; ++pid) data.poly_offsets[pid+1] = data.poly_offsets[pid] + elem_size[order[pid]];
+    data.poly_vids.resize(data.poly_offsets.back());
+    std::atomic<bool> ok(true);
+    PARALLEL_FOR(0, uint(np), 100000, [&](const uint pid)
+    {
+        uint e    = order[pid];
+        uint *vid = data.poly_vids.data() + data.poly_offsets[pid];
+        for(uint i=0; i<elem_size[e]; ++i)
+        {
+            vid[i] = vid_of(elem_nodes[8*e+i]);
+            if(vid[i]==uint(-1)) ok = false;
+        }
+    });
+    if(!ok) { error("elements reference missing nodes"); return; }
+
+    if(!volume_label.empty())
+    {
+        data.poly_labels.resize(np);
+        for(uint pid=0; pid<np; ++pid)
+        {
+            auto it = volume_label.find(elem_entity[order[pid]]);
+            data.poly_labels[pid] = (it!=volume_label.end()) ? it->second : -1;
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_MSH(const char                     * filename,
+              std::vector<vec3d>             & verts,
+              std::vector<std::vector<uint>> & polys,
+              std::vector<int>               & poly_labels)
+{
+    IOData data;
+    read_MSH(filename, data);
+    polys       = data.polys();
+    verts       = std::move(data.verts);
+    poly_labels = std::move(data.poly_labels);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_MSH(const char                     * filename,
+              std::vector<vec3d>             & verts,
+              std::vector<std::vector<uint>> & polys)
+{
+    std::vector<int> poly_labels;
+    read_MSH(filename, verts, polys, poly_labels);
+}
+
+}
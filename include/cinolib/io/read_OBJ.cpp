@@ -42,8 +42,13 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/io/read_OBJ.h>
+#include <cinolib/io/memory_mapped_file.h>
+#include <cinolib/io/fast_number_parsing.h>
 #include <cinolib/to_openGL_unified_verts.h>
 #include <cinolib/string_utilities.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <thread>
 #include <sstream>
 #include <iostream>
 #include <fstream>
@@ -54,12 +59,37 @@
 namespace cinolib
 {
 
+// usemtl/mtllib directive found while parsing a chunk of an OBJ file
+//
+struct OBJ_event
+{
+    bool        is_mtllib;
+    std::string arg;            // material name (usemtl) or file path (mtllib)
+    uint        n_polys_before; // number of polygons in the chunk preceding the directive
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// output of the parser for a portion of an OBJ file. Vertices are
+// serialized (xyz,xyz,...). Polygons are serialized and indexed by offsets
+//
+struct OBJ_chunk
+{
+    std::vector<double>    pos, tex, nor;
+    std::vector<uint>      poly_pos, poly_pos_off;
+    std::vector<uint>      poly_tex, poly_tex_off;
+    std::vector<uint>      poly_nor, poly_nor_off;
+    std::vector<uint>      face_lab;     // number of groups preceding each face, within the chunk
+    uint                   n_groups = 0;
+    std::vector<OBJ_event> events;
+};
+
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 // https://stackoverflow.com/questions/9310327/sscanf-optional-column
 //
 CINO_INLINE
-void read_point_id(char * s, int & v, int & vt, int & vn)
+void read_point_id(const char * s, int & v, int & vt, int & vn)
 {
     v = vt = vn = -1;
          if(sscanf(s, "%d/%d/%d", &v, &vt, &vn) == 3) { --v; --vt; --vn; }
@@ -70,6 +100,183 @@ void read_point_id(char * s, int & v, int & vt, int & vn)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// fast version of read_point_id, operating on the token [s,end).
+// Returns false for unusual tokens, which should be handled by read_point_id
+//
+CINO_INLINE
+bool fast_read_point_id(const char * s, const char * end, int & v, int & vt, int & vn)
+{
+    v = vt = vn = -1;
+    if(!fast_parse_int(s, end, v)) return false;
+    if(s==end) { --v; return true; } // v
+    if(*s!='/') return false;
+    ++s;
+    if(s<end && *s=='/')
+    {
+        ++s;
+        if(!fast_parse_int(s, end, vn) || s!=end) return false;
+        --v; --vn;                     // v//vn
+        return true;
+    }
+    if(!fast_parse_int(s, end, vt)) return false;
+    if(s==end) { --v; --vt; return true; } // v/vt
+    if(*s!='/') return false;
+    ++s;
+    if(!fast_parse_int(s, end, vn) || s!=end) return false;
+    --v; --vt; --vn;                   // v/vt/vn
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// parses up to n doubles from [s,end). Returns how many were parsed, or -1
+// if the line contains something that the fast parser cannot handle
+//
+CINO_INLINE
+int fast_read_doubles(const char * s, const char * end, double * d, const int n)
+{
+    int count = 0;
+    while(count<n)
+    {
+        skip_blanks(s, end);
+        if(s==end) break;
+        if(!fast_parse_double(s, end, d[count])) return -1;
+        if(s<end && !is_blank(*s)) return -1;
+        ++count;
+    }
+    return count;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void parse_OBJ_chunk(const char * beg, const char * end, OBJ_chunk & chunk)
+{
+    chunk.poly_pos_off.assign(1,0);
+    chunk.poly_tex_off.assign(1,0);
+    chunk.poly_nor_off.assign(1,0);
+
+    // rough guess of the amount of memory needed (a vertex line takes ~30 bytes)
+    size_t guess = size_t(end-beg)/64;
+    chunk.pos.reserve(guess);
+    chunk.poly_pos.reserve(guess);
+
+    std::string line; // NULL terminated copy of the current line (for slow paths only)
+
+    const char *l_beg = beg;
+    while(l_beg<end)
+    {
+        const char *l_end = static_cast<const char*>(memchr(l_beg, '\n', size_t(end-l_beg)));
+        if(l_end==nullptr) l_end = end;
+        const char *next = (l_end<end) ? l_end+1 : end;
+
+        switch(*l_beg)
+        {
+            case 'v':
+            {
+                // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
+                //
+                double xyz[3];
+                const char *c1 = l_beg+1;
+                const char *c2 = l_beg+2;
+                int n = -1;
+                int type = -1; // 0 pos, 1 tex, 2 nor
+                     if(c1<l_end && is_blank(*c1))                          { type = 0; n = fast_read_doubles(c1, l_end, xyz, 3); }
+                else if(c2<=l_end && *c1=='t' && (c2==l_end || is_blank(*c2))) { type = 1; n = fast_read_doubles(c2, l_end, xyz, 3); }
+                else if(c2<=l_end && *c1=='n' && (c2==l_end || is_blank(*c2))) { type = 2; n = fast_read_doubles(c2, l_end, xyz, 3); }
+
+                if(n>=0)
+                {
+                         if(type==0 && n==3) chunk.pos.insert(chunk.pos.end(), xyz, xyz+3);
+                    else if(type==1 && n==3) chunk.tex.insert(chunk.tex.end(), xyz, xyz+3);
+                    else if(type==1 && n==2) { xyz[2] = 0; chunk.tex.insert(chunk.tex.end(), xyz, xyz+3); }
+                    else if(type==2 && n==3) chunk.nor.insert(chunk.nor.end(), xyz, xyz+3);
+                }
+                else
+                {
+                    line.assign(l_beg, l_end);
+                    double a, b, c;
+                         if(sscanf(line.data(), "v  %lf %lf %lf", &a, &b, &c) == 3) { chunk.pos.push_back(a); chunk.pos.push_back(b); chunk.pos.push_back(c); }
+                    else if(sscanf(line.data(), "vt %lf %lf %lf", &a, &b, &c) == 3) { chunk.tex.push_back(a); chunk.tex.push_back(b); chunk.tex.push_back(c); }
+                    else if(sscanf(line.data(), "vt %lf %lf %lf", &a, &b, &c) == 2) { chunk.tex.push_back(a); chunk.tex.push_back(b); chunk.tex.push_back(0); }
+                    else if(sscanf(line.data(), "vn %lf %lf %lf", &a, &b, &c) == 3) { chunk.nor.push_back(a); chunk.nor.push_back(b); chunk.nor.push_back(c); }
+                }
+                break;
+            }
+
+            case 'f':
+            {
+                const char *s = l_beg+1; // discard the 'f' letter
+                size_t n_pos = chunk.poly_pos.size();
+                size_t n_tex = chunk.poly_tex.size();
+                size_t n_nor = chunk.poly_nor.size();
+                while(true)
+                {
+                    skip_blanks(s, l_end);
+                    if(s==l_end) break;
+                    const char *t = s;
+                    while(t<l_end && !is_blank(*t)) ++t;
+
+                    int v_pos, v_tex, v_nor;
+                    if(!fast_read_point_id(s, t, v_pos, v_tex, v_nor))
+                    {
+                        line.assign(s, t);
+                        read_point_id(line.c_str(), v_pos, v_tex, v_nor);
+                    }
+                    if (v_pos >= 0) chunk.poly_pos.push_back(v_pos);
+                    if (v_tex >= 0) chunk.poly_tex.push_back(v_tex);
+                    if (v_nor >= 0) chunk.poly_nor.push_back(v_nor);
+                    s = t;
+                }
+                if (chunk.poly_tex.size()>n_tex) chunk.poly_tex_off.push_back(uint(chunk.poly_tex.size()));
+                if (chunk.poly_nor.size()>n_nor) chunk.poly_nor_off.push_back(uint(chunk.poly_nor.size()));
+                if (chunk.poly_pos.size()>n_pos) chunk.poly_pos_off.push_back(uint(chunk.poly_pos.size()));
+                chunk.face_lab.push_back(chunk.n_groups);
+                break;
+            }
+
+            case 'u':
+            {
+                line.assign(l_beg, l_end);
+                char mat_c[1024];
+                if (sscanf(line.data(), "usemtl %s", mat_c) == 1)
+                {
+                    OBJ_event e;
+                    e.is_mtllib      = false;
+                    e.arg            = std::string(mat_c);
+                    e.n_polys_before = uint(chunk.poly_pos_off.size()-1);
+                    chunk.events.push_back(e);
+                }
+                break;
+            }
+
+            case 'm':
+            {
+                line.assign(l_beg, l_end);
+                char mtu_c[1024];
+                if(sscanf(line.data(), "mtllib %[^\n]s", mtu_c) == 1)
+                {
+                    OBJ_event e;
+                    e.is_mtllib      = true;
+                    e.arg            = std::string(mtu_c);
+                    e.n_polys_before = uint(chunk.poly_pos_off.size()-1);
+                    chunk.events.push_back(e);
+                }
+                break;
+            }
+
+            case 'g':
+            {
+                chunk.n_groups++;
+                break;
+            }
+        }
+        l_beg = next;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void read_OBJ(const char                     * filename,
               std::vector<vec3d>             & verts,
@@ -118,139 +325,236 @@ void read_OBJ(const char                     * filename,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// parses an OBJ file into data. Per corner texture/normal references are stored in data only
+// if all polygons define them. If poly_tex/poly_nor are not null they are also filled with the
+// references of the polygons that do define them (possibly a subset of the polygons, as in
+// the legacy vector-of-vectors interface)
 CINO_INLINE
-void read_OBJ(const char                     * filename,
-              std::vector<vec3d>             & pos,           // vertex xyz positions
-              std::vector<vec3d>             & tex,           // vertex uv(w) texture coordinates
-              std::vector<vec3d>             & nor,           // vertex normals
-              std::vector<std::vector<uint>> & poly_pos,      // polygons with references to pos
-              std::vector<std::vector<uint>> & poly_tex,      // polygons with references to tex
-              std::vector<std::vector<uint>> & poly_nor,      // polygons with references to nor
-              std::vector<Color>             & poly_col,      // per polygon colors
-              std::vector<int>               & poly_lab,      // per polygon labels (cluster by OBJ groups "g")
-              std::string                    & diffuse_path,  // path of the image encoding the diffuse  texture component
-              std::string                    & specular_path, // path of the image encoding the specular texture component
-              std::string                    & normal_path)   // path of the image encoding the normal   texture component
+void read_OBJ_data(const char                     * filename,
+                   IOData                         & data,
+                   std::string                    & diffuse_path,
+                   std::string                    & specular_path,
+                   std::string                    & normal_path,
+                   std::vector<std::vector<uint>> * poly_tex,
+                   std::vector<std::vector<uint>> * poly_nor)
 {
     setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
 
-    pos.clear();
-    tex.clear();
-    nor.clear();
-    poly_pos.clear();
-    poly_tex.clear();
-    poly_nor.clear();
-    poly_col.clear();
-    poly_lab.clear();
+    data.clear();
     diffuse_path.clear();
     specular_path.clear();
     normal_path.clear();
 
-    std::ifstream f(filename);
+    MemoryMappedFile f(filename);
     if(!f.is_open())
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_OBJ() : couldn't open input file " << filename << std::endl;
         exit(-1);
     }
 
-    int fresh_label = 0;
+    // split the file into newline aligned chunks, one per thread.
+    // Small files are parsed serially, as threads would only add overhead
+    uint n_chunks = 1;
+    if(f.size() > (1<<20))
+    {
+        unsigned n_threads = std::thread::hardware_concurrency();
+        n_chunks = (n_threads==0) ? 8 : n_threads;
+    }
+    std::vector<const char*> chunk_beg(n_chunks+1, f.end());
+    chunk_beg.front() = f.begin();
+    for(uint i=1; i<n_chunks; ++i)
+    {
+        const char *c = std::max(chunk_beg.at(i-1), f.begin() + (f.size()/n_chunks)*i);
+        c = static_cast<const char*>(memchr(c, '\n', size_t(f.end()-c)));
+        chunk_beg.at(i) = (c==nullptr) ? f.end() : c+1;
+    }
+
+    // parse chunks in parallel
+    std::vector<OBJ_chunk> chunks(n_chunks);
+    PARALLEL_FOR(0, n_chunks, 2, [&](uint i)
+    {
+        parse_OBJ_chunk(chunk_beg.at(i), chunk_beg.at(i+1), chunks.at(i));
+    });
+
+    // prefix sums to locate the output of each chunk in the global arrays
+    std::vector<uint> off_pos (n_chunks+1,0), off_tex (n_chunks+1,0), off_nor (n_chunks+1,0);
+    std::vector<uint> off_ppos(n_chunks+1,0), off_cpos(n_chunks+1,0);
+    std::vector<uint> off_face(n_chunks+1,0), off_lab (n_chunks+1,0);
+    std::vector<uint> off_ftex(n_chunks+1,0), off_fnor(n_chunks+1,0);
+    bool has_poly_tex = true; // texture/normal references are kept only if
+    bool has_poly_nor = true; // all polygons define them at all corners
+    for(uint i=0; i<n_chunks; ++i)
+    {
+        const OBJ_chunk & c = chunks.at(i);
+        off_pos .at(i+1) = off_pos .at(i) + uint(c.pos.size()/3);
+        off_tex .at(i+1) = off_tex .at(i) + uint(c.tex.size()/3);
+        off_nor .at(i+1) = off_nor .at(i) + uint(c.nor.size()/3);
+        off_ppos.at(i+1) = off_ppos.at(i) + uint(c.poly_pos_off.size()-1);
+        off_cpos.at(i+1) = off_cpos.at(i) + uint(c.poly_pos.size());
+        off_face.at(i+1) = off_face.at(i) + uint(c.face_lab.size());
+        off_lab .at(i+1) = off_lab .at(i) + c.n_groups;
+        off_ftex.at(i+1) = off_ftex.at(i) + uint(c.poly_tex_off.size()-1);
+        off_fnor.at(i+1) = off_fnor.at(i) + uint(c.poly_nor_off.size()-1);
+        has_poly_tex &= (c.poly_tex_off==c.poly_pos_off);
+        has_poly_nor &= (c.poly_nor_off==c.poly_pos_off);
+    }
+    has_poly_tex &= (off_cpos.back()>0);
+    has_poly_nor &= (off_cpos.back()>0);
+
+    // materials and colors are stateful (usemtl applies to all subsequent
+    // faces, mtllib may redefine the palette). Replay the events serially
+    // and define, for each chunk, the color runs of its polygons
     std::map<std::string,Color> color_map;
     Color curr_color = Color::WHITE();     // set WHITE as default color
     bool has_per_face_color = false;
-    bool has_groups         = false;
-
-    std::string line;
-    while(std::getline(f,line))
+    std::vector<std::vector<std::pair<uint,Color>>> color_runs(n_chunks);
+    for(uint i=0; i<n_chunks; ++i)
     {
-        switch(line[0])
+        color_runs.at(i).push_back(std::make_pair(0,curr_color));
+        for(const OBJ_event & e : chunks.at(i).events)
         {
-            case 'v':
+            if(e.is_mtllib)
             {
-                // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-                //
-                double a, b, c;
-                     if(sscanf(line.data(), "v  %lf %lf %lf", &a, &b, &c) == 3) pos.push_back(vec3d(a,b,c));
-                else if(sscanf(line.data(), "vt %lf %lf %lf", &a, &b, &c) == 3) tex.push_back(vec3d(a,b,c));
-                else if(sscanf(line.data(), "vt %lf %lf %lf", &a, &b, &c) == 2) tex.push_back(vec3d(a,b,0));
-                else if(sscanf(line.data(), "vn %lf %lf %lf", &a, &b, &c) == 3) nor.push_back(vec3d(a,b,c));
-                break;
-            }
+                std::string s0(filename);
+                std::string s2 = get_file_path(s0) + get_file_name(e.arg);
 
-            case 'f':
-            {
-                line = line.substr(1,line.size()-1); // discard the 'f' letter
-                std::istringstream ss(line);
-                std::vector<uint> p_pos, p_tex, p_nor;
-                for(std::string sub_str; ss >> sub_str;)
+                // this fix shouldn't be here, but...
+                // https://stackoverflow.com/questions/1279779/what-is-the-difference-between-r-and-n
+                if(!s2.empty() && s2[s2.size()-1]=='\r')
                 {
-                    int v_pos, v_tex, v_nor;
-                    read_point_id(strdup(sub_str.c_str()), v_pos, v_tex, v_nor);
-                    if (v_pos >= 0) p_pos.push_back(v_pos);
-                    if (v_tex >= 0) p_tex.push_back(v_tex);
-                    if (v_nor >= 0) p_nor.push_back(v_nor);
+                    s2.erase(s2.size()-1);
                 }
-                if (!p_tex.empty()) poly_tex.push_back(p_tex);
-                if (!p_nor.empty()) poly_nor.push_back(p_nor);
-                if (!p_pos.empty())
+
+                if(read_MTU(s2.c_str(), color_map, diffuse_path, specular_path, normal_path))
                 {
-                    poly_pos.push_back(p_pos);
-                    poly_col.push_back(curr_color);
+                    has_per_face_color = true;
                 }
-                poly_lab.push_back(fresh_label);
-                break;
             }
-
-            case 'u':
+            else
             {
-                char mat_c[1024];
-                if (sscanf(line.data(), "usemtl %s", mat_c) == 1)
+                auto query = color_map.find(e.arg);
+                if (query != color_map.end())
                 {
-                    auto query = color_map.find(std::string(mat_c));
-                    if (query != color_map.end())
-                    {
-                        curr_color = query->second;
-                    }
-                    else std::cerr << "WARNING: could not find material: " << mat_c << std::endl;
+                    curr_color = query->second;
+                    color_runs.at(i).push_back(std::make_pair(e.n_polys_before,curr_color));
                 }
-                break;
+                else std::cerr << "WARNING: could not find material: " << e.arg << std::endl;
             }
+        }
+    }
 
-            case 'm':
-            {
-                char mtu_c[1024];
-                if(sscanf(line.data(), "mtllib %[^\n]s", mtu_c) == 1)
-                {
-                    std::string s0(filename);
-                    std::string s1(mtu_c);
-                    std::string s2 = get_file_path(s0) + get_file_name(s1);
-
-                    // this fix shouldn't be here, but...
-                    // https://stackoverflow.com/questions/1279779/what-is-the-difference-between-r-and-n
-                    if(!s2.empty() && s2[s2.size()-1]=='\r')
-                    {
-                        s2.erase(s2.size()-1);
-                    }
+    // merge
+    data.verts.resize(off_pos.back());
+    data.uvw.resize(off_tex.back());
+    data.normals.resize(off_nor.back());
+    data.poly_offsets.resize(off_ppos.back()+1);
+    data.poly_vids.resize(off_cpos.back());
+    if(has_poly_tex)       data.poly_uvw.resize(off_cpos.back());
+    if(has_poly_nor)       data.poly_nor.resize(off_cpos.back());
+    if(has_per_face_color) data.poly_colors.resize(off_ppos.back());
+    if(off_lab.back()>0)   data.poly_labels.resize(off_face.back());
+    if(poly_tex!=nullptr)  poly_tex->assign(off_ftex.back(), std::vector<uint>());
+    if(poly_nor!=nullptr)  poly_nor->assign(off_fnor.back(), std::vector<uint>());
+
+    auto copy_verts = [](const std::vector<double> & src, std::vector<vec3d> & dst, const uint off)
+    {
+        for(uint i=0; i<src.size()/3; ++i) dst[off+i] = vec3d(src[3*i], src[3*i+1], src[3*i+2]);
+    };
 
-                    if(read_MTU(s2.c_str(), color_map, diffuse_path, specular_path, normal_path))
-                    {
-                        has_per_face_color = true;
-                    }
-                }
-                break;
-            }
+    PARALLEL_FOR(0, n_chunks, 2, [&](uint i)
+    {
+        OBJ_chunk & c = chunks.at(i);
+        copy_verts(c.pos, data.verts,   off_pos.at(i));
+        copy_verts(c.tex, data.uvw,     off_tex.at(i));
+        copy_verts(c.nor, data.normals, off_nor.at(i));
+        for(uint j=1; j<c.poly_pos_off.size(); ++j) data.poly_offsets[off_ppos.at(i)+j] = off_cpos.at(i) + c.poly_pos_off[j];
+        std::copy(c.poly_pos.begin(), c.poly_pos.end(), data.poly_vids.begin() + off_cpos.at(i));
+        if(has_poly_tex) std::copy(c.poly_tex.begin(), c.poly_tex.end(), data.poly_uvw.begin() + off_cpos.at(i));
+        if(has_poly_nor) std::copy(c.poly_nor.begin(), c.poly_nor.end(), data.poly_nor.begin() + off_cpos.at(i));
+
+        auto unflatten = [](const std::vector<uint> & ids, const std::vector<uint> & off, std::vector<std::vector<uint>> & polys, const uint first)
+        {
+            for(uint j=0; j+1<off.size(); ++j) polys[first+j].assign(ids.begin()+off[j], ids.begin()+off[j+1]);
+        };
+        if(poly_tex!=nullptr) unflatten(c.poly_tex, c.poly_tex_off, *poly_tex, off_ftex.at(i));
+        if(poly_nor!=nullptr) unflatten(c.poly_nor, c.poly_nor_off, *poly_nor, off_fnor.at(i));
 
-            case 'g':
+        if(has_per_face_color)
+        {
+            const auto & runs = color_runs.at(i);
+            uint n = uint(c.poly_pos_off.size()-1);
+            for(uint r=0; r<runs.size(); ++r)
             {
-                has_groups = true;
-                fresh_label++;
-                break;
+                uint beg = runs.at(r).first;
+                uint end = (r+1<runs.size()) ? runs.at(r+1).first : n;
+                for(uint pid=beg; pid<end; ++pid) data.poly_colors[off_ppos.at(i)+pid] = runs.at(r).second;
             }
         }
-    }
-    f.close();
 
-    if(!has_per_face_color) poly_col.clear();
-    if(!has_groups)         poly_lab.clear();
+        if(!data.poly_labels.empty())
+        {
+            for(uint j=0; j<c.face_lab.size(); ++j) data.poly_labels[off_face.at(i)+j] = int(off_lab.at(i) + c.face_lab[j]);
+        }
+
+        c = OBJ_chunk(); // release memory as soon as possible
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_OBJ(const char  * filename,
+              IOData      & data,
+              std::string & diffuse_path,  // path of the image encoding the diffuse  texture component
+              std::string & specular_path, // path of the image encoding the specular texture component
+              std::string & normal_path)   // path of the image encoding the normal   texture component
+{
+    read_OBJ_data(filename, data, diffuse_path, specular_path, normal_path, nullptr, nullptr);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_OBJ(const char                     * filename,
+              std::vector<vec3d>             & pos,           // vertex xyz positions
+              std::vector<vec3d>             & tex,           // vertex uv(w) texture coordinates
+              std::vector<vec3d>             & nor,           // vertex normals
+              std::vector<std::vector<uint>> & poly_pos,      // polygons with references to pos
+              std::vector<std::vector<uint>> & poly_tex,      // polygons with references to tex
+              std::vector<std::vector<uint>> & poly_nor,      // polygons with references to nor
+              std::vector<Color>             & poly_col,      // per polygon colors
+              std::vector<int>               & poly_lab,      // per polygon labels (cluster by OBJ groups "g")
+              std::string                    & diffuse_path,  // path of the image encoding the diffuse  texture component
+              std::string                    & specular_path, // path of the image encoding the specular texture component
+              std::string                    & normal_path)   // path of the image encoding the normal   texture component
+{
+    // texture/normal references are fetched directly from the parser, because
+    // IOData only stores them if all polygons define them
+    IOData data;
+    read_OBJ_data(filename, data, diffuse_path, specular_path, normal_path, &poly_tex, &poly_nor);
+
+    poly_pos.resize(data.num_polys());
+    PARALLEL_FOR(0, data.num_polys(), 10000, [&](const uint pid)
+    {
+        poly_pos[pid].assign(data.poly_begin(pid), data.poly_end(pid));
+    });
+    pos      = std::move(data.verts);
+    tex      = std::move(data.uvw);
+    nor      = std::move(data.normals);
+    poly_col = std::move(data.poly_colors);
+    poly_lab = std::move(data.poly_labels);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_OBJ(const char * filename,
+              IOData     & data)
+{
+    std::string  diffuse_path;
+    std::string  specular_path;
+    std::string  normal_path;
+    read_OBJ(filename, data, diffuse_path, specular_path, normal_path);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -43,12 +43,32 @@
 #include <cinolib/cino_inline.h>
 #include <cinolib/geometry/vec_mat.h>
 #include <cinolib/color.h>
+#include <cinolib/io/io_data.h>
 
 namespace cinolib
 {
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// polygons, texture coordinates and normals are returned as in the file (i.e.
+// with separate references per corner). Call data.unify_verts() to obtain an
+// openGL-like mesh, with unique per vertex xyz, uvw and normals
+//
+CINO_INLINE
+void read_OBJ(const char  * filename,
+              IOData      & data,
+              std::string & diffuse_path,  // path of the image encoding the diffuse  texture component
+              std::string & specular_path, // path of the image encoding the specular texture component
+              std::string & normal_path);  // path of the image encoding the normal   texture component
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_OBJ(const char * filename,
+              IOData     & data);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void read_OBJ(const char                     * filename,
               std::vector<vec3d>             & pos,           // vertex xyz positions
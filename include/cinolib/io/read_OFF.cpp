@@ -59,9 +59,20 @@ void read_OFF(const char                     * filename,
               std::vector<std::vector<uint>> & polys,
               std::vector<Color>             & poly_colors)
 {
-    verts.clear();
-    polys.clear();
-    poly_colors.clear();
+    IOData data;
+    read_OFF(filename, data);
+    polys       = data.polys();
+    verts       = std::move(data.verts);
+    poly_colors = std::move(data.poly_colors);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_OFF(const char * filename,
+              IOData     & data)
+{
+    data.clear();
 
     setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
 
@@ -78,6 +89,7 @@ void read_OFF(const char                     * filename,
     // read header and number of elements
     do getline(f, line, '\n'); while(line.find("OFF")==std::string::npos);
     do getline(f, line, '\n'); while(sscanf(line.c_str(), "%d %d %d\n", &nv, &np, &ne)!=3);
+    data.reserve(nv, np, 3*np);
 
     // read verts
     for(uint i=0; i<nv; ++i)
@@ -88,7 +100,7 @@ void read_OFF(const char                     * filename,
         double x, y, z;
         if(ss >> x >> y >> z)
         {
-            verts.push_back(vec3d(x,y,z));
+            data.verts.push_back(vec3d(x,y,z));
         }
         else --i;
     }
@@ -103,13 +115,12 @@ void read_OFF(const char                     * filename,
         if(ss >> n_corners)
         {
             uint vid;
-            std::vector<uint> p;
             for(uint j=0; j<n_corners; ++j)
             {
                 ss >> vid;
-                p.push_back(vid);
+                data.poly_vids.push_back(vid);
             }
-            polys.push_back(p);
+            data.poly_offsets.push_back(uint(data.poly_vids.size()));
 
             float val;
             std::vector<float> attr;
@@ -118,8 +129,8 @@ void read_OFF(const char                     * filename,
             switch(attr.size())
             {
                 case 1 : break; // TODO: READ LABEL (cast to int)!!!
-                case 3 : poly_colors.push_back(Color(attr.at(0), attr.at(1), attr.at(2))); break;
-                case 4 : poly_colors.push_back(Color(attr.at(0), attr.at(1), attr.at(2), attr.at(3))); break;
+                case 3 : data.poly_colors.push_back(Color(attr.at(0), attr.at(1), attr.at(2))); break;
+                case 4 : data.poly_colors.push_back(Color(attr.at(0), attr.at(1), attr.at(2), attr.at(3))); break;
                 default: break;
             }
         }
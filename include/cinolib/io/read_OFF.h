@@ -41,6 +41,7 @@
 #include <cinolib/cino_inline.h>
 #include <cinolib/geometry/vec_mat.h>
 #include <cinolib/color.h>
+#include <cinolib/io/io_data.h>
 
 namespace cinolib
 {
@@ -58,6 +59,12 @@ void read_OFF(const char                     * filename,
               std::vector<std::vector<uint>> & polys,
               std::vector<Color>             & poly_colors);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_OFF(const char * filename,
+              IOData     & data);
+
 }
 
 #ifndef  CINO_STATIC_LIB
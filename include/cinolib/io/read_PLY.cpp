@@ -0,0 +1,470 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/read_PLY.h>
+#include <cinolib/io/memory_mapped_file.h>
+#include <cinolib/io/fast_number_parsing.h>
+#include <cinolib/parallel_for.h>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace cinolib
+{
+
+namespace ply
+{
+    enum { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64, UNKNOWN };
+
+    enum { VERT_X, VERT_Y, VERT_Z, VERT_NX, VERT_NY, VERT_NZ, VERT_U, VERT_V,
+           COL_R, COL_G, COL_B, COL_A, FACE_VIDS, FACE_LABEL, IGNORED };
+
+    struct Property
+    {
+        std::string name;
+        int         type;
+        bool        is_list    = false;
+        int         count_type = UNKNOWN; // only for lists
+        size_t      offset     = 0;       // only for fixed size elements
+        int         semantic   = IGNORED;
+    };
+
+    struct Element
+    {
+        std::string           name;
+        size_t                count;
+        std::vector<Property> props;
+        bool                  fixed_size = true;
+        size_t                stride     = 0;
+    };
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    CINO_INLINE
+    int type_from_string(const std::string & s)
+    {
+        if(s=="char"   || s=="int8"   ) return INT8;
+        if(s=="uchar"  || s=="uint8"  ) return UINT8;
+        if(s=="short"  || s=="int16"  ) return INT16;
+        if(s=="ushort" || s=="uint16" ) return UINT16;
+        if(s=="int"    || s=="int32"  ) return INT32;
+        if(s=="uint"   || s=="uint32" ) return UINT32;
+        if(s=="float"  || s=="float32") return FLOAT32;
+        if(s=="double" || s=="float64") return FLOAT64;
+        return UNKNOWN;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    CINO_INLINE
+    size_t type_size(const int type)
+    {
+        static const size_t sizes[] = { 1, 1, 2, 2, 4, 4, 4, 8, 0 };
+        return sizes[type];
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    CINO_INLINE
+    bool type_is_integer(const int type)
+    {
+        return type!=FLOAT32 && type!=FLOAT64;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // decode a binary value of given type, swapping bytes if the file
+    // endianness differs from the one of the host
+    //
+    CINO_INLINE
+    double decode(const char * p, const int type, const bool swap)
+    {
+        char b[8];
+        size_t n = type_size(type);
+        if(swap) for(size_t i=0; i<n; ++i) b[i] = p[n-1-i];
+        else     memcpy(b, p, n);
+        switch(type)
+        {
+            case INT8    : { int8_t   x; memcpy(&x,b,1); return double(x); }
+            case UINT8   : { uint8_t  x; memcpy(&x,b,1); return double(x); }
+            case INT16   : { int16_t  x; memcpy(&x,b,2); return double(x); }
+            case UINT16  : { uint16_t x; memcpy(&x,b,2); return double(x); }
+            case INT32   : { int32_t  x; memcpy(&x,b,4); return double(x); }
+            case UINT32  : { uint32_t x; memcpy(&x,b,4); return double(x); }
+            case FLOAT32 : { float    x; memcpy(&x,b,4); return double(x); }
+            case FLOAT64 : { double   x; memcpy(&x,b,8); return x;         }
+        }
+        return 0;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    CINO_INLINE
+    int semantic(const std::string & elem, const std::string & prop)
+    {
+        if(elem=="vertex")
+        {
+            if(prop=="x")  return VERT_X;
+            if(prop=="y")  return VERT_Y;
+            if(prop=="z")  return VERT_Z;
+            if(prop=="nx") return VERT_NX;
+            if(prop=="ny") return VERT_NY;
+            if(prop=="nz") return VERT_NZ;
+            if(prop=="u" || prop=="s" || prop=="texture_u" || prop=="texture_s") return VERT_U;
+            if(prop=="v" || prop=="t" || prop=="texture_v" || prop=="texture_t") return VERT_V;
+        }
+        if(elem=="face")
+        {
+            if(prop=="vertex_indices" || prop=="vertex_index") return FACE_VIDS;
+            if(prop=="label") return FACE_LABEL;
+        }
+        if(elem=="vertex" || elem=="face")
+        {
+            if(prop=="red"   || prop=="r") return COL_R;
+            if(prop=="green" || prop=="g") return COL_G;
+            if(prop=="blue"  || prop=="b") return COL_B;
+            if(prop=="alpha" || prop=="a") return COL_A;
+        }
+        return IGNORED;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // skip spaces and newlines in ASCII files
+    //
+    inline void skip_ws(const char *& s, const char * end)
+    {
+        while(s<end && (is_blank(*s) || *s=='\n')) ++s;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    CINO_INLINE
+    bool ascii_value(const char *& s, const char * end, double & d)
+    {
+        skip_ws(s, end);
+        return fast_parse_double(s, end, d);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_PLY(const char * filename,
+              IOData     & data)
+{
+    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+
+    data.clear();
+
+    MemoryMappedFile f(filename);
+    if(!f.is_open())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_PLY() : couldn't open input file " << filename << std::endl;
+        exit(-1);
+    }
+
+    // parse header
+    const char *p   = f.begin();
+    const char *end = f.end();
+    std::vector<ply::Element> elements;
+    bool ascii = false;
+    bool swap  = false;
+    bool found_end_header = false;
+    uint line_id = 0;
+    while(p<end && !found_end_header)
+    {
+        const char *eol = static_cast<const char*>(memchr(p, '\n', size_t(end-p)));
+        if(eol==nullptr) eol = end;
+        std::istringstream ss(std::string(p,eol));
+        p = (eol<end) ? eol+1 : end;
+        std::string token;
+        ss >> token;
+
+        if(line_id++==0)
+        {
+            if(token!="ply")
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_PLY() : not a PLY file " << filename << std::endl;
+                return;
+            }
+        }
+        else if(token=="format")
+        {
+            std::string format;
+            ss >> format;
+            ascii = (format=="ascii");
+            const uint16_t one = 1;
+            bool host_is_le = (*reinterpret_cast<const char*>(&one)==1);
+                 if(format=="binary_little_endian") swap = !host_is_le;
+            else if(format=="binary_big_endian")    swap =  host_is_le;
+            else if(!ascii)
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_PLY() : unknown format " << format << std::endl;
+                return;
+            }
+        }
+        else if(token=="element")
+        {
+            ply::Element e;
+            ss >> e.name >> e.count;
+            elements.push_back(e);
+        }
+        else if(token=="property" && !elements.empty())
+        {
+            ply::Element & e = elements.back();
+            ply::Property prop;
+            std::string type;
+            ss >> type;
+            if(type=="list")
+            {
+                std::string count_type;
+                ss >> count_type >> type;
+                prop.is_list    = true;
+                prop.count_type = ply::type_from_string(count_type);
+                e.fixed_size    = false;
+            }
+            ss >> prop.name;
+            prop.type     = ply::type_from_string(type);
+            prop.semantic = ply::semantic(e.name, prop.name);
+            if(prop.type==ply::UNKNOWN || (prop.is_list && prop.count_type==ply::UNKNOWN))
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_PLY() : unknown property type " << type << std::endl;
+                return;
+            }
+            if(!prop.is_list)
+            {
+                prop.offset = e.stride;
+                e.stride   += ply::type_size(prop.type);
+            }
+            e.props.push_back(prop);
+        }
+        else if(token=="end_header")
+        {
+            found_end_header = true;
+        }
+    }
+    if(!found_end_header)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_PLY() : missing end_header " << filename << std::endl;
+        return;
+    }
+
+    // decode data
+    for(const ply::Element & e : elements)
+    {
+        bool is_vert = (e.name=="vertex");
+        bool is_face = (e.name=="face");
+
+        bool has[ply::IGNORED+1] = {};
+        for(const auto & prop : e.props) has[prop.semantic] = true;
+
+        std::vector<vec3d> * xyz = nullptr;
+        std::vector<vec3d> * nor = nullptr;
+        std::vector<vec3d> * uvw = nullptr;
+        std::vector<Color> * col = nullptr;
+        std::vector<int>   * lab = nullptr;
+        if(is_vert)
+        {
+            if(has[ply::VERT_X]  || has[ply::VERT_Y]  || has[ply::VERT_Z] ) xyz = &data.verts;
+            if(has[ply::VERT_NX] || has[ply::VERT_NY] || has[ply::VERT_NZ]) nor = &data.normals;
+            if(has[ply::VERT_U]  || has[ply::VERT_V])                       uvw = &data.uvw;
+            if(has[ply::COL_R]   || has[ply::COL_G]   || has[ply::COL_B]  ) col = &data.vert_colors;
+        }
+        if(is_face)
+        {
+            if(has[ply::FACE_LABEL])                                        lab = &data.poly_labels;
+            if(has[ply::COL_R]   || has[ply::COL_G]   || has[ply::COL_B]  ) col = &data.poly_colors;
+            if(has[ply::FACE_VIDS]) data.reserve(0, uint(e.count), 3*uint(e.count));
+        }
+        if(xyz) xyz->resize(e.count, vec3d(0,0,0));
+        if(nor) nor->resize(e.count, vec3d(0,0,0));
+        if(uvw) uvw->resize(e.count, vec3d(0,0,0));
+        if(col) col->resize(e.count, Color(0,0,0,1));
+        if(lab) lab->resize(e.count, 0);
+
+        // store a scalar property of the i-th item
+        auto store = [&](const size_t i, const ply::Property & prop, const double val)
+        {
+            switch(prop.semantic)
+            {
+                case ply::VERT_X     : (*xyz)[i].x() = val; break;
+                case ply::VERT_Y     : (*xyz)[i].y() = val; break;
+                case ply::VERT_Z     : (*xyz)[i].z() = val; break;
+                case ply::VERT_NX    : (*nor)[i].x() = val; break;
+                case ply::VERT_NY    : (*nor)[i].y() = val; break;
+                case ply::VERT_NZ    : (*nor)[i].z() = val; break;
+                case ply::VERT_U     : (*uvw)[i].x() = val; break;
+                case ply::VERT_V     : (*uvw)[i].y() = val; break;
+                case ply::FACE_LABEL : (*lab)[i]     = int(val); break;
+                case ply::COL_R      :
+                case ply::COL_G      :
+                case ply::COL_B      :
+                case ply::COL_A      :
+                {
+                    float c = ply::type_is_integer(prop.type) ? float(val/255.0) : float(val);
+                    (*col)[i].rgba[prop.semantic-ply::COL_R] = c;
+                    break;
+                }
+            }
+        };
+
+        if(ascii)
+        {
+            for(size_t i=0; i<e.count; ++i)
+            {
+                for(const auto & prop : e.props)
+                {
+                    double val;
+                    if(!ply::ascii_value(p, end, val)) goto truncated;
+                    if(prop.is_list)
+                    {
+                        uint n = uint(val);
+                        for(uint j=0; j<n; ++j)
+                        {
+                            if(!ply::ascii_value(p, end, val)) goto truncated;
+                            if(is_face && prop.semantic==ply::FACE_VIDS) data.poly_vids.push_back(uint(val));
+                        }
+                        if(is_face && prop.semantic==ply::FACE_VIDS) data.poly_offsets.push_back(uint(data.poly_vids.size()));
+                    }
+                    else if(prop.semantic!=ply::IGNORED && (is_vert || is_face)) store(i, prop, val);
+                }
+            }
+        }
+        else if(e.fixed_size)
+        {
+            // fixed size records: random access, decode in parallel
+            if(size_t(end-p) < e.count*e.stride) goto truncated;
+            const char *block = p;
+            if(is_vert || is_face)
+            {
+                PARALLEL_FOR(0, uint(e.count), 10000, [&](uint i)
+                {
+                    const char *rec = block + size_t(i)*e.stride;
+                    for(const auto & prop : e.props)
+                    {
+                        if(prop.semantic==ply::IGNORED) continue;
+                        store(i, prop, ply::decode(rec+prop.offset, prop.type, swap));
+                    }
+                });
+            }
+            p += e.count*e.stride;
+        }
+        else
+        {
+            // variable size records (i.e. with lists): sequential walk
+            for(size_t i=0; i<e.count; ++i)
+            {
+                for(const auto & prop : e.props)
+                {
+                    if(prop.is_list)
+                    {
+                        size_t cs = ply::type_size(prop.count_type);
+                        if(size_t(end-p)<cs) goto truncated;
+                        uint   n  = uint(ply::decode(p, prop.count_type, swap));
+                        size_t ts = ply::type_size(prop.type);
+                        p += cs;
+                        if(size_t(end-p)<n*ts) goto truncated;
+                        if(is_face && prop.semantic==ply::FACE_VIDS)
+                        {
+                            size_t off = data.poly_vids.size();
+                            data.poly_vids.resize(off+n);
+                            uint *poly = data.poly_vids.data() + off;
+                            if(!swap && (prop.type==ply::INT32 || prop.type==ply::UINT32))
+                            {
+                                memcpy(poly, p, n*4);
+                            }
+                            else for(uint j=0; j<n; ++j) poly[j] = uint(ply::decode(p+j*ts, prop.type, swap));
+                            data.poly_offsets.push_back(uint(data.poly_vids.size()));
+                        }
+                        p += n*ts;
+                    }
+                    else
+                    {
+                        size_t ts = ply::type_size(prop.type);
+                        if(size_t(end-p)<ts) goto truncated;
+                        if(prop.semantic!=ply::IGNORED && (is_vert || is_face)) store(i, prop, ply::decode(p, prop.type, swap));
+                        p += ts;
+                    }
+                }
+            }
+        }
+    }
+
+    return;
+
+    truncated:
+    std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_PLY() : unexpected end of file " << filename << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_PLY(const char                     * filename,
+              std::vector<vec3d>             & verts,
+              std::vector<vec3d>             & vert_normals,
+              std::vector<Color>             & vert_colors,
+              std::vector<vec3d>             & vert_uvw,
+              std::vector<std::vector<uint>> & polys,
+              std::vector<Color>             & poly_colors,
+              std::vector<int>               & poly_labels)
+{
+    IOData data;
+    read_PLY(filename, data);
+    polys        = data.polys();
+    verts        = std::move(data.verts);
+    vert_normals = std::move(data.normals);
+    vert_colors  = std::move(data.vert_colors);
+    vert_uvw     = std::move(data.uvw);
+    poly_colors  = std::move(data.poly_colors);
+    poly_labels  = std::move(data.poly_labels);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_PLY(const char                     * filename,
+              std::vector<vec3d>             & verts,
+              std::vector<std::vector<uint>> & polys)
+{
+    std::vector<vec3d> vert_normals, vert_uvw;
+    std::vector<Color> vert_colors, poly_colors;
+    std::vector<int>   poly_labels;
+    read_PLY(filename, verts, vert_normals, vert_colors, vert_uvw, polys, poly_colors, poly_labels);
+}
+
+}
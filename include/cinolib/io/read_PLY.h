@@ -0,0 +1,92 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_READ_PLY_H
+#define CINO_READ_PLY_H
+
+#include <sys/types.h>
+#include <vector>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+#include <cinolib/color.h>
+#include <cinolib/io/io_data.h>
+
+namespace cinolib
+{
+
+/* Reader for the Stanford PLY format (http://paulbourke.net/dataformats/ply/).
+ * ASCII, binary little endian and binary big endian files are supported.
+ * Binary files are memory mapped and decoded in bulk, without any parsing.
+ *
+ * Recognized properties are:
+ *
+ *     vertex : x y z, nx ny nz, red green blue alpha, u v (or s t, texture_u texture_v)
+ *     face   : vertex_indices (or vertex_index), red green blue alpha, label
+ *
+ * Any other element or property is skipped. Output vectors for properties
+ * that are not present in the file are left empty. Integer colors are
+ * mapped to [0,1], and texture coordinates are returned as (u,v,0)
+*/
+
+CINO_INLINE
+void read_PLY(const char * filename,
+              IOData     & data);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_PLY(const char                     * filename,
+              std::vector<vec3d>             & verts,
+              std::vector<vec3d>             & vert_normals,
+              std::vector<Color>             & vert_colors,
+              std::vector<vec3d>             & vert_uvw,
+              std::vector<std::vector<uint>> & polys,
+              std::vector<Color>             & poly_colors,
+              std::vector<int>               & poly_labels);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_PLY(const char                     * filename,
+              std::vector<vec3d>             & verts,
+              std::vector<std::vector<uint>> & polys);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "read_PLY.cpp"
+#endif
+
+#endif // CINO_READ_PLY
@@ -43,7 +43,9 @@
 *********************************************************************************/
 #include <cinolib/io/read_STL.h>
 #include <cinolib/io/io_utilities.h>
-#include <map>
+#include <cinolib/weld_vertices.h>
+#include <cinolib/parallel_for.h>
+#include <cstring>
 
 namespace cinolib
 {
@@ -52,10 +54,11 @@ CINO_INLINE
 void read_STL(const char         * filename,
               std::vector<vec3d> & verts,
               std::vector<uint>  & tris,
-              const bool           merge_duplicated_verts)
+              const bool           merge_duplicated_verts,
+              const double         merge_tolerance)
 {
     std::vector<vec3d> normals;
-    read_STL(filename, verts, normals, tris, merge_duplicated_verts);
+    read_STL(filename, verts, normals, tris, merge_duplicated_verts, merge_tolerance);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -65,7 +68,8 @@ void read_STL(const char         * filename,
               std::vector<vec3d> & verts,
               std::vector<vec3d> & normals,
               std::vector<uint>  & tris,
-              const bool           merge_duplicated_verts)
+              const bool           merge_duplicated_verts,
+              const double         merge_tolerance)
 {
     // https://en.wikipedia.org/wiki/STL_(file_format)
 
@@ -82,7 +86,8 @@ void read_STL(const char         * filename,
         exit(-1);
     }
 
-    std::map<vec3d,uint> vmap;
+    // triangle soup (serialized xyz coordinates of each triangle corner)
+    std::vector<double> soup;
 
     /* This is a horrible trick to cope with the fact that in Thingi10K
      * binary files start with the header of ASCII files even if they shouldn't.
@@ -92,7 +97,14 @@ void read_STL(const char         * filename,
     */
     bool is_binary = true;
 
-    if(seek_keyword(fp, "solid")) // ASCII file
+    // files whose size matches the one of a binary STL are surely binary:
+    // skip the ASCII attempt, which would otherwise scan the whole file
+    uint32_t nt_probe  = 0;
+    bool     size_test = (fseek(fp, 80, SEEK_SET)==0 && fread(&nt_probe, sizeof(uint32_t), 1, fp)==1 && fseek(fp, 0, SEEK_END)==0);
+    bool     sure_bin  = size_test && uint64_t(ftell(fp))==84+50*uint64_t(nt_probe);
+    rewind(fp);
+
+    if(!sure_bin && seek_keyword(fp, "solid")) // ASCII file
     {
         while(seek_keyword(fp, "facet"))
         {
@@ -114,24 +126,9 @@ void read_STL(const char         * filename,
                 if(!eat_double(fp, v.x()))      assert(false && "could not parse x coord");
                 if(!eat_double(fp, v.y()))      assert(false && "could not parse y coord");
                 if(!eat_double(fp, v.z()))      assert(false && "could not parse z coord");
-
-                if(merge_duplicated_verts)
-                {
-                    auto it = vmap.find(v);
-                    if(it == vmap.end())
-                    {
-                        uint fresh_id = uint(vmap.size());
-                        vmap[v] = fresh_id;
-                        verts.push_back(v);
-                        tris.push_back(fresh_id);
-                    }
-                    else tris.push_back(it->second);
-                }
-                else
-                {
-                    tris.push_back(uint(verts.size()));
-                    verts.push_back(v);
-                }
+                soup.push_back(v.x());
+                soup.push_back(v.y());
+                soup.push_back(v.z());
             }
             if(!seek_keyword(fp, "endloop"))  assert(false && "could not find keyword ENDLOOP");
             if(!seek_keyword(fp, "endfacet")) assert(false && "could not find keyword ENDFACET");
@@ -153,49 +150,59 @@ void read_STL(const char         * filename,
         char header[80];
         if(fread(header, 1, 80, fp)!=80) assert(false && "error reading STL binary header");
 
-        // read triangles
+        // read all triangles at once. Each record has a normal (3 floats),
+        // three verts (9 floats) and an attribute (unsigned short)
         unsigned int nt;
         if(fread(&nt, sizeof(unsigned int), 1, fp)!=1) assert(false && "error reading number of triangles");
-        for(unsigned int i=0; i<nt; ++i)
+        std::vector<char> data(size_t(nt)*50);
+        if(fread(data.data(), 1, data.size(), fp)!=data.size())
         {
-            // read normal
-            float nf[3];
-            if(fread(&nf, sizeof(float), 3, fp)!=3) assert(false && "error reading normal");
-            vec3d n(nf[0], nf[1], nf[2]);
-            normals.push_back(n);
-
-            // read verts
-            for(int j=0; j<3; ++j)
-            {
-                float vf[3];
-                if(fread(&vf, sizeof(float), 3, fp)!=3) assert(false && "error reading vertex");
-
-                vec3d v(vf[0], vf[1], vf[2]);                
-                if(merge_duplicated_verts)
-                {
-                    auto it = vmap.find(v);
-                    if(it == vmap.end())
-                    {
-                        uint fresh_id = uint(vmap.size());
-                        vmap[v] = fresh_id;
-                        verts.push_back(v);
-                        tris.push_back(fresh_id);
-                    }
-                    else tris.push_back(it->second);
-                }
-                else
-                {
-                    tris.push_back(uint(verts.size()));
-                    verts.push_back(v);
-                }
-            }
-
-            // read (and discard) attribute
-            unsigned short attribute;
-            if(fread(&attribute, sizeof(unsigned short), 1, fp)!=1) assert(false && "error reading attribute");
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_STL() : unexpected end of file " << filename << std::endl;
+            nt = 0;
         }
         fclose(fp);
+
+        normals.resize(nt);
+        soup.resize(size_t(nt)*9);
+        PARALLEL_FOR(0, nt, 10000, [&](uint i)
+        {
+            float f[12];
+            memcpy(f, data.data()+size_t(i)*50, sizeof(f));
+            normals[i] = vec3d(f[0], f[1], f[2]);
+            for(int j=0; j<9; ++j) soup[size_t(i)*9+j] = f[3+j];
+        });
     }
+
+    if(merge_duplicated_verts)
+    {
+        weld_vertices(soup, verts, tris, merge_tolerance);
+    }
+    else
+    {
+        uint nv = uint(soup.size()/3);
+        verts.resize(nv);
+        tris.resize(nv);
+        PARALLEL_FOR(0, nv, 10000, [&](uint i)
+        {
+            verts[i] = vec3d(soup[3*i], soup[3*i+1], soup[3*i+2]);
+            tris[i]  = i;
+        });
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_STL(const char   * filename,
+              IOData       & data,
+              const bool     merge_duplicated_verts,
+              const double   merge_tolerance)
+{
+    data.clear();
+    read_STL(filename, data.verts, data.poly_vids, merge_duplicated_verts, merge_tolerance);
+    uint nt = uint(data.poly_vids.size()/3);
+    data.poly_offsets.resize(nt+1);
+    for(uint pid=0; pid<=nt; ++pid) data.poly_offsets[pid] = 3*pid;
 }
 
 }
@@ -38,15 +38,23 @@
 
 #include <vector>
 #include <cinolib/geometry/vec_mat.h>
+#include <cinolib/io/io_data.h>
 
 namespace cinolib
 {
 
+/* Reads both ASCII and binary STL files. If merge_duplicated_verts is true
+ * coincident vertices are welded (see weld_vertices), otherwise the mesh is
+ * returned as a triangle soup. A positive merge_tolerance also merges vertices
+ * falling in the same cell of a grid of that size.
+*/
+
 CINO_INLINE
 void read_STL(const char         * filename,
               std::vector<vec3d> & verts,
               std::vector<uint>  & tris,
-              const bool           merge_duplicated_verts = true);
+              const bool           merge_duplicated_verts = true,
+              const double         merge_tolerance        = 0.0);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -55,7 +63,16 @@ void read_STL(const char         * filename,
               std::vector<vec3d> & verts,
               std::vector<vec3d> & normals,
               std::vector<uint>  & tris,
-              const bool           merge_duplicated_verts = true);
+              const bool           merge_duplicated_verts = true,
+              const double         merge_tolerance        = 0.0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_STL(const char   * filename,
+              IOData       & data,
+              const bool     merge_duplicated_verts = true,
+              const double   merge_tolerance        = 0.0);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -34,161 +34,491 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/io/read_VTU.h>
-
-#ifdef CINOLIB_USES_VTK
-#include <vtkSmartPointer.h>
-#include <vtkCell.h>
-#include <vtkUnstructuredGrid.h>
-#include <vtkXMLUnstructuredGridReader.h>
-#endif
+#include <cinolib/io/memory_mapped_file.h>
+#include <cinolib/io/fast_number_parsing.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
 
 namespace cinolib
 {
 
-#ifdef CINOLIB_USES_VTK
-
-CINO_INLINE
-void read_VTU(const char                      * filename,
-               std::vector<vec3d>             & verts,
-               std::vector<std::vector<uint>> & poly)
+namespace vtu
 {
-    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
-
-    vtkSmartPointer<vtkXMLUnstructuredGridReader> reader = vtkSmartPointer<vtkXMLUnstructuredGridReader>::New();
-    reader->SetFileName(filename);
-    reader->Update();
-    vtkSmartPointer<vtkUnstructuredGrid> grid(reader->GetOutput());
-
-    for(uint i=0; i<grid->GetNumberOfPoints(); ++i)
+    // a DataArray tag, as found in the XML
+    struct InArray
     {
-        double pnt[3];
-        grid->GetPoint(i, pnt);
-
-        verts.push_back(vec3d(pnt[0],pnt[1],pnt[2]));
+        std::string  name;
+        int          type     = UNKNOWN;
+        uint         n_comp   = 1;
+        std::string  format;             // ascii, binary or appended
+        size_t       offset   = 0;       // appended data only
+        const char * text_beg = nullptr; // inline data only
+        const char * text_end = nullptr;
+    };
+
+    // global properties of the file
+    struct InFile
+    {
+        const char * end             = nullptr;
+        bool         swap            = false;
+        size_t       header_size     = 4;
+        bool         compressed      = false;
+        const char * appended        = nullptr;
+        bool         appended_base64 = false;
+    };
+
+    inline const char * find(const char * beg, const char * end, const char * str)
+    {
+        return std::search(beg, end, str, str+strlen(str));
     }
 
-    for(uint i=0; i<grid->GetNumberOfCells(); ++i)
+    // finds an opening tag (e.g. "<Points"), making sure it is not the prefix of another one (e.g. "<PointData")
+    inline const char * find_tag(const char * beg, const char * end, const char * tag)
     {
-        vtkCell *c = grid->GetCell(i);
-
-        std::vector<uint> polyhedron;
-        switch (c->GetCellType())
+        size_t len = strlen(tag);
+        for(const char * p=find(beg,end,tag); p!=end; p=find(p+len,end,tag))
         {
-            case VTK_TETRA:      for(uint j=0; j<4; ++j) polyhedron.push_back(c->GetPointId(j)); break;
-            case VTK_HEXAHEDRON: for(uint j=0; j<8; ++j) polyhedron.push_back(c->GetPointId(j)); break;
+            if(p+len<end && (p[len]=='>' || p[len]=='/' || isspace(p[len]))) return p;
         }
+        return end;
+    }
 
-        if(!polyhedron.empty()) poly.push_back(polyhedron);
+    // value of the attribute key in the tag [beg,end)
+    inline bool attribute(const char * beg, const char * end, const char * key, std::string & val)
+    {
+        size_t len = strlen(key);
+        for(const char * p=find(beg,end,key); p!=end; p=find(p+len,end,key))
+        {
+            if(p==beg || !isspace(p[-1])) continue;
+            const char * q = p+len;
+            while(q<end && isspace(*q)) ++q;
+            if(q==end || *q!='=') continue;
+            ++q;
+            while(q<end && isspace(*q)) ++q;
+            if(q==end || (*q!='"' && *q!='\'')) continue;
+            const char * r = std::find(q+1, end, *q);
+            val.assign(q+1, r);
+            return true;
+        }
+        return false;
     }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-CINO_INLINE
-void read_VTU(const char                      * filename,
-               std::vector<double>            & xyz,
-               std::vector<std::vector<uint>> & poly)
+namespace vtu
 {
-    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+    // reads n header words (UInt32 or UInt64), raw or base64 encoded
+    inline bool read_header(const InFile & f, const char * p, const bool b64, const size_t n, std::vector<uint64_t> & words)
+    {
+        size_t n_bytes = n*f.header_size;
+        std::vector<char> tmp(n_bytes+3);
+        if(b64)
+        {
+            size_t n_chars = base64_encoded_size(n_bytes);
+            if(p+n_chars>f.end) return false;
+            base64_decode(p, n_chars, tmp.data());
+        }
+        else
+        {
+            if(p+n_bytes>f.end) return false;
+            memcpy(tmp.data(), p, n_bytes);
+        }
+        if(f.swap) swap_bytes(tmp.data(), n, f.header_size);
+        words.resize(n);
+        for(size_t i=0; i<n; ++i)
+        {
+            if(f.header_size==8) { uint64_t w; memcpy(&w, tmp.data()+8*i, 8); words[i] = w; }
+            else                 { uint32_t w; memcpy(&w, tmp.data()+4*i, 4); words[i] = w; }
+        }
+        return true;
+    }
 
-    vtkSmartPointer<vtkXMLUnstructuredGridReader> reader = vtkSmartPointer<vtkXMLUnstructuredGridReader>::New();
-    reader->SetFileName(filename);
-    reader->Update();
-    vtkSmartPointer<vtkUnstructuredGrid> grid(reader->GetOutput());
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    for(uint i=0; i<grid->GetNumberOfPoints(); ++i)
+    // decodes a binary data block (header included) starting at p
+    inline bool read_binary(const InFile & f, const char * p, const bool b64, std::vector<char> & bytes)
     {
-        double pnt[3];
-        grid->GetPoint(i, pnt);
+        const size_t hs = f.header_size;
+        std::vector<uint64_t> header;
 
-        xyz.push_back(pnt[0]);
-        xyz.push_back(pnt[1]);
-        xyz.push_back(pnt[2]);
+        if(!f.compressed)
+        {
+            if(!read_header(f, p, b64, 1, header)) return false;
+            size_t n = header[0];
+            if(!b64)
+            {
+                if(p+hs+n>f.end) return false;
+                bytes.assign(p+hs, p+hs+n);
+                return true;
+            }
+            // header and data are encoded together
+            size_t n_chars = base64_encoded_size(hs+n);
+            if(p+n_chars>f.end) return false;
+            bytes.resize(hs+n+3);
+            base64_decode(p, n_chars, bytes.data());
+            bytes.erase(bytes.begin(), bytes.begin()+hs);
+            bytes.resize(n);
+            return true;
+        }
+
+        // compressed data: [#blocks, block size, last block size, compressed sizes...]
+        if(!read_header(f, p, b64, 3, header)) return false;
+        size_t n_blocks = header[0];
+        if(!read_header(f, p, b64, 3+n_blocks, header)) return false;
+
+        size_t n_compressed = 0;
+        for(size_t b=0; b<n_blocks; ++b) n_compressed += header[3+b];
+        size_t n = (n_blocks==0) ? 0 : (n_blocks-1)*header[1] + (header[2]>0 ? header[2] : header[1]);
+        bytes.resize(n);
+
+        const char * blocks;
+        std::vector<char> tmp;
+        if(b64)
+        {
+            // header and data are encoded separately
+            const char * q = p + base64_encoded_size((3+n_blocks)*hs);
+            size_t n_chars = base64_encoded_size(n_compressed);
+            if(q+n_chars>f.end) return false;
+            tmp.resize(n_compressed+3);
+            base64_decode(q, n_chars, tmp.data());
+            blocks = tmp.data();
+        }
+        else
+        {
+            blocks = p + (3+n_blocks)*hs;
+            if(blocks+n_compressed>f.end) return false;
+        }
+        return zlib_decompress(header, blocks, bytes.data());
     }
 
-    for(uint i=0; i<grid->GetNumberOfCells(); ++i)
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    template<typename S, typename T>
+    inline void cast(const std::vector<char> & bytes, std::vector<T> & out)
+    {
+        out.resize(bytes.size()/sizeof(S));
+        PARALLEL_FOR(0, uint(out.size()), 100000, [&](const uint i)
+        {
+            S val;
+            memcpy(&val, bytes.data()+i*sizeof(S), sizeof(S));
+            out[i] = static_cast<T>(val);
+        });
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // decodes a data array and converts its values to T
+    template<typename T>
+    inline bool read_array(const InFile & f, const InArray & a, std::vector<T> & out)
     {
-        vtkCell *c = grid->GetCell(i);
+        if(a.format=="ascii")
+        {
+            out.clear();
+            const char * p = a.text_beg;
+            while(true)
+            {
+                while(p<a.text_end && isspace(*p)) ++p;
+                if(p==a.text_end) return true;
+                double d;
+                if(!fast_parse_double(p, a.text_end, d)) return false;
+                out.push_back(static_cast<T>(d));
+            }
+        }
 
-        std::vector<uint> polyhedron;
-        switch (c->GetCellType())
+        std::vector<char> bytes;
+        if(a.format=="binary")
+        {
+            const char * p = a.text_beg;
+            while(p<a.text_end && isspace(*p)) ++p;
+            if(!read_binary(f, p, true, bytes)) return false;
+        }
+        else if(a.format=="appended")
         {
-            case VTK_TETRA:      for(uint j=0; j<4; ++j) polyhedron.push_back(c->GetPointId(j)); break;
-            case VTK_HEXAHEDRON: for(uint j=0; j<8; ++j) polyhedron.push_back(c->GetPointId(j)); break;
+            if(f.appended==nullptr || f.appended+a.offset>=f.end) return false;
+            if(!read_binary(f, f.appended+a.offset, f.appended_base64, bytes)) return false;
         }
+        else return false;
 
-        if(!polyhedron.empty()) poly.push_back(polyhedron);
+        if(f.swap) swap_bytes(bytes.data(), bytes.size()/type_size(a.type), type_size(a.type));
+
+        switch(a.type)
+        {
+            case INT8   : cast<int8_t  >(bytes, out); break;
+            case UINT8  : cast<uint8_t >(bytes, out); break;
+            case INT16  : cast<int16_t >(bytes, out); break;
+            case UINT16 : cast<uint16_t>(bytes, out); break;
+            case INT32  : cast<int32_t >(bytes, out); break;
+            case UINT32 : cast<uint32_t>(bytes, out); break;
+            case INT64  : cast<int64_t >(bytes, out); break;
+            case UINT64 : cast<uint64_t>(bytes, out); break;
+            case FLOAT32: cast<float   >(bytes, out); break;
+            case FLOAT64: cast<double  >(bytes, out); break;
+            default     : return false;
+        }
+        return true;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // lists all the DataArray tags in the range [beg,end)
+    inline std::vector<InArray> list_arrays(const char * beg, const char * end)
+    {
+        std::vector<InArray> arrays;
+        for(const char * p=find_tag(beg,end,"<DataArray"); p!=end; p=find_tag(p,end,"<DataArray"))
+        {
+            const char * tag_end = std::find(p, end, '>');
+            if(tag_end==end) break;
+
+            InArray a;
+            std::string val;
+            if(attribute(p, tag_end, "type",               val)) a.type   = type_from_name(val);
+            if(attribute(p, tag_end, "Name",               val)) a.name   = val;
+            if(attribute(p, tag_end, "NumberOfComponents", val)) a.n_comp = std::max(1, atoi(val.c_str()));
+            if(attribute(p, tag_end, "format",             val)) a.format = val;
+            if(attribute(p, tag_end, "offset",             val)) a.offset = strtoull(val.c_str(), nullptr, 10);
+
+            if(tag_end[-1]=='/') p = tag_end+1; // empty element
+            else
+            {
+                a.text_beg = tag_end+1;
+                a.text_end = find(a.text_beg, end, "</DataArray>");
+                p = a.text_end;
+            }
+            arrays.push_back(a);
+        }
+        return arrays;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    // lists the DataArray tags of a section (e.g. "PointData") of a piece
+    inline std::vector<InArray> list_arrays(const char * beg, const char * end, const std::string & section)
+    {
+        const char * s = find_tag(beg, end, ("<" + section).c_str());
+        if(s==end) return {};
+        const char * s_end = find(s, end, ("</" + section + ">").c_str());
+        return list_arrays(s, s_end);
     }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void read_VTU(const char           * filename,
-               std::vector<double> & xyz,
-               std::vector<uint>   & tets,
-               std::vector<uint>   & hexa)
+void read_VTU(const char                     * filename,
+              std::vector<vec3d>             & verts,
+              std::vector<std::vector<uint>> & poly,
+              std::vector<VTUArray>          & point_data,
+              std::vector<VTUArray>          & cell_data)
 {
-
     setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
 
-    vtkSmartPointer<vtkXMLUnstructuredGridReader> reader = vtkSmartPointer<vtkXMLUnstructuredGridReader>::New();
-    reader->SetFileName(filename);
-    reader->Update();
-    vtkSmartPointer<vtkUnstructuredGrid> grid(reader->GetOutput());
+    MemoryMappedFile file(filename);
+    if(!file.is_open())
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_VTU() : couldn't open input file " << filename << std::endl;
+        exit(-1);
+    }
 
-    for(uint i=0; i<grid->GetNumberOfPoints(); ++i)
+    auto error = [&](const char * msg)
     {
-        double pnt[3];
-        grid->GetPoint(i, pnt);
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_VTU() : " << msg << " (" << filename << ")" << std::endl;
+    };
+
+    vtu::InFile f;
+    f.end = file.end();
 
-        xyz.push_back(pnt[0]);
-        xyz.push_back(pnt[1]);
-        xyz.push_back(pnt[2]);
+    // the XML part ends where the appended data (if any) begins
+    const char * xml_end = vtu::find(file.begin(), file.end(), "<AppendedData");
+
+    const char * t = vtu::find_tag(file.begin(), xml_end, "<VTKFile");
+    const char * t_end = std::find(t, xml_end, '>');
+    std::string val;
+    if(t==xml_end || !vtu::attribute(t, t_end, "type", val) || val!="UnstructuredGrid")
+    {
+        error("not a VTK Unstructured Grid");
+        return;
+    }
+    bool big_endian = (vtu::attribute(t, t_end, "byte_order", val) && val=="BigEndian");
+    f.swap = (big_endian == vtu::host_is_little_endian());
+    f.header_size = (vtu::attribute(t, t_end, "header_type", val) && val=="UInt64") ? 8 : 4;
+    if(vtu::attribute(t, t_end, "compressor", val) && !val.empty())
+    {
+        if(val!="vtkZLibDataCompressor")
+        {
+            error(("unsupported compressor " + val).c_str());
+            return;
+        }
+        f.compressed = true;
+    }
+    if(xml_end!=file.end())
+    {
+        const char * a_end = std::find(xml_end, file.end(), '>');
+        f.appended_base64  = (vtu::attribute(xml_end, a_end, "encoding", val) && val=="base64");
+        f.appended         = std::find(a_end, file.end(), '_');
+        if(f.appended!=file.end()) ++f.appended;
     }
 
-    for(uint i=0; i<grid->GetNumberOfCells(); ++i)
+    point_data.clear();
+    cell_data.clear();
+
+    // appends the content of a VTUArray to another array with the same name (if any)
+    auto merge = [](std::vector<VTUArray> & dst, const VTUArray & a)
+    {
+        for(VTUArray & b : dst)
+        {
+            if(b.name==a.name && b.is_int==a.is_int && b.n_comp==a.n_comp)
+            {
+                b.int_data.insert (b.int_data.end(),  a.int_data.begin(),  a.int_data.end());
+                b.real_data.insert(b.real_data.end(), a.real_data.begin(), a.real_data.end());
+                return;
+            }
+        }
+        dst.push_back(a);
+    };
+
+    auto read_attribute = [&](const vtu::InArray & in, VTUArray & a) -> bool
     {
-        vtkCell *c = grid->GetCell(i);
+        a.name   = in.name;
+        a.n_comp = in.n_comp;
+        a.is_int = (in.type!=vtu::FLOAT32 && in.type!=vtu::FLOAT64);
+        return a.is_int ? vtu::read_array(f, in, a.int_data) : vtu::read_array(f, in, a.real_data);
+    };
 
-        switch (c->GetCellType())
+    for(const char * p=vtu::find_tag(file.begin(), xml_end, "<Piece"); p!=xml_end; p=vtu::find_tag(p, xml_end, "<Piece"))
+    {
+        const char * p_end = vtu::find(p, xml_end, "</Piece>");
+        uint base = uint(verts.size());
+
+        // points
+        std::vector<vtu::InArray> arrays = vtu::list_arrays(p, p_end, "Points");
+        std::vector<double> xyz;
+        if(arrays.empty() || arrays.front().n_comp!=3 || !vtu::read_array(f, arrays.front(), xyz))
         {
-            case VTK_TETRA:      for(uint j=0; j<4; ++j) tets.push_back(c->GetPointId(j)); break;
-            case VTK_HEXAHEDRON: for(uint j=0; j<8; ++j) hexa.push_back(c->GetPointId(j)); break;
+            error("couldn't read points");
+            return;
         }
+        size_t nv = xyz.size()/3;
+        verts.resize(base+nv);
+        PARALLEL_FOR(0, uint(nv), 100000, [&](const uint vid)
+        {
+            verts[base+vid] = vec3d(xyz[3*vid], xyz[3*vid+1], xyz[3*vid+2]);
+        });
+
+        // cells (only tets and hexa are retained)
+        std::vector<int64_t> conn, offsets, types;
+        for(const vtu::InArray & a : vtu::list_arrays(p, p_end, "Cells"))
+        {
+            bool ok = true;
+            if(a.name=="connectivity") ok = vtu::read_array(f, a, conn);    else
+            if(a.name=="offsets"     ) ok = vtu::read_array(f, a, offsets); else
+            if(a.name=="types"       ) ok = vtu::read_array(f, a, types);
+            if(!ok)
+            {
+                error(("couldn't read cell array " + a.name).c_str());
+                return;
+            }
+        }
+        if(offsets.size()!=types.size())
+        {
+            error("inconsistent cell arrays");
+            return;
+        }
+        std::vector<uint> kept;
+        for(size_t cid=0; cid<types.size(); ++cid)
+        {
+            size_t beg = (cid>0) ? size_t(offsets[cid-1]) : 0;
+            size_t end = size_t(offsets[cid]);
+            if(end>conn.size() || beg>end) { error("inconsistent cell arrays"); return; }
+            if((types[cid]==vtu::VTK_TETRA_ID      && end-beg==4) ||
+               (types[cid]==vtu::VTK_HEXAHEDRON_ID && end-beg==8))
+            {
+                std::vector<uint> cell(end-beg);
+                for(size_t i=beg; i<end; ++i) cell[i-beg] = base + uint(conn[i]);
+                poly.push_back(cell);
+                kept.push_back(uint(cid));
+            }
+        }
+
+        // attributes
+        for(const vtu::InArray & in : vtu::list_arrays(p, p_end, "PointData"))
+        {
+            VTUArray a;
+            if(read_attribute(in, a) && a.size()==nv) merge(point_data, a);
+            else error(("couldn't read point data " + in.name).c_str());
+        }
+        for(const vtu::InArray & in : vtu::list_arrays(p, p_end, "CellData"))
+        {
+            VTUArray a, b;
+            if(!read_attribute(in, a) || a.size()!=types.size())
+            {
+                error(("couldn't read cell data " + in.name).c_str());
+                continue;
+            }
+            b.name   = a.name;
+            b.n_comp = a.n_comp;
+            b.is_int = a.is_int;
+            for(uint cid : kept)
+            {
+                for(uint i=cid*a.n_comp; i<(cid+1)*a.n_comp; ++i)
+                {
+                    if(a.is_int) b.int_data.push_back(a.int_data[i]);
+                    else         b.real_data.push_back(a.real_data[i]);
+                }
+            }
+            merge(cell_data, b);
+        }
+
+        p = p_end;
     }
 }
 
-#else
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void read_VTU(const char          *,
-               std::vector<double> &,
-               std::vector<uint>   &,
-               std::vector<uint>   &)
+void read_VTU(const char                      * filename,
+               std::vector<vec3d>             & verts,
+               std::vector<std::vector<uint>> & poly)
 {
-    std::cerr << "ERROR : VTK missing. Install VTK and recompile defining symbol CINOLIB_USES_VTK" << std::endl;
-    exit(-1);
+    std::vector<VTUArray> point_data, cell_data;
+    read_VTU(filename, verts, poly, point_data, cell_data);
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
-void read_VTU(const char                      *,
-               std::vector<double>            &,
-               std::vector<std::vector<uint>> &)
+void read_VTU(const char                      * filename,
+               std::vector<double>            & xyz,
+               std::vector<std::vector<uint>> & poly)
 {
-    std::cerr << "ERROR : VTK missing. Install VTK and recompile defining symbol CINOLIB_USES_VTK" << std::endl;
-    exit(-1);
+    std::vector<vec3d> verts;
+    read_VTU(filename, verts, poly);
+    for(const vec3d & v : verts)
+    {
+        xyz.push_back(v.x());
+        xyz.push_back(v.y());
+        xyz.push_back(v.z());
+    }
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
-void read_VTU(const char                      *,
-               std::vector<vec3d>             &,
-               std::vector<std::vector<uint>> &)
+void read_VTU(const char           * filename,
+               std::vector<double> & xyz,
+               std::vector<uint>   & tets,
+               std::vector<uint>   & hexa)
 {
-    std::cerr << "ERROR : VTK missing. Install VTK and recompile defining symbol CINOLIB_USES_VTK" << std::endl;
-    exit(-1);
+    std::vector<std::vector<uint>> poly;
+    read_VTU(filename, xyz, poly);
+    for(const auto & p : poly)
+    {
+        if(p.size()==4) tets.insert(tets.end(), p.begin(), p.end());
+        else            hexa.insert(hexa.end(), p.begin(), p.end());
+    }
 }
 
-#endif
-
 }
@@ -40,6 +40,7 @@
 #include <vector>
 #include <cinolib/cino_inline.h>
 #include <cinolib/geometry/vec_mat.h>
+#include <cinolib/io/vtu_utilities.h>
 
 
 namespace cinolib
@@ -66,6 +67,22 @@ void read_VTU(const char                      * filename,
                std::vector<vec3d>             & verts,
                std::vector<std::vector<uint>> & poly);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Native reader for VTK XML Unstructured Grids. It supports ASCII, inline
+ * base64 and appended (raw or base64) data, optionally compressed with zlib
+ * (requires symbol CINOLIB_USES_ZLIB). Binary arrays are decoded with bulk
+ * copies. Only tetrahedra and hexahedra are retained; cell attributes are
+ * filtered accordingly, so that they remain aligned with poly.
+*/
+
+CINO_INLINE
+void read_VTU(const char                     * filename,
+              std::vector<vec3d>             & verts,
+              std::vector<std::vector<uint>> & poly,
+              std::vector<VTUArray>          & point_data,
+              std::vector<VTUArray>          & cell_data);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -36,15 +36,21 @@
 #ifndef CINO_READ_WRITE_H
 #define CINO_READ_WRITE_H
 
+// FLAT CONTAINER FILLED BY READERS
+#include <cinolib/io/io_data.h>
+
+
 // SURFACE READERS
 #include <cinolib/io/read_OBJ.h>
 #include <cinolib/io/read_OFF.h>
 #include <cinolib/io/read_IV.h>
 #include <cinolib/io/read_STL.h>
+#include <cinolib/io/read_PLY.h>
 // SURFACE WRITERS
 #include <cinolib/io/write_OBJ.h>
 #include <cinolib/io/write_OFF.h>
 #include <cinolib/io/write_STL.h>
+#include <cinolib/io/write_PLY.h>
 #include <cinolib/io/write_NODE_ELE.h>
 
 
@@ -52,17 +58,25 @@
 #include <cinolib/io/read_HEDRA.h>
 #include <cinolib/io/read_HYBRID.h>
 #include <cinolib/io/read_MESH.h>
+#include <cinolib/io/read_MESHB.h>
 #include <cinolib/io/read_TET.h>
 #include <cinolib/io/read_VTU.h>
 #include <cinolib/io/read_VTK.h>
 #include <cinolib/io/read_HEXEX.h>
+#include <cinolib/io/read_MSH.h>
 // VOLUME WRITERS
 #include <cinolib/io/write_HEDRA.h>
 #include <cinolib/io/write_MESH.h>
+#include <cinolib/io/write_MESHB.h>
 #include <cinolib/io/write_TET.h>
 #include <cinolib/io/write_VTU.h>
 #include <cinolib/io/write_VTK.h>
 #include <cinolib/io/write_OVM.h>
+#include <cinolib/io/write_MSH.h>
+
+
+// OUT OF CORE READERS
+#include <cinolib/io/mesh_stream_reader.h>
 
 
 // SKELETON READERS
@@ -0,0 +1,275 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/vtu_utilities.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+
+#ifdef CINOLIB_USES_ZLIB
+#include <zlib.h>
+#endif
+
+namespace cinolib
+{
+namespace vtu
+{
+
+CINO_INLINE
+size_t type_size(const int type)
+{
+    switch(type)
+    {
+        case INT8  : case UINT8  : return 1;
+        case INT16 : case UINT16 : return 2;
+        case INT32 : case UINT32 : case FLOAT32 : return 4;
+        case INT64 : case UINT64 : case FLOAT64 : return 8;
+        default : return 0;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const char * type_name(const int type)
+{
+    static const char * names[] = { "Int8", "UInt8", "Int16", "UInt16", "Int32", "UInt32",
+                                    "Int64", "UInt64", "Float32", "Float64", "Unknown" };
+    return names[std::min(type, int(UNKNOWN))];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int type_from_name(const std::string & name)
+{
+    for(int t=INT8; t<UNKNOWN; ++t) if(name==type_name(t)) return t;
+    return UNKNOWN;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t base64_encoded_size(const size_t n_bytes)
+{
+    return 4*((n_bytes+2)/3);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void base64_encode(const char * src, const size_t n, std::vector<char> & dst)
+{
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    size_t off = dst.size();
+    dst.resize(off + base64_encoded_size(n));
+
+    // every 3 input bytes become 4 output chars, hence chunks of
+    // 3*k bytes can be encoded independently from one another
+    const size_t chunk    = 3*65536;
+    const size_t n_chunks = (n+chunk-1)/chunk;
+    PARALLEL_FOR(0, uint(n_chunks), 4, [&](const uint c)
+    {
+        const unsigned char * s   = reinterpret_cast<const unsigned char*>(src) + c*chunk;
+        const unsigned char * end = reinterpret_cast<const unsigned char*>(src) + std::min(n, (c+1)*chunk);
+        char * d = dst.data() + off + 4*(c*chunk/3);
+        for(; s+3<=end; s+=3, d+=4)
+        {
+            uint32_t v = (uint32_t(s[0])<<16) | (uint32_t(s[1])<<8) | uint32_t(s[2]);
+            d[0] = table[(v>>18) & 63];
+            d[1] = table[(v>>12) & 63];
+            d[2] = table[(v>> 6) & 63];
+            d[3] = table[ v      & 63];
+        }
+        if(s<end) // tail (only in the last chunk)
+        {
+            uint32_t v = uint32_t(s[0])<<16;
+            if(s+1<end) v |= uint32_t(s[1])<<8;
+            d[0] = table[(v>>18) & 63];
+            d[1] = table[(v>>12) & 63];
+            d[2] = (s+1<end) ? table[(v>>6) & 63] : '=';
+            d[3] = '=';
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t base64_decode(const char * src, const size_t n_chars, char * dst)
+{
+    static signed char table[256];
+    static bool init = [](){
+        std::fill(table, table+256, -1);
+        const char * chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for(int i=0; i<64; ++i) table[uint8_t(chars[i])] = static_cast<signed char>(i);
+        return true;
+    }();
+    (void)init;
+
+    assert(n_chars%4==0);
+    const size_t n_quads = n_chars/4;
+    if(n_quads==0) return 0;
+
+    // all quads but the last one are full
+    const size_t chunk    = 65536;
+    const size_t n_chunks = (n_quads-1+chunk-1)/chunk;
+    PARALLEL_FOR(0, uint(n_chunks), 4, [&](const uint c)
+    {
+        size_t q_end = std::min(n_quads-1, (c+1)*chunk);
+        for(size_t q=c*chunk; q<q_end; ++q)
+        {
+            const uint8_t * s = reinterpret_cast<const uint8_t*>(src) + 4*q;
+            uint32_t v = (uint32_t(table[s[0]])<<18) | (uint32_t(table[s[1]])<<12) |
+                         (uint32_t(table[s[2]])<< 6) |  uint32_t(table[s[3]]);
+            char * d = dst + 3*q;
+            d[0] = char(v>>16);
+            d[1] = char(v>> 8);
+            d[2] = char(v    );
+        }
+    });
+
+    // last quad (may contain padding)
+    const uint8_t * s = reinterpret_cast<const uint8_t*>(src) + 4*(n_quads-1);
+    char * d = dst + 3*(n_quads-1);
+    uint32_t v = (uint32_t(table[s[0]])<<18) | (uint32_t(table[s[1]])<<12);
+    size_t n = 1;
+    if(s[2]!='=') { v |= uint32_t(table[s[2]])<<6; ++n; }
+    if(s[3]!='=') { v |= uint32_t(table[s[3]]);    ++n; }
+    d[0] = char(v>>16);
+    if(n>1) d[1] = char(v>>8);
+    if(n>2) d[2] = char(v);
+    return 3*(n_quads-1) + n;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+#ifdef CINOLIB_USES_ZLIB
+
+CINO_INLINE
+bool zlib_compress(const std::vector<char> & data,
+                   const int                 level,
+                   std::vector<uint64_t>   & header,
+                   std::vector<char>       & blocks)
+{
+    size_t n_blocks = (data.size()+ZLIB_BLOCK_SIZE-1)/ZLIB_BLOCK_SIZE;
+
+    std::vector<std::vector<char>> tmp(n_blocks);
+    std::atomic<bool> ok(true);
+    PARALLEL_FOR(0, uint(n_blocks), 4, [&](const uint b)
+    {
+        size_t beg = b*ZLIB_BLOCK_SIZE;
+        size_t len = std::min(ZLIB_BLOCK_SIZE, data.size()-beg);
+        uLongf dst_len = compressBound(uLong(len));
+        tmp[b].resize(dst_len);
+        if(compress2(reinterpret_cast<Bytef*>(tmp[b].data()), &dst_len,
+                     reinterpret_cast<const Bytef*>(data.data()+beg), uLong(len), level)!=Z_OK) ok = false;
+        tmp[b].resize(dst_len);
+    });
+    if(!ok) return false;
+
+    header.resize(3+n_blocks);
+    header[0] = n_blocks;
+    header[1] = ZLIB_BLOCK_SIZE;
+    header[2] = data.size()%ZLIB_BLOCK_SIZE; // as in VTK, zero means that the last block is full
+    size_t tot = 0;
+    for(size_t b=0; b<n_blocks; ++b)
+    {
+        header[3+b] = tmp[b].size();
+        tot += tmp[b].size();
+    }
+    blocks.clear();
+    blocks.reserve(tot);
+    for(const auto & b : tmp) blocks.insert(blocks.end(), b.begin(), b.end());
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool zlib_decompress(const std::vector<uint64_t> & header,
+                     const char                  * blocks,
+                     char                        * dst)
+{
+    size_t n_blocks = header[0];
+    std::vector<size_t> offsets(n_blocks+1,0);
+    for(size_t b=0; b<n_blocks; ++b) offsets[b+1] = offsets[b] + header[3+b];
+
+    std::atomic<bool> ok(true);
+    PARALLEL_FOR(0, uint(n_blocks), 4, [&](const uint b)
+    {
+        uLongf len = uLongf((b+1<n_blocks || header[2]==0) ? header[1] : header[2]);
+        uLongf exp = len;
+        if(uncompress(reinterpret_cast<Bytef*>(dst + b*header[1]), &len,
+                      reinterpret_cast<const Bytef*>(blocks + offsets[b]), uLong(header[3+b]))!=Z_OK || len!=exp) ok = false;
+    });
+    return ok;
+}
+
+#else
+
+CINO_INLINE
+bool zlib_compress(const std::vector<char> &, const int, std::vector<uint64_t> &, std::vector<char> &)
+{
+    std::cerr << "ERROR : zlib missing. Install zlib and recompile defining symbol CINOLIB_USES_ZLIB" << std::endl;
+    return false;
+}
+
+CINO_INLINE
+bool zlib_decompress(const std::vector<uint64_t> &, const char *, char *)
+{
+    std::cerr << "ERROR : zlib missing. Install zlib and recompile defining symbol CINOLIB_USES_ZLIB" << std::endl;
+    return false;
+}
+
+#endif
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void swap_bytes(char * data, const size_t n, const size_t elem_size)
+{
+    if(elem_size<2) return;
+    PARALLEL_FOR(0, uint(n), 1000000, [&](const uint i)
+    {
+        std::reverse(data + i*elem_size, data + (i+1)*elem_size);
+    });
+}
+
+}
+}
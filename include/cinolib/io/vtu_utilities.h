@@ -0,0 +1,154 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_VTU_UTILITIES_H
+#define CINO_VTU_UTILITIES_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Data encodings supported by the VTU (VTK XML Unstructured Grid) reader and
+ * writer. Inline data is stored within each DataArray tag. Appended data is
+ * stored, one array after the other, in a single block at the end of the file.
+ * Binary data (both inline and appended) can be zlib compressed (only if
+ * CinoLib is compiled with symbol CINOLIB_USES_ZLIB) using the same block
+ * layout of the vtkZLibDataCompressor, hence ParaView can open such files.
+*/
+
+enum
+{
+    VTU_ASCII,          // inline, as text
+    VTU_BINARY,         // inline, base64 encoded
+    VTU_APPENDED_RAW,   // appended, raw binary (fastest and smallest)
+    VTU_APPENDED_BASE64 // appended, base64 encoded
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Named per point or per cell attribute (e.g. labels, quality, scalar fields).
+ * Values are interleaved (n_comp values per element) and are written either
+ * as Int32 or as Float64, depending on which constructor was used.
+*/
+
+struct VTUArray
+{
+    explicit VTUArray() {}
+
+    explicit VTUArray(const std::string & name, const std::vector<double> & data, const uint n_comp = 1)
+        : name(name), n_comp(n_comp), is_int(false), real_data(data) {}
+
+    explicit VTUArray(const std::string & name, const std::vector<int> & data, const uint n_comp = 1)
+        : name(name), n_comp(n_comp), is_int(true), int_data(data) {}
+
+    size_t size() const { return (is_int ? int_data.size() : real_data.size()) / n_comp; }
+
+    std::string         name;
+    uint                n_comp = 1;
+    bool                is_int = false;
+    std::vector<double> real_data;
+    std::vector<int>    int_data;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+namespace vtu
+{
+    // VTK cell types used in CinoLib (see vtkCellType.h)
+    enum { VTK_TETRA_ID = 10, VTK_HEXAHEDRON_ID = 12 };
+
+    // scalar types of DataArrays
+    enum { INT8, UINT8, INT16, UINT16, INT32, UINT32, INT64, UINT64, FLOAT32, FLOAT64, UNKNOWN };
+
+    // the uncompressed block size used by the vtkZLibDataCompressor
+    static const size_t ZLIB_BLOCK_SIZE = 32768;
+
+    CINO_INLINE
+    size_t type_size(const int type);
+
+    CINO_INLINE
+    const char * type_name(const int type);
+
+    CINO_INLINE
+    int type_from_name(const std::string & name);
+
+    inline bool host_is_little_endian()
+    {
+        const uint16_t one = 1;
+        return *reinterpret_cast<const char*>(&one)==1;
+    }
+
+    CINO_INLINE
+    size_t base64_encoded_size(const size_t n_bytes);
+
+    // appends to dst the base64 encoding of the n bytes in src
+    CINO_INLINE
+    void base64_encode(const char * src, const size_t n, std::vector<char> & dst);
+
+    // decodes n_chars base64 characters (a multiple of 4) and returns the number of bytes written in dst
+    CINO_INLINE
+    size_t base64_decode(const char * src, const size_t n_chars, char * dst);
+
+    // splits data in blocks and compresses them in parallel. On output, header contains
+    // [#blocks, block size, last block size (0 if full), compressed size of each block]
+    CINO_INLINE
+    bool zlib_compress(const std::vector<char> & data,
+                       const int                 level,
+                       std::vector<uint64_t>   & header,
+                       std::vector<char>       & blocks);
+
+    // inverse of zlib_compress. dst must be large enough to contain the uncompressed data
+    CINO_INLINE
+    bool zlib_decompress(const std::vector<uint64_t> & header,
+                         const char                  * blocks,
+                         char                        * dst);
+
+    // reverses the byte order of n consecutive elements of the given size
+    CINO_INLINE
+    void swap_bytes(char * data, const size_t n, const size_t elem_size);
+}
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "vtu_utilities.cpp"
+#endif
+
+#endif // CINO_VTU_UTILITIES_H
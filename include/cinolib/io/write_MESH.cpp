@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/io/write_MESH.h>
+#include <cinolib/io/buffered_text_writer.h>
 
 #include <iostream>
 
@@ -76,42 +77,47 @@ void write_MESH(const char                           * filename,
     {
         fprintf(fp, "Vertices\n" );
         fprintf(fp, "%d\n", nv);
-        for(uint vid=0; vid<nv; ++vid)
+        write_parallel(fp, nv, [&](const uint vid, TextBuffer & buf)
         {
-            // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-            //
-            fprintf( fp, "%.17g %.17g %.17g %d\n", verts.at(vid).x(), verts.at(vid).y(), verts.at(vid).z(), vert_labels.at(vid));
-        }
+            const vec3d & p = verts.at(vid);
+            buf.put(p.x()); buf.put(' ');
+            buf.put(p.y()); buf.put(' ');
+            buf.put(p.z()); buf.put(' ');
+            buf.put(vert_labels.at(vid));
+            buf.put('\n');
+        });
     }
 
     if (nt > 0)
     {
         fprintf(fp, "Tetrahedra\n" );
         fprintf(fp, "%d\n", nt );
-        for(uint pid=0; pid<polys.size(); ++pid)
+        write_parallel(fp, uint(polys.size()), [&](const uint pid, TextBuffer & buf)
         {
             const std::vector<uint> & tet = polys.at(pid);
             if (tet.size() == 4)
             {
-                fprintf(fp, "%d %d %d %d %d\n", tet.at(0)+1, tet.at(1)+1, tet.at(2)+1, tet.at(3)+1, poly_labels.at(pid));
+                for(uint vid : tet) { buf.put(vid+1); buf.put(' '); }
+                buf.put(poly_labels.at(pid));
+                buf.put('\n');
             }
-        }
+        });
     }
 
     if (nh > 0)
     {
         fprintf(fp, "Hexahedra\n" );
         fprintf(fp, "%d\n", nh );
-        for(uint pid=0; pid<polys.size(); ++pid)
+        write_parallel(fp, uint(polys.size()), [&](const uint pid, TextBuffer & buf)
         {
             const std::vector<uint> & hex = polys.at(pid);
             if (hex.size() == 8)
             {
-                fprintf(fp, "%d %d %d %d %d %d %d %d %d\n", hex.at(0)+1, hex.at(1)+1, hex.at(2)+1, hex.at(3)+1,
-                                                            hex.at(4)+1, hex.at(5)+1, hex.at(6)+1, hex.at(7)+1,
-                                                            poly_labels.at(pid));
+                for(uint vid : hex) { buf.put(vid+1); buf.put(' '); }
+                buf.put(poly_labels.at(pid));
+                buf.put('\n');
             }
-        }
+        });
     }
 
     fprintf(fp, "End\n\n");
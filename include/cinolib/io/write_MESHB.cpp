@@ -0,0 +1,218 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/write_MESHB.h>
+#include <cinolib/io/meshb_utilities.h>
+#include <cinolib/parallel_for.h>
+#include <climits>
+#include <iostream>
+
+namespace cinolib
+{
+
+namespace meshb
+{
+    // ids of the elements with npe vertices
+    inline std::vector<uint> elements_of_size(const std::vector<std::vector<uint>> & elems, const uint npe)
+    {
+        std::vector<uint> ids;
+        for(uint i=0; i<elems.size(); ++i) if(elems[i].size()==npe) ids.push_back(i);
+        return ids;
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    struct Block
+    {
+        int               kwd;
+        uint              npe; // zero for vertices
+        std::vector<uint> ids; // elements to write (unused for vertices)
+        size_t            n;   // number of lines
+        size_t            row; // bytes per line
+    };
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void write_MESHB(const char                           * filename,
+                 const std::vector<vec3d>             & verts,
+                 const std::vector<int>               & vert_labels,
+                 const std::vector<std::vector<uint>> & edges,
+                 const std::vector<int>               & edge_labels,
+                 const std::vector<std::vector<uint>> & faces,
+                 const std::vector<int>               & face_labels,
+                 const std::vector<std::vector<uint>> & polys,
+                 const std::vector<int>               & poly_labels)
+{
+    assert(vert_labels.empty() || vert_labels.size()==verts.size());
+    assert(edge_labels.empty() || edge_labels.size()==edges.size());
+    assert(face_labels.empty() || face_labels.size()==faces.size());
+    assert(poly_labels.empty() || poly_labels.size()==polys.size());
+
+    // split elements by type (elements of unsupported size are not written)
+    //
+    std::vector<meshb::Block> blocks(6);
+    blocks[0].kwd = meshb::VERTICES;       blocks[0].npe = 0;
+    blocks[1].kwd = meshb::EDGES;          blocks[1].npe = 2; blocks[1].ids = meshb::elements_of_size(edges, 2);
+    blocks[2].kwd = meshb::TRIANGLES;      blocks[2].npe = 3; blocks[2].ids = meshb::elements_of_size(faces, 3);
+    blocks[3].kwd = meshb::QUADRILATERALS; blocks[3].npe = 4; blocks[3].ids = meshb::elements_of_size(faces, 4);
+    blocks[4].kwd = meshb::TETRAHEDRA;     blocks[4].npe = 4; blocks[4].ids = meshb::elements_of_size(polys, 4);
+    blocks[5].kwd = meshb::HEXAHEDRA;      blocks[5].npe = 8; blocks[5].ids = meshb::elements_of_size(polys, 8);
+    blocks[0].n = verts.size();
+    for(uint i=1; i<blocks.size(); ++i) blocks[i].n = blocks[i].ids.size();
+
+    if(blocks[1].n<edges.size() || blocks[2].n+blocks[3].n<faces.size() || blocks[4].n+blocks[5].n<polys.size())
+    {
+        std::cerr << "WARNING : " << __FILE__ << ", line " << __LINE__ << " : write_MESHB() : elements other than edges, tris, quads, tets and hexa will not be written" << std::endl;
+    }
+
+    // pick the lowest version that can represent the mesh
+    //
+    size_t max_n = 0;
+    for(const auto & b : blocks) max_n = std::max(max_n, b.n);
+    int version = 2;
+    if(max_n>size_t(INT_MAX)) version = 4;
+    else
+    {
+        meshb::Format v2(2);
+        size_t bytes = 8 + (4+v2.pos_w+4); // header + dimension
+        for(const auto & b : blocks)
+        {
+            size_t row = b.npe>0 ? (b.npe+1)*v2.int_w : 3*v2.real_w+v2.int_w;
+            if(b.n>0) bytes += 4+v2.pos_w+v2.int_w + b.n*row;
+        }
+        bytes += 4+v2.pos_w; // end
+        if(bytes>size_t(INT_MAX)) version = 3;
+    }
+    meshb::Format fmt(version);
+    for(auto & b : blocks) b.row = b.npe>0 ? (b.npe+1)*fmt.int_w : 3*fmt.real_w+fmt.int_w;
+
+    FILE *fp = fopen(filename, "wb");
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_MESHB() : couldn't write output file " << filename << std::endl;
+        exit(-1);
+    }
+
+    // header and dimension (the position of the next keyword is known in advance)
+    //
+    std::vector<char> buf(32);
+    size_t pos = 0;
+    char * p   = buf.data();
+    p = fmt.put<int32_t>(p, 1);
+    p = fmt.put<int32_t>(p, version);
+    p = fmt.put<int32_t>(p, meshb::DIMENSION);
+    p = fmt.put_pos(p, 8 + 4+fmt.pos_w+4);
+    p = fmt.put<int32_t>(p, 3);
+    pos += size_t(p-buf.data());
+    fwrite(buf.data(), 1, pos, fp);
+
+    // keyword blocks
+    //
+    for(const auto & b : blocks)
+    {
+        if(b.n==0) continue;
+
+        size_t head = 4+fmt.pos_w+fmt.int_w;
+        buf.resize(head + b.n*b.row);
+        p = buf.data();
+        p = fmt.put<int32_t>(p, b.kwd);
+        p = fmt.put_pos(p, pos + buf.size());
+        p = fmt.put_int(p, b.n);
+
+        char * data = p;
+        if(b.kwd==meshb::VERTICES)
+        {
+            PARALLEL_FOR(0, uint(b.n), 10000, [&](const uint vid)
+            {
+                char * v = data + vid*b.row;
+                v = fmt.put_real(v, verts[vid].x());
+                v = fmt.put_real(v, verts[vid].y());
+                v = fmt.put_real(v, verts[vid].z());
+                v = fmt.put_int (v, vert_labels.empty() ? 0 : vert_labels[vid]);
+            });
+        }
+        else
+        {
+            const std::vector<std::vector<uint>> & elems  = (b.npe==2) ? edges       : (b.kwd==meshb::TRIANGLES || b.kwd==meshb::QUADRILATERALS) ? faces       : polys;
+            const std::vector<int>               & labels = (b.npe==2) ? edge_labels : (b.kwd==meshb::TRIANGLES || b.kwd==meshb::QUADRILATERALS) ? face_labels : poly_labels;
+            PARALLEL_FOR(0, uint(b.n), 10000, [&](const uint i)
+            {
+                char * e   = data + i*b.row;
+                uint   eid = b.ids[i];
+                for(uint vid : elems[eid]) e = fmt.put_int(e, int64_t(vid)+1);
+                e = fmt.put_int(e, labels.empty() ? 0 : labels[eid]);
+            });
+        }
+        fwrite(buf.data(), 1, buf.size(), fp);
+        pos += buf.size();
+    }
+
+    // end
+    //
+    p = buf.data();
+    p = fmt.put<int32_t>(p, meshb::END);
+    p = fmt.put_pos(p, 0);
+    fwrite(buf.data(), 1, size_t(p-buf.data()), fp);
+    fclose(fp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void write_MESHB(const char                           * filename,
+                 const std::vector<vec3d>             & verts,
+                 const std::vector<std::vector<uint>> & polys,
+                 const std::vector<int>               & vert_labels,
+                 const std::vector<int>               & poly_labels)
+{
+    std::vector<std::vector<uint>> edges, faces;
+    std::vector<int>               edge_labels, face_labels;
+    write_MESHB(filename, verts, vert_labels, edges, edge_labels, faces, face_labels, polys, poly_labels);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void write_MESHB(const char                           * filename,
+                 const std::vector<vec3d>             & verts,
+                 const std::vector<std::vector<uint>> & polys)
+{
+    std::vector<int> vert_labels, poly_labels;
+    write_MESHB(filename, verts, polys, vert_labels, poly_labels);
+}
+
+}
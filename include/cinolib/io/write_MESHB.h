@@ -0,0 +1,89 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_WRITE_MESHB_H
+#define CINO_WRITE_MESHB_H
+
+#include <sys/types.h>
+#include <vector>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+
+namespace cinolib
+{
+
+/* Writer for the binary Medit format (.meshb). Faces can be triangles or
+ * quads, polys can be tets or hexa. Each keyword block is assembled in memory
+ * and written with a single fwrite. The file version is the lowest one that
+ * can represent the mesh: version 2 (32 bit positions) for files up to 2GB,
+ * version 3 (64 bit positions) for larger files, and version 4 (64 bit
+ * indices) only if the number of vertices or elements exceeds 2^31-1.
+ * Empty label vectors are written as zero refs.
+*/
+
+CINO_INLINE
+void write_MESHB(const char                           * filename,
+                 const std::vector<vec3d>             & verts,
+                 const std::vector<int>               & vert_labels,
+                 const std::vector<std::vector<uint>> & edges,
+                 const std::vector<int>               & edge_labels,
+                 const std::vector<std::vector<uint>> & faces,
+                 const std::vector<int>               & face_labels,
+                 const std::vector<std::vector<uint>> & polys,
+                 const std::vector<int>               & poly_labels);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void write_MESHB(const char                           * filename,
+                 const std::vector<vec3d>             & verts,
+                 const std::vector<std::vector<uint>> & polys,
+                 const std::vector<int>               & vert_labels,
+                 const std::vector<int>               & poly_labels);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void write_MESHB(const char                           * filename,
+                 const std::vector<vec3d>             & verts,
+                 const std::vector<std::vector<uint>> & polys);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "write_MESHB.cpp"
+#endif
+
+#endif // CINO_WRITE_MESHB_H
@@ -0,0 +1,243 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/write_MSH.h>
+#include <cinolib/io/buffered_text_writer.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/min_max_inf.h>
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+namespace cinolib
+{
+
+namespace msh
+{
+    // writes single values either as text or as binary data
+    struct Writer
+    {
+        FILE * fp;
+        bool   binary;
+
+        void put(const int    i) { if(binary) fwrite(&i, sizeof(int),    1, fp); else fprintf(fp, "%d ",  i); }
+        void put(const size_t i) { if(binary) fwrite(&i, sizeof(size_t), 1, fp); else fprintf(fp, "%zu ", i); }
+        void put(const double d)
+        {
+            if(binary) fwrite(&d, sizeof(double), 1, fp);
+            else
+            {
+                char buf[CINO_MAX_DOUBLE_CHARS+1];
+                *format_double(d, buf) = '\0';
+                fprintf(fp, "%s ", buf);
+            }
+        }
+        void endl() { if(!binary) fprintf(fp, "\n"); }
+    };
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void write_MSH(const char                           * filename,
+               const std::vector<vec3d>             & verts,
+               const std::vector<std::vector<uint>> & polys,
+               const std::vector<int>               & poly_labels,
+               const int                              format)
+{
+    assert(poly_labels.empty() || poly_labels.size()==polys.size());
+
+    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+
+    FILE *fp = fopen(filename, "wb");
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_MSH() : couldn't write output file " << filename << std::endl;
+        exit(-1);
+    }
+
+    msh::Writer w;
+    w.fp     = fp;
+    w.binary = (format==MSH_BINARY);
+
+    // one volume entity per label, one element block per entity and element type
+    //
+    std::map<int,int> entity; // label => entity tag
+    for(uint pid=0; pid<polys.size(); ++pid)
+    {
+        int label = poly_labels.empty() ? -1 : poly_labels.at(pid);
+        entity.insert(std::make_pair(label, 0));
+    }
+    int tag = 0;
+    for(auto & e : entity) e.second = ++tag;
+
+    std::vector<std::vector<uint>> blocks(2*entity.size()); // tets and hexa of each entity
+    for(uint pid=0; pid<polys.size(); ++pid)
+    {
+        assert((polys.at(pid).size()==4 || polys.at(pid).size()==8) && "Unsupported Polyhedron!");
+        int e = entity.at(poly_labels.empty() ? -1 : poly_labels.at(pid)) - 1;
+        blocks.at(2*e + (polys.at(pid).size()==8 ? 1 : 0)).push_back(pid);
+    }
+    size_t n_blocks = 0;
+    for(const auto & b : blocks) if(!b.empty()) ++n_blocks;
+
+    // header
+    //
+    fprintf(fp, "$MeshFormat\n4.1 %d %d\n", w.binary ? 1 : 0, int(sizeof(size_t)));
+    if(w.binary)
+    {
+        int one = 1; // allows to detect the endianness
+        fwrite(&one, sizeof(int), 1, fp);
+        fprintf(fp, "\n");
+    }
+    fprintf(fp, "$EndMeshFormat\n");
+
+    // entities (volumes only)
+    //
+    vec3d min( inf_double,  inf_double,  inf_double);
+    vec3d max(-inf_double, -inf_double, -inf_double);
+    for(const vec3d & v : verts)
+    {
+        min = min.min(v);
+        max = max.max(v);
+    }
+    fprintf(fp, "$Entities\n");
+    w.put(size_t(0)); w.put(size_t(0)); w.put(size_t(0)); w.put(entity.size()); w.endl();
+    for(const auto & e : entity)
+    {
+        w.put(e.second);
+        for(int i=0; i<3; ++i) w.put(min[i]);
+        for(int i=0; i<3; ++i) w.put(max[i]);
+        if(e.first>=0) { w.put(size_t(1)); w.put(e.first+1); }
+        else           { w.put(size_t(0)); }
+        w.put(size_t(0)); // no bounding surfaces
+        w.endl();
+    }
+    if(w.binary) fprintf(fp, "\n");
+    fprintf(fp, "$EndEntities\n");
+
+    // nodes (all in the first entity)
+    //
+    size_t nv = verts.size();
+    fprintf(fp, "$Nodes\n");
+    w.put(size_t(nv>0 ? 1 : 0)); w.put(nv); w.put(size_t(nv>0 ? 1 : 0)); w.put(nv); w.endl();
+    if(nv>0)
+    {
+        w.put(3); w.put(1); w.put(0); w.put(nv); w.endl();
+        if(w.binary)
+        {
+            std::vector<size_t> tags(nv);
+            std::vector<double> xyz(3*nv);
+            PARALLEL_FOR(0, uint(nv), 100000, [&](const uint vid)
+            {
+                tags[vid] = vid+1;
+                xyz[3*vid  ] = verts[vid].x();
+                xyz[3*vid+1] = verts[vid].y();
+                xyz[3*vid+2] = verts[vid].z();
+            });
+            fwrite(tags.data(), sizeof(size_t), nv,   fp);
+            fwrite(xyz.data(),  sizeof(double), 3*nv, fp);
+            fprintf(fp, "\n");
+        }
+        else
+        {
+            write_parallel(fp, uint(nv), [&](const uint vid, TextBuffer & buf)
+            {
+                buf.put(vid+1);
+                buf.put('\n');
+            });
+            write_parallel(fp, uint(nv), [&](const uint vid, TextBuffer & buf)
+            {
+                buf.put(verts[vid].x()); buf.put(' ');
+                buf.put(verts[vid].y()); buf.put(' ');
+                buf.put(verts[vid].z()); buf.put('\n');
+            });
+        }
+    }
+    fprintf(fp, "$EndNodes\n");
+
+    // elements. Tags are polyhedra ids plus one
+    //
+    size_t np = polys.size();
+    fprintf(fp, "$Elements\n");
+    w.put(n_blocks); w.put(np); w.put(size_t(np>0 ? 1 : 0)); w.put(np); w.endl();
+    for(const auto & e : entity)
+    {
+        for(int hex=0; hex<2; ++hex)
+        {
+            const std::vector<uint> & block = blocks.at(2*(e.second-1) + hex);
+            if(block.empty()) continue;
+
+            size_t npe = hex ? 8 : 4;
+            w.put(3); w.put(e.second); w.put(hex ? 5 : 4); w.put(block.size()); w.endl();
+            if(w.binary)
+            {
+                std::vector<size_t> buf(block.size()*(1+npe));
+                PARALLEL_FOR(0, uint(block.size()), 100000, [&](const uint i)
+                {
+                    size_t * dst = buf.data() + i*(1+npe);
+                    dst[0] = block[i]+1;
+                    for(size_t j=0; j<npe; ++j) dst[1+j] = polys[block[i]][j]+1;
+                });
+                fwrite(buf.data(), sizeof(size_t), buf.size(), fp);
+            }
+            else
+            {
+                write_parallel(fp, uint(block.size()), [&](const uint i, TextBuffer & buf)
+                {
+                    buf.put(block[i]+1);
+                    for(uint vid : polys[block[i]]) { buf.put(' '); buf.put(vid+1); }
+                    buf.put('\n');
+                });
+            }
+        }
+    }
+    if(w.binary) fprintf(fp, "\n");
+    fprintf(fp, "$EndElements\n");
+    fclose(fp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void write_MSH(const char                           * filename,
+               const std::vector<vec3d>             & verts,
+               const std::vector<std::vector<uint>> & polys,
+               const int                              format)
+{
+    write_MSH(filename, verts, polys, std::vector<int>(), format);
+}
+
+}
@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/io/write_NODE_ELE.h>
+#include <cinolib/io/buffered_text_writer.h>
 #include <iostream>
 
 namespace cinolib
@@ -59,20 +60,21 @@ void write_NODE_ELE(const char                           * basename,
     }
 
     fprintf(f_node, "%d 0\n", (int)verts.size());
-    for(auto p : verts)
+    write_parallel(f_node, uint(verts.size()), [&](const uint vid, TextBuffer & buf)
     {
-        // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-        //
-        fprintf(f_node, "%.17g %.17g %.17g\n", p.x(), p.y(), p.z());
-    }
+        buf.put(verts[vid].x()); buf.put(' ');
+        buf.put(verts[vid].y()); buf.put(' ');
+        buf.put(verts[vid].z()); buf.put('\n');
+    });
 
     fprintf(f_ele, "%d\n", (int)poly.size());
-    for(const std::vector<uint> & p : poly)
+    write_parallel(f_ele, uint(poly.size()), [&](const uint pid, TextBuffer & buf)
     {
-        fprintf(f_ele, "%d ", (int)p.size());
-        for(uint vid : p) fprintf(f_ele, "%d ", vid+1);
-        fprintf(f_ele, "\n");
-    }
+        buf.put(uint(poly[pid].size()));
+        buf.put(' ');
+        for(uint vid : poly[pid]) { buf.put(vid+1); buf.put(' '); }
+        buf.put('\n');
+    });
 
     fclose(f_node);
     fclose(f_ele);
@@ -101,20 +103,20 @@ void write_NODE_ELE_2D(const char                           * basename,
     }
 
     fprintf(f_node, "%d 0\n", (int)verts.size());
-    for(auto p : verts)
+    write_parallel(f_node, uint(verts.size()), [&](const uint vid, TextBuffer & buf)
     {
-        // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-        //
-        fprintf(f_node, "%.17g %.17g\n", p.x(), p.y());
-    }
+        buf.put(verts[vid].x()); buf.put(' ');
+        buf.put(verts[vid].y()); buf.put('\n');
+    });
 
     fprintf(f_ele, "%d\n", (int)poly.size());
-    for(const std::vector<uint> & p : poly)
+    write_parallel(f_ele, uint(poly.size()), [&](const uint pid, TextBuffer & buf)
     {
-        fprintf(f_ele, "%d ", (int)p.size());
-        for(uint vid : p) fprintf(f_ele, "%d ", vid+1);
-        fprintf(f_ele, "\n");
-    }
+        buf.put(uint(poly[pid].size()));
+        buf.put(' ');
+        for(uint vid : poly[pid]) { buf.put(vid+1); buf.put(' '); }
+        buf.put('\n');
+    });
 
     fclose(f_node);
     fclose(f_ele);
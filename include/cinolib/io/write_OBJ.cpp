@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/io/write_OBJ.h>
+#include <cinolib/io/buffered_text_writer.h>
 #include <cinolib/color.h>
 #include <cinolib/stl_container_utilities.h>
 #include <cinolib/string_utilities.h>
@@ -60,22 +61,27 @@ void write_OBJ(const char                * filename,
         exit(-1);
     }
 
-    for(size_t i=0; i<xyz.size(); i+=3)
+    write_parallel(fp, uint(xyz.size()/3), [&](const uint vid, TextBuffer & buf)
     {
-        // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-        //
-        fprintf(fp, "v %.17g %.17g %.17g\n", xyz[i], xyz[i+1], xyz[i+2]);
-    }
+        buf.put("v ");
+        buf.put(xyz[3*vid  ]); buf.put(' ');
+        buf.put(xyz[3*vid+1]); buf.put(' ');
+        buf.put(xyz[3*vid+2]); buf.put('\n');
+    });
 
-    for(size_t i=0; i<tri.size(); i+=3)
+    write_parallel(fp, uint(tri.size()/3), [&](const uint tid, TextBuffer & buf)
     {
-        fprintf(fp, "f %d %d %d\n", tri[i] + 1, tri[i+1] + 1, tri[i+2] + 1);
-    }
+        buf.put('f');
+        for(uint i=3*tid; i<3*tid+3; ++i) { buf.put(' '); buf.put(tri[i]+1); }
+        buf.put('\n');
+    });
 
-    for(size_t i=0; i<quad.size(); i+=4)
+    write_parallel(fp, uint(quad.size()/4), [&](const uint qid, TextBuffer & buf)
     {
-        fprintf(fp, "f %d %d %d %d\n", quad[i] + 1, quad[i+1] + 1, quad[i+2] + 1, quad[i+3] + 1);
-    }
+        buf.put('f');
+        for(uint i=4*qid; i<4*qid+4; ++i) { buf.put(' '); buf.put(quad[i]+1); }
+        buf.put('\n');
+    });
 
     fclose(fp);
 }
@@ -97,19 +103,20 @@ void write_OBJ(const char                           * filename,
         exit(-1);
     }
 
-    for(uint i=0; i<xyz.size(); i+=3)
+    write_parallel(fp, uint(xyz.size()/3), [&](const uint vid, TextBuffer & buf)
     {
-        // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-        //
-        fprintf(fp, "v %.17g %.17g %.17g\n", xyz[i], xyz[i+1], xyz[i+2]);
-    }
+        buf.put("v ");
+        buf.put(xyz[3*vid  ]); buf.put(' ');
+        buf.put(xyz[3*vid+1]); buf.put(' ');
+        buf.put(xyz[3*vid+2]); buf.put('\n');
+    });
 
-    for(auto p : poly)
+    write_parallel(fp, uint(poly.size()), [&](const uint pid, TextBuffer & buf)
     {
-        fprintf(fp, "f ");
-        for(uint vid : p) fprintf(fp, "%d ", vid+1);
-        fprintf(fp, "\n");
-    }
+        buf.put("f ");
+        for(uint vid : poly[pid]) { buf.put(vid+1); buf.put(' '); }
+        buf.put('\n');
+    });
 
     fclose(fp);
 }
@@ -154,24 +161,31 @@ void write_OBJ(const char                * filename,
 
     fprintf(f_obj, "mtllib %s\n", get_file_name(mtl_filename).c_str());
 
-    for(uint i=0; i<xyz.size(); i+=3)
+    write_parallel(f_obj, uint(xyz.size()/3), [&](const uint vid, TextBuffer & buf)
     {
-        // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-        //
-        fprintf(f_obj, "v %.17g %.17g %.17g\n", xyz[i], xyz[i+1], xyz[i+2]);
-    }
+        buf.put("v ");
+        buf.put(xyz[3*vid  ]); buf.put(' ');
+        buf.put(xyz[3*vid+1]); buf.put(' ');
+        buf.put(xyz[3*vid+2]); buf.put('\n');
+    });
 
-    for(uint i=0; i<tri.size(); i+=3)
+    write_parallel(f_obj, uint(tri.size()/3), [&](const uint tid, TextBuffer & buf)
     {
-        fprintf(f_obj, "usemtl color_%d\n", color_map[colors.at(i/3)]);
-        fprintf(f_obj, "f %d %d %d\n", tri[i] + 1, tri[i+1] + 1, tri[i+2] + 1);
-    }
-
-    for(uint i=0; i<quad.size(); i+=4)
+        buf.put("usemtl color_");
+        buf.put(color_map.at(colors.at(tid)));
+        buf.put("\nf");
+        for(uint i=3*tid; i<3*tid+3; ++i) { buf.put(' '); buf.put(tri[i]+1); }
+        buf.put('\n');
+    });
+
+    write_parallel(f_obj, uint(quad.size()/4), [&](const uint qid, TextBuffer & buf)
     {
-        fprintf(f_obj, "usemtl color_%d\n", color_map[colors.at(i/4)]);
-        fprintf(f_obj, "f %d %d %d %d\n", quad[i] + 1, quad[i+1] + 1, quad[i+2] + 1, quad[i+3] + 1);
-    }
+        buf.put("usemtl color_");
+        buf.put(color_map.at(colors.at(qid)));
+        buf.put("\nf");
+        for(uint i=4*qid; i<4*qid+4; ++i) { buf.put(' '); buf.put(quad[i]+1); }
+        buf.put('\n');
+    });
 
     fclose(f_obj);
     fclose(f_mtl);
@@ -204,24 +218,27 @@ void write_OBJ(const char                * filename,
     fprintf(f_mtl, "newmtl color\nKd %f %f %f\n", color.r, color.g, color.b);
     fprintf(f_obj, "mtllib %s\n", get_file_name(mtl_filename).c_str());
 
-    for(uint i=0; i<xyz.size(); i+=3)
+    write_parallel(f_obj, uint(xyz.size()/3), [&](const uint vid, TextBuffer & buf)
     {
-        // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-        //
-        fprintf(f_obj, "v %.17g %.17g %.17g\n", xyz[i], xyz[i+1], xyz[i+2]);
-    }
+        buf.put("v ");
+        buf.put(xyz[3*vid  ]); buf.put(' ');
+        buf.put(xyz[3*vid+1]); buf.put(' ');
+        buf.put(xyz[3*vid+2]); buf.put('\n');
+    });
 
-    for(uint i=0; i<tri.size(); i+=3)
+    write_parallel(f_obj, uint(tri.size()/3), [&](const uint tid, TextBuffer & buf)
     {
-        fprintf(f_obj, "usemtl color\n");
-        fprintf(f_obj, "f %d %d %d\n", tri[i] + 1, tri[i+1] + 1, tri[i+2] + 1);
-    }
+        buf.put("usemtl color\nf");
+        for(uint i=3*tid; i<3*tid+3; ++i) { buf.put(' '); buf.put(tri[i]+1); }
+        buf.put('\n');
+    });
 
-    for(uint i=0; i<quad.size(); i+=4)
+    write_parallel(f_obj, uint(quad.size()/4), [&](const uint qid, TextBuffer & buf)
     {
-        fprintf(f_obj, "usemtl color\n");
-        fprintf(f_obj, "f %d %d %d %d\n", quad[i] + 1, quad[i+1] + 1, quad[i+2] + 1, quad[i+3] + 1);
-    }
+        buf.put("usemtl color\nf");
+        for(uint i=4*qid; i<4*qid+4; ++i) { buf.put(' '); buf.put(quad[i]+1); }
+        buf.put('\n');
+    });
 
     fclose(f_obj);
     fclose(f_mtl);
@@ -266,20 +283,22 @@ void write_OBJ(const char                           * filename,
 
     fprintf(f_obj, "mtllib %s\n", get_file_name(mtl_filename).c_str());
 
-    for(uint i=0; i<xyz.size(); i+=3)
+    write_parallel(f_obj, uint(xyz.size()/3), [&](const uint vid, TextBuffer & buf)
     {
-        // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-        //
-        fprintf(f_obj, "v %.17g %.17g %.17g\n", xyz[i], xyz[i+1], xyz[i+2]);
-    }
+        buf.put("v ");
+        buf.put(xyz[3*vid  ]); buf.put(' ');
+        buf.put(xyz[3*vid+1]); buf.put(' ');
+        buf.put(xyz[3*vid+2]); buf.put('\n');
+    });
 
-    for(uint fid=0; fid<poly.size(); ++fid)
+    write_parallel(f_obj, uint(poly.size()), [&](const uint fid, TextBuffer & buf)
     {
-        fprintf(f_obj, "usemtl color_%d\n", color_map.at(colors.at(fid)));
-        fprintf(f_obj, "f ");
-        for(uint vid : poly.at(fid)) fprintf(f_obj, "%d ", vid+1);
-        fprintf(f_obj, "\n");
-    }
+        buf.put("usemtl color_");
+        buf.put(color_map.at(colors.at(fid)));
+        buf.put("\nf ");
+        for(uint vid : poly.at(fid)) { buf.put(vid+1); buf.put(' '); }
+        buf.put('\n');
+    });
 
     fclose(f_obj);
     fclose(f_mtl);
@@ -322,19 +341,22 @@ void write_OBJ(const char                           *filename,
 
     fprintf(f_obj, "mtllib %s\n", get_file_name(mtl_filename).c_str());
 
-    for(uint i = 0; i < xyz.size(); i += 3)
+    write_parallel(f_obj, uint(xyz.size()/3), [&](const uint vid, TextBuffer & buf)
     {
-        // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-        fprintf(f_obj, "v %.17g %.17g %.17g\n", xyz[i], xyz[i+1], xyz[i+2]);
-    }
+        buf.put("v ");
+        buf.put(xyz[3*vid  ]); buf.put(' ');
+        buf.put(xyz[3*vid+1]); buf.put(' ');
+        buf.put(xyz[3*vid+2]); buf.put('\n');
+    });
 
-    for(uint pid = 0; pid < poly.size(); ++pid)
+    write_parallel(f_obj, uint(poly.size()), [&](const uint pid, TextBuffer & buf)
     {
-        fprintf(f_obj, "usemtl label_%d\n", labels[pid]);
-        fprintf(f_obj, "f ");
-        for(uint vid : poly.at(pid)) fprintf(f_obj, "%d ", vid+1);
-        fprintf(f_obj, "\n");
-    }
+        buf.put("usemtl label_");
+        buf.put(labels[pid]);
+        buf.put("\nf ");
+        for(uint vid : poly.at(pid)) { buf.put(vid+1); buf.put(' '); }
+        buf.put('\n');
+    });
 
     fclose(f_obj);
     fclose(f_mtl);
@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/io/write_OFF.h>
+#include <cinolib/io/buffered_text_writer.h>
 
 
 #include <iostream>
@@ -60,22 +61,26 @@ void write_OFF(const char                * filename,
     int n_poly = int(tri.size()/3 + quad.size()/4);
     fprintf (fp, "OFF\n%zu %d 0\n", xyz.size()/3, n_poly);
 
-    for(size_t i=0; i<xyz.size(); i+=3)
+    write_parallel(fp, uint(xyz.size()/3), [&](const uint vid, TextBuffer & buf)
     {
-        // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-        //
-        fprintf(fp, "%.17g %.17g %.17g\n", xyz[i], xyz[i+1], xyz[i+2]);
-    }
+        buf.put(xyz[3*vid  ]); buf.put(' ');
+        buf.put(xyz[3*vid+1]); buf.put(' ');
+        buf.put(xyz[3*vid+2]); buf.put('\n');
+    });
 
-    for(size_t i=0; i<tri.size(); i+=3)
+    write_parallel(fp, uint(tri.size()/3), [&](const uint tid, TextBuffer & buf)
     {
-        fprintf(fp, "3 %d %d %d\n", tri[i], tri[i+1], tri[i+2]);
-    }
+        buf.put('3');
+        for(uint i=3*tid; i<3*tid+3; ++i) { buf.put(' '); buf.put(tri[i]); }
+        buf.put('\n');
+    });
 
-    for(size_t i=0; i<quad.size(); i+=4)
+    write_parallel(fp, uint(quad.size()/4), [&](const uint qid, TextBuffer & buf)
     {
-        fprintf(fp, "4 %d %d %d %d\n", quad[i], quad[i+1], quad[i+2], quad[i+3]);
-    }
+        buf.put('4');
+        for(uint i=4*qid; i<4*qid+4; ++i) { buf.put(' '); buf.put(quad[i]); }
+        buf.put('\n');
+    });
 
     fclose(fp);
 }
@@ -100,22 +105,20 @@ void write_OFF(const char                           * filename,
     uint n_faces = uint(faces.size());
     fprintf (fp, "OFF\n%zu %d 0\n", xyz.size()/3, n_faces);
 
-    for(uint i=0; i<xyz.size(); i+=3)
+    write_parallel(fp, uint(xyz.size()/3), [&](const uint vid, TextBuffer & buf)
     {
-        // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-        //
-        fprintf(fp, "%.17g %.17g %.17g\n", xyz[i], xyz[i+1], xyz[i+2]);
-    }
+        buf.put(xyz[3*vid  ]); buf.put(' ');
+        buf.put(xyz[3*vid+1]); buf.put(' ');
+        buf.put(xyz[3*vid+2]); buf.put('\n');
+    });
 
-    for(uint i=0; i<faces.size(); ++i)
+    write_parallel(fp, n_faces, [&](const uint fid, TextBuffer & buf)
     {
-        fprintf(fp, "%d ", static_cast<int>(faces.at(i).size()));
-        for(uint j=0; j<faces.at(i).size(); ++j)
-        {
-            fprintf(fp, "%d ", faces.at(i).at(j));
-        }
-        fprintf(fp, "\n");
-    }
+        buf.put(uint(faces.at(fid).size()));
+        buf.put(' ');
+        for(uint vid : faces.at(fid)) { buf.put(vid); buf.put(' '); }
+        buf.put('\n');
+    });
 
     fclose(fp);
 }
@@ -0,0 +1,198 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/write_PLY.h>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <cmath>
+
+namespace cinolib
+{
+
+namespace ply
+{
+    // appends the bytes of a value to a buffer, swapping them if needed
+    //
+    template<typename T>
+    inline void put(std::vector<char> & buf, const T & val, const bool swap)
+    {
+        char b[sizeof(T)];
+        memcpy(b, &val, sizeof(T));
+        if(swap) for(size_t i=0; i<sizeof(T)/2; ++i) std::swap(b[i], b[sizeof(T)-1-i]);
+        buf.insert(buf.end(), b, b+sizeof(T));
+    }
+
+    //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    inline uint8_t to_uchar(const float c)
+    {
+        float x = std::round(c*255.f);
+        return static_cast<uint8_t>(std::max(0.f, std::min(255.f, x)));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void write_PLY(const char                           * filename,
+               const std::vector<double>            & xyz,
+               const std::vector<std::vector<uint>> & polys,
+               const std::vector<double>            & vert_normals,
+               const std::vector<Color>             & vert_colors,
+               const std::vector<double>            & vert_uv,
+               const std::vector<Color>             & poly_colors,
+               const std::vector<int>               & poly_labels,
+               const int                              format)
+{
+    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+
+    FILE *fp = fopen(filename, "wb");
+
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_PLY() : couldn't save file " << filename << std::endl;
+        exit(-1);
+    }
+
+    size_t nv = xyz.size()/3;
+    size_t np = polys.size();
+    bool has_vnor = (vert_normals.size() == 3*nv);
+    bool has_vcol = (vert_colors.size()  ==   nv);
+    bool has_vuv  = (vert_uv.size()      == 2*nv);
+    bool has_pcol = (poly_colors.size()  ==   np && np>0);
+    bool has_plab = (poly_labels.size()  ==   np && np>0);
+
+    // the list count is a uchar unless some polygon has more than 255 vertices
+    bool wide_cnt = false;
+    for(const auto & p : polys) if(p.size()>255) { wide_cnt = true; break; }
+
+    const uint16_t one = 1;
+    bool host_is_le = (*reinterpret_cast<const char*>(&one)==1);
+    bool swap = (format==PLY_BINARY_LITTLE_ENDIAN && !host_is_le) ||
+                (format==PLY_BINARY_BIG_ENDIAN    &&  host_is_le);
+
+    fprintf(fp, "ply\n");
+    switch(format)
+    {
+        case PLY_ASCII             : fprintf(fp, "format ascii 1.0\n");                break;
+        case PLY_BINARY_BIG_ENDIAN : fprintf(fp, "format binary_big_endian 1.0\n");    break;
+        default                    : fprintf(fp, "format binary_little_endian 1.0\n"); break;
+    }
+    fprintf(fp, "comment generated by cinolib\n");
+    fprintf(fp, "element vertex %zu\n", nv);
+    fprintf(fp, "property double x\nproperty double y\nproperty double z\n");
+    if(has_vnor) fprintf(fp, "property double nx\nproperty double ny\nproperty double nz\n");
+    if(has_vcol) fprintf(fp, "property uchar red\nproperty uchar green\nproperty uchar blue\nproperty uchar alpha\n");
+    if(has_vuv)  fprintf(fp, "property double u\nproperty double v\n");
+    fprintf(fp, "element face %zu\n", np);
+    fprintf(fp, "property list %s int vertex_indices\n", wide_cnt ? "uint" : "uchar");
+    if(has_pcol) fprintf(fp, "property uchar red\nproperty uchar green\nproperty uchar blue\nproperty uchar alpha\n");
+    if(has_plab) fprintf(fp, "property int label\n");
+    fprintf(fp, "end_header\n");
+
+    if(format==PLY_ASCII)
+    {
+        for(size_t vid=0; vid<nv; ++vid)
+        {
+            // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
+            //
+            fprintf(fp, "%.17g %.17g %.17g", xyz[3*vid], xyz[3*vid+1], xyz[3*vid+2]);
+            if(has_vnor) fprintf(fp, " %.17g %.17g %.17g", vert_normals[3*vid], vert_normals[3*vid+1], vert_normals[3*vid+2]);
+            if(has_vcol)
+            {
+                const Color & c = vert_colors[vid];
+                fprintf(fp, " %d %d %d %d", ply::to_uchar(c.r), ply::to_uchar(c.g), ply::to_uchar(c.b), ply::to_uchar(c.a));
+            }
+            if(has_vuv) fprintf(fp, " %.17g %.17g", vert_uv[2*vid], vert_uv[2*vid+1]);
+            fprintf(fp, "\n");
+        }
+        for(size_t pid=0; pid<np; ++pid)
+        {
+            fprintf(fp, "%d", int(polys[pid].size()));
+            for(uint vid : polys[pid]) fprintf(fp, " %d", int(vid));
+            if(has_pcol)
+            {
+                const Color & c = poly_colors[pid];
+                fprintf(fp, " %d %d %d %d", ply::to_uchar(c.r), ply::to_uchar(c.g), ply::to_uchar(c.b), ply::to_uchar(c.a));
+            }
+            if(has_plab) fprintf(fp, " %d", poly_labels[pid]);
+            fprintf(fp, "\n");
+        }
+    }
+    else
+    {
+        std::vector<char> buf;
+        size_t v_stride = 3*sizeof(double) + (has_vnor ? 3*sizeof(double) : 0) + (has_vcol ? 4 : 0) + (has_vuv ? 2*sizeof(double) : 0);
+        buf.reserve(nv*v_stride);
+        for(size_t vid=0; vid<nv; ++vid)
+        {
+            for(int i=0; i<3; ++i) ply::put(buf, xyz[3*vid+i], swap);
+            if(has_vnor) for(int i=0; i<3; ++i) ply::put(buf, vert_normals[3*vid+i], swap);
+            if(has_vcol) for(int i=0; i<4; ++i) ply::put(buf, ply::to_uchar(vert_colors[vid].rgba[i]), swap);
+            if(has_vuv)  for(int i=0; i<2; ++i) ply::put(buf, vert_uv[2*vid+i], swap);
+        }
+        fwrite(buf.data(), 1, buf.size(), fp);
+
+        buf.clear();
+        for(size_t pid=0; pid<np; ++pid)
+        {
+            if(wide_cnt) ply::put(buf, uint32_t(polys[pid].size()), swap);
+            else         ply::put(buf, uint8_t (polys[pid].size()), swap);
+            for(uint vid : polys[pid]) ply::put(buf, int32_t(vid), swap);
+            if(has_pcol) for(int i=0; i<4; ++i) ply::put(buf, ply::to_uchar(poly_colors[pid].rgba[i]), swap);
+            if(has_plab) ply::put(buf, int32_t(poly_labels[pid]), swap);
+        }
+        fwrite(buf.data(), 1, buf.size(), fp);
+    }
+
+    fclose(fp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void write_PLY(const char                           * filename,
+               const std::vector<double>            & xyz,
+               const std::vector<std::vector<uint>> & polys,
+               const int                              format)
+{
+    std::vector<double> vert_normals, vert_uv;
+    std::vector<Color>  vert_colors, poly_colors;
+    std::vector<int>    poly_labels;
+    write_PLY(filename, xyz, polys, vert_normals, vert_colors, vert_uv, poly_colors, poly_labels, format);
+}
+
+}
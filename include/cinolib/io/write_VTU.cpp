@@ -34,179 +34,307 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/io/write_VTU.h>
-
-
-#ifdef CINOLIB_USES_VTK
-#include <vtkSmartPointer.h>
-#include <vtkCell.h>
-#include <vtkCellData.h>
-#include <vtkIntArray.h>
-#include <vtkUnstructuredGrid.h>
-#include <vtkXMLUnstructuredGridWriter.h>
-#endif
+#include <cinolib/io/buffered_text_writer.h>
+#include <cinolib/parallel_for.h>
+#include <climits>
+#include <cstring>
+#include <iostream>
 
 namespace cinolib
 {
 
-#ifdef CINOLIB_USES_VTK
-
-CINO_INLINE
-void write_VTU(const char                           * filename,
-               const std::vector<vec3d>             & verts,
-               const std::vector<std::vector<uint>> & polys)
+namespace vtu
 {
-    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
-
-    vtkSmartPointer<vtkXMLUnstructuredGridWriter> writer = vtkSmartPointer<vtkXMLUnstructuredGridWriter>::New();
-    vtkSmartPointer<vtkUnstructuredGrid>          grid   = vtkSmartPointer<vtkUnstructuredGrid>::New();
-    vtkSmartPointer<vtkPoints>                    points = vtkSmartPointer<vtkPoints>::New();
-
-    // generate some arrays that allow each element type to be viewed alone by thresholding
-    //
-    vtkSmartPointer<vtkIntArray> tetselector = vtkSmartPointer<vtkIntArray>::New();
-    vtkSmartPointer<vtkIntArray> hexselector = vtkSmartPointer<vtkIntArray>::New();
-    tetselector->SetName("tet_selector");
-    hexselector->SetName("hex_selector");
+    // a DataArray ready to be written: XML attributes, raw content
+    // (native byte order) and, for binary encodings, the encoded data
+    struct OutArray
+    {
+        std::string       attributes;
+        int               type;
+        uint              n_comp;
+        std::vector<char> bytes;
+        std::vector<char> blob;
+    };
 
-    for(const vec3d & v : verts)
+    template<typename T>
+    inline void pack(const std::vector<T> & src, std::vector<char> & bytes)
     {
-        points->InsertNextPoint(v.x(), v.y(), v.z());
+        bytes.resize(src.size()*sizeof(T));
+        if(!src.empty()) memcpy(bytes.data(), src.data(), bytes.size());
     }
 
-    bool has_tets = false;
-    bool has_hexa = false;
-
-    for(auto p : polys)
+    template<typename T>
+    inline T get(const std::vector<char> & bytes, const size_t i)
     {
-        switch (p.size())
-        {
-            case 4:
-            {
-                vtkIdType pid[] = { p.at(0), p.at(1), p.at(2), p.at(3) };
-                grid->InsertNextCell(VTK_TETRA, 4, pid);
-                tetselector->InsertNextValue(1);
-                hexselector->InsertNextValue(0);
-                has_tets = true;
-                break;
-            }
-
-            case 8:
-            {
-                vtkIdType pid[] = { p.at(0), p.at(1), p.at(2), p.at(3),
-                                    p.at(4), p.at(5), p.at(6), p.at(7) };
-                grid->InsertNextCell(VTK_HEXAHEDRON, 8, pid);
-                tetselector->InsertNextValue(0);
-                hexselector->InsertNextValue(1);
-                has_hexa = true;
-                break;
-            }
-
-            default: assert(false && "Unsupported Polyhedron!");
-        }
+        T val;
+        memcpy(&val, bytes.data()+i*sizeof(T), sizeof(T));
+        return val;
     }
-
-    grid->SetPoints(points);
-    if (has_tets) grid->GetCellData()->AddArray(tetselector);
-    if (has_hexa) grid->GetCellData()->AddArray(hexselector);
-
-#if VTK_MAJOR_VERSION < 6
-    writer->SetInput( grid );
-#else
-    writer->SetInputData(grid);
-#endif
-    writer->SetFileName(filename);
-    writer->Write();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void write_VTU(const char                * filename,
-               const std::vector<double> & xyz,
-               const std::vector<uint>   & tets,
-               const std::vector<uint>   & hexa)
+void write_VTU(const char                           * filename,
+               const std::vector<vec3d>             & verts,
+               const std::vector<std::vector<uint>> & polys,
+               const std::vector<VTUArray>          & point_data,
+               const std::vector<VTUArray>          & cell_data,
+               const int                              encoding,
+               const int                              compression_level)
 {
     setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
 
-    vtkSmartPointer<vtkXMLUnstructuredGridWriter> writer = vtkSmartPointer<vtkXMLUnstructuredGridWriter>::New();
-    vtkSmartPointer<vtkUnstructuredGrid>          grid   = vtkSmartPointer<vtkUnstructuredGrid>::New();
-    vtkSmartPointer<vtkPoints>                    points = vtkSmartPointer<vtkPoints>::New();
+    FILE *fp = fopen(filename, "wb");
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_VTU() : couldn't write output file " << filename << std::endl;
+        exit(-1);
+    }
+
+    bool binary   = (encoding!=VTU_ASCII);
+    bool appended = (encoding==VTU_APPENDED_RAW || encoding==VTU_APPENDED_BASE64);
+    bool base64   = (encoding==VTU_BINARY       || encoding==VTU_APPENDED_BASE64);
+    int  level    = binary ? std::min(compression_level,9) : 0;
+#ifndef CINOLIB_USES_ZLIB
+    if(level>0)
+    {
+        std::cerr << "WARNING : zlib missing, data will not be compressed. Recompile defining symbol CINOLIB_USES_ZLIB" << std::endl;
+        level = 0;
+    }
+#endif
 
-    // generate some arrays that allow each element type to be viewed alone by thresholding
+    // serialize all arrays, in the order they will appear in the XML
     //
-    vtkSmartPointer<vtkIntArray> tetselector = vtkSmartPointer<vtkIntArray>::New();
-    vtkSmartPointer<vtkIntArray> hexselector = vtkSmartPointer<vtkIntArray>::New();
-    tetselector->SetName("tet_selector");
-    hexselector->SetName("hex_selector");
+    std::vector<vtu::OutArray> point_arrays, cell_arrays, geom_arrays;
+
+    auto add_attributes = [](const std::vector<VTUArray> & data, std::vector<vtu::OutArray> & arrays)
+    {
+        for(const VTUArray & a : data)
+        {
+            vtu::OutArray out;
+            out.type   = a.is_int ? vtu::INT32 : vtu::FLOAT64;
+            out.n_comp = a.n_comp;
+            out.attributes = std::string("type=\"") + vtu::type_name(out.type) + "\" Name=\"" + a.name +
+                             "\" NumberOfComponents=\"" + std::to_string(a.n_comp) + "\"";
+            if(a.is_int) vtu::pack(a.int_data,  out.bytes);
+            else         vtu::pack(a.real_data, out.bytes);
+            arrays.push_back(std::move(out));
+        }
+    };
+    add_attributes(point_data, point_arrays);
+    add_attributes(cell_data,  cell_arrays);
 
-    // write the vertex coordinates
+    // arrays that allow each element type to be viewed alone by thresholding
     //
-    for(size_t i=0; i<xyz.size(); i+=3)
+    std::vector<int> tet_selector(polys.size()), hex_selector(polys.size());
+    bool has_tets = false;
+    bool has_hexa = false;
+    size_t conn_size = 0;
+    for(uint pid=0; pid<polys.size(); ++pid)
     {
-        points->InsertNextPoint(xyz[i+0], xyz[i+1], xyz[i+2]);
+        assert((polys.at(pid).size()==4 || polys.at(pid).size()==8) && "Unsupported Polyhedron!");
+        tet_selector.at(pid) = (polys.at(pid).size()==4);
+        hex_selector.at(pid) = (polys.at(pid).size()==8);
+        has_tets |= (polys.at(pid).size()==4);
+        has_hexa |= (polys.at(pid).size()==8);
+        conn_size += polys.at(pid).size();
     }
+    std::vector<VTUArray> selectors;
+    if(has_tets) selectors.push_back(VTUArray("tet_selector", tet_selector));
+    if(has_hexa) selectors.push_back(VTUArray("hex_selector", hex_selector));
+    add_attributes(selectors, cell_arrays);
 
-    // write the tetrahedra
+    // point coordinates
     //
-    for(size_t i=0; i<tets.size(); i+=4)
+    vtu::OutArray points;
+    points.type   = vtu::FLOAT64;
+    points.n_comp = 3;
+    points.attributes = "type=\"Float64\" NumberOfComponents=\"3\"";
+    points.bytes.resize(verts.size()*3*sizeof(double));
+    PARALLEL_FOR(0, uint(verts.size()), 100000, [&](const uint vid)
     {
-        vtkIdType pid[] = { tets[i+0], tets[i+1], tets[i+2], tets[i+3] };
-        grid->InsertNextCell(VTK_TETRA, 4, pid);
-        tetselector->InsertNextValue(1);
-        hexselector->InsertNextValue(0);
-    }
+        double xyz[3] = { verts.at(vid).x(), verts.at(vid).y(), verts.at(vid).z() };
+        memcpy(points.bytes.data() + vid*sizeof(xyz), xyz, sizeof(xyz));
+    });
+    geom_arrays.push_back(std::move(points));
 
-    // write the hexahedra
+    // cells. Ids are written as Int32, unless they are too many
     //
-    for(size_t i=0; i<hexa.size(); i+=8 )
+    bool use_int64 = (conn_size>INT_MAX || verts.size()>INT_MAX);
+    std::vector<int64_t> conn, offsets(polys.size());
+    std::vector<uint8_t> types(polys.size());
+    conn.reserve(conn_size);
+    for(uint pid=0; pid<polys.size(); ++pid)
     {
-        vtkIdType pid[] = { hexa[i+0], hexa[i+1], hexa[i+2], hexa[i+3],
-                            hexa[i+4], hexa[i+5], hexa[i+6], hexa[i+7] };
-        grid->InsertNextCell(VTK_HEXAHEDRON, 8, pid);
-        tetselector->InsertNextValue(0);
-        hexselector->InsertNextValue(1);
+        for(uint vid : polys.at(pid)) conn.push_back(vid);
+        offsets.at(pid) = int64_t(conn.size());
+        types.at(pid)   = (polys.at(pid).size()==4) ? vtu::VTK_TETRA_ID : vtu::VTK_HEXAHEDRON_ID;
     }
+    auto add_ids = [&](const char * name, const std::vector<int64_t> & ids)
+    {
+        vtu::OutArray out;
+        out.type   = use_int64 ? vtu::INT64 : vtu::INT32;
+        out.n_comp = 1;
+        out.attributes = std::string("type=\"") + vtu::type_name(out.type) + "\" Name=\"" + name + "\"";
+        if(use_int64) vtu::pack(ids, out.bytes);
+        else          vtu::pack(std::vector<int32_t>(ids.begin(), ids.end()), out.bytes);
+        geom_arrays.push_back(std::move(out));
+    };
+    add_ids("connectivity", conn);
+    add_ids("offsets",      offsets);
+    vtu::OutArray cell_types;
+    cell_types.type   = vtu::UINT8;
+    cell_types.n_comp = 1;
+    cell_types.attributes = "type=\"UInt8\" Name=\"types\"";
+    vtu::pack(types, cell_types.bytes);
+    geom_arrays.push_back(std::move(cell_types));
+    std::vector<int64_t>().swap(conn);
 
-    // create the output mesh
+    // encode binary data. Every block starts with a UInt64 header, which
+    // contains either the number of bytes or the compression block table
     //
-    grid->SetPoints(points);
+    std::vector<vtu::OutArray*> all;
+    for(auto & a : point_arrays) all.push_back(&a);
+    for(auto & a : cell_arrays ) all.push_back(&a);
+    for(auto & a : geom_arrays ) all.push_back(&a);
 
-    if (tets.size() > 0) grid->GetCellData()->AddArray(tetselector);
-    if (hexa.size() > 0) grid->GetCellData()->AddArray(hexselector);
+    if(binary)
+    {
+        for(vtu::OutArray * a : all)
+        {
+            std::vector<uint64_t> header(1, a->bytes.size());
+            std::vector<char>     blocks;
+            if(level>0 && !vtu::zlib_compress(a->bytes, level, header, blocks))
+            {
+                std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_VTU() : compression failed" << std::endl;
+                fclose(fp);
+                return;
+            }
+            const std::vector<char> & data = (level>0) ? blocks : a->bytes;
+            const char * h = reinterpret_cast<const char*>(header.data());
+            size_t       n = header.size()*sizeof(uint64_t);
 
-#if VTK_MAJOR_VERSION < 6
-    writer->SetInput( grid );
-#else
-    writer->SetInputData(grid);
-#endif
-    writer->SetFileName(filename);
-    writer->Write();
+            if(!base64)
+            {
+                a->blob.reserve(n + data.size());
+                a->blob.insert(a->blob.end(), h, h+n);
+                a->blob.insert(a->blob.end(), data.begin(), data.end());
+            }
+            else if(level>0) // header and data are encoded separately
+            {
+                vtu::base64_encode(h, n, a->blob);
+                vtu::base64_encode(data.data(), data.size(), a->blob);
+            }
+            else // header and data are encoded together
+            {
+                std::vector<char> tmp;
+                tmp.reserve(n + data.size());
+                tmp.insert(tmp.end(), h, h+n);
+                tmp.insert(tmp.end(), data.begin(), data.end());
+                vtu::base64_encode(tmp.data(), tmp.size(), a->blob);
+            }
+            std::vector<char>().swap(a->bytes);
+        }
+    }
+
+    // write the XML
+    //
+    size_t offset = 0;
+    auto write_array = [&](vtu::OutArray & a)
+    {
+        if(appended)
+        {
+            fprintf(fp, "        <DataArray %s format=\"appended\" offset=\"%zu\"/>\n", a.attributes.c_str(), offset);
+            offset += a.blob.size();
+        }
+        else if(binary)
+        {
+            fprintf(fp, "        <DataArray %s format=\"binary\">\n          ", a.attributes.c_str());
+            fwrite(a.blob.data(), 1, a.blob.size(), fp);
+            fprintf(fp, "\n        </DataArray>\n");
+        }
+        else
+        {
+            fprintf(fp, "        <DataArray %s format=\"ascii\">\n", a.attributes.c_str());
+            size_t n_vals = a.bytes.size()/vtu::type_size(a.type);
+            write_parallel(fp, uint(n_vals/a.n_comp), [&](const uint i, TextBuffer & buf)
+            {
+                buf.put("          ");
+                for(size_t j=size_t(i)*a.n_comp; j<size_t(i+1)*a.n_comp; ++j)
+                {
+                    switch(a.type)
+                    {
+                        case vtu::FLOAT64 : buf.put(vtu::get<double>(a.bytes,j)); break;
+                        case vtu::INT32   : buf.put(vtu::get<int32_t>(a.bytes,j)); break;
+                        case vtu::INT64   : buf.put(double(vtu::get<int64_t>(a.bytes,j))); break; // exact up to 2^53
+                        case vtu::UINT8   : buf.put(int(vtu::get<uint8_t>(a.bytes,j))); break;
+                    }
+                    buf.put(' ');
+                }
+                buf.put('\n');
+            });
+            fprintf(fp, "        </DataArray>\n");
+        }
+    };
+
+    fprintf(fp, "<?xml version=\"1.0\"?>\n");
+    fprintf(fp, "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\"%s>\n",
+            vtu::host_is_little_endian() ? "LittleEndian" : "BigEndian",
+            (level>0) ? " compressor=\"vtkZLibDataCompressor\"" : "");
+    fprintf(fp, "  <UnstructuredGrid>\n");
+    fprintf(fp, "    <Piece NumberOfPoints=\"%zu\" NumberOfCells=\"%zu\">\n", verts.size(), polys.size());
+    fprintf(fp, "      <PointData>\n");
+    for(auto & a : point_arrays) write_array(a);
+    fprintf(fp, "      </PointData>\n");
+    fprintf(fp, "      <CellData>\n");
+    for(auto & a : cell_arrays) write_array(a);
+    fprintf(fp, "      </CellData>\n");
+    fprintf(fp, "      <Points>\n");
+    write_array(geom_arrays.at(0));
+    fprintf(fp, "      </Points>\n");
+    fprintf(fp, "      <Cells>\n");
+    for(uint i=1; i<geom_arrays.size(); ++i) write_array(geom_arrays.at(i));
+    fprintf(fp, "      </Cells>\n");
+    fprintf(fp, "    </Piece>\n");
+    fprintf(fp, "  </UnstructuredGrid>\n");
+    if(appended)
+    {
+        fprintf(fp, "  <AppendedData encoding=\"%s\">\n   _", base64 ? "base64" : "raw");
+        for(vtu::OutArray * a : all) fwrite(a->blob.data(), 1, a->blob.size(), fp);
+        fprintf(fp, "\n  </AppendedData>\n");
+    }
+    fprintf(fp, "</VTKFile>\n");
+    fclose(fp);
 }
 
-#else
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void write_VTU(const char                *,
-               const std::vector<double> &,
-               const std::vector<uint>   &,
-               const std::vector<uint>   &)
+void write_VTU(const char                           * filename,
+               const std::vector<vec3d>             & verts,
+               const std::vector<std::vector<uint>> & polys)
 {
-    std::cerr << "ERROR : VTK missing. Install VTK and recompile defining symbol CINOLIB_USES_VTK" << std::endl;
-    exit(-1);
+    write_VTU(filename, verts, polys, {}, {});
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void write_VTU(const char                           *,
-               const std::vector<vec3d>             &,
-               const std::vector<std::vector<uint>> &)
+void write_VTU(const char                * filename,
+               const std::vector<double> & xyz,
+               const std::vector<uint>   & tets,
+               const std::vector<uint>   & hexa)
 {
-    std::cerr << "ERROR : VTK missing. Install VTK and recompile defining symbol CINOLIB_USES_VTK" << std::endl;
-    exit(-1);
-}
+    std::vector<vec3d> verts(xyz.size()/3);
+    for(size_t vid=0; vid<verts.size(); ++vid) verts.at(vid) = vec3d(xyz[3*vid], xyz[3*vid+1], xyz[3*vid+2]);
 
+    std::vector<std::vector<uint>> polys;
+    polys.reserve(tets.size()/4 + hexa.size()/8);
+    for(size_t i=0; i<tets.size(); i+=4) polys.push_back(std::vector<uint>(tets.begin()+i, tets.begin()+i+4));
+    for(size_t i=0; i<hexa.size(); i+=8) polys.push_back(std::vector<uint>(hexa.begin()+i, hexa.begin()+i+8));
 
-#endif
+    write_VTU(filename, verts, polys, {}, {});
+}
 
 }
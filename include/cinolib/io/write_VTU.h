@@ -40,6 +40,7 @@
 #include <vector>
 #include <cinolib/cino_inline.h>
 #include <cinolib/geometry/vec_mat.h>
+#include <cinolib/io/vtu_utilities.h>
 
 namespace cinolib
 {
@@ -57,6 +58,25 @@ void write_VTU(const char                           * filename,
                const std::vector<vec3d>             & verts,
                const std::vector<std::vector<uint>> & polys);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Native writer for VTK XML Unstructured Grids (tetrahedra and hexahedra).
+ * Point and cell attribute arrays are optional (empty vectors are fine).
+ * encoding is one among VTU_ASCII, VTU_BINARY, VTU_APPENDED_RAW and
+ * VTU_APPENDED_BASE64 (see vtu_utilities.h). If compression_level is in
+ * [1,9] binary arrays are zlib compressed (in parallel, one block at a time).
+ * Compression requires symbol CINOLIB_USES_ZLIB, and is ignored otherwise.
+*/
+
+CINO_INLINE
+void write_VTU(const char                           * filename,
+               const std::vector<vec3d>             & verts,
+               const std::vector<std::vector<uint>> & polys,
+               const std::vector<VTUArray>          & point_data,
+               const std::vector<VTUArray>          & cell_data,
+               const int                              encoding          = VTU_APPENDED_RAW,
+               const int                              compression_level = 0);
+
 }
 
 #ifndef  CINO_STATIC_LIB
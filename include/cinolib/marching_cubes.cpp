@@ -0,0 +1,573 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/marching_cubes.h>
+#include <cinolib/serialize_index.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/io/io_data.h>
+#include <algorithm>
+#include <array>
+#include <thread>
+
+namespace cinolib
+{
+
+// Cell corners are numbered as x + 2y + 4z. Edges 0-3 are aligned with X, edges 4-7 with Y,
+// and edges 8-11 with Z. Face corners are listed counterclockwise, as seen from outside the
+// cell, and the i-th face edge connects the i-th and (i+1)-th face corners
+//
+static const uint MC_EDGE_CORNERS[12][2] =
+{
+    {0,1}, {2,3}, {4,5}, {6,7},
+    {0,2}, {1,3}, {4,6}, {5,7},
+    {0,4}, {1,5}, {2,6}, {3,7}
+};
+
+static const uint MC_FACE_CORNERS[6][4] =
+{
+    {0,4,6,2}, {1,3,7,5}, {0,1,5,4}, {2,6,7,3}, {0,2,3,1}, {4,5,7,6}
+};
+
+static const uint MC_FACE_EDGES[6][4] =
+{
+    {8,6,10,4}, {5,11,7,9}, {0,9,2,8}, {10,3,11,1}, {4,1,5,0}, {2,7,3,6}
+};
+
+static const uint MC_EDGE_FACES[12] = // bitmask of the two faces incident to each edge
+{
+    20, 24, 36, 40, 17, 18, 33, 34, 5, 6, 9, 10
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Links the level set vertices of a cell (one per edge with a sign change) in closed
+// loops, stored as next[e] = edge following e in the loop (-1 if e is not crossed).
+// Loops are oriented such that the positive side of the field is on their left
+//
+CINO_INLINE
+void marching_cubes_cell_loops(const double val[8],
+                               const bool   neg[8],
+                                     int    next[12])
+{
+    std::fill(next, next+12, -1);
+    for(uint f=0; f<6; ++f)
+    {
+        const uint * q  = MC_FACE_CORNERS[f];
+        const uint * fe = MC_FACE_EDGES[f];
+
+        uint n_cross = 0;
+        for(uint t=0; t<4; ++t) if(neg[q[t]]!=neg[q[(t+1)%4]]) ++n_cross;
+
+        if(n_cross==2)
+        {
+            // the segment goes from the edge entering the negative
+            // side to the edge leaving it (walking counterclockwise)
+            int beg = -1, end = -1;
+            for(uint t=0; t<4; ++t)
+            {
+                if(!neg[q[t]] &&  neg[q[(t+1)%4]]) beg = int(fe[t]);
+                if( neg[q[t]] && !neg[q[(t+1)%4]]) end = int(fe[t]);
+            }
+            next[beg] = end;
+        }
+        else if(n_cross==4)
+        {
+            // ambiguous face: use the asymptotic decider to understand whether the positive
+            // corners are connected through the face (i.e. the saddle of the bilinear
+            // interpolant is positive) or not. The denominator cannot vanish, because the
+            // signs alternate along the face
+            double w[4] = { val[q[0]], val[q[1]], val[q[2]], val[q[3]] };
+            bool pos_connected = (w[0]*w[2] - w[1]*w[3]) / (w[0] + w[2] - w[1] - w[3]) >= 0;
+            for(uint t=0; t<4; ++t)
+            {
+                uint prev = (t+3)%4;
+                if( pos_connected &&  neg[q[t]]) next[fe[prev]] = int(fe[t]);
+                if(!pos_connected && !neg[q[t]]) next[fe[t]]    = int(fe[prev]);
+            }
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Core of all the marching cubes variants. The field is sampled one plane at a time through
+// sample_plane(i,plane), which fills plane[j*dim[2]+k] with the value at lattice point (i,j,k)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void marching_cubes_slabs(const std::function<void(const uint i, double * plane)> & sample_plane,
+                          const uint                                               dim[3],
+                          const vec3d                                            & origin,
+                          const vec3d                                            & step,
+                          const double                                             isovalue,
+                                Trimesh<M,V,E,P>                                 & m)
+{
+    m.clear();
+    if(dim[0]<2 || dim[1]<2 || dim[2]<2) return;
+
+    struct Slab
+    {
+        std::vector<vec3d> verts;
+        std::vector<uint>  tris;
+        std::vector<std::pair<uint,uint>> first_plane; // (cache slot, vid) of the vertices on the first plane...
+        std::vector<std::pair<uint,uint>> last_plane;  // ...and on the last plane
+        std::vector<uint>  corner_verts;               // vertices placed at lattice points
+    };
+
+    uint n_layers  = dim[0]-1;
+    uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+    uint n_slabs   = std::min(n_layers, 4*n_threads);
+    uint n_plane   = dim[1]*dim[2];
+    std::vector<Slab> slabs(n_slabs);
+
+    PARALLEL_FOR(0, n_slabs, 2, [&](uint s)
+    {
+        Slab & slab = slabs.at(s);
+        uint   beg  = uint(uint64_t(n_layers)*s/n_slabs);
+        uint   end  = uint(uint64_t(n_layers)*(s+1)/n_slabs);
+
+        // vertices on the Y and Z edges of the planes i and i+1, and on the X edges in between.
+        // Vertices at the lattice points of the planes i and i+1 are cached in corner
+        std::vector<double> plane[2] = { std::vector<double>(n_plane), std::vector<double>(n_plane) };
+        std::vector<uint>   y_edge[2], z_edge[2], corner[2], x_edge(n_plane);
+        for(uint d=0; d<2; ++d)
+        {
+            y_edge[d].assign(n_plane, UINT_MAX);
+            z_edge[d].assign(n_plane, UINT_MAX);
+            corner[d].assign(n_plane, UINT_MAX);
+        }
+
+        // stores the edges and points of the cache plane d with a vertex on them as lists of (slot,vid)
+        // pairs (Y edges first, then Z edges shifted by n_plane, then points shifted by 2*n_plane), sorted by slot
+        auto export_plane = [&](const uint d, std::vector<std::pair<uint,uint>> & list)
+        {
+            for(uint slot=0; slot<n_plane; ++slot) if(y_edge[d][slot]!=UINT_MAX) list.push_back(std::make_pair(slot, y_edge[d][slot]));
+            for(uint slot=0; slot<n_plane; ++slot) if(z_edge[d][slot]!=UINT_MAX) list.push_back(std::make_pair(n_plane+slot, z_edge[d][slot]));
+            for(uint slot=0; slot<n_plane; ++slot) if(corner[d][slot]!=UINT_MAX) list.push_back(std::make_pair(2*n_plane+slot, corner[d][slot]));
+        };
+
+        sample_plane(beg, plane[0].data());
+        for(uint i=beg; i<end; ++i)
+        {
+            sample_plane(i+1, plane[1].data());
+            std::fill(y_edge[1].begin(), y_edge[1].end(), UINT_MAX);
+            std::fill(z_edge[1].begin(), z_edge[1].end(), UINT_MAX);
+            std::fill(corner[1].begin(), corner[1].end(), UINT_MAX);
+            std::fill(x_edge.begin(),    x_edge.end(),    UINT_MAX);
+
+            for(uint j=0; j+1<dim[1]; ++j)
+            {
+                // rows of samples at the corners of the cells (i,j,*)
+                const double * row[4] =
+                {
+                    plane[0].data() +  j   *dim[2],
+                    plane[1].data() +  j   *dim[2],
+                    plane[0].data() + (j+1)*dim[2],
+                    plane[1].data() + (j+1)*dim[2]
+                };
+                // signs of the four samples at k (i.e. corners 0-3 of the cell),
+                // carried along the row to skip cells the level set does not cross
+                auto signs = [&](const uint k) -> uint
+                {
+                    return uint(row[0][k]<isovalue)      | uint(row[1][k]<isovalue) << 1 |
+                           uint(row[2][k]<isovalue) << 2 | uint(row[3][k]<isovalue) << 3;
+                };
+                uint lo = signs(0);
+                for(uint k=0; k+1<dim[2]; ++k)
+                {
+                    uint hi   = signs(k+1);
+                    uint code = lo | hi << 4;
+                    lo = hi;
+                    if(code==0x00 || code==0xFF) continue;
+
+                    double val[8] =
+                    {
+                        row[0][k]   - isovalue, row[1][k]   - isovalue, row[2][k]   - isovalue, row[3][k]   - isovalue,
+                        row[0][k+1] - isovalue, row[1][k+1] - isovalue, row[2][k+1] - isovalue, row[3][k+1] - isovalue
+                    };
+                    bool neg[8];
+                    for(uint c=0; c<8; ++c) neg[c] = (code >> c) & 1;
+
+                    // vertex on the e-th edge of the cell (created if not cached yet). Samples equal to
+                    // the isovalue count as above it, and the vertices of all their crossed edges collapse
+                    // onto the lattice point. The vertex is then shared by all such edges
+                    auto edge_vert = [&](const uint e, uint & c) -> uint
+                    {
+                        uint * vid;
+                        if(e<4)      vid = &x_edge[(j+(e&1))*dim[2] + k+(e>>1)];
+                        else if(e<8) vid = &y_edge[(e-4)&1][j*dim[2] + k+((e-4)>>1)];
+                        else         vid = &z_edge[(e-8)&1][(j+((e-8)>>1))*dim[2] + k];
+                        uint ca = MC_EDGE_CORNERS[e][0];
+                        uint cb = MC_EDGE_CORNERS[e][1];
+                        c = (val[ca]==0) ? ca : ((val[cb]==0) ? cb : 8);
+                        if(*vid==UINT_MAX && c<8)
+                        {
+                            *vid = corner[c&1][(j+((c>>1)&1))*dim[2] + k+((c>>2)&1)];
+                            if(*vid==UINT_MAX)
+                            {
+                                *vid = uint(slab.verts.size());
+                                corner[c&1][(j+((c>>1)&1))*dim[2] + k+((c>>2)&1)] = *vid;
+                                slab.corner_verts.push_back(*vid);
+                                slab.verts.push_back(origin + vec3d((i+(c&1))*step.x(), (j+((c>>1)&1))*step.y(), (k+((c>>2)&1))*step.z()));
+                            }
+                        }
+                        else if(*vid==UINT_MAX)
+                        {
+                            double alpha = val[ca] / (val[ca] - val[cb]);
+                            vec3d  pa(i + (ca&1), j + ((ca>>1)&1), k + ((ca>>2)&1));
+                            vec3d  pb(i + (cb&1), j + ((cb>>1)&1), k + ((cb>>2)&1));
+                            vec3d  p = pa + alpha*(pb-pa);
+                            *vid = uint(slab.verts.size());
+                            slab.verts.push_back(origin + vec3d(p.x()*step.x(), p.y()*step.y(), p.z()*step.z()));
+                        }
+                        return *vid;
+                    };
+
+                    int next[12];
+                    marching_cubes_cell_loops(val, neg, next);
+                    bool visited[12] = { false, false, false, false, false, false,
+                                         false, false, false, false, false, false };
+                    for(uint e0=0; e0<12; ++e0)
+                    {
+                        if(next[e0]<0 || visited[e0]) continue;
+                        uint loop[12], loop_f[12], loop_c[12];
+                        uint n = 0;
+                        for(int e=int(e0); !visited[e]; e=next[e])
+                        {
+                            assert(e>=0);
+                            visited[e] = true;
+                            loop[n]    = edge_vert(uint(e), loop_c[n]);
+                            loop_f[n]  = MC_EDGE_FACES[e];
+                            if(loop_c[n]<8) // a lattice point lies on three faces of the cell
+                            {
+                                uint c = loop_c[n];
+                                loop_f[n] = (1u << (c&1)) | (1u << (2+((c>>1)&1))) | (1u << (4+((c>>2)&1)));
+                            }
+                            ++n;
+                        }
+
+                        // merge consecutive vertices collapsed onto the same lattice point. Loops
+                        // left with less than three vertices have zero area, and are discarded
+                        uint n_merged = 0;
+                        for(uint t=0; t<n; ++t)
+                        {
+                            if(n_merged>0 && loop[n_merged-1]==loop[t]) continue;
+                            loop  [n_merged] = loop  [t];
+                            loop_f[n_merged] = loop_f[t];
+                            loop_c[n_merged] = loop_c[t];
+                            ++n_merged;
+                        }
+                        while(n_merged>1 && loop[n_merged-1]==loop[0]) --n_merged;
+                        n = n_merged;
+                        if(n<3) continue;
+
+                        // triangulate the loop as a fan. Diagonals connecting two edges of the same
+                        // face could be generated by the adjacent cell as well, making the surface non
+                        // manifold, hence look for an apex that avoids them or add a central vertex.
+                        // Loops made of lattice points only use the lowest one as apex, so that the
+                        // adjacent cell makes the same choice for loops lying on a shared face
+                        uint apex = n;
+                        bool on_points = true;
+                        for(uint t=0; t<n; ++t) on_points &= (loop_c[t]<8);
+                        if(on_points)
+                        {
+                            apex = 0;
+                            for(uint t=1; t<n; ++t) if(loop_c[t]<loop_c[apex]) apex = t;
+                        }
+                        for(uint r=0; r<n && apex==n; ++r)
+                        {
+                            bool ok = true;
+                            for(uint t=2; t+1<n && ok; ++t) ok = !(loop_f[r] & loop_f[(r+t)%n]);
+                            if(ok) apex = r;
+                        }
+                        if(apex<n)
+                        {
+                            for(uint t=1; t+1<n; ++t)
+                            {
+                                slab.tris.push_back(loop[apex]);
+                                slab.tris.push_back(loop[(apex+t)%n]);
+                                slab.tris.push_back(loop[(apex+t+1)%n]);
+                            }
+                        }
+                        else
+                        {
+                            vec3d c(0,0,0);
+                            for(uint t=0; t<n; ++t) c += slab.verts.at(loop[t]);
+                            uint vc = uint(slab.verts.size());
+                            slab.verts.push_back(c/double(n));
+                            for(uint t=0; t<n; ++t)
+                            {
+                                slab.tris.push_back(vc);
+                                slab.tris.push_back(loop[t]);
+                                slab.tris.push_back(loop[(t+1)%n]);
+                            }
+                        }
+                    }
+                }
+            }
+            if(i==beg) export_plane(0, slab.first_plane);
+            std::swap(plane[0],  plane[1]);
+            std::swap(y_edge[0], y_edge[1]);
+            std::swap(z_edge[0], z_edge[1]);
+            std::swap(corner[0], corner[1]);
+        }
+        export_plane(0, slab.last_plane);
+    });
+
+    // weld the vertices on the planes shared by consecutive slabs. Both slabs created a
+    // vertex for each edge with a sign change on the plane, whereas a lattice point on the
+    // plane may have been reached (through the X edges) by one of them only
+    std::vector<std::vector<uint>> v_map(n_slabs);
+    std::vector<uint> offset(n_slabs+1, 0);
+    uint nv = 0;
+    for(uint s=0; s<n_slabs; ++s)
+    {
+        v_map.at(s).assign(slabs.at(s).verts.size(), UINT_MAX);
+        if(s>0)
+        {
+            const auto & first = slabs.at(s).first_plane;
+            const auto & last  = slabs.at(s-1).last_plane;
+            for(uint a=0, b=0; a<first.size() && b<last.size();)
+            {
+                     if(first.at(a).first<last.at(b).first) ++a;
+                else if(first.at(a).first>last.at(b).first) ++b;
+                else v_map.at(s).at(first.at(a++).second) = v_map.at(s-1).at(last.at(b++).second);
+            }
+        }
+        for(uint & vid : v_map.at(s)) if(vid==UINT_MAX) vid = nv++;
+        offset.at(s+1) = offset.at(s) + uint(slabs.at(s).tris.size());
+    }
+
+    // build the mesh from a flat list of triangles, without intermediate copies
+    IOData data;
+    data.verts.resize(nv);
+    data.poly_vids.resize(offset.back());
+    PARALLEL_FOR(0, n_slabs, 2, [&](uint s)
+    {
+        const Slab & slab = slabs.at(s);
+        for(uint vid=0; vid<slab.verts.size(); ++vid) data.verts.at(v_map.at(s).at(vid)) = slab.verts.at(vid);
+        for(uint i=0; i<slab.tris.size(); ++i) data.poly_vids.at(offset.at(s)+i) = v_map.at(s).at(slab.tris.at(i));
+    });
+
+    // where the field equals the isovalue on lattice points with lower values on both sides of a
+    // cell face (e.g. a plane of samples equal to the isovalue), the cells on either side generate
+    // the same triangles with opposite orientation. The level set is locally a double sheet of zero
+    // thickness, and both copies are discarded
+    std::vector<bool> on_point(nv, false);
+    for(uint s=0; s<n_slabs; ++s) for(uint vid : slabs.at(s).corner_verts) on_point.at(v_map.at(s).at(vid)) = true;
+    std::vector<std::pair<std::array<uint,3>,uint>> sheet; // (sorted vids, triangle)
+    for(uint tid=0; tid<offset.back()/3; ++tid)
+    {
+        const uint * t = data.poly_vids.data() + 3*tid;
+        if(!on_point.at(t[0]) && !on_point.at(t[1]) && !on_point.at(t[2])) continue;
+        std::array<uint,3> key = {{ t[0], t[1], t[2] }};
+        std::sort(key.begin(), key.end());
+        sheet.push_back(std::make_pair(key, tid));
+    }
+    std::vector<bool> drop(offset.back()/3, false);
+    std::sort(sheet.begin(), sheet.end());
+    for(uint a=0; a+1<sheet.size(); ++a)
+    {
+        if(drop.at(sheet.at(a).second)) continue;
+        for(uint b=a+1; b<sheet.size() && sheet.at(b).first==sheet.at(a).first; ++b)
+        {
+            // two triangles with the same vertices have opposite orientation
+            // iff the second vertex of one of them follows the first in the other
+            const uint * ta = data.poly_vids.data() + 3*sheet.at(a).second;
+            const uint * tb = data.poly_vids.data() + 3*sheet.at(b).second;
+            uint off = 0;
+            while(tb[off]!=ta[0]) ++off;
+            if(drop.at(sheet.at(b).second) || tb[(off+1)%3]==ta[1]) continue;
+            drop.at(sheet.at(a).second) = true;
+            drop.at(sheet.at(b).second) = true;
+            break;
+        }
+    }
+    if(!sheet.empty())
+    {
+        uint n_tris = 0;
+        for(uint tid=0; tid<drop.size(); ++tid)
+        {
+            if(drop.at(tid)) continue;
+            for(uint i=0; i<3; ++i) data.poly_vids.at(3*n_tris+i) = data.poly_vids.at(3*tid+i);
+            ++n_tris;
+        }
+        data.poly_vids.resize(3*n_tris);
+    }
+
+    // remove the lattice points whose loops all collapsed, or whose triangles were all discarded
+    if(std::find(on_point.begin(), on_point.end(), true)!=on_point.end())
+    {
+        std::vector<uint> v_new(nv, 0);
+        for(uint vid : data.poly_vids) v_new.at(vid) = 1;
+        uint n_used = 0;
+        for(uint vid=0; vid<nv; ++vid)
+        {
+            if(v_new.at(vid)==0) continue;
+            data.verts.at(n_used) = data.verts.at(vid);
+            v_new.at(vid) = n_used++;
+        }
+        for(uint & vid : data.poly_vids) vid = v_new.at(vid);
+        data.verts.resize(n_used);
+    }
+
+    data.poly_offsets.resize(data.poly_vids.size()/3+1);
+    for(uint pid=0; pid<data.poly_offsets.size(); ++pid) data.poly_offsets.at(pid) = 3*pid;
+    m.init(std::move(data));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void marching_cubes(const std::vector<double> & field,
+                    const uint                  dim[3],
+                    const AABB                & volume,
+                    const double                isovalue,
+                          Trimesh<M,V,E,P>    & m)
+{
+    assert(field.size()==size_t(dim[0])*dim[1]*dim[2]);
+    uint  n_plane = dim[1]*dim[2];
+    vec3d step(volume.delta_x()/std::max(1u, dim[0]-1),
+               volume.delta_y()/std::max(1u, dim[1]-1),
+               volume.delta_z()/std::max(1u, dim[2]-1));
+
+    marching_cubes_slabs([&](const uint i, double * plane)
+    {
+        std::copy(field.begin() + size_t(i)*n_plane, field.begin() + size_t(i+1)*n_plane, plane);
+    },
+    dim, volume.min, step, isovalue, m);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void marching_cubes(const std::function<double(const vec3d & p)> & f,
+                    const AABB                                   & volume,
+                    const uint                                     max_voxels_per_side,
+                    const double                                   isovalue,
+                          Trimesh<M,V,E,P>                       & m)
+{
+    // same lattice as the corners of the voxels computed by voxelize(f,...)
+    double len = volume.delta().max_entry() / max_voxels_per_side;
+    uint dim[3] =
+    {
+        uint(ceil(volume.delta_x()/len)) + 1,
+        uint(ceil(volume.delta_y()/len)) + 1,
+        uint(ceil(volume.delta_z()/len)) + 1
+    };
+
+    marching_cubes_slabs([&](const uint i, double * plane)
+    {
+        for(uint j=0; j<dim[1]; ++j)
+        for(uint k=0; k<dim[2]; ++k)
+        {
+            plane[j*dim[2]+k] = f(volume.min + vec3d(i*len, j*len, k*len));
+        }
+    },
+    dim, volume.min, vec3d(len,len,len), isovalue, m);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void marching_cubes(const VoxelGrid        & g,
+                          Trimesh<M,V,E,P> & m,
+                    const int                inside_flags)
+{
+    // the lattice connects voxel centers, and has an extra layer
+    // of outside samples all around, to close the surface
+    uint  dim[3] = { g.dim[0]+2, g.dim[1]+2, g.dim[2]+2 };
+    vec3d origin = g.bbox.min - vec3d(0.5*g.len, 0.5*g.len, 0.5*g.len);
+
+    marching_cubes_slabs([&](const uint i, double * plane)
+    {
+        std::fill(plane, plane+dim[1]*dim[2], 1.0);
+        if(i==0 || i>g.dim[0]) return;
+        for(uint j=0; j<g.dim[1]; ++j)
+        for(uint k=0; k<g.dim[2]; ++k)
+        {
+            int flag = g.voxels[serialize_3D_index(i-1,j,k,g.dim[1],g.dim[2])];
+            if(flag & inside_flags) plane[(j+1)*dim[2]+k+1] = -1.0;
+        }
+    },
+    dim, origin, vec3d(g.len,g.len,g.len), 0, m);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void marching_cubes(const SparseVoxelGrid  & g,
+                          Trimesh<M,V,E,P> & m,
+                    const int                inside_flags)
+{
+    uint  dim[3] = { g.dim[0]+2, g.dim[1]+2, g.dim[2]+2 };
+    vec3d origin = g.bbox.min - vec3d(0.5*g.len, 0.5*g.len, 0.5*g.len);
+
+    marching_cubes_slabs([&](const uint i, double * plane)
+    {
+        std::fill(plane, plane+dim[1]*dim[2], 1.0);
+        if(i==0 || i>g.dim[0]) return;
+        // visit the plane block by block, to avoid per voxel queries in uniform blocks
+        const uint B = SparseVoxelGrid::BLOCK_SIZE;
+        for(uint bj=0; bj<g.bdim[1]; ++bj)
+        for(uint bk=0; bk<g.bdim[2]; ++bk)
+        {
+            uint bid = g.block_id(i-1, bj*B, bk*B);
+            uint beg[3], end[3];
+            g.block_range(bid, beg, end);
+            if(g.block_is_uniform(bid))
+            {
+                if(!(g.block_flag(bid) & inside_flags)) continue;
+                for(uint j=beg[1]; j<end[1]; ++j)
+                for(uint k=beg[2]; k<end[2]; ++k) plane[(j+1)*dim[2]+k+1] = -1.0;
+            }
+            else
+            {
+                for(uint j=beg[1]; j<end[1]; ++j)
+                for(uint k=beg[2]; k<end[2]; ++k)
+                {
+                    if(g.get(i-1,j,k) & inside_flags) plane[(j+1)*dim[2]+k+1] = -1.0;
+                }
+            }
+        }
+    },
+    dim, origin, vec3d(g.len,g.len,g.len), 0, m);
+}
+
+}
@@ -0,0 +1,118 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MARCHING_CUBES_H
+#define CINO_MARCHING_CUBES_H
+
+#include <functional>
+#include <cinolib/cino_inline.h>
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/voxel_grid.h>
+#include <cinolib/sparse_voxel_grid.h>
+
+namespace cinolib
+{
+
+/* Marching cubes extraction of the level set of a scalar field sampled on a regular lattice.
+ * The output is a welded triangle mesh, with triangles oriented towards increasing values of
+ * the field. The mesh is watertight, unless the level set reaches the border of the lattice.
+ *
+ * Rather than using the classical table of 256 cases, the polygons in each cell are traced
+ * across the cell faces. Ambiguous faces (i.e. faces with alternating signs at the corners)
+ * are resolved with the asymptotic decider, which only depends on the values at the face
+ * corners. Adjacent cells therefore always agree, and no cracks can appear.
+ *
+ * Samples equal to the isovalue are treated as if they were slightly above it. Level set vertices
+ * falling exactly on them are collapsed into one, and the triangles that degenerate as a result
+ * are discarded. Where the level set touches itself at such samples the mesh is non manifold.
+ *
+ * The lattice is split into slabs along the X axis, which are processed in parallel. Each slab
+ * only stores two planes of samples at a time, and caches the vertices generated along the
+ * lattice edges of the current layer of cells, so that they are shared by adjacent cells.
+ * Vertices on the planes shared by two slabs are welded at the end.
+*/
+
+// Level set of a field sampled at the dim[0] x dim[1] x dim[2] points of a lattice spanning
+// the box volume. Samples are serialized as in serialize_3D_index(i,j,k,dim[1],dim[2])
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void marching_cubes(const std::vector<double> & field,
+                    const uint                  dim[3],
+                    const AABB                & volume,
+                    const double                isovalue,
+                          Trimesh<M,V,E,P>    & m);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Level set of an analytic function f (e.g. a Hermite_RBF), sampled at the corners of the
+// voxels voxelize(f,volume,max_voxels_per_side,g) would produce. Samples are computed on the
+// fly, hence memory does not grow with the cube of the resolution
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void marching_cubes(const std::function<double(const vec3d & p)> & f,
+                    const AABB                                   & volume,
+                    const uint                                     max_voxels_per_side,
+                    const double                                   isovalue,
+                          Trimesh<M,V,E,P>                       & m);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Surface enclosing the voxels whose flag is in inside_flags (bitwise OR of voxel flags).
+// The surface passes halfway between the centers of inside and outside voxels
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void marching_cubes(const VoxelGrid        & g,
+                          Trimesh<M,V,E,P> & m,
+                    const int                inside_flags = VOXEL_INSIDE | VOXEL_BOUNDARY);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Same as above, for sparse grids
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void marching_cubes(const SparseVoxelGrid  & g,
+                          Trimesh<M,V,E,P> & m,
+                    const int                inside_flags = VOXEL_INSIDE | VOXEL_BOUNDARY);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "marching_cubes.cpp"
+#endif
+
+#endif // CINO_MARCHING_CUBES_H
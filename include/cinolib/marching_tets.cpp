@@ -43,279 +43,245 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/marching_tets.h>
-#include <array>
+#include <cinolib/parallel_for.h>
+#include <cinolib/predicates.h>
+#include <algorithm>
+#include <numeric>
 
 namespace cinolib
 {
 
-enum // Look-up Table
-{
-    C_1111 = 0xF,
-    C_0111 = 0x7,
-    C_1011 = 0xB,
-    C_0011 = 0x3,
-    C_1101 = 0xD,
-    C_0101 = 0x5,
-    C_1001 = 0x9,
-    C_0001 = 0x1,
-    C_1110 = 0xE,
-    C_0110 = 0x6,
-    C_1010 = 0xA,
-    C_0010 = 0x2,
-    C_1100 = 0xC,
-    C_0100 = 0x4,
-    C_1000 = 0x8,
-    C_0000 = 0x0
-};
-
-//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void make_triangle(const Tetmesh<M,V,E,F,P> & m,
+void marching_tets(const Tetmesh<M,V,E,F,P> & m,
                    const double               isovalue,
-                   const uint                 vids[],
-                   const double               func[],
-                   const std::array<uint,3> & e,
-                   std::map<ipair,uint>     & e2v_map,
                    std::vector<vec3d>       & verts,
                    std::vector<uint>        & tris,
-                   std::vector<vec3d>       & norms);
+                   std::vector<vec3d>       & norms)
+{
+    std::vector<uint> tri_iso;
+    marching_tets(m, std::vector<double>(1,isovalue), verts, tris, norms, tri_iso);
+}
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void marching_tets(const Tetmesh<M,V,E,F,P> & m,
-                   const double               isovalue,
+                   const std::vector<double>& isovalues,
                    std::vector<vec3d>       & verts,
                    std::vector<uint>        & tris,
-                   std::vector<vec3d>       & norms)
+                   std::vector<vec3d>       & norms,
+                   std::vector<uint>        & tri_iso)
 {
-    /* FIXME: for all configurations where two verts >= isoval
-     * and the other two are < isoval, this method will try to
-     * make a quad (2 triangles).
-     * Indeed, if one vertx has exactly isoval, the surface cuts
-     * a triangle and not a quad inside the tet, and therefore
-     * one of the two triangles will be degenerate.
-     * To avoid confusion and excessive code specialization for corner
-     * cases, maybe it is better to have three possible states for a
-     * vertex (<,>,=). In this case each configuration will be 100% correct
-    */
-
-    std::vector<unsigned char> c(m.num_polys(),0x0);
-    std::vector<bool> swapped(m.num_polys(), false);
-
-    for(uint pid=0; pid<m.num_polys(); ++pid)
+    verts.clear();
+    tris.clear();
+    norms.clear();
+    tri_iso.clear();
+
+    // sort the isovalues, so that the ones crossing an edge
+    // or a tet can be found with a binary search
+    uint n_iso = uint(isovalues.size());
+    std::vector<uint> order(n_iso);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint a, uint b){ return isovalues.at(a) < isovalues.at(b); });
+    std::vector<double> iso(n_iso);
+    for(uint s=0; s<n_iso; ++s) iso.at(s) = isovalues.at(order.at(s));
+
+    auto f = [&](const uint vid) -> double { return m.vert_data(vid).uvw[0]; };
+
+    // Level set vertices are generated along the edges, for all isovalues strictly between the
+    // values at the endpoints. A mesh vertex whose value equals an isovalue is a level set vertex
+    // itself, provided that it has a neighbor with a lower value (hence the level set crosses
+    // at least one of its edges). Edge vertices come first, and mesh vertices follow
+    uint ne = m.num_edges();
+    uint nv = m.num_verts();
+    std::vector<uint> e_first(ne), v_first(nv), offset(ne+nv+1, 0);
+    PARALLEL_FOR(0, ne, 1000, [&](uint eid)
     {
-        double func[] =
-        {
-            m.vert_data(m.poly_vert_id(pid,0)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,1)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,2)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,3)).uvw[0]
-        };
-
-        if (isovalue >= func[0]) c.at(pid) |= C_1000;
-        if (isovalue >= func[1]) c.at(pid) |= C_0100;
-        if (isovalue >= func[2]) c.at(pid) |= C_0010;
-        if (isovalue >= func[3]) c.at(pid) |= C_0001;
-
-        /* If the isosurface does not intersect the tet,
-         * one should get C_1111 using ">=", and C_0000
-         * inverting to "<=".
-         *
-         * This does not happen if the isosurface passes
-         * exhactly through one face. In this case one will
-         * get C_1111 using ">=", and something like
-         * C_0111 using "<=".
-         *
-         * Normally this does not create any trouble, as the
-         * face-adjacent tet will trigger the generation of
-         * that triangle. But if the tet is exposed on the
-         * surface, then that triangle will be missing in the
-         * final iso-surface.
-         *
-         * To avoid these missing triangles, whenever I get
-         * a C_1111 I invert the sign, and assign to the tet
-         * the configuration produced using "<="
-        */
-        if (c.at(pid) == C_1111)
+        double lo = f(m.edge_vert_id(eid,0));
+        double hi = f(m.edge_vert_id(eid,1));
+        if(lo>hi) std::swap(lo,hi);
+        uint beg = uint(std::upper_bound(iso.begin(), iso.end(), lo) - iso.begin());
+        uint end = uint(std::lower_bound(iso.begin(), iso.end(), hi) - iso.begin());
+        e_first.at(eid)= beg;
+        offset.at(eid) = (end>beg) ? end-beg : 0;
+    });
+    PARALLEL_FOR(0, nv, 1000, [&](uint vid)
+    {
+        auto range = std::equal_range(iso.begin(), iso.end(), f(vid));
+        v_first.at(vid) = uint(range.first - iso.begin());
+        bool has_lower_nbr = false;
+        for(uint nbr : m.adj_v2v(vid)) if(f(nbr)<f(vid)) { has_lower_nbr = true; break; }
+        offset.at(ne+vid) = has_lower_nbr ? uint(range.second - range.first) : 0;
+    });
+    uint n_verts = PARALLEL_PREFIX_SUM(offset, 100000);
+
+    verts.resize(n_verts);
+    PARALLEL_FOR(0, ne, 1000, [&](uint eid)
+    {
+        uint   v0 = m.edge_vert_id(eid,0);
+        uint   v1 = m.edge_vert_id(eid,1);
+        double f0 = f(v0);
+        double f1 = f(v1);
+        for(uint vid=offset.at(eid), s=e_first.at(eid); vid<offset.at(eid+1); ++vid, ++s)
         {
-            swapped.at(pid) = true;
-            c.at(pid) = 0x0;
-            if (isovalue <= func[0]) c.at(pid) |= C_1000;
-            if (isovalue <= func[1]) c.at(pid) |= C_0100;
-            if (isovalue <= func[2]) c.at(pid) |= C_0010;
-            if (isovalue <= func[3]) c.at(pid) |= C_0001;
+            double alpha = (iso.at(s) - f0) / (f1 - f0);
+            verts.at(vid) = (1.0 - alpha) * m.vert(v0) + alpha * m.vert(v1);
         }
-    }
-
-    std::map<ipair,uint> e2v_map;
-
-    for(uint pid=0; pid<m.num_polys(); ++pid)
+    });
+    PARALLEL_FOR(0, nv, 1000, [&](uint vid)
     {
-        uint vids[] =
-        {
-            m.poly_vert_id(pid,0),
-            m.poly_vert_id(pid,1),
-            m.poly_vert_id(pid,2),
-            m.poly_vert_id(pid,3)
-        };
-
-        double func[] =
-        {
-            m.vert_data(vids[0]).uvw[0],
-            m.vert_data(vids[1]).uvw[0],
-            m.vert_data(vids[2]).uvw[0],
-            m.vert_data(vids[3]).uvw[0]
-        };
-
-        bool v_on_iso[] =
-        {
-            func[0] == isovalue,
-            func[1] == isovalue,
-            func[2] == isovalue,
-            func[3] == isovalue
-        };
+        for(uint i=offset.at(ne+vid); i<offset.at(ne+vid+1); ++i) verts.at(i) = m.vert(vid);
+    });
 
-        int adj_tet[] // not uint because it may be -1 if there is no adjacent tet!
-        {
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,0)),
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,1)),
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,2)),
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,3)),
-        };
-
-        // Avoid triangle duplication and collapsed triangle generation when the iso-surface
-        // passes EXACTLY through a vertex/edge/face shared between many tetrahedra.
-        //
-        switch (c.at(pid))
+    // level set vertex for isovalue s along the edge (v_lo,v_hi), with f(v_lo) < iso <= f(v_hi)
+    auto iso_vert = [&](const uint eid, const uint v_hi, const uint s) -> uint
+    {
+        if(iso.at(s)==f(v_hi)) return offset.at(ne+v_hi) + s - v_first.at(v_hi);
+        return offset.at(eid) + s - e_first.at(eid);
+    };
+
+    // generates the triangles of a tet, calling emit(t,s) for each triangle t of isovalue s.
+    // Parity of the permutations (a,b,c,i) and (a,b,c,d) used to orient the triangles, where
+    // i is the lone vertex, a,b are the vertices below the isovalue and c,d the ones above it
+    // (sorted in ascending order). The quad case is indexed by the bitmask of a and b
+    const int LONE_PARITY[4]  = { -1, 1, -1, 1 };
+    const int QUAD_PARITY[16] = { 0, 0, 0, 1, 0, -1, 1, 0, 0, 1, -1, 0, 1, 0, 0, 0 };
+    auto tet_triangles = [&](const uint pid, const std::function<void(const uint t[3], const uint s)> & emit)
+    {
+        uint   vids[4];
+        double func[4];
+        for(uint i=0; i<4; ++i)
         {
-            // iso-surface passes on a face : make sure only one tet (MUST BE the one with higher id) triggers triangle generation...
-            // Notice that if the adjacent tet is collapsed (C_1111), then it make sense to use the current one regardless the tid order
-            case C_1110 : if (v_on_iso[0] && v_on_iso[1] && v_on_iso[2] && (int)pid < adj_tet[0] && c.at(adj_tet[0]) != C_1111) c.at(pid) = C_0000; break;
-            case C_1101 : if (v_on_iso[0] && v_on_iso[1] && v_on_iso[3] && (int)pid < adj_tet[1] && c.at(adj_tet[1]) != C_1111) c.at(pid) = C_0000; break;
-            case C_1011 : if (v_on_iso[0] && v_on_iso[2] && v_on_iso[3] && (int)pid < adj_tet[2] && c.at(adj_tet[2]) != C_1111) c.at(pid) = C_0000; break;
-            case C_0111 : if (v_on_iso[1] && v_on_iso[2] && v_on_iso[3] && (int)pid < adj_tet[3] && c.at(adj_tet[3]) != C_1111) c.at(pid) = C_0000; break;
-
-            // iso-surface passes on a edge : do nothing
-            case C_0101 : if (v_on_iso[1] && v_on_iso[3]) c.at(pid) = C_0000; break;
-            case C_1010 : if (v_on_iso[0] && v_on_iso[2]) c.at(pid) = C_0000; break;
-            case C_0011 : if (v_on_iso[2] && v_on_iso[3]) c.at(pid) = C_0000; break;
-            case C_1100 : if (v_on_iso[0] && v_on_iso[1]) c.at(pid) = C_0000; break;
-            case C_1001 : if (v_on_iso[0] && v_on_iso[3]) c.at(pid) = C_0000; break;
-            case C_0110 : if (v_on_iso[1] && v_on_iso[2]) c.at(pid) = C_0000; break;
-
-            // iso-surface passes on a vertex : do nothing
-            case C_1000 : if (v_on_iso[0]) c.at(pid) = C_0000; break;
-            case C_0100 : if (v_on_iso[1]) c.at(pid) = C_0000; break;
-            case C_0010 : if (v_on_iso[2]) c.at(pid) = C_0000; break;
-            case C_0001 : if (v_on_iso[3]) c.at(pid) = C_0000; break;
-
-            default : break;
+            vids[i] = m.poly_vert_id(pid,i);
+            func[i] = f(vids[i]);
         }
-
-        // triangle generation
-        switch (c.at(pid))
+        double fmin = *std::min_element(func, func+4);
+        double fmax = *std::max_element(func, func+4);
+        uint   beg  = uint(std::upper_bound(iso.begin(), iso.end(), fmin) - iso.begin());
+        uint   end  = uint(std::upper_bound(iso.begin(), iso.end(), fmax) - iso.begin());
+        if(beg>=end) return;
+
+        uint eids[4][4];
+        for(uint eid : m.adj_p2e(pid))
         {
-            case C_1000 : { make_triangle(m, isovalue, vids, func, {2,0,4}, e2v_map, verts, tris, norms); break; }
-            case C_0111 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {2,0,4}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {0,2,4}, e2v_map, verts, tris, norms); break; }
-            case C_1011 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {1,2,3}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {2,1,3}, e2v_map, verts, tris, norms); break; }
-            case C_0100 : { make_triangle(m, isovalue, vids, func, {1,2,3}, e2v_map, verts, tris, norms); break; }
-            case C_1101 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {0,1,5}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {1,0,5}, e2v_map, verts, tris, norms); break; }
-            case C_0010 : { make_triangle(m, isovalue, vids, func, {0,1,5}, e2v_map, verts, tris, norms); break; }
-            case C_0001 : { make_triangle(m, isovalue, vids, func, {5,3,4}, e2v_map, verts, tris, norms); break; }
-            case C_1110 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {5,3,4}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {3,5,4}, e2v_map, verts, tris, norms); break; }
-            case C_0101 : { make_triangle(m, isovalue, vids, func, {5,2,4}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {2,5,1}, e2v_map, verts, tris, norms); break; }
-            case C_1010 : { make_triangle(m, isovalue, vids, func, {2,5,4}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {5,2,1}, e2v_map, verts, tris, norms); break; }
-            case C_0011 : { make_triangle(m, isovalue, vids, func, {3,4,1}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {1,4,0}, e2v_map, verts, tris, norms); break; }
-            case C_1100 : { make_triangle(m, isovalue, vids, func, {4,3,1}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {4,1,0}, e2v_map, verts, tris, norms); break; }
-            case C_1001 : { make_triangle(m, isovalue, vids, func, {3,2,0}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {5,3,0}, e2v_map, verts, tris, norms); break; }
-            case C_0110 : { make_triangle(m, isovalue, vids, func, {2,3,0}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {3,5,0}, e2v_map, verts, tris, norms); break; }
-            default : break;
+            uint i = m.poly_vert_offset(pid, m.edge_vert_id(eid,0));
+            uint j = m.poly_vert_offset(pid, m.edge_vert_id(eid,1));
+            eids[i][j] = eids[j][i] = eid;
         }
-    }
-}
-
-//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-
-template<class M, class V, class E, class F, class P>
-CINO_INLINE
-void make_triangle(const Tetmesh<M,V,E,F,P> & m,
-                   const double               isovalue,
-                   const uint                 vids[],
-                   const double               func[],
-                   const std::array<uint,3> & e,
-                   std::map<ipair,uint>     & e2v_map,
-                   std::vector<vec3d>       & verts,
-                   std::vector<uint>        & tris,
-                   std::vector<vec3d>       & norms)
-{
-    assert(isovalue >= *std::min_element(func, func+4));
-    assert(isovalue <= *std::max_element(func, func+4));
-
-    vec3d tri_verts[3];
-    uint  fresh_vid = uint(verts.size());
-
-    for(uint i=0; i<3; ++i)
-    {
-        uint v_a = vids[TET_EDGES[e[i]][0]];
-        uint v_b = vids[TET_EDGES[e[i]][1]];
-
-        // avoid duplicated vertices. If an edge has already
-        // been visited retrieve its id and coordinates
-        //
-        ipair pair  = unique_pair(v_a, v_b);
-        auto  query = e2v_map.find(pair);
+        int sign = (orient3d(m.vert(vids[0]), m.vert(vids[1]), m.vert(vids[2]), m.vert(vids[3]))>0) ? 1 : -1;
 
-        if (query != e2v_map.end())
+        for(uint s=beg; s<end; ++s)
         {
-            uint vid = query->second;
-            tri_verts[i] = vec3d(verts.at(vid));
-            tris.push_back(vid);
-        }
-        else
-        {
-            double f_a = func[TET_EDGES[e[i]][0]];
-            double f_b = func[TET_EDGES[e[i]][1]];
-
-            if (f_a < f_b)
+            uint below = 0, n_below = 0;
+            for(uint i=0; i<4; ++i)
             {
-                std::swap(v_a, v_b);
-                std::swap(f_a, f_b);
+                if(func[i]<iso.at(s))
+                {
+                    below |= 1u << i;
+                    ++n_below;
+                }
             }
+            // level set vertex along the edge between the i-th (below) and j-th (above) vertex
+            auto vert = [&](const uint i, const uint j) { return iso_vert(eids[i][j], vids[j], s); };
 
-            double alpha = (isovalue - f_a) / (f_b - f_a);
-
-            tri_verts[i] = (1.0 - alpha) * m.vert(v_a) + alpha * m.vert(v_b);
-
-            verts.push_back(tri_verts[i]);
+            if(n_below==1 || n_below==3)
+            {
+                uint lone_mask = (n_below==1) ? below : (~below & 0xF);
+                uint i = 0;
+                while(!(lone_mask & (1u<<i))) ++i;
+                uint o[3], n = 0;
+                for(uint j=0; j<4; ++j) if(j!=i) o[n++] = j;
+                uint t[3];
+                for(uint k=0; k<3; ++k) t[k] = (n_below==1) ? vert(i,o[k]) : vert(o[k],i);
+                // triangle normal points away from i iff sign*LONE_PARITY[i] is positive
+                if(sign*LONE_PARITY[i] != ((n_below==1) ? 1 : -1)) std::swap(t[1],t[2]);
+                if(t[0]==t[1] || t[1]==t[2] || t[0]==t[2]) continue;
+
+                // the triangle is the face opposite to i. If the tet on the other side of the face
+                // generates it too (with opposite orientation) the level set is locally a double
+                // sheet of zero thickness, and both copies are discarded
+                if(n_below==1 && func[o[0]]==iso.at(s) && func[o[1]]==iso.at(s) && func[o[2]]==iso.at(s))
+                {
+                    uint fid = m.poly_face_opposite_to(pid, vids[i]);
+                    int  nbr = m.poly_adj_through_face(pid, fid);
+                    if(nbr>=0 && f(m.poly_vert_opposite_to(uint(nbr), fid))<iso.at(s)) continue;
+                }
+                emit(t,s);
+            }
+            else
+            {
+                uint lo[2], hi[2], n_lo = 0, n_hi = 0;
+                for(uint j=0; j<4; ++j)
+                {
+                    if(below & (1u<<j)) lo[n_lo++] = j;
+                    else                hi[n_hi++] = j;
+                }
+                uint q[4] = { vert(lo[0],hi[0]), vert(lo[0],hi[1]), vert(lo[1],hi[1]), vert(lo[1],hi[0]) };
+                if(sign*QUAD_PARITY[below] != -1) std::swap(q[1],q[3]);
+
+                // drop the vertices collapsed onto the same mesh vertex
+                uint r[4], n = 0;
+                for(uint k=0; k<4; ++k) if(q[k]!=q[(k+1)%4]) r[n++] = q[k];
+                if(n>=3)
+                {
+                    uint t0[3] = { r[0], r[1], r[2] };
+                    if(t0[0]!=t0[2]) emit(t0,s);
+                }
+                if(n==4)
+                {
+                    uint t1[3] = { r[0], r[2], r[3] };
+                    emit(t1,s);
+                }
+            }
+        }
+    };
 
-            tris.push_back(fresh_vid);
-            e2v_map[pair] = fresh_vid++;
+    // count, then generate the triangles
+    std::vector<uint> tri_offset(m.num_polys()+1, 0);
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+    {
+        uint count = 0;
+        tet_triangles(pid, [&](const uint *, const uint){ ++count; });
+        tri_offset.at(pid) = count;
+    });
+    uint n_tris = PARALLEL_PREFIX_SUM(tri_offset, 100000);
+
+    tris.resize(3*n_tris);
+    norms.resize(n_tris);
+    tri_iso.resize(n_tris);
+    PARALLEL_FOR(0, m.num_polys(), 1000, [&](uint pid)
+    {
+        uint tid = tri_offset.at(pid);
+        tet_triangles(pid, [&](const uint t[3], const uint s)
+        {
+            tris.at(3*tid+0) = t[0];
+            tris.at(3*tid+1) = t[1];
+            tris.at(3*tid+2) = t[2];
+            vec3d n = (verts.at(t[1]) - verts.at(t[0])).cross(verts.at(t[2]) - verts.at(t[0]));
+            n.normalize();
+            norms.at(tid)   = n;
+            tri_iso.at(tid) = order.at(s);
+            ++tid;
+        });
+    });
+
+    // in rare degenerate configurations all the triangles incident to
+    // a collapsed vertex may have been discarded: remove such vertices
+    std::vector<uint> v_map(n_verts, 0);
+    for(uint vid : tris) v_map.at(vid) = 1;
+    uint n_used = PARALLEL_PREFIX_SUM(v_map, 100000);
+    if(n_used<n_verts)
+    {
+        std::vector<vec3d> tmp(n_used);
+        for(uint vid=0; vid<n_verts; ++vid)
+        {
+            if(vid+1<n_verts ? v_map.at(vid)<v_map.at(vid+1) : v_map.at(vid)<n_used) tmp.at(v_map.at(vid)) = verts.at(vid);
         }
+        for(uint & vid : tris) vid = v_map.at(vid);
+        verts.swap(tmp);
     }
-
-    vec3d u  = tri_verts[1] - tri_verts[0]; u.normalize();
-    vec3d w  = tri_verts[2] - tri_verts[0]; w.normalize();
-    vec3d n = u.cross(w);
-    n.normalize();
-    norms.push_back(n);
 }
 
 }
@@ -37,7 +37,6 @@
 #define CINO_MARCHING_TETS_H
 
 #include <vector>
-#include <map>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
 #include <cinolib/ipair.h>
@@ -46,6 +45,18 @@
 namespace cinolib
 {
 
+/* Marching tetrahedra extraction of the level sets of the scalar field stored in the
+ * first component of the vertex uvw coordinates. Triangles are oriented towards increasing
+ * values of the field, and vertices are shared by all the triangles incident to them.
+ *
+ * Tets are processed in parallel: a first pass counts the triangles generated by each tet,
+ * and a prefix sum on the counts gives each tet the position of its output. Level set
+ * vertices are indexed by mesh edge, hence no search structure is needed to weld them.
+ * Vertices whose value coincides with an isovalue are treated as if they were slightly
+ * above it. Level set vertices falling exactly on them are collapsed into one, and the
+ * triangles that degenerate as a result are discarded.
+*/
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void marching_tets(const Tetmesh<M,V,E,F,P> & m,
@@ -53,6 +64,20 @@ void marching_tets(const Tetmesh<M,V,E,F,P> & m,
                    std::vector<vec3d>       & verts,
                    std::vector<uint>        & tris,
                    std::vector<vec3d>       & norms);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Extracts the level sets of multiple isovalues in one pass over the tets.
+// Each output triangle is labeled with the index of its isovalue in tri_iso
+//
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void marching_tets(const Tetmesh<M,V,E,F,P> & m,
+                   const std::vector<double>& isovalues,
+                   std::vector<vec3d>       & verts,
+                   std::vector<uint>        & tris,
+                   std::vector<vec3d>       & norms,
+                   std::vector<uint>        & tri_iso);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -38,6 +38,8 @@
 #include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/gl/load_texture.h>
 #include <cinolib/color.h>
+#include <cinolib/how_many_seconds.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -49,6 +51,7 @@ CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::init_drawable_stuff()
 {
     drawlist.draw_mode        = DRAW_TRIS | DRAW_TRI_SMOOTH | DRAW_TRI_FACECOLOR | DRAW_SEGS;
+    drawlist.use_vbo          = true;
     drawlist_marked.draw_mode = DRAW_TRIS | DRAW_SEGS;
     drawlist_marked.seg_width = 3;
     marked_edge_color         = Color::RED();
@@ -58,6 +61,17 @@ void AbstractDrawablePolygonMesh<Mesh>::init_drawable_stuff()
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::clear()
+{
+    Mesh::clear();
+    vbo_release(drawlist.vbo);
+    vbo_release(drawlist_marked.vbo);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::draw(const float) const
@@ -86,48 +100,17 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::updateGL_marked()
 {
-    drawlist_marked.segs.clear();
-    drawlist_marked.seg_coords.clear();
-    drawlist_marked.seg_colors.clear();
-
-    for(uint eid=0; eid<this->num_edges(); ++eid)
+    // locate the segment of each visible marked edge in the render data
+    marked_seg_beg.resize(this->num_edges()+1);
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid)
     {
-        if(!this->edge_data(eid).flags[MARKED]) continue;
+        marked_seg_beg[eid] = this->edge_data(eid).flags[MARKED] ? edge_num_segs(eid) : 0;
+    });
+    marked_seg_beg.back() = 0;
+    uint n_segs = PARALLEL_PREFIX_SUM(marked_seg_beg, 1000);
 
-        bool hidden = true;
-        for(uint pid : this->adj_e2p(eid))
-        {
-            if(!this->poly_data(pid).flags[HIDDEN])
-            {
-                hidden = false;
-                break;
-            }
-        }
-        if(hidden) continue;
-
-        vec3d vid0 = this->edge_vert(eid,0);
-        vec3d vid1 = this->edge_vert(eid,1);
-
-        uint base_addr = uint(drawlist_marked.seg_coords.size()/3);
-        drawlist_marked.segs.push_back(base_addr    );
-        drawlist_marked.segs.push_back(base_addr + 1);
-
-        drawlist_marked.seg_coords.push_back(float(vid0.x()));
-        drawlist_marked.seg_coords.push_back(float(vid0.y()));
-        drawlist_marked.seg_coords.push_back(float(vid0.z()));
-        drawlist_marked.seg_coords.push_back(float(vid1.x()));
-        drawlist_marked.seg_coords.push_back(float(vid1.y()));
-        drawlist_marked.seg_coords.push_back(float(vid1.z()));
-
-        drawlist_marked.seg_colors.push_back(marked_edge_color.r);
-        drawlist_marked.seg_colors.push_back(marked_edge_color.g);
-        drawlist_marked.seg_colors.push_back(marked_edge_color.b);
-        drawlist_marked.seg_colors.push_back(marked_edge_color.a);
-        drawlist_marked.seg_colors.push_back(marked_edge_color.r);
-        drawlist_marked.seg_colors.push_back(marked_edge_color.g);
-        drawlist_marked.seg_colors.push_back(marked_edge_color.b);
-        drawlist_marked.seg_colors.push_back(marked_edge_color.a);
-    }
+    drawlist_marked.resize(0, n_segs);
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid) { fill_marked_edge_render_data(eid); });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -136,6 +119,8 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
 {
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
     drawlist.material = material_;
     drawlist.tri_coords.clear();
     drawlist.tris.clear();
@@ -145,206 +130,398 @@ void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
     drawlist.segs.clear();
     drawlist.seg_coords.clear();
     drawlist.seg_colors.clear();
+    drawlist.tag_all_dirty();
+
+    dirty_verts.clear();
+    dirty_edges.clear();
+    dirty_polys.clear();
+    gl_num_verts = this->num_verts();
+    gl_num_edges = this->num_edges();
+    gl_num_polys = this->num_polys();
+    gl_draw_mode = drawlist.draw_mode;
+    gl_layout_dirty = false;
 
     if(this->num_polys() == 0) // for point clouds
     {
-        drawlist.tri_coords.reserve(this->num_verts()*3);
-        drawlist.tri_v_colors.reserve(this->num_verts()*4);
-        for(uint vid=0; vid<this->num_verts(); ++vid)
-        {
-            drawlist.tri_coords.push_back(float(this->vert(vid).x()));
-            drawlist.tri_coords.push_back(float(this->vert(vid).y()));
-            drawlist.tri_coords.push_back(float(this->vert(vid).z()));
-
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.r);
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.g);
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.b);
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.a);
-        }
+        drawlist.tri_coords.resize(this->num_verts()*3);
+        drawlist.tri_v_colors.resize(this->num_verts()*4);
+        PARALLEL_FOR(0, this->num_verts(), 1000, [&](uint vid) { fill_vert_render_data(vid); });
+    }
+    else
+    {
+        // locate the triangles of each polygon and the segment of each
+        // edge in the render data (hidden elements are not rendered)
+        poly_tri_beg.resize(this->num_polys()+1);
+        PARALLEL_FOR(0, this->num_polys(), 1000, [&](uint pid) { poly_tri_beg[pid] = poly_num_tris(pid); });
+        poly_tri_beg.back() = 0;
+        uint n_tris = PARALLEL_PREFIX_SUM(poly_tri_beg, 1000);
+
+        edge_seg_beg.resize(this->num_edges()+1);
+        PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid) { edge_seg_beg[eid] = edge_num_segs(eid); });
+        edge_seg_beg.back() = 0;
+        uint n_segs = PARALLEL_PREFIX_SUM(edge_seg_beg, 1000);
+
+        drawlist.resize(n_tris, n_segs);
+        tri_AO.resize(3*n_tris);
+
+        PARALLEL_FOR(0, this->num_polys(), 1000, [&](uint pid) { fill_poly_render_data(pid); });
+        PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid) { fill_edge_render_data(eid); });
+    }
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    gl_update_time = how_many_seconds(t0,t1);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::updateGL_dirty()
+{
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    // polys flagged as dirty may have been hidden/unhidden by direct access to their flags
+    bool valid = render_data_is_valid();
+    for(auto it=dirty_polys.begin(); valid && it!=dirty_polys.end(); ++it)
+    {
+        uint pid = *it;
+        if(pid>=this->num_polys() || poly_num_tris(pid)!=poly_tri_beg.at(pid+1)-poly_tri_beg.at(pid)) valid = false;
+    }
+
+    if(!valid)
+    {
+        updateGL();
+    }
+    else if(this->num_polys() == 0) // for point clouds
+    {
+        for(uint vid : dirty_verts) fill_vert_render_data(vid);
+        drawlist.tag_all_dirty();
     }
     else
     {
-        for(uint pid=0; pid<this->num_polys(); ++pid)
+        // moving a vertex changes the normals of its incident polygons,
+        // which in turn affect (smooth) normals and AO at all their corners
+        std::unordered_set<uint> polys_to_fill;
+        auto add_poly_and_neighbors = [&](const uint pid)
+        {
+            for(uint vid : this->adj_p2v(pid))
+            for(uint nbr : this->adj_v2p(vid))
+            {
+                polys_to_fill.insert(nbr);
+            }
+        };
+        for(uint pid : dirty_polys) add_poly_and_neighbors(pid);
+        for(uint vid : dirty_verts)
         {
-            if (this->poly_data(pid).flags[HIDDEN]) continue;
+            for(uint pid : this->adj_v2p(vid)) add_poly_and_neighbors(pid);
+            for(uint eid : this->adj_v2e(vid)) dirty_edges.insert(eid);
+        }
 
-            vec3d n = this->poly_data(pid).normal;
+        for(uint pid : polys_to_fill)
+        {
+            fill_poly_render_data(pid);
+            drawlist.tag_tris_dirty(poly_tri_beg.at(pid), poly_tri_beg.at(pid+1));
+        }
+
+        // marked edges are refreshed in place, unless some of them got marked/unmarked
+        bool marked_changed = (marked_seg_beg.size() != this->num_edges()+1);
+        for(uint eid : dirty_edges)
+        {
+            fill_edge_render_data(eid);
+            drawlist.tag_segs_dirty(edge_seg_beg.at(eid), edge_seg_beg.at(eid+1));
 
-            for(uint i=0; i<this->poly_tessellation(pid).size()/3; ++i)
+            if(marked_changed) continue;
+            uint n_segs = this->edge_data(eid).flags[MARKED] ? edge_num_segs(eid) : 0;
+            if(n_segs != marked_seg_beg.at(eid+1) - marked_seg_beg.at(eid)) marked_changed = true;
+            else if(n_segs>0)
             {
-                uint vid0 = this->poly_tessellation(pid).at(3*i+0);
-                uint vid1 = this->poly_tessellation(pid).at(3*i+1);
-                uint vid2 = this->poly_tessellation(pid).at(3*i+2);
-
-                // average AO with adjacent visible faces having dihedral angle lower than 60 degrees
-                auto  vid0_vis_pids = this->vert_adj_visible_polys(vid0, n, 60.0);
-                auto  vid1_vis_pids = this->vert_adj_visible_polys(vid1, n, 60.0);
-                auto  vid2_vis_pids = this->vert_adj_visible_polys(vid2, n, 60.0);
-                float AO_vid0 = 0.f;
-                float AO_vid1 = 0.f;
-                float AO_vid2 = 0.f;
-                for(uint pid : vid0_vis_pids) AO_vid0 += this->poly_data(pid).AO*AO_alpha + (1.f - AO_alpha);
-                for(uint pid : vid1_vis_pids) AO_vid1 += this->poly_data(pid).AO*AO_alpha + (1.f - AO_alpha);
-                for(uint pid : vid2_vis_pids) AO_vid2 += this->poly_data(pid).AO*AO_alpha + (1.f - AO_alpha);
-                AO_vid0 /= static_cast<float>(vid0_vis_pids.size());
-                AO_vid1 /= static_cast<float>(vid1_vis_pids.size());
-                AO_vid2 /= static_cast<float>(vid2_vis_pids.size());
-
-                uint base_addr = uint(drawlist.tri_coords.size()/3);
-
-                drawlist.tris.push_back(base_addr    );
-                drawlist.tris.push_back(base_addr + 1);
-                drawlist.tris.push_back(base_addr + 2);
-
-                drawlist.tri_coords.push_back(float(this->vert(vid0).x()));
-                drawlist.tri_coords.push_back(float(this->vert(vid0).y()));
-                drawlist.tri_coords.push_back(float(this->vert(vid0).z()));
-                drawlist.tri_coords.push_back(float(this->vert(vid1).x()));
-                drawlist.tri_coords.push_back(float(this->vert(vid1).y()));
-                drawlist.tri_coords.push_back(float(this->vert(vid1).z()));
-                drawlist.tri_coords.push_back(float(this->vert(vid2).x()));
-                drawlist.tri_coords.push_back(float(this->vert(vid2).y()));
-                drawlist.tri_coords.push_back(float(this->vert(vid2).z()));
-
-                if (drawlist.draw_mode & DRAW_TRI_SMOOTH)
-                {
-                    // average normals with adjacent visible faces having dihedral angle lower than 60 degrees
-                    vec3d n_vid0(0,0,0);
-                    vec3d n_vid1(0,0,0);
-                    vec3d n_vid2(0,0,0);
-                    for(uint pid : vid0_vis_pids) n_vid0 += this->poly_data(pid).normal;
-                    for(uint pid : vid1_vis_pids) n_vid1 += this->poly_data(pid).normal;
-                    for(uint pid : vid2_vis_pids) n_vid2 += this->poly_data(pid).normal;
-                    n_vid0 /= static_cast<double>(vid0_vis_pids.size());
-                    n_vid1 /= static_cast<double>(vid1_vis_pids.size());
-                    n_vid2 /= static_cast<double>(vid2_vis_pids.size());
-
-                    drawlist.tri_v_norms.push_back(float(n_vid0.x()));
-                    drawlist.tri_v_norms.push_back(float(n_vid0.y()));
-                    drawlist.tri_v_norms.push_back(float(n_vid0.z()));
-                    drawlist.tri_v_norms.push_back(float(n_vid1.x()));
-                    drawlist.tri_v_norms.push_back(float(n_vid1.y()));
-                    drawlist.tri_v_norms.push_back(float(n_vid1.z()));
-                    drawlist.tri_v_norms.push_back(float(n_vid2.x()));
-                    drawlist.tri_v_norms.push_back(float(n_vid2.y()));
-                    drawlist.tri_v_norms.push_back(float(n_vid2.z()));
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_FLAT)
-                {
-                    drawlist.tri_v_norms.push_back(float(n.x()));
-                    drawlist.tri_v_norms.push_back(float(n.y()));
-                    drawlist.tri_v_norms.push_back(float(n.z()));
-                    drawlist.tri_v_norms.push_back(float(n.x()));
-                    drawlist.tri_v_norms.push_back(float(n.y()));
-                    drawlist.tri_v_norms.push_back(float(n.z()));
-                    drawlist.tri_v_norms.push_back(float(n.x()));
-                    drawlist.tri_v_norms.push_back(float(n.y()));
-                    drawlist.tri_v_norms.push_back(float(n.z()));
-                }
-
-                if (drawlist.draw_mode & DRAW_TRI_TEXTURE1D)
-                {
-                    drawlist.tri_text.push_back(float(this->vert_data(vid0).uvw[0]));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid1).uvw[0]));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid2).uvw[0]));
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_TEXTURE2D)
-                {
-                    drawlist.tri_text.push_back(float(this->vert_data(vid0).uvw[0]*drawlist.texture.scaling_factor));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid0).uvw[1]*drawlist.texture.scaling_factor));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid1).uvw[0]*drawlist.texture.scaling_factor));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid1).uvw[1]*drawlist.texture.scaling_factor));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid2).uvw[0]*drawlist.texture.scaling_factor));
-                    drawlist.tri_text.push_back(float(this->vert_data(vid2).uvw[1]*drawlist.texture.scaling_factor));
-                }
-
-                if (drawlist.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
-                {
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.r*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.g*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.b*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.a);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.r*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.g*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.b*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.a);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.r*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.g*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.b*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.a);
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_VERTCOLOR)
-                {
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.r*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.g*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.b*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.a);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.r*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.g*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.b*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.a);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.r*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.g*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.b*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.a);
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_QUALITY)
-                {
-                    float q = this->poly_data(pid).quality;
-                    Color c = Color::red_white_blue_ramp_01(q);
-                    drawlist.tri_v_colors.push_back(c.r*AO_vid0);
-                    drawlist.tri_v_colors.push_back(c.g*AO_vid0);
-                    drawlist.tri_v_colors.push_back(c.b*AO_vid0);
-                    drawlist.tri_v_colors.push_back(c.a);
-                    drawlist.tri_v_colors.push_back(c.r*AO_vid1);
-                    drawlist.tri_v_colors.push_back(c.g*AO_vid1);
-                    drawlist.tri_v_colors.push_back(c.b*AO_vid1);
-                    drawlist.tri_v_colors.push_back(c.a);
-                    drawlist.tri_v_colors.push_back(c.r*AO_vid2);
-                    drawlist.tri_v_colors.push_back(c.g*AO_vid2);
-                    drawlist.tri_v_colors.push_back(c.b*AO_vid2);
-                    drawlist.tri_v_colors.push_back(c.a);
-                }
+                fill_marked_edge_render_data(eid);
+                drawlist_marked.tag_segs_dirty(marked_seg_beg.at(eid), marked_seg_beg.at(eid+1));
             }
         }
+        if(marked_changed) updateGL_marked();
+    }
+
+    dirty_verts.clear();
+    dirty_edges.clear();
+    dirty_polys.clear();
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    gl_update_time = how_many_seconds(t0,t1);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::updateGL_colors()
+{
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    if(!render_data_is_valid())
+    {
+        updateGL();
+    }
+    else if(this->num_polys() == 0) // for point clouds
+    {
+        PARALLEL_FOR(0, this->num_verts(), 1000, [&](uint vid) { fill_vert_render_data(vid);   });
+        drawlist.tag_all_dirty();
+    }
+    else
+    {
+        PARALLEL_FOR(0, this->num_polys(), 1000, [&](uint pid) { fill_poly_render_colors(pid); });
+        PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid) { fill_edge_render_data(eid);   });
+        drawlist.tag_all_dirty();
+    }
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    gl_update_time = how_many_seconds(t0,t1);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool AbstractDrawablePolygonMesh<Mesh>::render_data_is_valid() const
+{
+    // draw modes that change the amount of data stored for each triangle
+    const int layout_bits = DRAW_TRI_FLAT      | DRAW_TRI_SMOOTH    |
+                            DRAW_TRI_FACECOLOR | DRAW_TRI_VERTCOLOR | DRAW_TRI_QUALITY |
+                            DRAW_TRI_TEXTURE1D | DRAW_TRI_TEXTURE2D;
+
+    if(gl_num_verts != this->num_verts() ||
+       gl_num_edges != this->num_edges() ||
+       gl_num_polys != this->num_polys() ||
+       (gl_draw_mode & layout_bits) != (drawlist.draw_mode & layout_bits)) return false;
+
+    if(this->num_polys() == 0) return true; // for point clouds
+
+    // hiding/unhiding or re-tessellating elements changes the layout of the
+    // render data (see updateGL), even if the number of elements is the same
+    return !gl_layout_dirty &&
+           poly_tri_beg.size() == this->num_polys()+1 &&
+           edge_seg_beg.size() == this->num_edges()+1;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// number of triangles rendered for a polygon (none if hidden)
+template<class Mesh>
+CINO_INLINE
+uint AbstractDrawablePolygonMesh<Mesh>::poly_num_tris(const uint pid) const
+{
+    return this->poly_data(pid).flags[HIDDEN] ? 0 : uint(this->poly_tessellation(pid).size()/3);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// number of segments rendered for an edge (none if all its polygons are hidden)
+template<class Mesh>
+CINO_INLINE
+uint AbstractDrawablePolygonMesh<Mesh>::edge_num_segs(const uint eid) const
+{
+    for(uint pid : this->adj_e2p(eid))
+    {
+        if(!this->poly_data(pid).flags[HIDDEN]) return 1;
+    }
+    return 0;
+}
 
-        for(uint eid=0; eid<this->num_edges(); ++eid)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::fill_vert_render_data(const uint vid)
+{
+    float *xyz  = drawlist.tri_coords.data()   + 3*vid;
+    float *rgba = drawlist.tri_v_colors.data() + 4*vid;
+    xyz[0]  = float(this->vert(vid).x());
+    xyz[1]  = float(this->vert(vid).y());
+    xyz[2]  = float(this->vert(vid).z());
+    rgba[0] = this->vert_data(vid).color.r;
+    rgba[1] = this->vert_data(vid).color.g;
+    rgba[2] = this->vert_data(vid).color.b;
+    rgba[3] = this->vert_data(vid).color.a;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::fill_poly_render_data(const uint pid)
+{
+    if(this->poly_data(pid).flags[HIDDEN]) return;
+
+    vec3d n = this->poly_data(pid).normal;
+
+    for(uint i=0; i<this->poly_tessellation(pid).size()/3; ++i)
+    {
+        uint t = poly_tri_beg.at(pid) + i;
+        uint vids[3] =
         {
-            bool hidden = true;
-            for(uint pid : this->adj_e2p(eid))
+            this->poly_tessellation(pid).at(3*i+0),
+            this->poly_tessellation(pid).at(3*i+1),
+            this->poly_tessellation(pid).at(3*i+2)
+        };
+
+        float *xyz = drawlist.tri_coords.data() + 9*t;
+        float *nor = drawlist.tri_v_norms.data() + 9*t;
+        float *tex = drawlist.tri_text.data() + drawlist.text_per_tri()*t;
+
+        for(uint j=0; j<3; ++j)
+        {
+            uint vid = vids[j];
+
+            // average AO (and normals) with adjacent visible faces having dihedral angle lower than 60 degrees
+            auto  vis_pids = this->vert_adj_visible_polys(vid, n, 60.0);
+            float AO = 0.f;
+            for(uint nbr : vis_pids) AO += this->poly_data(nbr).AO*AO_alpha + (1.f - AO_alpha);
+            AO /= static_cast<float>(vis_pids.size());
+            tri_AO.at(3*t+j) = AO;
+
+            xyz[3*j+0] = float(this->vert(vid).x());
+            xyz[3*j+1] = float(this->vert(vid).y());
+            xyz[3*j+2] = float(this->vert(vid).z());
+
+            if (drawlist.draw_mode & DRAW_TRI_SMOOTH)
             {
-                if(!this->poly_data(pid).flags[HIDDEN])
-                {
-                    hidden = false;
-                    break;
-                }
+                vec3d n_vid(0,0,0);
+                for(uint nbr : vis_pids) n_vid += this->poly_data(nbr).normal;
+                n_vid /= static_cast<double>(vis_pids.size());
+                nor[3*j+0] = float(n_vid.x());
+                nor[3*j+1] = float(n_vid.y());
+                nor[3*j+2] = float(n_vid.z());
+            }
+            else if (drawlist.draw_mode & DRAW_TRI_FLAT)
+            {
+                nor[3*j+0] = float(n.x());
+                nor[3*j+1] = float(n.y());
+                nor[3*j+2] = float(n.z());
+            }
+
+            if (drawlist.draw_mode & DRAW_TRI_TEXTURE1D)
+            {
+                tex[j] = float(this->vert_data(vid).uvw[0]);
+            }
+            else if (drawlist.draw_mode & DRAW_TRI_TEXTURE2D)
+            {
+                tex[2*j+0] = float(this->vert_data(vid).uvw[0]*drawlist.texture.scaling_factor);
+                tex[2*j+1] = float(this->vert_data(vid).uvw[1]*drawlist.texture.scaling_factor);
             }
-            if(hidden) continue;
-
-            uint base_addr = uint(drawlist.seg_coords.size()/3);
-            drawlist.segs.push_back(base_addr    );
-            drawlist.segs.push_back(base_addr + 1);
-
-            vec3d vid0 = this->edge_vert(eid,0);
-            vec3d vid1 = this->edge_vert(eid,1);
-
-            drawlist.seg_coords.push_back(float(vid0.x()));
-            drawlist.seg_coords.push_back(float(vid0.y()));
-            drawlist.seg_coords.push_back(float(vid0.z()));
-            drawlist.seg_coords.push_back(float(vid1.x()));
-            drawlist.seg_coords.push_back(float(vid1.y()));
-            drawlist.seg_coords.push_back(float(vid1.z()));
-
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.a);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.a);
         }
     }
+
+    fill_poly_render_colors(pid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::fill_poly_render_colors(const uint pid)
+{
+    if(this->poly_data(pid).flags[HIDDEN]) return;
+    if(drawlist.colors_per_tri()==0) return;
+
+    for(uint i=0; i<this->poly_tessellation(pid).size()/3; ++i)
+    {
+        uint   t    = poly_tri_beg.at(pid) + i;
+        float *rgba = drawlist.tri_v_colors.data() + 12*t;
+        for(uint j=0; j<3; ++j)
+        {
+            Color c;
+                 if (drawlist.draw_mode & DRAW_TRI_FACECOLOR) c = this->poly_data(pid).color; // replicate f color on each vertex
+            else if (drawlist.draw_mode & DRAW_TRI_VERTCOLOR) c = this->vert_data(this->poly_tessellation(pid).at(3*i+j)).color;
+            else if (drawlist.draw_mode & DRAW_TRI_QUALITY)   c = Color::red_white_blue_ramp_01(this->poly_data(pid).quality);
+
+            float AO = tri_AO.at(3*t+j);
+            rgba[4*j+0] = c.r*AO;
+            rgba[4*j+1] = c.g*AO;
+            rgba[4*j+2] = c.b*AO;
+            rgba[4*j+3] = c.a;
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::fill_edge_render_data(const uint eid)
+{
+    if(edge_seg_beg.at(eid+1) == edge_seg_beg.at(eid)) return; // hidden edge
+
+    uint sid = edge_seg_beg.at(eid);
+
+    vec3d  vid0 = this->edge_vert(eid,0);
+    vec3d  vid1 = this->edge_vert(eid,1);
+    float *xyz  = drawlist.seg_coords.data() + 6*sid;
+    float *rgba = drawlist.seg_colors.data() + 8*sid;
+
+    xyz[0] = float(vid0.x());
+    xyz[1] = float(vid0.y());
+    xyz[2] = float(vid0.z());
+    xyz[3] = float(vid1.x());
+    xyz[4] = float(vid1.y());
+    xyz[5] = float(vid1.z());
+
+    const Color & c = this->edge_data(eid).color;
+    rgba[0] = c.r; rgba[1] = c.g; rgba[2] = c.b; rgba[3] = c.a;
+    rgba[4] = c.r; rgba[5] = c.g; rgba[6] = c.b; rgba[7] = c.a;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::fill_marked_edge_render_data(const uint eid)
+{
+    if(marked_seg_beg.at(eid+1) == marked_seg_beg.at(eid)) return; // not marked, or hidden
+
+    uint sid = marked_seg_beg.at(eid);
+
+    vec3d  vid0 = this->edge_vert(eid,0);
+    vec3d  vid1 = this->edge_vert(eid,1);
+    float *xyz  = drawlist_marked.seg_coords.data() + 6*sid;
+    float *rgba = drawlist_marked.seg_colors.data() + 8*sid;
+
+    xyz[0] = float(vid0.x());
+    xyz[1] = float(vid0.y());
+    xyz[2] = float(vid0.z());
+    xyz[3] = float(vid1.x());
+    xyz[4] = float(vid1.y());
+    xyz[5] = float(vid1.z());
+
+    const Color & c = marked_edge_color;
+    rgba[0] = c.r; rgba[1] = c.g; rgba[2] = c.b; rgba[3] = c.a;
+    rgba[4] = c.r; rgba[5] = c.g; rgba[6] = c.b; rgba[7] = c.a;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::vert_set_dirty(const uint vid)
+{
+    dirty_verts.insert(vid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::edge_set_dirty(const uint eid)
+{
+    dirty_edges.insert(eid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::poly_set_dirty(const uint pid)
+{
+    dirty_polys.insert(pid);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -496,7 +673,6 @@ CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::show_wireframe_color(const Color & c)
 {
     this->edge_set_color(c); // NOTE: this will change alpha for ANY adge (both interior and boundary)
-    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -515,7 +691,6 @@ CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::show_wireframe_transparency(const float alpha)
 {
     this->edge_set_alpha(alpha); // NOTE: this will change alpha for ANY adge (both interior and boundary)
-    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -41,6 +41,7 @@
 #include <cinolib/meshes/mesh_slicer.h>
 #include <cinolib/drawable_object.h>
 #include <cinolib/gl/draw_lines_tris.h>
+#include <unordered_set>
 
 namespace cinolib
 {
@@ -74,22 +75,46 @@ class AbstractDrawablePolygonMesh : public virtual Mesh, public DrawableObject
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void vert_set_color(const Color & c) { Mesh::vert_set_color(c); updateGL(); }
-        void edge_set_color(const Color & c) { Mesh::edge_set_color(c); updateGL(); }
-        void poly_set_color(const Color & c) { Mesh::poly_set_color(c); updateGL(); }
-        void vert_set_alpha(const float   a) { Mesh::vert_set_alpha(a); updateGL(); }
-        void edge_set_alpha(const float   a) { Mesh::edge_set_alpha(a); updateGL(); }
-        void poly_set_alpha(const float   a) { Mesh::poly_set_alpha(a); updateGL(); }
+        void vert_set_color(const Color & c) { Mesh::vert_set_color(c); updateGL_colors(); }
+        void edge_set_color(const Color & c) { Mesh::edge_set_color(c); updateGL_colors(); }
+        void poly_set_color(const Color & c) { Mesh::poly_set_color(c); updateGL_colors(); }
+        void vert_set_alpha(const float   a) { Mesh::vert_set_alpha(a); updateGL_colors(); }
+        void edge_set_alpha(const float   a) { Mesh::edge_set_alpha(a); updateGL_colors(); }
+        void poly_set_alpha(const float   a) { Mesh::poly_set_alpha(a); updateGL_colors(); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // hiding polygons or changing their tessellation alters the layout of the render data
+        void poly_set_flag(const int flag, const bool b)                                { Mesh::poly_set_flag(flag,b);      if(flag==HIDDEN) gl_layout_dirty = true; }
+        void poly_set_flag(const int flag, const bool b, const std::vector<uint> & pids) { Mesh::poly_set_flag(flag,b,pids); if(flag==HIDDEN) gl_layout_dirty = true; }
+        void update_p_tessellation(const uint pid) { Mesh::update_p_tessellation(pid); gl_layout_dirty = true; }
+        void update_p_tessellations()              { Mesh::update_p_tessellations();   gl_layout_dirty = true; }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void init_drawable_stuff();
 
+        // also releases the GPU buffers of the render data (e.g. when a new mesh is loaded)
+        void clear() override;
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void updateGL();        // regenerates rendering data for both mesh and marked elements
-        void updateGL_mesh();   // regenerates rendering data for mesh elements
-        void updateGL_marked(); // regenerates rendering data for marked mesh elements
+        void   updateGL();              // regenerates rendering data for both mesh and marked elements
+        void   updateGL_mesh();         // regenerates rendering data for mesh elements
+        void   updateGL_marked();       // regenerates rendering data for marked mesh elements
+        void   updateGL_dirty();        // updates rendering data only for elements flagged as dirty (see below)
+        void   updateGL_colors();       // updates colors only, leaving geometry, normals and textures untouched
+        double updateGL_time() const { return gl_update_time; } // seconds spent by the last update
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // flag elements whose attributes (position, color, uvw, flags...) changed since the last
+        // updateGL. Calling updateGL_dirty() will only refresh the render data they affect.
+        // If the connectivity, the draw mode or the set of rendered elements changed (e.g.
+        // through poly_set_flag(HIDDEN,...) or on a dirty poly), a full update is performed instead
+        void vert_set_dirty(const uint vid);
+        void edge_set_dirty(const uint eid);
+        void poly_set_dirty(const uint pid);
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -115,6 +140,32 @@ class AbstractDrawablePolygonMesh : public virtual Mesh, public DrawableObject
         void show_marked_edge_color(const Color & c);
         void show_marked_edge_width(const float width);
         void show_marked_edge_transparency(const float alpha);
+
+    protected:
+
+        // layout of the render data, used to update it incrementally
+        std::vector<uint>        poly_tri_beg;   // first triangle of each poly (CSR style, hidden polys have none)
+        std::vector<uint>        edge_seg_beg;   // segment of each edge (CSR style, hidden edges have none)
+        std::vector<uint>        marked_seg_beg; // segment of each edge in drawlist_marked (CSR style, only visible marked edges have one)
+        std::vector<float>       tri_AO;         // ambient occlusion at each triangle corner
+        uint                     gl_num_verts = 0;
+        uint                     gl_num_edges = 0;
+        uint                     gl_num_polys = 0;
+        int                      gl_draw_mode = 0;
+        bool                     gl_layout_dirty = true; // polys were hidden/unhidden or re-tessellated since the last updateGL
+        double                   gl_update_time = 0;
+        std::unordered_set<uint> dirty_verts;
+        std::unordered_set<uint> dirty_edges;
+        std::unordered_set<uint> dirty_polys;
+
+        bool render_data_is_valid() const;
+        uint poly_num_tris(const uint pid) const;
+        uint edge_num_segs(const uint eid) const;
+        void fill_vert_render_data(const uint vid);
+        void fill_poly_render_data(const uint pid);
+        void fill_poly_render_colors(const uint pid);
+        void fill_edge_render_data(const uint eid);
+        void fill_marked_edge_render_data(const uint eid);
 };
 
 }
@@ -38,7 +38,7 @@
 #include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/gl/load_texture.h>
 #include <cinolib/color.h>
-#include <unordered_set>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -49,6 +49,8 @@ void AbstractDrawablePolyhedralMesh<Mesh>::init_drawable_stuff()
 {
     drawlist_in.draw_mode     = DRAW_TRIS | DRAW_TRI_SMOOTH | DRAW_TRI_FACECOLOR | DRAW_SEGS;
     drawlist_out.draw_mode    = DRAW_TRIS | DRAW_TRI_SMOOTH | DRAW_TRI_FACECOLOR | DRAW_SEGS;
+    drawlist_in.use_vbo       = true;
+    drawlist_out.use_vbo      = true;
     drawlist_marked.draw_mode = DRAW_TRIS | DRAW_SEGS;
     drawlist_marked.seg_width = 3;
     marked_edge_color         = Color::RED();
@@ -60,6 +62,18 @@ void AbstractDrawablePolyhedralMesh<Mesh>::init_drawable_stuff()
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::clear()
+{
+    Mesh::clear();
+    vbo_release(drawlist_in.vbo);
+    vbo_release(drawlist_out.vbo);
+    vbo_release(drawlist_marked.vbo);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolyhedralMesh<Mesh>::draw(const float) const
@@ -194,196 +208,61 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_out()
     drawlist_out.seg_coords.clear();
     drawlist_out.seg_colors.clear();
 
-    for(uint fid=0; fid<this->num_faces(); ++fid)
+    // count triangles and segments to be rendered, and locate
+    // them in the render data with a (parallel) prefix sum
+    std::vector<uint> face_tri_beg(this->num_faces()+1, 0);
+    std::vector<uint> pid_beneath(this->num_faces());
+    PARALLEL_FOR(0, this->num_faces(), 1000, [&](uint fid)
     {
-        if (!this->face_is_on_srf(fid)) continue;
-
-        uint pid_beneath;
-        if(!this->face_is_visible(fid,pid_beneath)) continue;
-
-        bool is_CW = this->poly_face_is_CW(pid_beneath, fid);
-        vec3d n = this->poly_face_normal(pid_beneath, fid);
+        if(this->face_is_on_srf(fid) && this->face_is_visible(fid, pid_beneath[fid]))
+        {
+            face_tri_beg[fid] = uint(this->face_tessellation(fid).size()/3);
+        }
+    });
+    uint n_tris = PARALLEL_PREFIX_SUM(face_tri_beg, 1000);
 
-        for(uint i=0; i<this->face_tessellation(fid).size()/3; ++i)
+    std::vector<uint> edge_seg_beg(this->num_edges()+1, 0);
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid)
+    {
+        if(!this->edge_is_on_srf(eid)) return;
+        for(uint pid : this->adj_e2p(eid))
         {
-            uint vid0 = this->face_tessellation(fid).at(3*i+0);
-            uint vid1 = this->face_tessellation(fid).at(3*i+1);
-            uint vid2 = this->face_tessellation(fid).at(3*i+2);
-            if(is_CW) std::swap(vid1,vid2); // flip triangle orientation
-
-            // average AO with adjacent visible faces having dihedral angle lower than 60 degrees
-            auto  vid0_vis_fids = this->vert_adj_visible_faces(vid0, n, 60.0);
-            auto  vid1_vis_fids = this->vert_adj_visible_faces(vid1, n, 60.0);
-            auto  vid2_vis_fids = this->vert_adj_visible_faces(vid2, n, 60.0);
-            float AO_vid0 = 0.f;
-            float AO_vid1 = 0.f;
-            float AO_vid2 = 0.f;
-            for(auto fp : vid0_vis_fids) AO_vid0 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
-            for(auto fp : vid1_vis_fids) AO_vid1 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
-            for(auto fp : vid2_vis_fids) AO_vid2 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
-            AO_vid0 /= static_cast<float>(vid0_vis_fids.size());
-            AO_vid1 /= static_cast<float>(vid1_vis_fids.size());
-            AO_vid2 /= static_cast<float>(vid2_vis_fids.size());
-
-            uint base_addr = uint(drawlist_out.tri_coords.size()/3);
-
-            drawlist_out.tris.push_back(base_addr    );
-            drawlist_out.tris.push_back(base_addr + 1);
-            drawlist_out.tris.push_back(base_addr + 2);
-
-            drawlist_out.tri_coords.push_back(float(this->vert(vid0).x()));
-            drawlist_out.tri_coords.push_back(float(this->vert(vid0).y()));
-            drawlist_out.tri_coords.push_back(float(this->vert(vid0).z()));
-            drawlist_out.tri_coords.push_back(float(this->vert(vid1).x()));
-            drawlist_out.tri_coords.push_back(float(this->vert(vid1).y()));
-            drawlist_out.tri_coords.push_back(float(this->vert(vid1).z()));
-            drawlist_out.tri_coords.push_back(float(this->vert(vid2).x()));
-            drawlist_out.tri_coords.push_back(float(this->vert(vid2).y()));
-            drawlist_out.tri_coords.push_back(float(this->vert(vid2).z()));
-
-            if (drawlist_out.draw_mode & DRAW_TRI_SMOOTH)
+            if(!this->poly_data(pid).flags[HIDDEN])
             {
-                // average normals with adjacent visible faces having dihedral angle lower than 60 degrees
-                vec3d n_vid0(0,0,0);
-                vec3d n_vid1(0,0,0);
-                vec3d n_vid2(0,0,0);
-                for(auto fp : vid0_vis_fids) n_vid0 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid1_vis_fids) n_vid1 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid2_vis_fids) n_vid2 += this->poly_face_normal(fp.second, fp.first);
-                n_vid0 /= static_cast<double>(vid0_vis_fids.size());
-                n_vid1 /= static_cast<double>(vid1_vis_fids.size());
-                n_vid2 /= static_cast<double>(vid2_vis_fids.size());
-
-                drawlist_out.tri_v_norms.push_back(float(n_vid0.x()));
-                drawlist_out.tri_v_norms.push_back(float(n_vid0.y()));
-                drawlist_out.tri_v_norms.push_back(float(n_vid0.z()));
-                drawlist_out.tri_v_norms.push_back(float(n_vid1.x()));
-                drawlist_out.tri_v_norms.push_back(float(n_vid1.y()));
-                drawlist_out.tri_v_norms.push_back(float(n_vid1.z()));
-                drawlist_out.tri_v_norms.push_back(float(n_vid2.x()));
-                drawlist_out.tri_v_norms.push_back(float(n_vid2.y()));
-                drawlist_out.tri_v_norms.push_back(float(n_vid2.z()));
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_FLAT)
-            {
-                drawlist_out.tri_v_norms.push_back(float(n.x()));
-                drawlist_out.tri_v_norms.push_back(float(n.y()));
-                drawlist_out.tri_v_norms.push_back(float(n.z()));
-                drawlist_out.tri_v_norms.push_back(float(n.x()));
-                drawlist_out.tri_v_norms.push_back(float(n.y()));
-                drawlist_out.tri_v_norms.push_back(float(n.z()));
-                drawlist_out.tri_v_norms.push_back(float(n.x()));
-                drawlist_out.tri_v_norms.push_back(float(n.y()));
-                drawlist_out.tri_v_norms.push_back(float(n.z()));
+                edge_seg_beg[eid] = 1;
+                break;
             }
+        }
+    });
+    uint n_segs = PARALLEL_PREFIX_SUM(edge_seg_beg, 1000);
 
-            if (drawlist_out.draw_mode & DRAW_TRI_TEXTURE1D)
-            {
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid0).uvw[0]));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid1).uvw[0]));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid2).uvw[0]));
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_TEXTURE2D)
-            {
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid0).uvw[0]*drawlist_out.texture.scaling_factor));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid0).uvw[1]*drawlist_out.texture.scaling_factor));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid1).uvw[0]*drawlist_out.texture.scaling_factor));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid1).uvw[1]*drawlist_out.texture.scaling_factor));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid2).uvw[0]*drawlist_out.texture.scaling_factor));
-                drawlist_out.tri_text.push_back(float(this->vert_data(vid2).uvw[1]*drawlist_out.texture.scaling_factor));
-            }
+    drawlist_out.resize(n_tris, n_segs);
 
-            if (drawlist_out.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
-            {
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_VERTCOLOR)
-            {
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.r*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.g*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.b*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.a);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.r*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.g*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.b*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.a);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.r*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.g*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.b*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.a);
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_QUALITY)
-            {
-                float q = this->poly_data(pid_beneath).quality;
-                Color c = Color::red_white_blue_ramp_01(q);
-                drawlist_out.tri_v_colors.push_back(c.r*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(c.g*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(c.b*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(c.a);
-                drawlist_out.tri_v_colors.push_back(c.r*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(c.g*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(c.b*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(c.a);
-                drawlist_out.tri_v_colors.push_back(c.r*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(c.g*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(c.b*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(c.a);
-            }
+    PARALLEL_FOR(0, this->num_faces(), 1000, [&](uint fid)
+    {
+        if(face_tri_beg[fid+1] > face_tri_beg[fid])
+        {
+            fill_face_render_data(drawlist_out, fid, pid_beneath[fid], face_tri_beg[fid]);
         }
-    }
-
-    for(uint eid=0; eid<this->num_edges(); ++eid)
+    });
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid)
     {
-        vec3d vid0 = this->edge_vert(eid,0);
-        vec3d vid1 = this->edge_vert(eid,1);
-
-        if (this->edge_is_on_srf(eid))
+        if(edge_seg_beg[eid+1] > edge_seg_beg[eid])
         {
-            bool hidden = true;
-            for(uint pid : this->adj_e2p(eid))
-            {
-                if(!this->poly_data(pid).flags[HIDDEN])
-                {
-                    hidden = false;
-                    break;
-                }
-            }
-            if(hidden) continue;
-
-            uint base_addr = uint(drawlist_out.seg_coords.size()/3);
-            drawlist_out.segs.push_back(base_addr    );
-            drawlist_out.segs.push_back(base_addr + 1);
-
-            drawlist_out.seg_coords.push_back(float(vid0.x()));
-            drawlist_out.seg_coords.push_back(float(vid0.y()));
-            drawlist_out.seg_coords.push_back(float(vid0.z()));
-            drawlist_out.seg_coords.push_back(float(vid1.x()));
-            drawlist_out.seg_coords.push_back(float(vid1.y()));
-            drawlist_out.seg_coords.push_back(float(vid1.z()));
-
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.a);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.a);
+            fill_edge_render_data(drawlist_out, eid, edge_seg_beg[eid]);
         }
+    });
+
+    for(uint eid=0; eid<this->num_edges(); ++eid)
+    {
+        bool hidden_srf_edge = this->edge_is_on_srf(eid) && edge_seg_beg[eid+1]==edge_seg_beg[eid];
+        if (hidden_srf_edge) continue;
 
         if (this->edge_data(eid).flags[MARKED])
         {
+            vec3d vid0 = this->edge_vert(eid,0);
+            vec3d vid1 = this->edge_vert(eid,1);
+
             uint base_addr = uint(drawlist_marked.seg_coords.size()/3);
             drawlist_marked.segs.push_back(base_addr    );
             drawlist_marked.segs.push_back(base_addr + 1);
@@ -423,203 +302,162 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_in()
     drawlist_in.seg_coords.clear();
     drawlist_in.seg_colors.clear();
 
-    std::unordered_set<uint> edges_to_render;
-
-    for(uint fid=0; fid<this->num_faces(); ++fid)
+    // count triangles and segments to be rendered, and locate
+    // them in the render data with a (parallel) prefix sum
+    std::vector<uint> face_tri_beg(this->num_faces()+1, 0);
+    std::vector<uint> pid_beneath(this->num_faces());
+    PARALLEL_FOR(0, this->num_faces(), 1000, [&](uint fid)
     {
-        if(this->face_is_on_srf(fid)) continue;
-
-        uint pid_beneath;
-        if(!this->face_is_visible(fid, pid_beneath)) continue;
+        if(!this->face_is_on_srf(fid) && this->face_is_visible(fid, pid_beneath[fid]))
+        {
+            face_tri_beg[fid] = uint(this->face_tessellation(fid).size()/3);
+        }
+    });
+    uint n_tris = PARALLEL_PREFIX_SUM(face_tri_beg, 1000);
 
-        bool is_CW = this->poly_face_is_CW(pid_beneath, fid);
+    // render inner edges incident to at least one visible inner face
+    // (surface edges are handled by updateGL_out())
+    std::vector<uint> edge_seg_beg(this->num_edges()+1, 0);
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid)
+    {
+        if(this->edge_is_on_srf(eid)) return;
+        for(uint fid : this->adj_e2f(eid))
+        {
+            uint pid;
+            if(!this->face_is_on_srf(fid) && this->face_is_visible(fid, pid))
+            {
+                edge_seg_beg[eid] = 1;
+                break;
+            }
+        }
+    });
+    uint n_segs = PARALLEL_PREFIX_SUM(edge_seg_beg, 1000);
 
-        vec3d n = this->poly_face_normal(pid_beneath, fid);
+    drawlist_in.resize(n_tris, n_segs);
 
-        for(uint eid : this->adj_f2e(fid))
+    PARALLEL_FOR(0, this->num_faces(), 1000, [&](uint fid)
+    {
+        if(face_tri_beg[fid+1] > face_tri_beg[fid])
         {
-            if (this->edge_is_on_srf(eid)) continue; // updateGL_out() will consider it
-            edges_to_render.insert(eid);
+            fill_face_render_data(drawlist_in, fid, pid_beneath[fid], face_tri_beg[fid]);
         }
+    });
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](uint eid)
+    {
+        if(edge_seg_beg[eid+1] > edge_seg_beg[eid])
+        {
+            fill_edge_render_data(drawlist_in, eid, edge_seg_beg[eid]);
+        }
+    });
+}
 
-        for(uint i=0; i<this->face_tessellation(fid).size()/3; ++i)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::fill_face_render_data(RenderData & data,
+                                                                 const uint   fid,
+                                                                 const uint   pid_beneath,
+                                                                 const uint   tri_beg)
+{
+    bool  is_CW = this->poly_face_is_CW(pid_beneath, fid);
+    vec3d n     = this->poly_face_normal(pid_beneath, fid);
+
+    for(uint i=0; i<this->face_tessellation(fid).size()/3; ++i)
+    {
+        uint t = tri_beg + i;
+        uint vids[3] =
         {
-            uint vid0 = this->face_tessellation(fid).at(3*i+0);
-            uint vid1 = this->face_tessellation(fid).at(3*i+1);
-            uint vid2 = this->face_tessellation(fid).at(3*i+2);
-            if (is_CW) std::swap(vid1,vid2); // flip triangle orientation
-
-            // average AO with adjacent visible faces having dihedral angle lower than 60 degrees
-            auto  vid0_vis_fids = this->vert_adj_visible_faces(vid0, n, 60.0);
-            auto  vid1_vis_fids = this->vert_adj_visible_faces(vid1, n, 60.0);
-            auto  vid2_vis_fids = this->vert_adj_visible_faces(vid2, n, 60.0);
-            float AO_vid0 = 0.f;
-            float AO_vid1 = 0.f;
-            float AO_vid2 = 0.f;
-            for(auto fp : vid0_vis_fids) AO_vid0 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
-            for(auto fp : vid1_vis_fids) AO_vid1 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
-            for(auto fp : vid2_vis_fids) AO_vid2 += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
-            AO_vid0 /= static_cast<float>(vid0_vis_fids.size());
-            AO_vid1 /= static_cast<float>(vid1_vis_fids.size());
-            AO_vid2 /= static_cast<float>(vid2_vis_fids.size());
-
-            uint base_addr = uint(drawlist_in.tri_coords.size()/3);
-
-            drawlist_in.tris.push_back(base_addr    );
-            drawlist_in.tris.push_back(base_addr + 1);
-            drawlist_in.tris.push_back(base_addr + 2);
-
-            drawlist_in.tri_coords.push_back(float(this->vert(vid0).x()));
-            drawlist_in.tri_coords.push_back(float(this->vert(vid0).y()));
-            drawlist_in.tri_coords.push_back(float(this->vert(vid0).z()));
-            drawlist_in.tri_coords.push_back(float(this->vert(vid1).x()));
-            drawlist_in.tri_coords.push_back(float(this->vert(vid1).y()));
-            drawlist_in.tri_coords.push_back(float(this->vert(vid1).z()));
-            drawlist_in.tri_coords.push_back(float(this->vert(vid2).x()));
-            drawlist_in.tri_coords.push_back(float(this->vert(vid2).y()));
-            drawlist_in.tri_coords.push_back(float(this->vert(vid2).z()));
-
-            if (drawlist_in.draw_mode & DRAW_TRI_SMOOTH)
-            {
-                // average normals with adjacent visible faces having dihedral angle lower than 60 degrees
-                vec3d n_vid0(0,0,0);
-                vec3d n_vid1(0,0,0);
-                vec3d n_vid2(0,0,0);
-                for(auto fp : vid0_vis_fids) n_vid0 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid1_vis_fids) n_vid1 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid2_vis_fids) n_vid2 += this->poly_face_normal(fp.second, fp.first);
-                n_vid0 /= static_cast<double>(vid0_vis_fids.size());
-                n_vid1 /= static_cast<double>(vid1_vis_fids.size());
-                n_vid2 /= static_cast<double>(vid2_vis_fids.size());
-
-                drawlist_in.tri_v_norms.push_back(float(n_vid0.x()));
-                drawlist_in.tri_v_norms.push_back(float(n_vid0.y()));
-                drawlist_in.tri_v_norms.push_back(float(n_vid0.z()));
-                drawlist_in.tri_v_norms.push_back(float(n_vid1.x()));
-                drawlist_in.tri_v_norms.push_back(float(n_vid1.y()));
-                drawlist_in.tri_v_norms.push_back(float(n_vid1.z()));
-                drawlist_in.tri_v_norms.push_back(float(n_vid2.x()));
-                drawlist_in.tri_v_norms.push_back(float(n_vid2.y()));
-                drawlist_in.tri_v_norms.push_back(float(n_vid2.z()));
-            }
-            else if (drawlist_in.draw_mode & DRAW_TRI_FLAT)
-            {
-                drawlist_in.tri_v_norms.push_back(float(n.x()));
-                drawlist_in.tri_v_norms.push_back(float(n.y()));
-                drawlist_in.tri_v_norms.push_back(float(n.z()));
-                drawlist_in.tri_v_norms.push_back(float(n.x()));
-                drawlist_in.tri_v_norms.push_back(float(n.y()));
-                drawlist_in.tri_v_norms.push_back(float(n.z()));
-                drawlist_in.tri_v_norms.push_back(float(n.x()));
-                drawlist_in.tri_v_norms.push_back(float(n.y()));
-                drawlist_in.tri_v_norms.push_back(float(n.z()));
-            }
+            this->face_tessellation(fid).at(3*i+0),
+            this->face_tessellation(fid).at(3*i+1),
+            this->face_tessellation(fid).at(3*i+2)
+        };
+        if(is_CW) std::swap(vids[1],vids[2]); // flip triangle orientation
+
+        float *xyz  = data.tri_coords.data()   + 9*t;
+        float *nor  = data.tri_v_norms.data()  + 9*t;
+        float *tex  = data.tri_text.data()     + data.text_per_tri()*t;
+        float *rgba = data.tri_v_colors.data() + 12*t;
+
+        for(uint j=0; j<3; ++j)
+        {
+            uint vid = vids[j];
+
+            // average AO (and normals) with adjacent visible faces having dihedral angle lower than 60 degrees
+            auto  vis_fids = this->vert_adj_visible_faces(vid, n, 60.0);
+            float AO = 0.f;
+            for(auto fp : vis_fids) AO += this->face_data(fp.first).AO*AO_alpha + (1.f - AO_alpha);
+            AO /= static_cast<float>(vis_fids.size());
+
+            xyz[3*j+0] = float(this->vert(vid).x());
+            xyz[3*j+1] = float(this->vert(vid).y());
+            xyz[3*j+2] = float(this->vert(vid).z());
 
-            if (drawlist_in.draw_mode & DRAW_TRI_TEXTURE1D)
+            if (data.draw_mode & DRAW_TRI_SMOOTH)
             {
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid0).uvw[0]));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid1).uvw[0]));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid2).uvw[0]));
+                vec3d n_vid(0,0,0);
+                for(auto fp : vis_fids) n_vid += this->poly_face_normal(fp.second, fp.first);
+                n_vid /= static_cast<double>(vis_fids.size());
+                nor[3*j+0] = float(n_vid.x());
+                nor[3*j+1] = float(n_vid.y());
+                nor[3*j+2] = float(n_vid.z());
             }
-            else if (drawlist_in.draw_mode & DRAW_TRI_TEXTURE2D)
+            else if (data.draw_mode & DRAW_TRI_FLAT)
             {
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid0).uvw[0]*drawlist_in.texture.scaling_factor));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid0).uvw[1]*drawlist_in.texture.scaling_factor));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid1).uvw[0]*drawlist_in.texture.scaling_factor));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid1).uvw[1]*drawlist_in.texture.scaling_factor));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid2).uvw[0]*drawlist_in.texture.scaling_factor));
-                drawlist_in.tri_text.push_back(float(this->vert_data(vid2).uvw[1]*drawlist_in.texture.scaling_factor));
+                nor[3*j+0] = float(n.x());
+                nor[3*j+1] = float(n.y());
+                nor[3*j+2] = float(n.z());
             }
 
-            if (drawlist_in.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
+            if (data.draw_mode & DRAW_TRI_TEXTURE1D)
             {
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
+                tex[j] = float(this->vert_data(vid).uvw[0]);
             }
-            else if (drawlist_in.draw_mode & DRAW_TRI_VERTCOLOR)
+            else if (data.draw_mode & DRAW_TRI_TEXTURE2D)
             {
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.r*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.g*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.b*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.a);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.r*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.g*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.b*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.a);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.r*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.g*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.b*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.a);
+                tex[2*j+0] = float(this->vert_data(vid).uvw[0]*data.texture.scaling_factor);
+                tex[2*j+1] = float(this->vert_data(vid).uvw[1]*data.texture.scaling_factor);
             }
-            else if (drawlist_in.draw_mode & DRAW_TRI_QUALITY)
+
+            if (data.colors_per_tri()>0)
             {
-                float q = this->poly_data(pid_beneath).quality;
-                Color c = Color::red_white_blue_ramp_01(q);
-                drawlist_in.tri_v_colors.push_back(c.r*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(c.g*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(c.b*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(c.a);
-                drawlist_in.tri_v_colors.push_back(c.r*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(c.g*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(c.b*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(c.a);
-                drawlist_in.tri_v_colors.push_back(c.r*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(c.g*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(c.b*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(c.a);
+                Color c;
+                     if (data.draw_mode & DRAW_TRI_FACECOLOR) c = this->poly_data(pid_beneath).color; // replicate f color on each vertex
+                else if (data.draw_mode & DRAW_TRI_VERTCOLOR) c = this->vert_data(vid).color;
+                else if (data.draw_mode & DRAW_TRI_QUALITY)   c = Color::red_white_blue_ramp_01(this->poly_data(pid_beneath).quality);
+
+                rgba[4*j+0] = c.r*AO;
+                rgba[4*j+1] = c.g*AO;
+                rgba[4*j+2] = c.b*AO;
+                rgba[4*j+3] = c.a;
             }
         }
     }
+}
 
-    for(uint eid : edges_to_render)
-    {
-        uint base_addr = uint(drawlist_in.seg_coords.size()/3);
-        drawlist_in.segs.push_back(base_addr    );
-        drawlist_in.segs.push_back(base_addr + 1);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        vec3d vid0 = this->edge_vert(eid,0);
-        vec3d vid1 = this->edge_vert(eid,1);
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::fill_edge_render_data(RenderData & data,
+                                                                 const uint   eid,
+                                                                 const uint   seg)
+{
+    vec3d  vid0 = this->edge_vert(eid,0);
+    vec3d  vid1 = this->edge_vert(eid,1);
+    float *xyz  = data.seg_coords.data() + 6*seg;
+    float *rgba = data.seg_colors.data() + 8*seg;
 
-        drawlist_in.seg_coords.push_back(float(vid0.x()));
-        drawlist_in.seg_coords.push_back(float(vid0.y()));
-        drawlist_in.seg_coords.push_back(float(vid0.z()));
-        drawlist_in.seg_coords.push_back(float(vid1.x()));
-        drawlist_in.seg_coords.push_back(float(vid1.y()));
-        drawlist_in.seg_coords.push_back(float(vid1.z()));
-
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.r);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.g);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.b);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.a);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.r);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.g);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.b);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.a);
-
-//        if (this->edge_data(eid).flags[MARKED] && drawlist_in.draw_mode & DRAW_MARKED_SEGS)
-//        {
-//            uint base_addr = uint(drawlist_in.flags[MARKED]_seg_coords.size()/3);
-//            drawlist_in.flags[MARKED]_segs.push_back(base_addr    );
-//            drawlist_in.flags[MARKED]_segs.push_back(base_addr + 1);
-
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid0.x());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid0.y());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid0.z());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid1.x());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid1.y());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid1.z());
-//        }
-    }
+    xyz[0] = float(vid0.x());
+    xyz[1] = float(vid0.y());
+    xyz[2] = float(vid0.z());
+    xyz[3] = float(vid1.x());
+    xyz[4] = float(vid1.y());
+    xyz[5] = float(vid1.z());
+
+    const Color & c = this->edge_data(eid).color;
+    rgba[0] = c.r; rgba[1] = c.g; rgba[2] = c.b; rgba[3] = c.a;
+    rgba[4] = c.r; rgba[5] = c.g; rgba[6] = c.b; rgba[7] = c.a;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
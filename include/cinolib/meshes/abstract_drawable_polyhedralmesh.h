@@ -89,6 +89,9 @@ class AbstractDrawablePolyhedralMesh : public virtual Mesh, public DrawableObjec
 
         void init_drawable_stuff();
 
+        // also releases the GPU buffers of the render data (e.g. when a new mesh is loaded)
+        void clear() override;
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void updateGL();         // regenerates rendering data for mesh inside/outside and marked elements
@@ -139,6 +142,14 @@ class AbstractDrawablePolyhedralMesh : public virtual Mesh, public DrawableObjec
         void show_marked_face(const bool b);
         void show_marked_face_color(const Color & c);
         void show_marked_face_transparency(const float alpha);
+
+    protected:
+
+        // write the render data of a face/edge starting from the given triangle/segment.
+        // Buffers must be pre-allocated. Distinct elements touch disjoint ranges, so
+        // these can be safely called in parallel
+        void fill_face_render_data(RenderData & data, const uint fid, const uint pid_beneath, const uint tri_beg);
+        void fill_edge_render_data(RenderData & data, const uint eid, const uint seg);
 };
 
 }
@@ -37,6 +37,8 @@
 #include <cinolib/meshes/mesh_attributes.h>
 #include <cinolib/stl_container_utilities.h>
 #include <cinolib/min_max_inf.h>
+#include <cinolib/geometry/segment_utils.h>
+#include <cinolib/how_many_seconds.h>
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
@@ -108,6 +110,121 @@ void AbstractMesh<M,V,E,P>::clear()
     e2p.clear();
     p2e.clear();
     p2p.clear();
+    //
+    invalidate_pick_index();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractMesh<M,V,E,P>::load_binary(const char * filename)
+{
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    this->clear();
+    this->mesh_data().filename = std::string(filename);
+
+    BinaryMeshReader r;
+    if(!r.open(filename)) return false;
+    if(r.mesh_type()!=int(mesh_type()))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_binary() : mesh type mismatch in " << filename << std::endl;
+        return false;
+    }
+    if(!binary_read(r))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_binary() : missing or corrupted sections in " << filename << std::endl;
+        this->clear();
+        return false;
+    }
+    update_bbox();
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    std::cout << "load mesh\t"     <<
+                 this->num_verts() << "V / " <<
+                 this->num_edges() << "E / " <<
+                 this->num_polys() << "P  [" <<
+                 how_many_seconds(t0,t1) << "s]" << std::endl;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractMesh<M,V,E,P>::save_binary(const char * filename) const
+{
+    BinaryMeshWriter w(mesh_type());
+    binary_write(w);
+    return w.write(filename);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::binary_write(BinaryMeshWriter & w) const
+{
+    w.add(BIN_VERTS, verts);
+    w.add(BIN_EDGES, edges);
+    w.add(BIN_POLYS, polys);
+    w.add(BIN_V2V,   v2v);
+    w.add(BIN_V2E,   v2e);
+    w.add(BIN_V2P,   v2p);
+    w.add(BIN_E2P,   e2p);
+    w.add(BIN_P2E,   p2e);
+    w.add(BIN_P2P,   p2p);
+    w.template add<vec3d        >(BIN_V_NORMAL,  v_data, [](const V & d) { return d.normal;            });
+    w.template add<Color        >(BIN_V_COLOR,   v_data, [](const V & d) { return d.color;             });
+    w.template add<vec3d        >(BIN_V_UVW,     v_data, [](const V & d) { return d.uvw;               });
+    w.template add<int          >(BIN_V_LABEL,   v_data, [](const V & d) { return d.label;             });
+    w.template add<float        >(BIN_V_QUALITY, v_data, [](const V & d) { return d.quality;           });
+    w.template add<unsigned char>(BIN_V_FLAGS,   v_data, [](const V & d) { return (unsigned char)d.flags.to_ulong(); });
+    w.template add<Color        >(BIN_E_COLOR,   e_data, [](const E & d) { return d.color;             });
+    w.template add<int          >(BIN_E_LABEL,   e_data, [](const E & d) { return d.label;             });
+    w.template add<unsigned char>(BIN_E_FLAGS,   e_data, [](const E & d) { return (unsigned char)d.flags.to_ulong(); });
+    w.template add<Color        >(BIN_P_COLOR,   p_data, [](const P & d) { return d.color;             });
+    w.template add<int          >(BIN_P_LABEL,   p_data, [](const P & d) { return d.label;             });
+    w.template add<float        >(BIN_P_QUALITY, p_data, [](const P & d) { return d.quality;           });
+    w.template add<unsigned char>(BIN_P_FLAGS,   p_data, [](const P & d) { return (unsigned char)d.flags.to_ulong(); });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractMesh<M,V,E,P>::binary_read(const BinaryMeshReader & r)
+{
+    if(!r.get(BIN_VERTS, verts) ||
+       !r.get(BIN_EDGES, edges) ||
+       !r.get(BIN_POLYS, polys) ||
+       !r.get(BIN_V2V,   v2v)   ||
+       !r.get(BIN_V2E,   v2e)   ||
+       !r.get(BIN_V2P,   v2p)   ||
+       !r.get(BIN_E2P,   e2p)   ||
+       !r.get(BIN_P2E,   p2e)   ||
+       !r.get(BIN_P2P,   p2p))  return false;
+
+    // attributes are optional: missing channels retain their default values
+    v_data.resize(verts.size());
+    e_data.resize(edges.size()/2);
+    p_data.resize(polys.size());
+    r.template get<vec3d        >(BIN_V_NORMAL,  v_data, [](V & d, const vec3d         & x) { d.normal  = x; });
+    r.template get<Color        >(BIN_V_COLOR,   v_data, [](V & d, const Color         & x) { d.color   = x; });
+    r.template get<vec3d        >(BIN_V_UVW,     v_data, [](V & d, const vec3d         & x) { d.uvw     = x; });
+    r.template get<int          >(BIN_V_LABEL,   v_data, [](V & d, const int           & x) { d.label   = x; });
+    r.template get<float        >(BIN_V_QUALITY, v_data, [](V & d, const float         & x) { d.quality = x; });
+    r.template get<unsigned char>(BIN_V_FLAGS,   v_data, [](V & d, const unsigned char & x) { d.flags   = x; });
+    r.template get<Color        >(BIN_E_COLOR,   e_data, [](E & d, const Color         & x) { d.color   = x; });
+    r.template get<int          >(BIN_E_LABEL,   e_data, [](E & d, const int           & x) { d.label   = x; });
+    r.template get<unsigned char>(BIN_E_FLAGS,   e_data, [](E & d, const unsigned char & x) { d.flags   = x; });
+    r.template get<Color        >(BIN_P_COLOR,   p_data, [](P & d, const Color         & x) { d.color   = x; });
+    r.template get<int          >(BIN_P_LABEL,   p_data, [](P & d, const int           & x) { d.label   = x; });
+    r.template get<float        >(BIN_P_QUALITY, p_data, [](P & d, const float         & x) { d.quality = x; });
+    r.template get<unsigned char>(BIN_P_FLAGS,   p_data, [](P & d, const unsigned char & x) { d.flags   = x; });
+    return true;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -131,6 +248,7 @@ void AbstractMesh<M,V,E,P>::translate(const vec3d & delta)
     for(uint vid=0; vid<num_verts(); ++vid) vert(vid) += delta;
     bb.min += delta;
     bb.max += delta;
+    invalidate_pick_index();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -227,6 +345,7 @@ void AbstractMesh<M,V,E,P>::update_bbox()
 {
     bb.reset();
     bb.push(this->verts);
+    invalidate_pick_index();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1152,6 +1271,7 @@ void AbstractMesh<M,V,E,P>::center_bbox()
     for(uint vid=0; vid<num_verts(); ++vid) vert(vid) -= center;
     bb.min -= center;
     bb.max -= center;
+    invalidate_pick_index();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1368,14 +1488,70 @@ void AbstractMesh<M,V,E,P>::edge_mark_sharp_creases(const float thresh)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+const BVH & AbstractMesh<M,V,E,P>::vert_index() const
+{
+    if(bvh_verts.num_items()!=num_verts() || bvh_verts_rev!=geom_rev)
+    {
+        std::vector<AABB> boxes(num_verts());
+        for(uint vid=0; vid<num_verts(); ++vid) boxes[vid] = AABB(vert(vid),vert(vid));
+        bvh_verts.build(boxes);
+        bvh_verts_rev = geom_rev;
+    }
+    return bvh_verts;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+const BVH & AbstractMesh<M,V,E,P>::edge_index() const
+{
+    if(bvh_edges.num_items()!=num_edges() || bvh_edges_rev!=geom_rev)
+    {
+        std::vector<AABB> boxes(num_edges());
+        for(uint eid=0; eid<num_edges(); ++eid)
+        {
+            boxes[eid] = AABB(edge_vert(eid,0), edge_vert(eid,1));
+            boxes[eid].push(edge_sample_at(eid,0.5)); // guard against roundoff
+        }
+        bvh_edges.build(boxes);
+        bvh_edges_rev = geom_rev;
+    }
+    return bvh_edges;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+const BVH & AbstractMesh<M,V,E,P>::poly_index() const
+{
+    if(bvh_polys.num_items()!=num_polys() || bvh_polys_rev!=geom_rev)
+    {
+        std::vector<AABB> boxes(num_polys());
+        for(uint pid=0; pid<num_polys(); ++pid)
+        {
+            boxes[pid] = poly_aabb(pid);
+            boxes[pid].push(poly_centroid(pid)); // guard against roundoff
+        }
+        bvh_polys.build(boxes);
+        bvh_polys_rev = geom_rev;
+    }
+    return bvh_polys;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_vert(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint vid=0; vid<this->num_verts(); ++vid) closest.push_back(std::make_pair(this->vert(vid).dist(p),vid));
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    uint   vid = 0;
+    double d;
+    vert_index().closest(p, [&](const uint id){ return vert(id).dist(p); }, vid, d);
+    return vid;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1384,10 +1560,10 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_edge(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint eid=0; eid<this->num_edges(); ++eid) closest.push_back(std::make_pair(this->edge_sample_at(eid, 0.5).dist(p),eid));
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    uint   eid = 0;
+    double d;
+    edge_index().closest(p, [&](const uint id){ return edge_sample_at(id,0.5).dist(p); }, eid, d);
+    return eid;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1396,13 +1572,84 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractMesh<M,V,E,P>::pick_poly(const vec3d & p) const
 {
-    std::vector<std::pair<double,uint>> closest;
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    // hidden polys are skipped by the distance function, not by the index,
+    // so that changing their visibility does not require a rebuild
+    uint   pid = 0;
+    double d;
+    poly_index().closest(p, [&](const uint id)
     {
-        if(!this->poly_data(pid).flags[HIDDEN]) closest.push_back(std::make_pair(this->poly_centroid(pid).dist(p),pid));
+        return poly_data(id).flags[HIDDEN] ? inf_double : poly_centroid(id).dist(p);
+    }, pid, d);
+    return pid;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::invalidate_pick_index()
+{
+    bvh_verts.clear();
+    bvh_edges.clear();
+    bvh_polys.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractMesh<M,V,E,P>::pick_poly(const Ray & r, uint & pid, vec3d & hit) const
+{
+    std::vector<uint> vids, eids;
+    return pick_ray(r, pid, hit, vids, eids);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractMesh<M,V,E,P>::pick_vert(const Ray & r, uint & vid) const
+{
+    uint  pid;
+    vec3d hit;
+    std::vector<uint> vids, eids;
+    if(!pick_ray(r, pid, hit, vids, eids)) return false;
+
+    double d = inf_double;
+    for(uint id : vids)
+    {
+        double tmp = vert(id).dist(hit);
+        if(tmp<d)
+        {
+            d   = tmp;
+            vid = id;
+        }
     }
-    std::sort(closest.begin(), closest.end());
-    return closest.front().second;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractMesh<M,V,E,P>::pick_edge(const Ray & r, uint & eid) const
+{
+    uint  pid;
+    vec3d hit;
+    std::vector<uint> vids, eids;
+    if(!pick_ray(r, pid, hit, vids, eids)) return false;
+
+    double d = inf_double;
+    for(uint id : eids)
+    {
+        double tmp = point_segment_sqrd_dist(edge_vert(id,0), edge_vert(id,1), hit);
+        if(tmp<d)
+        {
+            d   = tmp;
+            eid = id;
+        }
+    }
+    return true;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
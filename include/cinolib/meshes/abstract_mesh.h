@@ -41,10 +41,13 @@
 #include <sys/types.h>
 
 #include <cinolib/geometry/aabb.h>
+#include <cinolib/geometry/ray.h>
 #include <cinolib/geometry/vec_mat.h>
+#include <cinolib/bvh.h>
 #include <cinolib/color.h>
 #include <cinolib/symbols.h>
 #include <cinolib/ipair.h>
+#include <cinolib/io/binary_mesh.h>
 
 typedef enum
 {
@@ -87,6 +90,19 @@ class AbstractMesh
         std::vector<std::vector<uint>> p2e; // poly to edge adjacency
         std::vector<std::vector<uint>> p2p; // poly to poly adjacency
 
+        // spatial indices used for picking. They are built at the first pick
+        // and dropped whenever the geometry changes (see invalidate_pick_index)
+        mutable BVH bvh_verts;
+        mutable BVH bvh_edges;
+        mutable BVH bvh_polys;
+
+        // bumped by any non const access to the vertex coordinates. Each pick
+        // index remembers the revision it was built at, and is rebuilt if stale
+        uint         geom_rev = 0;
+        mutable uint bvh_verts_rev = 0;
+        mutable uint bvh_edges_rev = 0;
+        mutable uint bvh_polys_rev = 0;
+
     public:
 
         typedef M M_type;
@@ -112,6 +128,11 @@ class AbstractMesh
         virtual void load(const char * filename) = 0;
         virtual void save(const char * filename) const = 0;
 
+        // native binary format (.cino). Stores the full mesh connectivity and
+        // the standard attributes, so that loading does not rebuild the topology
+                bool load_binary(const char * filename);
+                bool save_binary(const char * filename) const;
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
                 void update_bbox();
@@ -149,7 +170,7 @@ class AbstractMesh
 
         const AABB                           & bbox()          const { return bb;    }
         const std::vector<vec3d>             & vector_verts()  const { return verts; }
-              std::vector<vec3d>             & vector_verts()        { return verts; }
+              std::vector<vec3d>             & vector_verts()        { ++geom_rev; return verts; }
         const std::vector<uint>              & vector_edges()  const { return edges; }
               std::vector<uint>              & vector_edges()        { return edges; }
         const std::vector<std::vector<uint>> & vector_polys()  const { return polys; }
@@ -208,15 +229,28 @@ class AbstractMesh
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        // useful for GUIs with mouse picking
-        uint pick_vert(const vec3d & p) const;
-        uint pick_edge(const vec3d & p) const;
-        uint pick_poly(const vec3d & p) const;
+        // useful for GUIs with mouse picking. Queries are answered by spatial
+        // indices that are lazily built on first use and discarded by update_bbox,
+        // update_normals, clear, by any element insertion/removal/renumbering and
+        // by any non const access to the vertex coordinates (vert, vector_verts)
+                uint pick_vert(const vec3d & p) const;
+                uint pick_edge(const vec3d & p) const;
+                uint pick_poly(const vec3d & p) const;
+        virtual void invalidate_pick_index();
+
+        // ray based picking (e.g. with a ray shot from the camera through the
+        // clicked pixel, see GLcanvas::eye_ray). The first visible element hit
+        // by the ray is selected; vertices and edges are chosen among those of
+        // the element hit, taking the one closest to the hit point. Return false
+        // if the ray misses the mesh
+        bool pick_poly(const Ray & r, uint & pid, vec3d & hit) const;
+        bool pick_vert(const Ray & r, uint & vid) const;
+        bool pick_edge(const Ray & r, uint & eid) const;
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
           const vec3d          & vert                       (const uint vid) const { return verts.at(vid); }
-                vec3d          & vert                       (const uint vid)       { return verts.at(vid); }
+                vec3d          & vert                       (const uint vid)       { ++geom_rev; return verts.at(vid); }
                 void             vert_weights_uniform       (const uint vid, std::vector<std::pair<uint,double>> & wgts) const;
                 std::set<uint>   vert_n_ring                (const uint vid, const uint n) const;
                 bool             verts_are_adjacent         (const uint vid0, const uint vid1) const;
@@ -299,6 +333,29 @@ class AbstractMesh
         virtual void               poly_set_color             (const Color & c);
         virtual void               poly_set_alpha             (const float alpha);
         virtual void               poly_export_element        (const uint pid, std::vector<vec3d> & verts, std::vector<std::vector<uint>> & faces) const = 0;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    protected:
+
+        // fill/read the sections of a binary file. Derived classes should
+        // extend them with their own containers and attributes
+        virtual void binary_write(BinaryMeshWriter       & w) const;
+        virtual bool binary_read (const BinaryMeshReader & r);
+
+        // lazily (re)built spatial indices of verts, edges and polys
+        const BVH & vert_index() const;
+        const BVH & edge_index() const;
+        const BVH & poly_index() const;
+
+        // first visible element hit by ray r (polygons for surface meshes, faces for volume
+        // meshes). Returns the poly hit (or beneath the face), the hit point and the vertices
+        // and edges of the element hit, which are the candidates for ray based vert/edge picking
+        virtual bool pick_ray(const Ray               & r,
+                                    uint              & pid,
+                                    vec3d             & hit,
+                                    std::vector<uint> & vids,
+                                    std::vector<uint> & eids) const = 0;
 };
 
 }
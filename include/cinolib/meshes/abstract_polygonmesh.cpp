@@ -40,8 +40,10 @@
 #include <cinolib/stl_container_utilities.h>
 #include <cinolib/geometry/polygon_utils.h>
 #include <cinolib/vector_serialization.h>
+#include <cinolib/string_utilities.h>
 #include <cinolib/how_many_seconds.h>
 #include <cinolib/deg_rad.h>
+#include <cinolib/Moller_Trumbore_intersection.h>
 #include <unordered_set>
 #include <cinolib/ANSI_color_codes.h>
 #include <queue>
@@ -55,45 +57,53 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::load(const char * filename)
 {
+    std::string str(filename);
+    std::string ext = get_file_extension(str);
+    if(ext.compare("cino") == 0 ||
+       ext.compare("CINO") == 0)
+    {
+        this->load_binary(filename);
+        return;
+    }
+
     this->clear();
     this->mesh_data().filename = std::string(filename);
 
-    std::vector<vec3d>             pos;      // vertex xyz positions
-    std::vector<vec3d>             tex;      // vertex uv(w) texture coordinates
-    std::vector<vec3d>             nor;      // vertex normals
-    std::vector<std::vector<uint>> poly_pos; // polygons with references to pos
-    std::vector<std::vector<uint>> poly_tex; // polygons with references to tex
-    std::vector<std::vector<uint>> poly_nor; // polygons with references to nor
-    std::vector<Color>             poly_col; // per polygon colors
-    std::vector<int>               poly_lab; // per polygon labels
+    IOData data;
 
-    std::string str(filename);
     std::string filetype = str.substr(str.size()-4,4);
 
     if (filetype.compare(".off") == 0 ||
         filetype.compare(".OFF") == 0)
     {
-        read_OFF(filename, pos, poly_pos, poly_col);
+        read_OFF(filename, data);
     }
     else if (filetype.compare(".obj") == 0 ||
              filetype.compare(".OBJ") == 0)
     {
-        //read_OBJ(filename, pos, poly_pos);
-        read_OBJ(filename, pos, tex, nor, poly_pos, poly_tex, poly_nor, poly_col, poly_lab);
+        read_OBJ(filename, data);
     }
     else if (filetype.compare(".stl") == 0 ||
              filetype.compare(".STL") == 0)
     {
-        std::vector<uint> tris;
-        read_STL(filename, pos, tris);
-        poly_pos = polys_from_serialized_vids(tris, 3);
+        read_STL(filename, data);
+    }
+    else if (filetype.compare(".ply") == 0 ||
+             filetype.compare(".PLY") == 0)
+    {
+        read_PLY(filename, data);
+    }
+    else if (get_file_extension(str).compare("meshb") == 0 ||
+             get_file_extension(str).compare("MESHB") == 0)
+    {
+        read_MESHB(filename, data, 2);
     }
     else
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load() : file format not supported yet " << std::endl;
     }
 
-    init(pos, tex, nor, poly_pos, poly_tex, poly_nor, poly_col, poly_lab);
+    init(std::move(data));
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -135,6 +145,41 @@ void AbstractPolygonMesh<M,V,E,P>::save(const char * filename) const
 
         write_STL(filename, serialized_xyz_from_vec3d(this->vector_verts()), this->polys, normals);
     }
+    else if (filetype.compare("ply") == 0 ||
+             filetype.compare("PLY") == 0)
+    {
+        std::vector<double> vert_normals, vert_uv;
+        std::vector<Color>  vert_colors, poly_colors;
+        std::vector<int>    poly_labels;
+        vert_normals.reserve(3*this->num_verts());
+        vert_colors.reserve(this->num_verts());
+        vert_uv.reserve(2*this->num_verts());
+        for(uint vid=0; vid<this->num_verts(); ++vid)
+        {
+            vert_normals.push_back(this->vert_data(vid).normal.x());
+            vert_normals.push_back(this->vert_data(vid).normal.y());
+            vert_normals.push_back(this->vert_data(vid).normal.z());
+            vert_colors.push_back(this->vert_data(vid).color);
+            vert_uv.push_back(this->vert_data(vid).uvw.x());
+            vert_uv.push_back(this->vert_data(vid).uvw.y());
+        }
+        if(this->polys_are_colored()) poly_colors = this->vector_poly_colors();
+        if(this->polys_are_labeled()) poly_labels = this->vector_poly_labels();
+        write_PLY(filename, coords, this->polys, vert_normals, vert_colors, vert_uv, poly_colors, poly_labels);
+    }
+    else if (get_file_extension(str).compare("meshb") == 0 ||
+             get_file_extension(str).compare("MESHB") == 0)
+    {
+        std::vector<int>               no_labels, poly_labels;
+        std::vector<std::vector<uint>> no_elems;
+        if(this->polys_are_labeled()) poly_labels = this->vector_poly_labels();
+        write_MESHB(filename, this->verts, no_labels, no_elems, no_labels, this->polys, poly_labels, no_elems, no_labels);
+    }
+    else if (get_file_extension(str).compare("cino") == 0 ||
+             get_file_extension(str).compare("CINO") == 0)
+    {
+        this->save_binary(filename);
+    }
     else
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write() : file format not supported yet " << std::endl;
@@ -143,6 +188,73 @@ void AbstractPolygonMesh<M,V,E,P>::save(const char * filename) const
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::binary_write(BinaryMeshWriter & w) const
+{
+    AbstractMesh<M,V,E,P>::binary_write(w);
+    w.add(BIN_POLY_TRIANGLES, poly_triangles);
+    w.template add<vec3d>(BIN_P_NORMAL, this->p_data, [](const P & d) { return d.normal; });
+    w.template add<float>(BIN_P_AO,     this->p_data, [](const P & d) { return d.AO;     });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractPolygonMesh<M,V,E,P>::binary_read(const BinaryMeshReader & r)
+{
+    if(!AbstractMesh<M,V,E,P>::binary_read(r))   return false;
+    if(!r.get(BIN_POLY_TRIANGLES, poly_triangles)) return false;
+    r.template get<vec3d>(BIN_P_NORMAL, this->p_data, [](P & d, const vec3d & x) { d.normal = x; });
+    r.template get<float>(BIN_P_AO,     this->p_data, [](P & d, const float & x) { d.AO     = x; });
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool AbstractPolygonMesh<M,V,E,P>::pick_ray(const Ray               & r,
+                                                  uint              & pid,
+                                                  vec3d             & hit,
+                                                  std::vector<uint> & vids,
+                                                  std::vector<uint> & eids) const
+{
+    double t;
+    auto hit_poly = [&](const uint id, const double t_max, double & t_hit) -> bool
+    {
+        if(this->poly_data(id).flags[HIDDEN]) return false;
+        bool found = false;
+        t_hit = t_max;
+        const std::vector<uint> & tris = poly_triangles.at(id);
+        for(uint i=0; i<tris.size(); i+=3)
+        {
+            bool   backside, coplanar;
+            double t_tri;
+            vec3d  bary;
+            if(Moller_Trumbore_intersection(r.begin(), r.dir(),
+                                            this->vert(tris[i  ]),
+                                            this->vert(tris[i+1]),
+                                            this->vert(tris[i+2]),
+                                            backside, coplanar, t_tri, bary) && t_tri>=0 && t_tri<t_hit)
+            {
+                t_hit = t_tri;
+                found = true;
+            }
+        }
+        return found;
+    };
+    if(!this->poly_index().first_hit(r.begin(), r.dir(), hit_poly, pid, t)) return false;
+
+    hit  = r.begin() + t*r.dir();
+    vids = this->adj_p2v(pid);
+    eids = this->adj_p2e(pid);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::clear()
@@ -179,17 +291,10 @@ void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & v
     this->p_data.reserve(np);
 
     // initialize mesh connectivity (and normals)
-    for(auto v : verts) this->vert_add(v);
-    for(auto p : polys) this->poly_add(p);
+    for(const auto & v : verts) this->vert_add(v);
+    for(const auto & p : polys) this->poly_add(p);
 
-    if(this->mesh_data().update_normals) this->update_v_normals();
-
-    this->copy_xyz_to_uvw(UVW_param);
-
-    for(uint eid=0; eid<this->num_edges(); ++eid)
-    {
-        this->edge_data(eid).flags[MARKED] = (this->edge_is_boundary(eid) || !this->edge_is_manifold(eid));
-    }
+    finalize_init();
 
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
 
@@ -202,6 +307,22 @@ void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & v
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::finalize_init()
+{
+    if(this->mesh_data().update_normals) this->update_v_normals();
+
+    this->copy_xyz_to_uvw(UVW_param);
+
+    for(uint eid=0; eid<this->num_edges(); ++eid)
+    {
+        this->edge_data(eid).flags[MARKED] = (this->edge_is_boundary(eid) || !this->edge_is_manifold(eid));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::init(      std::vector<vec3d>             & pos,       // vertex xyz positions
@@ -223,28 +344,28 @@ void AbstractPolygonMesh<M,V,E,P>::init(      std::vector<vec3d>             & p
         std::vector<vec3d> tmp_xyz, tmp_uvw, tmp_nor;
         std::vector<std::vector<uint>> tmp_poly;
         to_openGL_unified_verts(pos, tex, nor, poly_pos, poly_tex, poly_nor, tmp_xyz, tmp_uvw, tmp_nor, tmp_poly);
-        pos      = tmp_xyz;
-        tex      = tmp_uvw;
-        nor      = tmp_nor;
-        poly_pos = tmp_poly;
+        pos.swap(tmp_xyz);
+        tex.swap(tmp_uvw);
+        nor.swap(tmp_nor);
+        poly_pos.swap(tmp_poly);
     }
     else if (poly_pos.size() == poly_tex.size())
     {
         std::vector<vec3d> tmp_xyz, tmp_uvw;
         std::vector<std::vector<uint>> tmp_poly;
         to_openGL_unified_verts(pos, tex, poly_pos, poly_tex, tmp_xyz, tmp_uvw, tmp_poly);
-        pos      = tmp_xyz;
-        tex      = tmp_uvw;
-        poly_pos = tmp_poly;
+        pos.swap(tmp_xyz);
+        tex.swap(tmp_uvw);
+        poly_pos.swap(tmp_poly);
     }
     else if (poly_pos.size() == poly_nor.size())
     {
         std::vector<vec3d> tmp_xyz, tmp_nor;
         std::vector<std::vector<uint>> tmp_poly;
         to_openGL_unified_verts(pos, nor, poly_pos, poly_nor, tmp_xyz, tmp_nor, tmp_poly);
-        pos      = tmp_xyz;
-        nor      = tmp_nor;
-        poly_pos = tmp_poly;
+        pos.swap(tmp_xyz);
+        nor.swap(tmp_nor);
+        poly_pos.swap(tmp_poly);
     }
 
     init(pos, poly_pos);
@@ -288,6 +409,85 @@ void AbstractPolygonMesh<M,V,E,P>::init(      std::vector<vec3d>             & p
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::init(IOData && data)
+{
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    data.unify_verts();
+
+    // pre-allocate memory
+    uint np = data.num_polys();
+    uint ne = uint(1.5*np);
+    this->edges.reserve(ne*2);
+    this->polys.reserve(np);
+    this->poly_triangles.reserve(np);
+    this->e2p.reserve(ne);
+    this->p2e.reserve(np);
+    this->p2p.reserve(np);
+    this->e_data.reserve(ne);
+    this->p_data.reserve(np);
+
+    // vertices have no connectivity yet: move them in bulk
+    if(this->verts.empty()) this->verts = std::move(data.verts);
+    else this->verts.insert(this->verts.end(), data.verts.begin(), data.verts.end());
+    uint nv = this->num_verts();
+    this->v_data.resize(nv);
+    this->v2v.resize(nv);
+    this->v2e.resize(nv);
+    this->v2p.resize(nv);
+    if(this->mesh_data().update_bbox) this->update_bbox();
+
+    std::vector<uint> p;
+    for(uint pid=0; pid<np; ++pid)
+    {
+        p.assign(data.poly_begin(pid), data.poly_end(pid));
+        this->poly_add(p);
+    }
+
+    finalize_init();
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    std::cout << "load mesh\t"     <<
+                 this->num_verts() << "V / " <<
+                 this->num_edges() << "E / " <<
+                 this->num_polys() << "P  [" <<
+                 how_many_seconds(t0,t1) << "s]" << std::endl;
+
+    if(data.uvw.size()==nv)
+    {
+        std::cout << "load textures" << std::endl;
+        for(uint vid=0; vid<nv; ++vid) this->vert_data(vid).uvw = data.uvw[vid];
+    }
+    if(data.normals.size()==nv)
+    {
+        std::cout << "load normals" << std::endl;
+        for(uint vid=0; vid<nv; ++vid) this->vert_data(vid).normal = data.normals[vid];
+    }
+    if(data.vert_colors.size()==nv)
+    {
+        std::cout << "load per vertex colors" << std::endl;
+        for(uint vid=0; vid<nv; ++vid) this->vert_data(vid).color = data.vert_colors[vid];
+    }
+    if(data.vert_labels.size()==nv)
+    {
+        for(uint vid=0; vid<nv; ++vid) this->vert_data(vid).label = data.vert_labels[vid];
+    }
+    if(data.poly_colors.size()==this->num_polys())
+    {
+        std::cout << "load per polygon colors" << std::endl;
+        for(uint pid=0; pid<this->num_polys(); ++pid) this->poly_data(pid).color = data.poly_colors[pid];
+    }
+    if(data.poly_labels.size()==this->num_polys())
+    {
+        this->poly_apply_labels(data.poly_labels);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_p_tessellation(const uint pid)
@@ -409,6 +609,7 @@ void AbstractPolygonMesh<M,V,E,P>::update_normals()
 {
     this->update_p_normals();
     this->update_v_normals();
+    this->invalidate_pick_index();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -870,6 +1071,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractPolygonMesh<M,V,E,P>::vert_add(const vec3d & pos)
 {
+    this->invalidate_pick_index();
     uint vid = this->num_verts();
     //
     this->verts.push_back(pos);
@@ -924,6 +1126,8 @@ void AbstractPolygonMesh<M,V,E,P>::vert_switch_id(const uint vid0, const uint vi
 
     if (vid0 == vid1) return;
 
+    this->invalidate_pick_index();
+
     std::swap(this->verts.at(vid0),  this->verts.at(vid1));
     std::swap(this->v_data.at(vid0), this->v_data.at(vid1));
     std::swap(this->v2v.at(vid0),    this->v2v.at(vid1));
@@ -991,6 +1195,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::vert_remove_unreferenced(const uint vid)
 {
+    this->invalidate_pick_index();
     this->v2v.at(vid).clear();
     this->v2e.at(vid).clear();
     this->v2p.at(vid).clear();
@@ -1087,6 +1292,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractPolygonMesh<M,V,E,P>::edge_add(const uint vid0, const uint vid1)
 {
+    this->invalidate_pick_index();
     assert(this->edge_id(vid0, vid1)==-1); // make sure it doesn't exist already
     assert(vid0 < this->num_verts());
     assert(vid1 < this->num_verts());
@@ -1123,6 +1329,8 @@ void AbstractPolygonMesh<M,V,E,P>::edge_switch_id(const uint eid0, const uint ei
 
     if (eid0 == eid1) return;
 
+    this->invalidate_pick_index();
+
     for(uint off=0; off<2; ++off) std::swap(this->edges.at(2*eid0+off), this->edges.at(2*eid1+off));
 
     std::swap(this->e2p.at(eid0),    this->e2p.at(eid1));
@@ -1172,6 +1380,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::edge_remove_unreferenced(const uint eid)
 {
+    this->invalidate_pick_index();
     this->e2p.at(eid).clear();
     edge_switch_id(eid, this->num_edges()-1);
     this->edges.resize(this->edges.size()-2);
@@ -1393,6 +1602,8 @@ void AbstractPolygonMesh<M,V,E,P>::poly_switch_id(const uint pid0, const uint pi
 
     if (pid0 == pid1) return;
 
+    this->invalidate_pick_index();
+
     std::swap(this->polys.at(pid0),          this->polys.at(pid1));
     std::swap(this->p_data.at(pid0),         this->p_data.at(pid1));
     std::swap(this->p2e.at(pid0),            this->p2e.at(pid1));
@@ -1445,6 +1656,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 uint AbstractPolygonMesh<M,V,E,P>::poly_add(const std::vector<uint> & vlist)
 {
+    this->invalidate_pick_index();
     if(poly_id(vlist)!=-1)
     {
         std::cout << ANSI_fg_color_red << "WARNING: adding duplicated poly!" << ANSI_fg_color_default << std::endl;
@@ -1578,6 +1790,7 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::poly_remove_unreferenced(const uint pid)
 {
+    this->invalidate_pick_index();
     this->polys.at(pid).clear();
     this->p2e.at(pid).clear();
     this->p2p.at(pid).clear();
@@ -40,6 +40,7 @@
 #include <cinolib/meshes/mesh_attributes.h>
 #include <cinolib/ipair.h>
 #include <cinolib/symbols.h>
+#include <cinolib/io/io_data.h>
 
 namespace cinolib
 {
@@ -78,6 +79,8 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
                   const std::vector<std::vector<uint>> & poly_nor,  // polygons with references to nor
                   const std::vector<Color>             & poly_col,  // per polygon colors
                   const std::vector<int>               & poly_lab); // per polygon labels
+        void init(IOData && data);                                  // consumes the output of a reader (no copies)
+        void finalize_init(); // completes init() on meshes built with vert_add/poly_add (e.g. by AsyncMeshLoader)
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -196,6 +199,19 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
               std::vector<uint>    poly_inner_edges        (const uint pid) const;
               std::vector<uint>    poly_boundary_verts     (const uint pid) const;
               std::vector<uint>    poly_inner_verts        (const uint pid) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    protected:
+
+        void binary_write(BinaryMeshWriter       & w) const override;
+        bool binary_read (const BinaryMeshReader & r) override;
+
+        bool pick_ray(const Ray               & r,
+                            uint              & pid,
+                            vec3d             & hit,
+                            std::vector<uint> & vids,
+                            std::vector<uint> & eids) const override;
 };
 
 }
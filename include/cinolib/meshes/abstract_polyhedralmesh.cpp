@@ -37,6 +37,7 @@
 #include <cinolib/geometry/triangle.h>
 #include <cinolib/geometry/polygon_utils.h>
 #include <cinolib/how_many_seconds.h>
+#include <cinolib/Moller_Trumbore_intersection.h>
 #include <unordered_set>
 #include <unordered_map>
 #include <cinolib/ANSI_color_codes.h>
@@ -67,6 +68,129 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::clear()
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::invalidate_pick_index()
+{
+    AbstractMesh<M,V,E,P>::invalidate_pick_index();
+    bvh_faces.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::binary_write(BinaryMeshWriter & w) const
+{
+    AbstractMesh<M,V,E,P>::binary_write(w);
+    w.add(BIN_FACES,          faces);
+    w.add(BIN_POLY_WINDING,   polys_face_winding);
+    w.add(BIN_V2F,            v2f);
+    w.add(BIN_E2F,            e2f);
+    w.add(BIN_F2E,            f2e);
+    w.add(BIN_F2F,            f2f);
+    w.add(BIN_F2P,            f2p);
+    w.add(BIN_P2V,            p2v);
+    w.add(BIN_FACE_TRIANGLES, face_triangles);
+    w.template add<vec3d        >(BIN_F_NORMAL,  f_data, [](const F & d) { return d.normal;  });
+    w.template add<Color        >(BIN_F_COLOR,   f_data, [](const F & d) { return d.color;   });
+    w.template add<int          >(BIN_F_LABEL,   f_data, [](const F & d) { return d.label;   });
+    w.template add<float        >(BIN_F_QUALITY, f_data, [](const F & d) { return d.quality; });
+    w.template add<float        >(BIN_F_AO,      f_data, [](const F & d) { return d.AO;      });
+    w.template add<unsigned char>(BIN_F_FLAGS,   f_data, [](const F & d) { return (unsigned char)d.flags.to_ulong(); });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+bool AbstractPolyhedralMesh<M,V,E,F,P>::binary_read(const BinaryMeshReader & r)
+{
+    if(!AbstractMesh<M,V,E,P>::binary_read(r)       ||
+       !r.get(BIN_FACES,          faces)              ||
+       !r.get(BIN_POLY_WINDING,   polys_face_winding) ||
+       !r.get(BIN_V2F,            v2f)                ||
+       !r.get(BIN_E2F,            e2f)                ||
+       !r.get(BIN_F2E,            f2e)                ||
+       !r.get(BIN_F2F,            f2f)                ||
+       !r.get(BIN_F2P,            f2p)                ||
+       !r.get(BIN_P2V,            p2v)                ||
+       !r.get(BIN_FACE_TRIANGLES, face_triangles))    return false;
+
+    f_data.resize(faces.size());
+    r.template get<vec3d        >(BIN_F_NORMAL,  f_data, [](F & d, const vec3d         & x) { d.normal  = x; });
+    r.template get<Color        >(BIN_F_COLOR,   f_data, [](F & d, const Color         & x) { d.color   = x; });
+    r.template get<int          >(BIN_F_LABEL,   f_data, [](F & d, const int           & x) { d.label   = x; });
+    r.template get<float        >(BIN_F_QUALITY, f_data, [](F & d, const float         & x) { d.quality = x; });
+    r.template get<float        >(BIN_F_AO,      f_data, [](F & d, const float         & x) { d.AO      = x; });
+    r.template get<unsigned char>(BIN_F_FLAGS,   f_data, [](F & d, const unsigned char & x) { d.flags   = x; });
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+const BVH & AbstractPolyhedralMesh<M,V,E,F,P>::face_index() const
+{
+    if(bvh_faces.num_items()!=this->num_faces() || bvh_faces_rev!=this->geom_rev)
+    {
+        std::vector<AABB> boxes(this->num_faces());
+        for(uint fid=0; fid<this->num_faces(); ++fid) boxes[fid] = AABB(face_verts(fid));
+        bvh_faces.build(boxes);
+        bvh_faces_rev = this->geom_rev;
+    }
+    return bvh_faces;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+bool AbstractPolyhedralMesh<M,V,E,F,P>::pick_ray(const Ray               & r,
+                                                       uint              & pid,
+                                                       vec3d             & hit,
+                                                       std::vector<uint> & vids,
+                                                       std::vector<uint> & eids) const
+{
+    // only faces on the visible surface (see face_is_visible) can be hit
+    uint   fid;
+    double t;
+    auto hit_face = [&](const uint id, const double t_max, double & t_hit) -> bool
+    {
+        uint pid_beneath;
+        if(!face_is_visible(id, pid_beneath)) return false;
+        bool found = false;
+        t_hit = t_max;
+        const std::vector<uint> & tris = face_triangles.at(id);
+        for(uint i=0; i<tris.size(); i+=3)
+        {
+            bool   backside, coplanar;
+            double t_tri;
+            vec3d  bary;
+            if(Moller_Trumbore_intersection(r.begin(), r.dir(),
+                                            this->vert(tris[i  ]),
+                                            this->vert(tris[i+1]),
+                                            this->vert(tris[i+2]),
+                                            backside, coplanar, t_tri, bary) && t_tri>=0 && t_tri<t_hit)
+            {
+                t_hit = t_tri;
+                found = true;
+            }
+        }
+        return found;
+    };
+    if(!face_index().first_hit(r.begin(), r.dir(), hit_face, fid, t)) return false;
+
+    face_is_visible(fid, pid);
+    hit  = r.begin() + t*r.dir();
+    vids = this->adj_f2v(fid);
+    eids = this->adj_f2e(fid);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>             & verts,
@@ -104,12 +228,11 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
     this->face_triangles.reserve(nf);
     this->polys_face_winding.reserve(np);
 
-    for(auto v : verts) vert_add(v);
-    for(auto f : faces) face_add(f);
+    for(const auto & v : verts) vert_add(v);
+    for(const auto & f : faces) face_add(f);
     for(uint pid=0; pid<polys.size(); ++pid) this->poly_add(polys.at(pid), polys_face_winding.at(pid));
-    if(this->mesh_data().update_normals) this->update_v_normals();
 
-    this->copy_xyz_to_uvw(UVW_param);
+    finalize_init();
 
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
 
@@ -146,11 +269,10 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
     this->p_data.reserve(np);
     this->polys_face_winding.reserve(np);
 
-    for(auto v : verts) vert_add(v);
-    for(auto p : polys) poly_add(p);
-    if(this->mesh_data().update_normals) this->update_v_normals();
+    for(const auto & v : verts) vert_add(v);
+    for(const auto & p : polys) poly_add(p);
 
-    this->copy_xyz_to_uvw(UVW_param);
+    finalize_init();
 
     std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
 
@@ -195,6 +317,84 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::init(IOData && data)
+{
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    // pre-allocate memory
+    uint np = data.num_polys();
+    this->polys.reserve(np);
+    this->p2v.reserve(np);
+    this->p2e.reserve(np);
+    this->p2p.reserve(np);
+    this->p_data.reserve(np);
+    this->polys_face_winding.reserve(np);
+
+    // vertices have no connectivity yet: move them in bulk
+    if(this->verts.empty()) this->verts = std::move(data.verts);
+    else this->verts.insert(this->verts.end(), data.verts.begin(), data.verts.end());
+    uint nv = this->num_verts();
+    this->v_data.resize(nv);
+    this->v2v.resize(nv);
+    this->v2e.resize(nv);
+    this->v2f.resize(nv);
+    this->v2p.resize(nv);
+    this->update_bbox();
+
+    std::vector<uint> p;
+    for(uint pid=0; pid<np; ++pid)
+    {
+        p.assign(data.poly_begin(pid), data.poly_end(pid));
+        poly_add(p);
+    }
+
+    finalize_init();
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    std::cout << "load mesh\t"     <<
+                 this->num_verts() << "V / " <<
+                 this->num_edges() << "E / " <<
+                 this->num_faces() << "F / " <<
+                 this->num_polys() << "P  [" <<
+                 how_many_seconds(t0,t1) << "s]" << std::endl;
+
+    if(data.vert_labels.size()==nv)
+    {
+        std::cout << "set vert labels" << std::endl;
+        for(uint vid=0; vid<nv; ++vid) this->vert_data(vid).label = data.vert_labels[vid];
+    }
+    if(data.vert_colors.size()==nv)
+    {
+        for(uint vid=0; vid<nv; ++vid) this->vert_data(vid).color = data.vert_colors[vid];
+    }
+    if(data.poly_labels.size()==this->num_polys())
+    {
+        std::cout << "set poly labels" << std::endl;
+        for(uint pid=0; pid<this->num_polys(); ++pid) this->poly_data(pid).label = data.poly_labels[pid];
+        this->poly_color_wrt_label();
+    }
+    if(data.poly_colors.size()==this->num_polys())
+    {
+        for(uint pid=0; pid<this->num_polys(); ++pid) this->poly_data(pid).color = data.poly_colors[pid];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::finalize_init()
+{
+    if(this->mesh_data().update_normals) this->update_v_normals();
+
+    this->copy_xyz_to_uvw(UVW_param);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 double AbstractPolyhedralMesh<M,V,E,F,P>::mesh_srf_area() const
@@ -305,6 +505,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::update_normals()
 {
     update_f_normals();
     update_v_normals();
+    this->invalidate_pick_index();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1972,6 +2173,8 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::vert_switch_id(const uint vid0, const ui
 {
     if(vid0 == vid1) return;
 
+    this->invalidate_pick_index();
+
     std::swap(this->verts.at(vid0),   this->verts.at(vid1));
     std::swap(this->v2v.at(vid0),     this->v2v.at(vid1));
     std::swap(this->v2e.at(vid0),     this->v2e.at(vid1));
@@ -2053,6 +2256,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::vert_remove_unreferenced(const uint vid)
 {
+    this->invalidate_pick_index();
     this->v2v.at(vid).clear();
     this->v2e.at(vid).clear();
     this->v2f.at(vid).clear();
@@ -2072,6 +2276,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::vert_add(const vec3d & pos)
 {
+    this->invalidate_pick_index();
     uint vid = this->num_verts();
     //
     this->verts.push_back(pos);
@@ -2099,6 +2304,8 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::edge_switch_id(const uint eid0, const ui
 {
     if (eid0 == eid1) return;
 
+    this->invalidate_pick_index();
+
     for(uint off=0; off<2; ++off) std::swap(this->edges.at(2*eid0+off), this->edges.at(2*eid1+off));
 
     std::swap(this->e2f.at(eid0),     this->e2f.at(eid1));
@@ -2152,6 +2359,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::edge_add(const uint vid0, const uint vid1)
 {
+    this->invalidate_pick_index();
     assert(this->edge_id(vid0, vid1)==-1); // make sure it doesn't exist already
     assert(vid0 < this->num_verts());
     assert(vid1 < this->num_verts());
@@ -2195,6 +2403,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::edge_remove_unreferenced(const uint eid)
 {
+    this->invalidate_pick_index();
     this->e2f.at(eid).clear();
     this->e2p.at(eid).clear();
     edge_switch_id(eid, this->num_edges()-1);
@@ -2214,6 +2423,8 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::face_switch_id(const uint fid0, const ui
 
     if (fid0 == fid1) return;
 
+    this->invalidate_pick_index();
+
     std::swap(this->faces.at(fid0),          this->faces.at(fid1));
     std::swap(this->f_data.at(fid0),         this->f_data.at(fid1));
     std::swap(this->f2e.at(fid0),            this->f2e.at(fid1));
@@ -2280,6 +2491,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::face_add(const std::vector<uint> & f)
 {
+    this->invalidate_pick_index();
     if(face_id(f)!=-1)
     {
         std::cout << ANSI_fg_color_red << "WARNING: adding duplicated face!" << ANSI_fg_color_default << std::endl;
@@ -2356,6 +2568,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::face_remove_unreferenced(const uint fid)
 {
+    this->invalidate_pick_index();
     this->faces.at(fid).clear();
     this->f2e.at(fid).clear();
     this->f2f.at(fid).clear();
@@ -2378,6 +2591,8 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_switch_id(const uint pid0, const ui
 {
     if (pid0 == pid1) return;
 
+    this->invalidate_pick_index();
+
     std::swap(this->polys.at(pid0),              this->polys.at(pid1));
     std::swap(this->p_data.at(pid0),             this->p_data.at(pid1));
     std::swap(this->p2v.at(pid0),                this->p2v.at(pid1));
@@ -2445,6 +2660,7 @@ CINO_INLINE
 uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_add(const std::vector<uint> & flist,
                                                  const std::vector<bool> & fwinding)
 {
+    this->invalidate_pick_index();
     if(poly_id(flist)!=-1)
     {
         std::cout << ANSI_fg_color_red << "WARNING: adding duplicated poly!" << ANSI_fg_color_default << std::endl;
@@ -2721,6 +2937,7 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::poly_remove_unreferenced(const uint pid)
 {
+    this->invalidate_pick_index();
     this->polys.at(pid).clear();
     this->p2v.at(pid).clear();
     this->p2e.at(pid).clear();
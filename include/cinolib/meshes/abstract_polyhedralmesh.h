@@ -39,6 +39,7 @@
 #include <cinolib/meshes/abstract_mesh.h>
 #include <cinolib/meshes/mesh_attributes.h>
 #include <cinolib/ipair.h>
+#include <cinolib/io/io_data.h>
 
 namespace cinolib
 {
@@ -66,6 +67,9 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         std::vector<std::vector<uint>> face_triangles; // per face serialized triangulation (e.g., for rendering)
 
+        mutable BVH  bvh_faces; // spatial index for ray picking (see AbstractMesh::invalidate_pick_index)
+        mutable uint bvh_faces_rev = 0;
+
     public:
 
         typedef F F_type;
@@ -76,6 +80,7 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void clear() override;
+        void invalidate_pick_index() override;
 
         void init(const std::vector<vec3d>             & verts,
                   const std::vector<std::vector<uint>> & faces,
@@ -90,6 +95,10 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
                   const std::vector<int>               & vert_labels,
                   const std::vector<int>               & poly_labels);
 
+        void init(IOData && data); // consumes the output of a reader (no copies)
+
+        void finalize_init(); // completes init() on meshes built with vert_add/poly_add (e.g. by AsyncMeshLoader)
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         double mesh_srf_area() const;
@@ -310,6 +319,20 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
                 bool               poly_is_prism               (const uint pid, const uint fid) const; // check if it is a prism using fid as base
                 bool               poly_is_hexable_w_midpoint  (const uint pid) const; // check if this element can be hexed with midpoint subdivision
 
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    protected:
+
+        void binary_write(BinaryMeshWriter       & w) const override;
+        bool binary_read (const BinaryMeshReader & r) override;
+
+        const BVH & face_index() const;
+
+        bool pick_ray(const Ray               & r,
+                            uint              & pid,
+                            vec3d             & hit,
+                            std::vector<uint> & vids,
+                            std::vector<uint> & eids) const override;
 };
 
 }
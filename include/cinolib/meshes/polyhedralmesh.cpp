@@ -76,6 +76,14 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void Polyhedralmesh<M,V,E,F,P>::load(const char * filename)
 {
+    std::string ext = get_file_extension(std::string(filename));
+    if(ext.compare("cino") == 0 ||
+       ext.compare("CINO") == 0)
+    {
+        this->load_binary(filename);
+        return;
+    }
+
     this->clear();
     this->mesh_data().filename = std::string(filename);
 
@@ -83,8 +91,7 @@ void Polyhedralmesh<M,V,E,F,P>::load(const char * filename)
     std::vector<std::vector<uint>> tmp_faces;
     std::vector<std::vector<uint>> tmp_polys;
     std::vector<std::vector<bool>> tmp_polys_face_winding;
-    std::vector<int>               vert_labels;
-    std::vector<int>               poly_labels;
+    IOData                         data;
 
     std::string str(filename);
     std::string filetype = "." + get_file_extension(str);
@@ -104,20 +111,39 @@ void Polyhedralmesh<M,V,E,F,P>::load(const char * filename)
     else if (filetype.compare(".mesh") == 0 ||
              filetype.compare(".MESH") == 0)
     {
-        read_MESH(filename, tmp_verts, tmp_polys, vert_labels, poly_labels);
-        this->init(tmp_verts, tmp_polys, vert_labels, poly_labels);
+        read_MESH(filename, data);
+        this->init(std::move(data));
+    }
+    else if (filetype.compare(".meshb") == 0 ||
+             filetype.compare(".MESHB") == 0)
+    {
+        read_MESHB(filename, data);
+        this->init(std::move(data));
     }
     else if (filetype.compare(".vtu") == 0 ||
              filetype.compare(".VTU") == 0)
     {
-        read_VTU(filename, tmp_verts, tmp_polys);
-        this->init(tmp_verts, tmp_polys, vert_labels, poly_labels);
+        std::vector<VTUArray> point_data, cell_data;
+        read_VTU(filename, data.verts, tmp_polys, point_data, cell_data);
+        data.set_polys(tmp_polys);
+        for(const VTUArray & a : cell_data)
+        {
+            if(a.name=="label" && a.is_int && a.n_comp==1) data.poly_labels = a.int_data;
+        }
+        this->init(std::move(data));
+    }
+    else if (filetype.compare(".msh") == 0 ||
+             filetype.compare(".MSH") == 0)
+    {
+        read_MSH(filename, data);
+        this->init(std::move(data));
     }
     else if (filetype.compare(".vtk") == 0 ||
              filetype.compare(".VTK") == 0)
     {
-        read_VTK(filename, tmp_verts, tmp_polys);
-        this->init(tmp_verts, tmp_polys, vert_labels, poly_labels);
+        read_VTK(filename, data.verts, tmp_polys);
+        data.set_polys(tmp_polys);
+        this->init(std::move(data));
     }
     else
     {
@@ -143,6 +169,15 @@ void Polyhedralmesh<M,V,E,F,P>::save(const char * filename) const
         }
         else write_MESH(filename, this->verts, this->p2v);
     }
+    else if (filetype.compare("meshb") == 0 ||
+             filetype.compare("MESHB") == 0)
+    {
+        if(this->polys_are_labeled())
+        {
+            write_MESHB(filename, this->verts, this->p2v, std::vector<int>(), this->vector_poly_labels());
+        }
+        else write_MESHB(filename, this->verts, this->p2v);
+    }
     else if(filetype.compare("hedra") == 0 ||
        filetype.compare("HEDRA") == 0)
     {
@@ -153,6 +188,11 @@ void Polyhedralmesh<M,V,E,F,P>::save(const char * filename) const
     {
         write_OVM(filename, *this);
     }
+    else if (filetype.compare("cino") == 0 ||
+             filetype.compare("CINO") == 0)
+    {
+        this->save_binary(filename);
+    }
     else
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write() : file format not supported yet " << std::endl;
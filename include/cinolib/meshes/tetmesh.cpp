@@ -91,13 +91,19 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void Tetmesh<M,V,E,F,P>::load(const char * filename)
 {
+    std::string ext = get_file_extension(std::string(filename));
+    if(ext.compare("cino") == 0 ||
+       ext.compare("CINO") == 0)
+    {
+        this->load_binary(filename);
+        return;
+    }
+
     this->clear();
     this->mesh_data().filename = std::string(filename);
 
-    std::vector<vec3d>             tmp_verts;
-    std::vector<std::vector<uint>> tmp_polys;
-    std::vector<int>               vert_labels;
-    std::vector<int>               poly_labels;
+    IOData                         data;
+    std::vector<std::vector<uint>> tmp_polys; // for readers that do not fill IOData directly
 
     std::string str(filename);
     std::string filetype = "." + get_file_extension(str);
@@ -105,29 +111,47 @@ void Tetmesh<M,V,E,F,P>::load(const char * filename)
     if (filetype.compare(".mesh") == 0 ||
         filetype.compare(".MESH") == 0)
     {
-        read_MESH(filename, tmp_verts, tmp_polys, vert_labels, poly_labels);
+        read_MESH(filename, data);
+    }
+    else if (filetype.compare(".meshb") == 0 ||
+             filetype.compare(".MESHB") == 0)
+    {
+        read_MESHB(filename, data);
     }
     else if (filetype.compare(".vtu") == 0 ||
              filetype.compare(".VTU") == 0)
     {
-        read_VTU(filename, tmp_verts, tmp_polys);
+        std::vector<VTUArray> point_data, cell_data;
+        read_VTU(filename, data.verts, tmp_polys, point_data, cell_data);
+        data.set_polys(tmp_polys);
+        for(const VTUArray & a : cell_data)
+        {
+            if(a.name=="label" && a.is_int && a.n_comp==1) data.poly_labels = a.int_data;
+        }
+    }
+    else if (filetype.compare(".msh") == 0 ||
+             filetype.compare(".MSH") == 0)
+    {
+        read_MSH(filename, data);
     }
     else if (filetype.compare(".vtk") == 0 ||
              filetype.compare(".VTK") == 0)
     {
-        read_VTK(filename, tmp_verts, tmp_polys);
+        read_VTK(filename, data.verts, tmp_polys);
+        data.set_polys(tmp_polys);
     }
     else if (filetype.compare(".tet") == 0 ||
              filetype.compare(".TET") == 0)
     {
-        read_TET(filename, tmp_verts, tmp_polys);
+        read_TET(filename, data.verts, tmp_polys);
+        data.set_polys(tmp_polys);
     }
     else
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load() : file format not supported yet " << std::endl;
     }
 
-    this->init(tmp_verts, tmp_polys, vert_labels, poly_labels);
+    this->init(std::move(data));
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -148,6 +172,15 @@ void Tetmesh<M,V,E,F,P>::save(const char * filename) const
         }
         else write_MESH(filename, this->verts, this->p2v);
     }
+    else if (filetype.compare("meshb") == 0 ||
+             filetype.compare("MESHB") == 0)
+    {
+        if(this->polys_are_labeled())
+        {
+            write_MESHB(filename, this->verts, this->p2v, std::vector<int>(), this->vector_poly_labels());
+        }
+        else write_MESHB(filename, this->verts, this->p2v);
+    }
     else if (filetype.compare("tet") == 0 ||
              filetype.compare("TET") == 0)
     {
@@ -156,7 +189,15 @@ void Tetmesh<M,V,E,F,P>::save(const char * filename) const
     else if (filetype.compare("vtu") == 0 ||
              filetype.compare("VTU") == 0)
     {
-        write_VTU(filename, this->verts, this->p2v);
+        std::vector<VTUArray> cell_data;
+        if(this->polys_are_labeled()) cell_data.push_back(VTUArray("label", this->vector_poly_labels()));
+        write_VTU(filename, this->verts, this->p2v, {}, cell_data);
+    }
+    else if (filetype.compare("msh") == 0 ||
+             filetype.compare("MSH") == 0)
+    {
+        if(this->polys_are_labeled()) write_MSH(filename, this->verts, this->p2v, this->vector_poly_labels());
+        else                          write_MSH(filename, this->verts, this->p2v);
     }
     else if (filetype.compare("vtk") == 0 ||
              filetype.compare("VTK") == 0)
@@ -173,6 +214,11 @@ void Tetmesh<M,V,E,F,P>::save(const char * filename) const
     {
         write_OVM(filename, *this);
     }
+    else if (filetype.compare("cino") == 0 ||
+             filetype.compare("CINO") == 0)
+    {
+        this->save_binary(filename);
+    }
     else
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write() : file format not supported yet " << std::endl;
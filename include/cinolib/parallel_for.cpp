@@ -37,6 +37,7 @@
 #include <thread>
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 namespace cinolib
 {
@@ -96,4 +97,55 @@ static void PARALLEL_FOR(      uint   beg,
 #endif
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+T PARALLEL_PREFIX_SUM(      std::vector<T> & v,
+                      const uint             serial_if_less_than)
+{
+    uint n = uint(v.size());
+
+#ifndef SERIALIZE_PARALLEL_FOR
+    if(n>0 && n>=serial_if_less_than)
+    {
+        const static unsigned n_threads_hint = std::thread::hardware_concurrency();
+        const static unsigned n_threads      = (n_threads_hint==0u) ? 8u : n_threads_hint;
+
+        uint n_blocks = std::min(uint(n_threads), n);
+        uint slice    = (n + n_blocks - 1)/n_blocks;
+        std::vector<T> block_sum(n_blocks+1, T(0));
+
+        PARALLEL_FOR(0, n_blocks, 0, [&](uint b)
+        {
+            uint end = std::min(n, (b+1)*slice);
+            for(uint i=b*slice; i<end; ++i) block_sum[b+1] += v[i];
+        });
+        for(uint b=0; b<n_blocks; ++b) block_sum[b+1] += block_sum[b];
+
+        PARALLEL_FOR(0, n_blocks, 0, [&](uint b)
+        {
+            T    sum = block_sum[b];
+            uint end = std::min(n, (b+1)*slice);
+            for(uint i=b*slice; i<end; ++i)
+            {
+                T tmp = v[i];
+                v[i]  = sum;
+                sum  += tmp;
+            }
+        });
+        return block_sum[n_blocks];
+    }
+#endif
+
+    T sum = T(0);
+    for(uint i=0; i<n; ++i)
+    {
+        T tmp = v[i];
+        v[i]  = sum;
+        sum  += tmp;
+    }
+    return sum;
+}
+
 }
@@ -37,6 +37,7 @@
 #define CINO_PARALLEL_FOR_H
 
 #include <sys/types.h>
+#include <vector>
 #include <cinolib/cino_inline.h>
 
 namespace cinolib
@@ -85,6 +86,25 @@ static void PARALLEL_FOR(      uint   beg,
                                uint   end,
                          const uint   serial_if_less_than,
                          const Func & func);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Parallel exclusive prefix sum, computed in place. Typically used to turn
+ * per-element counts into offsets within a flat buffer that can then be
+ * filled in parallel with PARALLEL_FOR. E.g., given per poly triangle counts
+ *
+ *     cnt = { 2, 0, 1, 3, 0 }
+ *
+ * a call to PARALLEL_PREFIX_SUM(cnt,...) makes cnt = { 0, 2, 2, 3, 6 } and returns 6.
+ * The range is split into as many blocks as threads; each block is summed up
+ * in parallel, block offsets are accumulated serially, and a second parallel
+ * pass scans each block starting from its offset.
+*/
+
+template<typename T>
+CINO_INLINE
+T PARALLEL_PREFIX_SUM(      std::vector<T> & v,
+                      const uint             serial_if_less_than);
 }
 
 #ifndef  CINO_STATIC_LIB
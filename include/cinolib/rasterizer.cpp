@@ -0,0 +1,224 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/rasterizer.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void rasterize_triangles(const std::vector<vec3d> & verts,
+                         const std::vector<uint>  & tris,
+                         const uint                 w,
+                         const uint                 h,
+                               uint8_t            * mask,
+                               float              * depth,
+                         const bool                 parallel)
+{
+    const int64_t SUB   = 256;  // subpixel precision (8 bits)
+    const int     TILE  = 16;   // tile size (pixels)
+    const double  LIMIT = 1<<20; // larger coordinates would overflow 64 bits edge functions
+
+    // per triangle setup: edge functions E(x,y) = A*x + B*y + C, expressed in subpixel
+    // coordinates and biased so that the top-left rule becomes E>=0. Edge i is opposite
+    // to vertex i, hence E_i/area is the barycentric coordinate of vertex i
+    struct Setup
+    {
+        int64_t A[3], B[3], C[3], bias[3];
+        int     x0, y0, x1, y1; // pixel bbox (inclusive)
+        double  z[3];
+        double  area;
+        bool    valid;
+    };
+
+    uint n_tris = uint(tris.size()/3);
+    std::vector<Setup> setup(n_tris);
+    auto setup_tri = [&](const uint tid)
+    {
+        Setup & s = setup[tid];
+        s.valid = false;
+
+        vec3d p[3] = { verts[tris[3*tid]], verts[tris[3*tid+1]], verts[tris[3*tid+2]] };
+        double min_x = std::min(p[0].x(), std::min(p[1].x(), p[2].x()));
+        double max_x = std::max(p[0].x(), std::max(p[1].x(), p[2].x()));
+        double min_y = std::min(p[0].y(), std::min(p[1].y(), p[2].y()));
+        double max_y = std::max(p[0].y(), std::max(p[1].y(), p[2].y()));
+        if(max_x < 0 || max_y < 0 || min_x > w || min_y > h) return;
+        if(min_x < -LIMIT || min_y < -LIMIT || max_x > LIMIT || max_y > LIMIT) return;
+
+        int64_t X[3], Y[3];
+        for(int i=0; i<3; ++i)
+        {
+            X[i] = (int64_t)std::llround(p[i].x()*SUB);
+            Y[i] = (int64_t)std::llround(p[i].y()*SUB);
+        }
+        int64_t area = (X[1]-X[0])*(Y[2]-Y[0]) - (X[2]-X[0])*(Y[1]-Y[0]);
+        if(area==0) return;
+        if(area<0) // make it CCW
+        {
+            std::swap(X[1],X[2]);
+            std::swap(Y[1],Y[2]);
+            std::swap(p[1],p[2]);
+            area = -area;
+        }
+
+        for(int i=0; i<3; ++i)
+        {
+            int a = (i+1)%3;
+            int b = (i+2)%3;
+            s.A[i] = Y[a] - Y[b];
+            s.B[i] = X[b] - X[a];
+            s.C[i] = X[a]*Y[b] - Y[a]*X[b];
+            bool top  = (Y[a]==Y[b] && X[b]<X[a]);
+            bool left = (Y[b]<Y[a]);
+            s.bias[i] = (top || left) ? 0 : -1;
+            s.z[i]    = p[i].z();
+        }
+        s.area  = double(area);
+        s.x0    = std::max(0,     (int)std::floor(min_x-0.5));
+        s.y0    = std::max(0,     (int)std::floor(min_y-0.5));
+        s.x1    = std::min(int(w)-1, (int)std::ceil(max_x-0.5));
+        s.y1    = std::min(int(h)-1, (int)std::ceil(max_y-0.5));
+        s.valid = (s.x0<=s.x1 && s.y0<=s.y1);
+    };
+    if(parallel) PARALLEL_FOR(0, n_tris, 1000, setup_tri);
+    else for(uint tid=0; tid<n_tris; ++tid) setup_tri(tid);
+
+    // bin triangles into tiles (in input order, so that depth ties are resolved as OpenGL does)
+    int n_tx = (int(w)+TILE-1)/TILE;
+    int n_ty = (int(h)+TILE-1)/TILE;
+    std::vector<std::vector<uint>> bins(n_tx*n_ty);
+    for(uint tid=0; tid<n_tris; ++tid)
+    {
+        const Setup & s = setup[tid];
+        if(!s.valid) continue;
+        for(int ty=s.y0/TILE; ty<=s.y1/TILE; ++ty)
+        for(int tx=s.x0/TILE; tx<=s.x1/TILE; ++tx)
+        {
+            bins[ty*n_tx+tx].push_back(tid);
+        }
+    }
+
+    auto raster_tile = [&](const uint tile)
+    {
+        int tx0 = (tile%n_tx)*TILE;
+        int ty0 = (tile/n_tx)*TILE;
+        int tx1 = std::min(int(w),tx0+TILE)-1;
+        int ty1 = std::min(int(h),ty0+TILE)-1;
+
+        // edge function sampled at the center of pixel (x,y)
+        auto E = [&](const Setup & s, const int i, const int x, const int y) -> int64_t
+        {
+            return s.A[i]*(x*SUB+SUB/2) + s.B[i]*(y*SUB+SUB/2) + s.C[i] + s.bias[i];
+        };
+
+        for(uint tid : bins[tile])
+        {
+            const Setup & s = setup[tid];
+
+            // coverage only: if all the tile corners are inside the triangle the whole tile is
+            // covered, and no other triangle can change it
+            if(depth==nullptr)
+            {
+                bool full = true;
+                for(int i=0; i<3 && full; ++i)
+                {
+                    full = E(s,i,tx0,ty0)>=0 && E(s,i,tx1,ty0)>=0 &&
+                           E(s,i,tx0,ty1)>=0 && E(s,i,tx1,ty1)>=0;
+                }
+                if(full)
+                {
+                    for(int y=ty0; y<=ty1; ++y) std::memset(mask + y*w + tx0, 0xFF, tx1-tx0+1);
+                    return;
+                }
+            }
+
+            int x0 = std::max(tx0, s.x0);
+            int x1 = std::min(tx1, s.x1);
+            int y0 = std::max(ty0, s.y0);
+            int y1 = std::min(ty1, s.y1);
+            if(x0>x1 || y0>y1) continue;
+
+            int64_t step[3] = { s.A[0]*SUB, s.A[1]*SUB, s.A[2]*SUB };
+            for(int y=y0; y<=y1; ++y)
+            {
+                int64_t e0 = E(s,0,x0,y);
+                int64_t e1 = E(s,1,x0,y);
+                int64_t e2 = E(s,2,x0,y);
+                uint8_t *row = mask + y*w;
+                if(depth==nullptr)
+                {
+                    for(int x=x0; x<=x1; ++x)
+                    {
+                        row[x] |= ((e0|e1|e2)>=0) ? 0xFF : 0x00;
+                        e0 += step[0];
+                        e1 += step[1];
+                        e2 += step[2];
+                    }
+                }
+                else
+                {
+                    float *zrow = depth + y*w;
+                    for(int x=x0; x<=x1; ++x)
+                    {
+                        if((e0|e1|e2)>=0)
+                        {
+                            // barycentric interpolation (remove the top-left bias)
+                            double z = (double(e0-s.bias[0])*s.z[0] +
+                                        double(e1-s.bias[1])*s.z[1] +
+                                        double(e2-s.bias[2])*s.z[2])/s.area;
+                            if(z<zrow[x])
+                            {
+                                zrow[x] = float(z);
+                                row[x]  = 0xFF;
+                            }
+                        }
+                        e0 += step[0];
+                        e1 += step[1];
+                        e2 += step[2];
+                    }
+                }
+            }
+        }
+    };
+    if(parallel) PARALLEL_FOR(0, uint(bins.size()), 16, raster_tile);
+    else for(uint tile=0; tile<bins.size(); ++tile) raster_tile(tile);
+}
+
+}
@@ -0,0 +1,82 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_RASTERIZER_H
+#define CINO_RASTERIZER_H
+
+#include <cinolib/geometry/vec_mat.h>
+#include <vector>
+
+namespace cinolib
+{
+
+/* Tile based CPU rasterizer for triangle soups, meant to replace offline OpenGL
+ * contexts in headless environments (e.g. for shadow/coverage computations).
+ * Vertices are expressed in window coordinates: x,y in pixels, with the origin
+ * in the bottom left corner of the image (as in OpenGL), and z in [0,1].
+ *
+ * Pixels are sampled at their centers. Vertices are snapped to a subpixel grid
+ * (1/256 of a pixel) and edge functions are evaluated in integer arithmetic,
+ * breaking ties with the top-left rule. Each pixel is therefore covered by at
+ * most one of two triangles sharing an edge, and results match the rasterization
+ * of OpenGL implementations up to the pixels touched by silhouette edges.
+ *
+ * The image is split into square tiles, each processed with the triangles that
+ * overlap it. Tiles fully covered by a triangle are filled at once, and inner
+ * loops are branchless, so that they can be vectorized by the compiler.
+ * If parallel is true tiles are processed on multiple threads.
+ *
+ * Covered pixels are set to 0xFF in mask (w x h buffer, 8 bits per pixel).
+ * If depth is not null, it is used as a depth buffer (w x h floats, to be
+ * initialized by the caller): a pixel is written only if the interpolated z
+ * is smaller than the current depth.
+*/
+
+CINO_INLINE
+void rasterize_triangles(const std::vector<vec3d> & verts,
+                         const std::vector<uint>  & tris,
+                         const uint                 w,
+                         const uint                 h,
+                               uint8_t            * mask,
+                               float              * depth    = nullptr,
+                         const bool                 parallel = true);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "rasterizer.cpp"
+#endif
+
+#endif // CINO_RASTERIZER_H
@@ -0,0 +1,263 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/sparse_voxel_grid.h>
+#include <cinolib/serialize_index.h>
+#include <algorithm>
+#include <climits>
+#include <cassert>
+
+namespace cinolib
+{
+
+CINO_INLINE
+uint SparseVoxelGrid::code_of(const int flag)
+{
+    switch(flag)
+    {
+        case VOXEL_UNKNOWN  : return 0;
+        case VOXEL_OUTSIDE  : return 1;
+        case VOXEL_INSIDE   : return 2;
+        case VOXEL_BOUNDARY : return 3;
+        default: assert(false && "SparseVoxelGrid: voxels can have only one flag");
+    }
+    return 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int SparseVoxelGrid::flag_of(const uint code)
+{
+    static const int flags[4] = { VOXEL_UNKNOWN, VOXEL_OUTSIDE, VOXEL_INSIDE, VOXEL_BOUNDARY };
+    return flags[code];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint SparseVoxelGrid::local_index(const uint i, const uint j, const uint k)
+{
+    return ((i & 7) << 6) | ((j & 7) << 3) | (k & 7);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseVoxelGrid::init(const AABB   & bbox,
+                           const double   len,
+                           const uint     dim[3],
+                           const int      flag)
+{
+    clear();
+    this->bbox = bbox;
+    this->len  = len;
+    for(uint i=0; i<3; ++i)
+    {
+        this->dim[i] = dim[i];
+        bdim[i]      = (dim[i] + BLOCK_SIZE - 1)/BLOCK_SIZE;
+    }
+    header.assign(size_t(bdim[0])*bdim[1]*bdim[2], UNIFORM + code_of(flag));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseVoxelGrid::clear()
+{
+    header.clear();
+    leaf_block.clear();
+    leaf_data.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint SparseVoxelGrid::block_id(const uint i, const uint j, const uint k) const
+{
+    return serialize_3D_index(i/BLOCK_SIZE, j/BLOCK_SIZE, k/BLOCK_SIZE, bdim[1], bdim[2]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseVoxelGrid::block_range(const uint bid, uint beg[3], uint end[3]) const
+{
+    vec3u b = deserialize_3D_index(bid, bdim[1], bdim[2]);
+    for(uint i=0; i<3; ++i)
+    {
+        beg[i] = b[i]*BLOCK_SIZE;
+        end[i] = std::min(beg[i]+BLOCK_SIZE, dim[i]);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int SparseVoxelGrid::get(const uint i, const uint j, const uint k) const
+{
+    assert(i<dim[0] && j<dim[1] && k<dim[2]);
+    uint h = header[block_id(i,j,k)];
+    if(h>=UNIFORM) return flag_of(h-UNIFORM);
+    uint l = local_index(i,j,k);
+    return flag_of((leaf_data[h*WORDS + (l>>5)] >> (2*(l&31))) & 3);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int SparseVoxelGrid::get(const uint ijk[3]) const
+{
+    return get(ijk[0], ijk[1], ijk[2]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseVoxelGrid::set(const uint i, const uint j, const uint k, const int flag)
+{
+    assert(i<dim[0] && j<dim[1] && k<dim[2]);
+    uint bid  = block_id(i,j,k);
+    uint code = code_of(flag);
+    if(header[bid]>=UNIFORM)
+    {
+        if(header[bid]==UNIFORM+code) return;
+        block_activate(bid);
+    }
+    uint       l = local_index(i,j,k);
+    uint64_t & w = leaf_data[header[bid]*WORDS + (l>>5)];
+    w = (w & ~(uint64_t(3) << (2*(l&31)))) | (uint64_t(code) << (2*(l&31)));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseVoxelGrid::set(const uint ijk[3], const int flag)
+{
+    set(ijk[0], ijk[1], ijk[2], flag);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int SparseVoxelGrid::block_flag(const uint bid) const
+{
+    assert(block_is_uniform(bid));
+    return flag_of(header[bid]-UNIFORM);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseVoxelGrid::block_fill(const uint bid, const int flag)
+{
+    if(header[bid]<UNIFORM)
+    {
+        // release the active block, moving the last one in its slot
+        // to keep the list of active blocks compact
+        uint l    = header[bid];
+        uint last = uint(leaf_block.size())-1;
+        if(l!=last)
+        {
+            leaf_block[l] = leaf_block[last];
+            header[leaf_block[l]] = l;
+            std::copy(leaf_data.begin()+last*WORDS, leaf_data.end(), leaf_data.begin()+l*WORDS);
+        }
+        leaf_block.pop_back();
+        leaf_data.resize(last*WORDS);
+    }
+    header[bid] = UNIFORM + code_of(flag);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseVoxelGrid::block_activate(const uint bid)
+{
+    if(header[bid]<UNIFORM) return;
+
+    // replicate the 2 bits code of the block in all the voxels
+    uint64_t pattern = uint64_t(header[bid]-UNIFORM) * 0x5555555555555555ull;
+    header[bid] = uint(leaf_block.size());
+    leaf_block.push_back(bid);
+    leaf_data.insert(leaf_data.end(), WORDS, pattern);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseVoxelGrid::collapse()
+{
+    std::vector<uint>     new_block;
+    std::vector<uint64_t> new_data;
+    for(uint l=0; l<leaf_block.size(); ++l)
+    {
+        uint bid = leaf_block[l];
+
+        // check whether all the voxels in the block (ignoring the
+        // padding of blocks that exceed the grid size) are the same
+        uint beg[3], end[3];
+        block_range(bid, beg, end);
+        int  flag    = get(beg[0], beg[1], beg[2]);
+        bool uniform = true;
+        for(uint i=beg[0]; i<end[0] && uniform; ++i)
+        for(uint j=beg[1]; j<end[1] && uniform; ++j)
+        for(uint k=beg[2]; k<end[2] && uniform; ++k)
+        {
+            uniform = (get(i,j,k)==flag);
+        }
+
+        if(uniform) header[bid] = UNIFORM + code_of(flag); else
+        {
+            header[bid] = uint(new_block.size());
+            new_block.push_back(bid);
+            new_data.insert(new_data.end(), leaf_data.begin()+l*WORDS, leaf_data.begin()+(l+1)*WORDS);
+        }
+    }
+    leaf_block.swap(new_block);
+    leaf_data.swap(new_data);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t SparseVoxelGrid::memory_footprint() const
+{
+    return header.capacity()     * sizeof(uint) +
+           leaf_block.capacity() * sizeof(uint) +
+           leaf_data.capacity()  * sizeof(uint64_t);
+}
+
+}
@@ -0,0 +1,134 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SPARSE_VOXEL_GRID_H
+#define CINO_SPARSE_VOXEL_GRID_H
+
+#include <cinolib/voxel_grid.h>
+
+namespace cinolib
+{
+
+/* Sparse counterpart of VoxelGrid, meant for high resolution grids (e.g. 2048^3) where
+ * the dense array of voxels would not fit in memory. The grid is partitioned in blocks
+ * of 8x8x8 voxels. Blocks where all voxels have the same flag (e.g. deep inside or far
+ * outside the object) are stored as a single value. Only the active blocks, that is, the
+ * blocks with mixed content (typically the thin shell traversed by the boundary), store
+ * per voxel flags, packed in 2 bits per voxel (128 bytes per block).
+ *
+ * Block headers are stored in a flat array (4 bytes per block, that is 1/128 of a byte
+ * per voxel), hence access to a voxel costs two lookups. Voxels are addressed by their
+ * (i,j,k) coordinates (serialized indices would overflow 32 bits at high resolutions),
+ * and blocks by a serialized index in the (coarser) grid of blocks.
+ *
+ * Writing voxels of distinct active blocks from different threads is safe. Writing a
+ * voxel in a uniform block activates it (allocating memory), and is not thread safe.
+*/
+
+class SparseVoxelGrid
+{
+    public:
+
+        static const uint BLOCK_SIZE   = 8;   // voxels per block side
+        static const uint BLOCK_VOXELS = 512; // voxels per block
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        explicit SparseVoxelGrid(){}
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void init(const AABB   & bbox,
+                  const double   len,
+                  const uint     dim[3],
+                  const int      flag = VOXEL_UNKNOWN); // initial flag of all voxels
+
+        void clear();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        int  get(const uint i, const uint j, const uint k) const;
+        int  get(const uint ijk[3]) const;
+        void set(const uint i, const uint j, const uint k, const int flag);
+        void set(const uint ijk[3], const int flag);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint num_blocks() const { return uint(header.size()); }
+        uint num_active_blocks() const { return uint(leaf_block.size()); }
+        uint active_block(const uint i) const { return leaf_block.at(i); } // i-th active block (serialized index)
+
+        uint block_id(const uint i, const uint j, const uint k) const; // block containing voxel (i,j,k)
+        void block_range(const uint bid, uint beg[3], uint end[3]) const; // voxels in [beg,end)
+        bool block_is_uniform(const uint bid) const { return header.at(bid)>=UNIFORM; }
+        int  block_flag(const uint bid) const; // flag of all the voxels in a uniform block
+        void block_fill(const uint bid, const int flag); // set all voxels in a block (making it uniform, not thread safe)
+        void block_activate(const uint bid); // store per voxel flags (not thread safe)
+
+        // turns active blocks with uniform content back into uniform blocks, releasing memory
+        void collapse();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        size_t memory_footprint() const; // bytes
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint   dim[3]  = {0,0,0}; // number of voxels along XYZ axis
+        uint   bdim[3] = {0,0,0}; // number of blocks along XYZ axis
+        AABB   bbox;              // bounding box
+        double len     = 0;       // per voxel edge length
+
+    protected:
+
+        static const uint UNIFORM = 0xFFFFFFFC; // headers >= UNIFORM encode a uniform block (flag code in the lowest 2 bits)
+        static const uint WORDS   = 16;         // 64 bit words per active block
+
+        static uint code_of(const int flag);
+        static int  flag_of(const uint code);
+        static uint local_index(const uint i, const uint j, const uint k);
+
+        std::vector<uint>     header;     // per block: position in the list of active blocks, or UNIFORM + code
+        std::vector<uint>     leaf_block; // per active block: block id
+        std::vector<uint64_t> leaf_data;  // per active block: 512 voxels, 2 bits each
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "sparse_voxel_grid.cpp"
+#endif
+
+#endif // CINO_SPARSE_VOXEL_GRID_H
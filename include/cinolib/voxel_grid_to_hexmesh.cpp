@@ -34,10 +34,152 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/voxel_grid_to_hexmesh.h>
+#include <cinolib/serialize_index.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/string_utilities.h>
+#include <cinolib/io/buffered_text_writer.h>
+#include <cinolib/io/write_MESHB.h>
+#include <cinolib/io/write_VTU.h>
+#include <unordered_map>
+#include <iostream>
+#include <climits>
+#include <thread>
 
 namespace cinolib
 {
 
+// adds to m the hexahedron with the given vertices (ordered as in REFERENCE_HEX_VERTS),
+// re-using the faces it shares with previously added hexahedra
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+uint voxel_to_hex(AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                  const std::vector<uint>           & verts)
+{
+    std::vector<uint> faces(6);
+    std::vector<bool> winding(6,false);
+
+    // make faces
+    for(uint off=0; off<6; ++off)
+    {
+        std::vector<uint> face =
+        {
+            verts[HEXA_FACES[off][0]],
+            verts[HEXA_FACES[off][1]],
+            verts[HEXA_FACES[off][2]],
+            verts[HEXA_FACES[off][3]]
+        };
+        int fid = m.face_id(face);
+        if(fid<0)
+        {
+            fid = m.face_add(face);
+            winding[off] = true;
+        }
+        faces[off] = fid;
+    }
+    // add voxel
+    return m.poly_add(faces,winding);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// numbers the voxel corners of the i-th plane of corners (orthogonal to the X axis) that
+// are incident to at least one selected voxel. Corners are numbered in scanline order,
+// starting from base, and stored in ids, a (dim[1]+1)*(dim[2]+1) map where unused corners
+// are set to UINT_MAX. The numbering of a plane only depends on the two layers of voxels
+// incident to it, hence planes can be processed in any order (and in parallel).
+// Returns the number of used corners
+CINO_INLINE
+uint voxel_grid_corner_plane(const VoxelGrid         & g,
+                             const int                 voxel_types,
+                             const uint                i,
+                             const uint                base,
+                                   std::vector<uint> & ids)
+{
+    const uint d1 = g.dim[1];
+    const uint d2 = g.dim[2];
+    ids.assign((d1+1)*(d2+1), UINT_MAX);
+
+    for(uint l=(i>0)?i-1:0; l<=i && l<g.dim[0]; ++l)
+    {
+        const int * layer = g.voxels + serialize_3D_index(l,0,0,d1,d2);
+        for(uint j=0; j<d1; ++j)
+        for(uint k=0; k<d2; ++k)
+        {
+            if(layer[j*d2+k] & voxel_types)
+            {
+                ids[ j   *(d2+1)+k  ] = 0;
+                ids[ j   *(d2+1)+k+1] = 0;
+                ids[(j+1)*(d2+1)+k  ] = 0;
+                ids[(j+1)*(d2+1)+k+1] = 0;
+            }
+        }
+    }
+
+    uint count = 0;
+    for(uint & id : ids) if(id!=UINT_MAX) id = base + count++;
+    return count;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// counts the used corners of each plane and the selected voxels of each layer,
+// and turns both counts into offsets (i.e. the first id owned by each plane/layer).
+// Returns the total number of vertices and hexahedra in nv and nh
+CINO_INLINE
+void voxel_grid_slice_offsets(const VoxelGrid         & g,
+                              const int                 voxel_types,
+                                    std::vector<uint> & v_off,
+                                    std::vector<uint> & h_off,
+                                    uint              & nv,
+                                    uint              & nh)
+{
+    const uint d0 = g.dim[0];
+    const uint d1 = g.dim[1];
+    const uint d2 = g.dim[2];
+    v_off.assign(d0+1, 0);
+    h_off.assign(d0,   0);
+
+    PARALLEL_FOR(0, d0+1, 8, [&](uint i)
+    {
+        std::vector<uint> ids;
+        v_off[i] = voxel_grid_corner_plane(g, voxel_types, i, 0, ids);
+        if(i<d0)
+        {
+            const int * layer = g.voxels + serialize_3D_index(i,0,0,d1,d2);
+            for(uint id=0; id<d1*d2; ++id) if(layer[id] & voxel_types) ++h_off[i];
+        }
+    });
+
+    nv = PARALLEL_PREFIX_SUM(v_off, 1024);
+    nh = PARALLEL_PREFIX_SUM(h_off, 1024);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// fetches the vertex ids of voxel (j,k) of a layer of voxels, given the corner maps of the
+// two planes bounding it (see voxel_grid_corner_plane). Vertices are ordered as in REFERENCE_HEX_VERTS
+CINO_INLINE
+void voxel_grid_hex_verts(const std::vector<uint> & lo,
+                          const std::vector<uint> & hi,
+                          const uint                d2,
+                          const uint                j,
+                          const uint                k,
+                                uint              * verts)
+{
+    const uint row0 =  j   *(d2+1)+k;
+    const uint row1 = (j+1)*(d2+1)+k;
+    verts[0] = lo[row0  ];
+    verts[1] = hi[row0  ];
+    verts[2] = hi[row1  ];
+    verts[3] = lo[row1  ];
+    verts[4] = lo[row0+1];
+    verts[5] = hi[row0+1];
+    verts[6] = hi[row1+1];
+    verts[7] = lo[row1+1];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 // Converts a voxel grid into a hexahedral mesh. Users can select what voxel types
 // can be retained in the output mesh. Legal choices are combinations of the following
 // types:
@@ -51,52 +193,312 @@ void voxel_grid_to_hexmesh(const VoxelGrid                         & g,
                                  AbstractPolyhedralMesh<M,V,E,F,P> & m,
                            const int voxel_types)
 {
-    uint n_voxel =  g.dim[0]   * g.dim[1]   * g.dim[2];
-    uint n_verts = (g.dim[0]+1)*(g.dim[1]+1)*(g.dim[2]+1);
-    std::vector<int> vert_map(n_verts,-1); // to keep track of already existing vertices
-    for(uint id=0; id<n_voxel; ++id)
+    std::vector<vec3d> verts;
+    std::vector<uint>  hexa;
+    std::vector<int>   labels;
+    voxel_grid_to_hexmesh(g, verts, hexa, labels, voxel_types);
+
+    uint v_base = m.num_verts();
+    for(const vec3d & p : verts) m.vert_add(p);
+
+    // hexahedra come in voxel order, therefore the faces shared with the voxels below
+    // along X, Y and Z have already been created. Their ids are kept in rolling buffers
+    // (-1 if the neighbor is not in the mesh), so that no face lookup is ever needed
+    const uint d1 = g.dim[1];
+    const uint d2 = g.dim[2];
+    std::vector<int> prev_x(d1*d2), curr_x(d1*d2), curr_y(d1*d2);
+    uint h = 0;
+    for(uint i=0; i<g.dim[0]; ++i)
     {
-        if(g.voxels[id] & voxel_types)
+        std::swap(prev_x, curr_x);
+        std::fill(curr_x.begin(), curr_x.end(), -1);
+        std::fill(curr_y.begin(), curr_y.end(), -1);
+        const int * layer = g.voxels + serialize_3D_index(i,0,0,d1,d2);
+        for(uint j=0; j<d1; ++j)
         {
-            vec3u ijk = deserialize_3D_index(id,g.dim[1],g.dim[2]);
+            int prev_z = -1;
+            for(uint k=0; k<d2; ++k)
+            {
+                uint id = j*d2+k;
+                if(!(layer[id] & voxel_types))
+                {
+                    prev_z = -1;
+                    continue;
+                }
+
+                int shared[6] =
+                {
+                    prev_z,                                  // -Z (f0)
+                    -1,                                      // +X (f1)
+                    -1,                                      // +Z (f2)
+                    (i>0) ? prev_x[id] : -1,                 // -X (f3)
+                    (j>0) ? curr_y[id-d2] : -1,              // -Y (f4)
+                    -1                                       // +Y (f5)
+                };
+
+                std::vector<uint> faces(6);
+                std::vector<bool> winding(6,false);
+                for(uint off=0; off<6; ++off)
+                {
+                    if(shared[off]>=0)
+                    {
+                        faces[off] = shared[off];
+                        continue;
+                    }
+                    std::vector<uint> face =
+                    {
+                        v_base + hexa[8*h+HEXA_FACES[off][0]],
+                        v_base + hexa[8*h+HEXA_FACES[off][1]],
+                        v_base + hexa[8*h+HEXA_FACES[off][2]],
+                        v_base + hexa[8*h+HEXA_FACES[off][3]]
+                    };
+                    faces[off]   = m.face_add(face);
+                    winding[off] = true;
+                }
+                uint pid = m.poly_add(faces,winding);
+                m.poly_data(pid).label = labels[h];
 
-            std::vector<uint> verts(8);
-            std::vector<uint> faces(6);
-            std::vector<bool> winding(6,false);
+                prev_z     = faces[2];
+                curr_x[id] = faces[1];
+                curr_y[id] = faces[5];
+                ++h;
+            }
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void voxel_grid_to_hexmesh(const VoxelGrid         & g,
+                                 std::vector<vec3d> & verts,
+                                 std::vector<uint>  & hexa,
+                                 std::vector<int>   & labels,
+                           const int voxel_types)
+{
+    verts.clear();
+    hexa.clear();
+    labels.clear();
+    const uint d0 = g.dim[0];
+    const uint d1 = g.dim[1];
+    const uint d2 = g.dim[2];
+    if(d0==0 || d1==0 || d2==0) return;
 
-            // make verts
-            for(uint off=0; off<8; ++off)
+    std::vector<uint> v_off, h_off;
+    uint nv, nh;
+    voxel_grid_slice_offsets(g, voxel_types, v_off, h_off, nv, nh);
+    verts.resize(nv);
+    hexa.resize(8*size_t(nh));
+    labels.resize(nh);
+
+    // each slab of layers walks its planes of corners keeping only two corner maps
+    // at a time, and fills its own (disjoint) portion of the output arrays
+    uint n_threads = std::max(1u, std::thread::hardware_concurrency());
+    uint n_slabs   = std::min(d0, 4*n_threads);
+    PARALLEL_FOR(0, n_slabs, 2, [&](uint s)
+    {
+        uint beg = uint(uint64_t(d0)*s/n_slabs);
+        uint end = uint(uint64_t(d0)*(s+1)/n_slabs);
+
+        auto plane_verts = [&](const uint i, const std::vector<uint> & ids)
+        {
+            for(uint j=0; j<=d1; ++j)
+            for(uint k=0; k<=d2; ++k)
             {
-                uint index = voxel_corner_index(g, ijk.ptr(), off);
-                if(vert_map[index]<0)
+                uint vid = ids[j*(d2+1)+k];
+                if(vid==UINT_MAX) continue;
+                uint ijk[3] = { i, j, k };
+                verts[vid] = voxel_corner_xyz(g, ijk, 0);
+            }
+        };
+
+        std::vector<uint> lo, hi;
+        voxel_grid_corner_plane(g, voxel_types, beg, v_off[beg], lo);
+        for(uint i=beg; i<end; ++i)
+        {
+            voxel_grid_corner_plane(g, voxel_types, i+1, v_off[i+1], hi);
+            plane_verts(i, lo);
+            if(i+1==d0) plane_verts(d0, hi);
+
+            uint h = h_off[i];
+            const int * layer = g.voxels + serialize_3D_index(i,0,0,d1,d2);
+            for(uint j=0; j<d1; ++j)
+            for(uint k=0; k<d2; ++k)
+            {
+                int flag = layer[j*d2+k];
+                if(flag & voxel_types)
                 {
-                    vec3d p = voxel_corner_xyz(g,ijk.ptr(),off);
-                    vert_map[index] = m.vert_add(p);
+                    voxel_grid_hex_verts(lo, hi, d2, j, k, &hexa[8*size_t(h)]);
+                    labels[h++] = flag;
                 }
-                verts[off] = vert_map[index];
             }
+            std::swap(lo, hi);
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void voxel_grid_to_hexmesh(const VoxelGrid & g,
+                           const char      * filename,
+                           const int         voxel_types)
+{
+    std::string filetype = get_file_extension(std::string(filename));
 
-            // make faces
-            for(uint off=0; off<6; ++off)
+    if(filetype.compare("mesh") == 0 ||
+       filetype.compare("MESH") == 0)
+    {
+        const uint d0 = g.dim[0];
+        const uint d1 = g.dim[1];
+        const uint d2 = g.dim[2];
+
+        std::vector<uint> v_off, h_off;
+        uint nv = 0, nh = 0;
+        if(d0>0 && d1>0 && d2>0) voxel_grid_slice_offsets(g, voxel_types, v_off, h_off, nv, nh);
+
+        setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+
+        FILE *fp = fopen(filename, "w");
+
+        if(!fp)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : voxel_grid_to_hexmesh() : couldn't write output file " << filename << std::endl;
+            exit(-1);
+        }
+
+        fprintf(fp, "MeshVersionFormatted 1\n" );
+        fprintf(fp, "Dimension 3\n" );
+
+        // one item per plane of corners (or layer of voxels): each thread formats
+        // a whole slice at a time, and memory is bounded by the slice size
+        if(nv > 0)
+        {
+            fprintf(fp, "Vertices\n" );
+            fprintf(fp, "%d\n", nv);
+            write_parallel(fp, d0+1, [&](const uint i, TextBuffer & buf)
             {
-                std::vector<uint> face =
+                std::vector<uint> ids;
+                voxel_grid_corner_plane(g, voxel_types, i, 0, ids);
+                for(uint j=0; j<=d1; ++j)
+                for(uint k=0; k<=d2; ++k)
                 {
-                    verts[HEXA_FACES[off][0]],
-                    verts[HEXA_FACES[off][1]],
-                    verts[HEXA_FACES[off][2]],
-                    verts[HEXA_FACES[off][3]]
-                };
-                int fid = m.face_id(face);
-                if(fid<0)
+                    if(ids[j*(d2+1)+k]==UINT_MAX) continue;
+                    uint  ijk[3] = { i, j, k };
+                    vec3d p      = voxel_corner_xyz(g, ijk, 0);
+                    buf.put(p.x()); buf.put(' ');
+                    buf.put(p.y()); buf.put(' ');
+                    buf.put(p.z()); buf.put(' ');
+                    buf.put(0);
+                    buf.put('\n');
+                }
+            }, 1);
+        }
+
+        if(nh > 0)
+        {
+            fprintf(fp, "Hexahedra\n" );
+            fprintf(fp, "%d\n", nh );
+            write_parallel(fp, d0, [&](const uint i, TextBuffer & buf)
+            {
+                std::vector<uint> lo, hi;
+                voxel_grid_corner_plane(g, voxel_types, i,   v_off[i],   lo);
+                voxel_grid_corner_plane(g, voxel_types, i+1, v_off[i+1], hi);
+                const int * layer = g.voxels + serialize_3D_index(i,0,0,d1,d2);
+                for(uint j=0; j<d1; ++j)
+                for(uint k=0; k<d2; ++k)
                 {
-                    fid = m.face_add(face);
-                    winding[off] = true;
+                    int flag = layer[j*d2+k];
+                    if(flag & voxel_types)
+                    {
+                        uint hex[8];
+                        voxel_grid_hex_verts(lo, hi, d2, j, k, hex);
+                        for(uint vid : hex) { buf.put(vid+1); buf.put(' '); }
+                        buf.put(flag);
+                        buf.put('\n');
+                    }
+                }
+            }, 1);
+        }
+
+        fprintf(fp, "End\n\n");
+        fclose(fp);
+        return;
+    }
+
+    std::vector<vec3d> verts;
+    std::vector<uint>  hexa;
+    std::vector<int>   labels;
+    voxel_grid_to_hexmesh(g, verts, hexa, labels, voxel_types);
+    std::vector<std::vector<uint>> polys(labels.size());
+    for(size_t pid=0; pid<polys.size(); ++pid) polys[pid].assign(hexa.begin()+8*pid, hexa.begin()+8*(pid+1));
+
+    if(filetype.compare("meshb") == 0 ||
+       filetype.compare("MESHB") == 0)
+    {
+        write_MESHB(filename, verts, polys, std::vector<int>(), labels);
+    }
+    else if(filetype.compare("vtu") == 0 ||
+            filetype.compare("VTU") == 0)
+    {
+        write_VTU(filename, verts, polys, {}, { VTUArray("label", labels) });
+    }
+    else
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : voxel_grid_to_hexmesh() : file format not supported yet " << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void voxel_grid_to_hexmesh(const SparseVoxelGrid                   & g,
+                                 AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                           const int voxel_types)
+{
+    // corners are identified by their serialized index in the (dim+1)^3 grid
+    // of voxel corners, which may exceed 32 bits at high resolutions
+    auto corner_key = [&](const uint ijk[3], const uint off) -> uint64_t
+    {
+        return (uint64_t(ijk[0] + uint(REFERENCE_HEX_VERTS[off][0])) * (g.dim[1]+1) +
+                uint64_t(ijk[1] + uint(REFERENCE_HEX_VERTS[off][1]))) * (g.dim[2]+1) +
+                uint64_t(ijk[2] + uint(REFERENCE_HEX_VERTS[off][2]));
+    };
+
+    std::unordered_map<uint64_t,uint> vert_map; // to keep track of already existing vertices
+    for(uint bid=0; bid<g.num_blocks(); ++bid)
+    {
+        // skip uniform blocks with unwanted voxels
+        if(g.block_is_uniform(bid) && !(g.block_flag(bid) & voxel_types)) continue;
+
+        uint beg[3], end[3];
+        g.block_range(bid, beg, end);
+        for(uint i=beg[0]; i<end[0]; ++i)
+        for(uint j=beg[1]; j<end[1]; ++j)
+        for(uint k=beg[2]; k<end[2]; ++k)
+        {
+            int flag = g.get(i,j,k);
+            if(flag & voxel_types)
+            {
+                // make verts
+                uint ijk[3] = { i, j, k };
+                std::vector<uint> verts(8);
+                for(uint off=0; off<8; ++off)
+                {
+                    uint64_t key = corner_key(ijk, off);
+                    auto     it  = vert_map.find(key);
+                    if(it==vert_map.end())
+                    {
+                        vec3d p = voxel_corner_xyz(g.bbox,g.len,ijk,off);
+                        it = vert_map.insert(std::make_pair(key, m.vert_add(p))).first;
+                    }
+                    verts[off] = it->second;
                 }
-                faces[off] = fid;
+
+                uint pid = voxel_to_hex(m, verts);
+                m.poly_data(pid).label = flag;
             }
-            // add voxel
-            uint pid = m.poly_add(faces,winding);
-            m.poly_data(pid).label = g.voxels[id];
         }
     }
 }
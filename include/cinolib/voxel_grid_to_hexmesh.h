@@ -37,6 +37,7 @@
 #define CINO_VOXEL_GRID_TO_HEXMESH_H
 
 #include <cinolib/voxel_grid.h>
+#include <cinolib/sparse_voxel_grid.h>
 #include <cinolib/meshes/hexmesh.h>
 
 namespace cinolib
@@ -54,6 +55,41 @@ CINO_INLINE
 void voxel_grid_to_hexmesh(const VoxelGrid                         & g,
                                  AbstractPolyhedralMesh<M,V,E,F,P> & m,
                            const int voxel_types = VOXEL_INSIDE | VOXEL_BOUNDARY);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void voxel_grid_to_hexmesh(const SparseVoxelGrid                   & g,
+                                 AbstractPolyhedralMesh<M,V,E,F,P> & m,
+                           const int voxel_types = VOXEL_INSIDE | VOXEL_BOUNDARY);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Flat version of the conversion above, which does not build any mesh connectivity.
+// The output is a list of vertices, a serialized list of hexahedra (8 vertices each,
+// ordered as in REFERENCE_HEX_VERTS) and one label (i.e. voxel type) per hexahedron.
+// Voxels are processed by slabs of layers orthogonal to the X axis, in parallel.
+// Vertices are numbered plane by plane, and hexahedra follow the voxel order
+//
+CINO_INLINE
+void voxel_grid_to_hexmesh(const VoxelGrid         & g,
+                                 std::vector<vec3d> & verts,
+                                 std::vector<uint>  & hexa,
+                                 std::vector<int>   & labels,
+                           const int voxel_types = VOXEL_INSIDE | VOXEL_BOUNDARY);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Writes the hexahedral mesh of a voxel grid straight to file, without building it
+// in memory. MESH files are streamed one plane of voxel corners (and one layer of
+// voxels) at a time, hence memory usage is proportional to a single slice of the grid.
+// Other formats (MESHB, VTU) are written from the flat arrays computed above
+//
+CINO_INLINE
+void voxel_grid_to_hexmesh(const VoxelGrid & g,
+                           const char      * filename,
+                           const int voxel_types = VOXEL_INSIDE | VOXEL_BOUNDARY);
 }
 
 #ifndef  CINO_STATIC_LIB
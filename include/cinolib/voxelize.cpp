@@ -36,11 +36,166 @@
 #include <cinolib/voxelize.h>
 #include <cinolib/serialize_index.h>
 #include <cinolib/parallel_for.h>
+#include <cinolib/predicates.h>
 #include <mutex>
+#include <queue>
+#include <algorithm>
 
 namespace cinolib
 {
 
+// classifies a voxel depending on how function f evaluates at its corners
+CINO_INLINE
+int voxel_flag(const std::function<double(const vec3d & p)> & f,
+               const AABB                                   & bbox,
+               const double                                   len,
+               const uint                                     ijk[3])
+{
+    bool negative = false;
+    bool positive = false;
+    bool zero     = false;
+    for(uint off=0; off<8; ++off)
+    {
+        vec3d p = voxel_corner_xyz(bbox,len,ijk,off);
+        double fp = f(p);
+        positive |= (fp>0);
+        negative |= (fp<0);
+        zero     |= (fp==0);
+    }
+    if( positive && !negative && !zero) return VOXEL_OUTSIDE;
+    if(!positive &&  negative && !zero) return VOXEL_INSIDE;
+    return VOXEL_BOUNDARY;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Labels as inside or outside all voxels which are not traversed by the surface,
+// counting the number of times the column of voxel centers passing through them
+// crosses the surface. Voxels are inside if the number of crossings is odd or the
+// winding number is not zero (so that overlapping shells are filled as well).
+// Columns are aligned with the Z axis (hence contiguous in memory), and are processed
+// in parallel. Triangles are binned into the columns their XY projection covers, and
+// crossings are detected with orient2d. Columns passing exactly through an edge or a
+// vertex are assigned to one triangle only, simulating a perturbation of the column
+// along the direction (-1,-eps)
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void voxelize_scanline_fill(const AbstractPolygonMesh<M,V,E,P> & m,
+                                  VoxelGrid                    & g)
+{
+    std::vector<uint> tris;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        const std::vector<uint> & t = m.poly_tessellation(pid);
+        tris.insert(tris.end(), t.begin(), t.end());
+    }
+    uint n_tris = uint(tris.size()/3);
+    uint n_cols = g.dim[0]*g.dim[1];
+
+    // range of columns covered by the XY projection of a triangle (end excluded)
+    auto col_range = [&](const uint tid, uint beg[2], uint end[2])
+    {
+        for(uint d=0; d<2; ++d)
+        {
+            double min = std::min(m.vert(tris[3*tid])[d], std::min(m.vert(tris[3*tid+1])[d], m.vert(tris[3*tid+2])[d]));
+            double max = std::max(m.vert(tris[3*tid])[d], std::max(m.vert(tris[3*tid+1])[d], m.vert(tris[3*tid+2])[d]));
+            double lo  = ceil ((min - g.bbox.min[d])/g.len - 0.5);
+            double hi  = floor((max - g.bbox.min[d])/g.len - 0.5) + 1;
+            beg[d] = uint(std::max(0.0, std::min(double(g.dim[d]), lo)));
+            end[d] = uint(std::max(0.0, std::min(double(g.dim[d]), hi)));
+        }
+    };
+
+    // bin triangles into columns (CSR layout)
+    std::vector<uint> col_offset(n_cols+1, 0);
+    for(uint tid=0; tid<n_tris; ++tid)
+    {
+        uint beg[2], end[2];
+        col_range(tid, beg, end);
+        for(uint i=beg[0]; i<end[0]; ++i)
+        for(uint j=beg[1]; j<end[1]; ++j) ++col_offset[i*g.dim[1]+j];
+    }
+    uint n_entries = PARALLEL_PREFIX_SUM(col_offset, 100000);
+    std::vector<uint> col_tris(n_entries);
+    std::vector<uint> pos(col_offset.begin(), col_offset.end()-1);
+    for(uint tid=0; tid<n_tris; ++tid)
+    {
+        uint beg[2], end[2];
+        col_range(tid, beg, end);
+        for(uint i=beg[0]; i<end[0]; ++i)
+        for(uint j=beg[1]; j<end[1]; ++j) col_tris[pos[i*g.dim[1]+j]++] = tid;
+    }
+
+    PARALLEL_FOR(0, n_cols, 1000, [&](uint col)
+    {
+        uint  i = col / g.dim[1];
+        uint  j = col % g.dim[1];
+        vec2d p(g.bbox.min.x() + (i+0.5)*g.len,
+                g.bbox.min.y() + (j+0.5)*g.len);
+
+        std::vector<std::pair<double,int>> crossings; // (z, +1/-1 depending on triangle orientation)
+        for(uint off=col_offset[col]; off<col_offset[col+1]; ++off)
+        {
+            uint  tid  = col_tris[off];
+            vec3d t[3] = { m.vert(tris[3*tid  ]),
+                           m.vert(tris[3*tid+1]),
+                           m.vert(tris[3*tid+2]) };
+            vec2d v[3] = { vec2d(t[0].x(), t[0].y()),
+                           vec2d(t[1].x(), t[1].y()),
+                           vec2d(t[2].x(), t[2].y()) };
+            double area = orient2d(v[0], v[1], v[2]);
+            if(area==0) continue; // triangle is parallel to the column
+            int sign = 1;
+            if(area<0)
+            {
+                std::swap(t[1], t[2]);
+                std::swap(v[1], v[2]);
+                sign = -1;
+            }
+
+            double w[3] = { orient2d(v[1], v[2], p),
+                            orient2d(v[2], v[0], p),
+                            orient2d(v[0], v[1], p) };
+            bool hit = true;
+            for(uint e=0; e<3 && hit; ++e)
+            {
+                if(w[e]<0) hit = false;
+                else if(w[e]==0)
+                {
+                    vec2d d = v[(e+2)%3] - v[(e+1)%3];
+                    hit = (d.y()>0 || (d.y()==0 && d.x()<0));
+                }
+            }
+            if(hit)
+            {
+                double z = (w[0]*t[0].z() + w[1]*t[1].z() + w[2]*t[2].z()) / (w[0] + w[1] + w[2]);
+                crossings.push_back(std::make_pair(z,sign));
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        int * voxels  = g.voxels + col*g.dim[2];
+        uint  n_cross = 0;
+        int   winding = 0;
+        for(uint k=0; k<g.dim[2]; ++k)
+        {
+            double z = g.bbox.min.z() + (k+0.5)*g.len;
+            while(n_cross<crossings.size() && crossings.at(n_cross).first<z)
+            {
+                winding += crossings.at(n_cross).second;
+                ++n_cross;
+            }
+            if(voxels[k]==VOXEL_UNKNOWN)
+            {
+                voxels[k] = (n_cross%2==1 || winding!=0) ? VOXEL_INSIDE : VOXEL_OUTSIDE;
+            }
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 // Voxelizes an object described by a surface mesh. Voxels will be deemed
 // as being entirely inside, outside or traversed by the boundary of the
 // input surface mesh, which can contain triangles, quads or general polygons.
@@ -49,7 +204,8 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void voxelize(const AbstractPolygonMesh<M,V,E,P> & m,
               const uint                           max_voxels_per_side,
-                    VoxelGrid                    & g)
+                    VoxelGrid                    & g,
+              const bool                           flood_fill)
 {
     // pad the bbox to ease the subsequent inside/outside labeling
     g.bbox = m.bbox();
@@ -101,6 +257,20 @@ void voxelize(const AbstractPolygonMesh<M,V,E,P> & m,
         }
     });
 
+    // scanline parity is only meaningful for watertight meshes. If some edge
+    // is not shared by exactly two polygons, flood the outside instead
+    bool closed = true;
+    for(uint eid=0; eid<m.num_edges() && closed; ++eid)
+    {
+        if(m.adj_e2p(eid).size()!=2) closed = false;
+    }
+
+    if(!flood_fill && closed)
+    {
+        voxelize_scanline_fill(m,g);
+        return;
+    }
+
     // flood the outside
     std::queue<uint> q;
     q.push(0); // voxel zero is guaranteed to be outside (due to the previous padding)
@@ -159,22 +329,263 @@ void voxelize(const std::function<double(const vec3d & p)> & f,
     PARALLEL_FOR(0, size, 100000, [&](uint index)
     {
         vec3u ijk = deserialize_3D_index(index,g.dim[1],g.dim[2]);
-        bool negative = false;
-        bool positive = false;
-        bool zero     = false;
-        for(uint off=0; off<8; ++off)
-        {
-            vec3d p = voxel_corner_xyz(g,ijk.ptr(),off);
-            double fp = f(p);
-            positive |= (fp>0);
-            negative |= (fp<0);
-            zero     |= (fp==0);
-        }
-        if( positive && !negative && !zero) g.voxels[index] = VOXEL_OUTSIDE; else
-        if(!positive &&  negative && !zero) g.voxels[index] = VOXEL_INSIDE;  else
-        g.voxels[index] = VOXEL_BOUNDARY;
+        g.voxels[index] = voxel_flag(f, g.bbox, g.len, ijk.ptr());
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void voxelize(const AbstractPolygonMesh<M,V,E,P> & m,
+              const uint                           max_voxels_per_side,
+                    SparseVoxelGrid              & g)
+{
+    // pad the bbox to ease the subsequent inside/outside labeling
+    AABB   bbox = m.bbox();
+    double len  = bbox.delta().max_entry() / max_voxels_per_side;
+    vec3d  pad(len,len,len);
+    bbox.min -= pad;
+    bbox.max += pad;
+
+    // determine grid size across all dimensions
+    uint dim[3] =
+    {
+        uint(ceil(bbox.delta_x()/len)),
+        uint(ceil(bbox.delta_y()/len)),
+        uint(ceil(bbox.delta_z()/len))
+    };
+    g.init(bbox, len, dim, VOXEL_UNKNOWN);
+
+    // range of voxels spanned by the AABB of a polygon
+    auto poly_range = [&](const uint pid, uint beg[3], uint end[3])
+    {
+        AABB  box = m.poly_aabb(pid);
+        vec3d b   = (box.min - g.bbox.min)/g.len;
+        vec3d e   = (box.max - g.bbox.min)/g.len;
+        for(uint i=0; i<3; ++i)
+        {
+            beg[i] = uint(floor(b[i]));
+            end[i] = std::min(uint(ceil(e[i])), g.dim[i]);
+        }
+    };
+
+    // bucket polygons by the blocks they may intersect, and activate such blocks
+    std::vector<std::pair<uint,uint>> block_poly;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        uint beg[3], end[3];
+        poly_range(pid, beg, end);
+        if(beg[0]>=end[0] || beg[1]>=end[1] || beg[2]>=end[2]) continue;
+
+        for(uint i=beg[0]/SparseVoxelGrid::BLOCK_SIZE; i<=(end[0]-1)/SparseVoxelGrid::BLOCK_SIZE; ++i)
+        for(uint j=beg[1]/SparseVoxelGrid::BLOCK_SIZE; j<=(end[1]-1)/SparseVoxelGrid::BLOCK_SIZE; ++j)
+        for(uint k=beg[2]/SparseVoxelGrid::BLOCK_SIZE; k<=(end[2]-1)/SparseVoxelGrid::BLOCK_SIZE; ++k)
+        {
+            uint bid = g.block_id(i*SparseVoxelGrid::BLOCK_SIZE, j*SparseVoxelGrid::BLOCK_SIZE, k*SparseVoxelGrid::BLOCK_SIZE);
+            block_poly.push_back(std::make_pair(bid,pid));
+        }
+    }
+    std::sort(block_poly.begin(), block_poly.end());
+    std::vector<uint> bucket;
+    for(uint i=0; i<block_poly.size(); ++i)
+    {
+        if(i==0 || block_poly[i].first!=block_poly[i-1].first)
+        {
+            bucket.push_back(i);
+            g.block_activate(block_poly[i].first);
+        }
+    }
+    bucket.push_back(uint(block_poly.size()));
+
+    // flag voxels that have non empty intersection with the input mesh elements.
+    // Each thread processes a different block, hence there are no write conflicts
+    PARALLEL_FOR(0, uint(bucket.size()-1), 1, [&](const uint b)
+    {
+        uint bid = block_poly[bucket[b]].first;
+        uint b_beg[3], b_end[3];
+        g.block_range(bid, b_beg, b_end);
+
+        for(uint n=bucket[b]; n<bucket[b+1]; ++n)
+        {
+            uint pid = block_poly[n].second;
+            uint beg[3], end[3];
+            poly_range(pid, beg, end);
+
+            for(uint i=std::max(beg[0],b_beg[0]); i<std::min(end[0],b_end[0]); ++i)
+            for(uint j=std::max(beg[1],b_beg[1]); j<std::min(end[1],b_end[1]); ++j)
+            for(uint k=std::max(beg[2],b_beg[2]); k<std::min(end[2],b_end[2]); ++k)
+            {
+                if(g.get(i,j,k)==VOXEL_UNKNOWN)
+                {
+                    uint ijk[3] = { i, j, k };
+                    AABB voxel = voxel_bbox(g.bbox, g.len, ijk);
+                    for(uint t=0; t<m.poly_tessellation(pid).size()/3; ++t)
+                    {
+                        vec3d tri[3] = { m.vert(m.poly_tessellation(pid).at(3*t+0)),
+                                         m.vert(m.poly_tessellation(pid).at(3*t+1)),
+                                         m.vert(m.poly_tessellation(pid).at(3*t+2)) };
+
+                        if(voxel.intersects_triangle(tri))
+                        {
+                            g.set(i,j,k,VOXEL_BOUNDARY);
+                            break; // do not test other triangles for this boundary voxel...
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    // flood the outside. Uniform blocks are flooded as a whole, whereas
+    // active blocks (i.e. blocks traversed by the surface) voxel by voxel
+    std::queue<uint>  q_blocks;
+    std::queue<vec3u> q_voxels;
+    auto visit = [&](const uint i, const uint j, const uint k)
+    {
+        uint bid = g.block_id(i,j,k);
+        if(g.block_is_uniform(bid))
+        {
+            if(g.block_flag(bid)==VOXEL_UNKNOWN)
+            {
+                g.block_fill(bid, VOXEL_OUTSIDE);
+                q_blocks.push(bid);
+            }
+        }
+        else if(g.get(i,j,k)==VOXEL_UNKNOWN)
+        {
+            g.set(i,j,k,VOXEL_OUTSIDE);
+            q_voxels.push(vec3u(i,j,k));
+        }
+    };
+    visit(0,0,0); // voxel zero is guaranteed to be outside (due to the previous padding)
+    while(!q_blocks.empty() || !q_voxels.empty())
+    {
+        if(!q_voxels.empty())
+        {
+            vec3u ijk = q_voxels.front();
+            q_voxels.pop();
+            for(uint a=0; a<3; ++a)
+            {
+                vec3u n = ijk;
+                if(ijk[a]>0)          { n[a] = ijk[a]-1; visit(n[0],n[1],n[2]); }
+                if(ijk[a]+1<g.dim[a]) { n[a] = ijk[a]+1; visit(n[0],n[1],n[2]); }
+            }
+        }
+        else
+        {
+            uint bid = q_blocks.front();
+            q_blocks.pop();
+            uint beg[3], end[3];
+            g.block_range(bid, beg, end);
+
+            // visit the voxels beyond each face of the block. If they belong
+            // to a uniform block, visiting one of them is enough
+            for(uint a=0; a<3; ++a)
+            for(uint side=0; side<2; ++side)
+            {
+                if(side==0 && beg[a]==0       ) continue;
+                if(side==1 && end[a]==g.dim[a]) continue;
+                uint a1 = (a+1)%3;
+                uint a2 = (a+2)%3;
+                uint n[3];
+                n[a]  = (side==0) ? beg[a]-1 : end[a];
+                n[a1] = beg[a1];
+                n[a2] = beg[a2];
+                if(g.block_is_uniform(g.block_id(n[0],n[1],n[2])))
+                {
+                    visit(n[0],n[1],n[2]);
+                    continue;
+                }
+                for(n[a1]=beg[a1]; n[a1]<end[a1]; ++n[a1])
+                for(n[a2]=beg[a2]; n[a2]<end[a2]; ++n[a2])
+                {
+                    visit(n[0],n[1],n[2]);
+                }
+            }
+        }
+    }
+
+    // mark the rest as inside
+    for(uint bid=0; bid<g.num_blocks(); ++bid)
+    {
+        if(g.block_is_uniform(bid) && g.block_flag(bid)==VOXEL_UNKNOWN)
+        {
+            g.block_fill(bid, VOXEL_INSIDE);
+        }
+    }
+    PARALLEL_FOR(0, g.num_active_blocks(), 64, [&](const uint n)
+    {
+        uint beg[3], end[3];
+        g.block_range(g.active_block(n), beg, end);
+        for(uint i=beg[0]; i<end[0]; ++i)
+        for(uint j=beg[1]; j<end[1]; ++j)
+        for(uint k=beg[2]; k<end[2]; ++k)
+        {
+            if(g.get(i,j,k)==VOXEL_UNKNOWN) g.set(i,j,k,VOXEL_INSIDE);
+        }
     });
+    g.collapse();
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void voxelize(const std::function<double(const vec3d & p)> & f,
+              const AABB                                   & volume,
+              const uint                                     max_voxels_per_side,
+                    SparseVoxelGrid                        & g)
+{
+    // determine grid size across all dimensions
+    double len = volume.delta().max_entry() / max_voxels_per_side;
+    uint dim[3] =
+    {
+        uint(ceil(volume.delta_x()/len)),
+        uint(ceil(volume.delta_y()/len)),
+        uint(ceil(volume.delta_z()/len))
+    };
+    g.init(volume, len, dim, VOXEL_UNKNOWN);
+
+    // evaluate blocks in parallel, in batches, using a temporary buffer with per voxel
+    // flags. Blocks are then stored either as uniform blocks or as active blocks
+    const uint batch = 4096;
+    std::vector<int> flags(batch*SparseVoxelGrid::BLOCK_VOXELS);
+    for(uint first=0; first<g.num_blocks(); first+=batch)
+    {
+        uint n = std::min(batch, g.num_blocks()-first);
+        std::vector<char> uniform(n); // not std::vector<bool>, as it is written concurrently
+        PARALLEL_FOR(0, n, 1, [&](const uint b)
+        {
+            uint beg[3], end[3];
+            g.block_range(first+b, beg, end);
+            int  * block_flags = flags.data() + b*SparseVoxelGrid::BLOCK_VOXELS;
+            uint   count       = 0;
+            for(uint i=beg[0]; i<end[0]; ++i)
+            for(uint j=beg[1]; j<end[1]; ++j)
+            for(uint k=beg[2]; k<end[2]; ++k)
+            {
+                uint ijk[3] = { i, j, k };
+                block_flags[count++] = voxel_flag(f, g.bbox, g.len, ijk);
+            }
+            uniform[b] = std::all_of(block_flags, block_flags+count, [&](const int v){ return v==block_flags[0]; });
+        });
+        for(uint b=0; b<n; ++b)
+        {
+            int * block_flags = flags.data() + b*SparseVoxelGrid::BLOCK_VOXELS;
+            if(uniform[b]) g.block_fill(first+b, block_flags[0]); else
+            {
+                uint beg[3], end[3];
+                g.block_range(first+b, beg, end);
+                uint count = 0;
+                for(uint i=beg[0]; i<end[0]; ++i)
+                for(uint j=beg[1]; j<end[1]; ++j)
+                for(uint k=beg[2]; k<end[2]; ++k)
+                {
+                    g.set(i,j,k,block_flags[count++]);
+                }
+            }
+        }
+    }
 }
 
+}
@@ -37,6 +37,7 @@
 #define CINO_VOXELIZE_H
 
 #include <cinolib/voxel_grid.h>
+#include <cinolib/sparse_voxel_grid.h>
 #include <cinolib/meshes/abstract_polygonmesh.h>
 
 namespace cinolib
@@ -45,12 +46,19 @@ namespace cinolib
 // Voxelizes an object described by a surface mesh. Voxels will be deemed
 // as being entirely inside, outside or traversed by the boundary of the
 // input surface mesh, which can contain triangles, quads or general polygons.
+// Non boundary voxels are labeled in parallel, counting how many times each
+// column of voxel centers crosses the surface. If flood_fill is true, or if
+// the mesh is not closed (i.e. some edge is not shared by exactly two polys)
+// the outside is flooded from a grid corner instead. This is slower, but
+// tolerates small holes in the mesh and labels as inside any cavity which is
+// not reachable from the outside
 //
 template<class M, class V, class E, class P>
 CINO_INLINE
 void voxelize(const AbstractPolygonMesh<M,V,E,P> & m,
               const uint                           max_voxels_per_side,
-                    VoxelGrid                    & g);
+                    VoxelGrid                    & g,
+              const bool                           flood_fill = false);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -63,6 +71,28 @@ void voxelize(const std::function<double(const vec3d & p)> & f,
               const AABB                                   & volume,
               const uint                                     max_voxels_per_side,
                     VoxelGrid                              & g);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Same as above, for sparse grids. Memory is proportional to the number of
+// blocks traversed by the surface, hence very high resolutions are possible
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+void voxelize(const AbstractPolygonMesh<M,V,E,P> & m,
+              const uint                           max_voxels_per_side,
+                    SparseVoxelGrid              & g);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Same as above, for sparse grids. Blocks are evaluated in parallel, and
+// stored as uniform blocks whenever possible
+//
+CINO_INLINE
+void voxelize(const std::function<double(const vec3d & p)> & f,
+              const AABB                                   & volume,
+              const uint                                     max_voxels_per_side,
+                    SparseVoxelGrid                        & g);
 }
 
 #ifndef  CINO_STATIC_LIB
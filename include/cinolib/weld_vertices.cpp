@@ -0,0 +1,153 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/weld_vertices.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void weld_vertices(const std::vector<double> & soup_xyz,
+                         std::vector<vec3d>  & verts,
+                         std::vector<uint>   & vids,
+                   const double                tolerance)
+{
+    uint n = uint(soup_xyz.size()/3);
+    verts.clear();
+    vids.resize(n);
+    if(n==0) return;
+
+    // quantized (or exact) keys. Adding 0.0 maps -0.0 to +0.0,
+    // so that they compare equal (as they do in a std::map<vec3d,uint>)
+    std::vector<double>   key(3*size_t(n));
+    std::vector<uint64_t> hash(n);
+    PARALLEL_FOR(0, n, 10000, [&](uint i)
+    {
+        uint64_t h = 14695981039346656037ull;
+        for(int j=0; j<3; ++j)
+        {
+            double x = soup_xyz[3*size_t(i)+j];
+            x = (tolerance>0) ? std::floor(x/tolerance) + 0.0 : x + 0.0;
+            key[3*size_t(i)+j] = x;
+            uint64_t bits;
+            memcpy(&bits, &x, sizeof(double));
+            h = (h ^ bits) * 1099511628211ull;
+            h ^= h >> 29;
+        }
+        hash[i] = h;
+    });
+    auto same_key = [&](const uint i, const uint j)
+    {
+        return key[3*size_t(i)  ]==key[3*size_t(j)  ] &&
+               key[3*size_t(i)+1]==key[3*size_t(j)+1] &&
+               key[3*size_t(i)+2]==key[3*size_t(j)+2];
+    };
+
+    // split corners in independent partitions (by hash), one per thread.
+    // The split is stable, so each partition lists its corners in input order
+    uint n_parts = (n<100000) ? 1 : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<uint> part_beg(n_parts+1, 0);
+    std::vector<uint> order;
+    if(n_parts>1)
+    {
+        for(uint i=0; i<n; ++i) ++part_beg[(hash[i]>>32)%n_parts+1];
+        for(uint p=0; p<n_parts; ++p) part_beg[p+1] += part_beg[p];
+        order.resize(n);
+        std::vector<uint> pos(part_beg.begin(), part_beg.end()-1);
+        for(uint i=0; i<n; ++i) order[pos[(hash[i]>>32)%n_parts]++] = i;
+    }
+    else part_beg[1] = n;
+
+    // map each corner to the first occurrence of its point, with
+    // an open addressing hash table (linear probing) per partition
+    std::vector<uint> rep(n);
+    PARALLEL_FOR(0, n_parts, 2, [&](uint p)
+    {
+        uint size = part_beg[p+1] - part_beg[p];
+        uint64_t cap = 16;
+        while(cap < 2*uint64_t(size)) cap *= 2;
+        const uint64_t mask  = cap-1;
+        const uint     empty = uint(-1);
+        std::vector<uint> table(cap, empty);
+        for(uint k=part_beg[p]; k<part_beg[p+1]; ++k)
+        {
+            uint i = (n_parts>1) ? order[k] : k;
+            uint64_t slot = hash[i] & mask;
+            while(table[slot]!=empty && !same_key(table[slot],i)) slot = (slot+1) & mask;
+            if(table[slot]==empty) table[slot] = i;
+            rep[i] = table[slot];
+        }
+    });
+    std::vector<uint>().swap(order);
+    std::vector<uint64_t>().swap(hash);
+    std::vector<double>().swap(key);
+
+    // assign fresh ids in order of first occurrence (prefix sum over blocks)
+    uint n_blocks = n_parts;
+    std::vector<uint> block(n_blocks+1);
+    for(uint b=0; b<=n_blocks; ++b) block[b] = uint(uint64_t(n)*b/n_blocks);
+    std::vector<uint> count(n_blocks+1, 0);
+    PARALLEL_FOR(0, n_blocks, 2, [&](uint b)
+    {
+        for(uint i=block[b]; i<block[b+1]; ++i) if(rep[i]==i) ++count[b+1];
+    });
+    for(uint b=0; b<n_blocks; ++b) count[b+1] += count[b];
+
+    verts.resize(count.back());
+    PARALLEL_FOR(0, n_blocks, 2, [&](uint b)
+    {
+        uint fresh_id = count[b];
+        for(uint i=block[b]; i<block[b+1]; ++i)
+        {
+            if(rep[i]!=i) continue;
+            verts[fresh_id] = vec3d(soup_xyz[3*size_t(i)], soup_xyz[3*size_t(i)+1], soup_xyz[3*size_t(i)+2]);
+            vids[i] = fresh_id++;
+        }
+    });
+
+    // representatives always precede the corners they represent
+    PARALLEL_FOR(0, n, 10000, [&](uint i)
+    {
+        if(rep[i]!=i) vids[i] = vids[rep[i]];
+    });
+}
+
+}
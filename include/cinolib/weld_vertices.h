@@ -0,0 +1,75 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2023: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_WELD_VERTICES_H
+#define CINO_WELD_VERTICES_H
+
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+
+namespace cinolib
+{
+
+/* Merges coincident vertices of a polygon soup, given as a list of serialized
+ * xyz coordinates (one triplet per polygon corner). Outputs the list of unique
+ * vertices and, for each corner, the id of the vertex it has been merged to.
+ *
+ * Welding is done in parallel: corners are split in partitions by hashing their
+ * coordinates, and each partition is welded with its own hash table. Fresh vertex
+ * ids follow the order of first
+ * occurrence in the soup, and each vertex gets the position of its first
+ * occurrence, hence the output is the same as the one of the classical serial
+ * welding based on a std::map<vec3d,uint>.
+ *
+ * If tolerance is positive, coordinates are quantized on a grid with cells
+ * of size tolerance, and all corners falling in the same cell are merged.
+ * Note that this does not merge close corners that lie across cell boundaries.
+*/
+
+CINO_INLINE
+void weld_vertices(const std::vector<double> & soup_xyz,
+                         std::vector<vec3d>  & verts,
+                         std::vector<uint>   & vids,
+                   const double                tolerance = 0.0);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "weld_vertices.cpp"
+#endif
+
+#endif // CINO_WELD_VERTICES_H